@@ -72,13 +72,22 @@ project "JetXEngine"
         -- AppFramework
         "../Src/AppFramework/Application.h",
         "../Src/AppFramework/Application.cpp",
+        "../Src/AppFramework/RenderingThread.h",
+        "../Src/AppFramework/RenderingThread.cpp",
         -- Foundation
         "../Src/Foundation/JetX.h",
         "../Src/Foundation/FileSystem.h",
         "../Src/Foundation/FileSystem.cpp",
         "../Src/Foundation/RefCounting.h",
+        "../Src/Foundation/Hash.h",
         "../Src/Foundation/XMemory.h",
         "../Src/Foundation/XMemory.cpp",
+        "../Src/Foundation/MemArena.h",
+        "../Src/Foundation/MemArena.cpp",
+        "../Src/Foundation/JobSystem.h",
+        "../Src/Foundation/JobSystem.cpp",
+        "../Src/Foundation/TaskGraph.h",
+        "../Src/Foundation/TaskGraph.cpp",
         "../Src/Foundation/OutputDevice.h",
         "../Src/Foundation/OutputDevice.cpp",
         -- Renderer Interface
@@ -87,12 +96,44 @@ project "JetXEngine"
         "../Src/Renderer/RendererDefs.h",
         "../Src/Renderer/RendererState.h",
         "../Src/Renderer/RHIResource.h",
+        "../Src/Renderer/RHICapture.h",
+        "../Src/Renderer/RHICapture.cpp",
+        "../Src/Renderer/RHICommandList.h",
+        "../Src/Renderer/RHICommandList.cpp",
+        "../Src/Renderer/RenderTargetPool.h",
+        "../Src/Renderer/RenderTargetPool.cpp",
+        "../Src/Renderer/DrawQueue.h",
+        "../Src/Renderer/DrawQueue.cpp",
+        "../Src/Renderer/OcclusionCuller.h",
+        "../Src/Renderer/OcclusionCuller.cpp",
+        "../Src/Renderer/ShaderPermutation.h",
+        "../Src/Renderer/ShaderPermutation.cpp",
+        -- Null
+        "../Src/Renderer/Null/NullRenderer.h",
+        "../Src/Renderer/Null/NullRenderer.cpp",
+        "../Src/Renderer/Null/NullResource.h",
+        "../Src/Renderer/Null/NullResource.cpp",
+        -- Software
+        "../Src/Renderer/Software/SoftwareRasterizer.h",
+        "../Src/Renderer/Software/SoftwareRasterizer.cpp",
+        "../Src/Renderer/Software/SoftwareRenderer.h",
+        "../Src/Renderer/Software/SoftwareRenderer.cpp",
+        "../Src/Renderer/Software/SoftwareResource.h",
+        "../Src/Renderer/Software/SoftwareResource.cpp",
+        "../Src/Renderer/Software/SoftwareShader.h",
+        "../Src/Renderer/Software/SoftwareShader.cpp",
         -- OpenGL
         "../Src/Renderer/OpenGL/OpenGLCommand.cpp",
         "../Src/Renderer/OpenGL/OpenGLDataBuffer.cpp",
         "../Src/Renderer/OpenGL/OpenGLDataBuffer.h",
         "../Src/Renderer/OpenGL/OpenGLRenderer.h",
         "../Src/Renderer/OpenGL/OpenGLRenderer.cpp",
+        "../Src/Renderer/OpenGL/OpenGLPipelineState.h",
+        "../Src/Renderer/OpenGL/OpenGLPipelineState.cpp",
+        "../Src/Renderer/OpenGL/OpenGLProgramCache.h",
+        "../Src/Renderer/OpenGL/OpenGLProgramCache.cpp",
+        "../Src/Renderer/OpenGL/OpenGLQuery.h",
+        "../Src/Renderer/OpenGL/OpenGLQuery.cpp",
         "../Src/Renderer/OpenGL/OpenGLResource.cpp",
         "../Src/Renderer/OpenGL/OpenGLShader.h",
         "../Src/Renderer/OpenGL/OpenGLShader.cpp",
@@ -100,6 +141,14 @@ project "JetXEngine"
         "../Src/Renderer/OpenGL/OpenGLState.cpp",
         "../Src/Renderer/OpenGL/OpenGLVertexDeclaration.h",
         "../Src/Renderer/OpenGL/OpenGLVertexDeclaration.cpp",
+        "../Src/Renderer/OpenGL/OpenGLStreamBuffer.h",
+        "../Src/Renderer/OpenGL/OpenGLStreamBuffer.cpp",
+        "../Src/Renderer/OpenGL/OpenGLTexture.h",
+        "../Src/Renderer/OpenGL/OpenGLTexture.cpp",
+        "../Src/Renderer/OpenGL/OpenGLFrameBuffer.h",
+        "../Src/Renderer/OpenGL/OpenGLFrameBuffer.cpp",
+        "../Src/Renderer/OpenGL/OpenGLUniformBuffer.h",
+        "../Src/Renderer/OpenGL/OpenGLUniformBuffer.cpp",
         "../Src/Renderer/OpenGL/OpenGLViewport.h",
         "../Src/Renderer/OpenGL/OpenGLViewport.cpp",
         "../Src/Renderer/OpenGL/PlatformOpenGL.h",
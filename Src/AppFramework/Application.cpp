@@ -3,6 +3,7 @@
 //
 
 #include "AppFramework/Application.h"
+#include "AppFramework/RenderingThread.h"
 
 //////////////////////////////////////////////////////////////////////////
 // helper functions
@@ -485,6 +486,7 @@ bool FApplication::Init()
 
 void FApplication::Shutdown()
 {
+	StopRenderingThread();
 	glfwTerminate();
 }
 
@@ -504,6 +506,18 @@ void FApplication::RunLoop()
 		double NowTime = glfwGetTime();
 		OnTick((float)(NowTime - LastTime));
 		LastTime = NowTime;
+
+		if (RenderingThread)
+		{
+			FRHICommandList &RHICmdList = RenderingThread->BeginFrame();
+			OnRender(RHICmdList);
+			RenderingThread->EndFrame();
+		}
+	}
+
+	if (RenderingThread)
+	{
+		RenderingThread->FlushFrames();
 	}
 }
 
@@ -516,3 +530,31 @@ void FApplication::RequestQuit()
 {
 	bReqQuit = true;
 }
+
+bool FApplication::StartRenderingThread(FRenderer *InRenderer, FOutputDevice *InLogger, uint32_t InFrameLag)
+{
+	if (RenderingThread)
+	{
+		return false;
+	}
+
+	RenderingThread = new FRenderingThread();
+	if (!RenderingThread->Start(InRenderer, InLogger, InFrameLag))
+	{
+		delete RenderingThread;
+		RenderingThread = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+void FApplication::StopRenderingThread()
+{
+	if (RenderingThread)
+	{
+		RenderingThread->Stop();
+		delete RenderingThread;
+		RenderingThread = nullptr;
+	}
+}
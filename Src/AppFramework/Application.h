@@ -22,6 +22,10 @@
 
 
 class IWindowClient;
+class FRenderer;
+class FRHICommandList;
+class FRenderingThread;
+class FOutputDevice;
 
 //FWindow
 class FWindow : public FRefCountedObject
@@ -102,6 +106,7 @@ class FApplication
 public:
 	FApplication() 
 		: bReqQuit(false)
+		, RenderingThread(nullptr)
 	{}
 
 	virtual ~FApplication() {}
@@ -111,11 +116,21 @@ public:
 	virtual void RunLoop();
 	virtual void OnTick(float InDeltaSeconds);
 
+	// record the rendering of the frame, called after OnTick() when the rendering thread is running.
+	virtual void OnRender(FRHICommandList &RHICmdList) {}
+
 	// request quit app
 	virtual void RequestQuit();
 
 protected:
+	// optional: InRenderer is initialized and used on a rendering thread from now on, the frames
+	// recorded by OnRender() are rendered while the next OnTick() runs. InFrameLag is 1 or 2.
+	bool StartRenderingThread(FRenderer *InRenderer, FOutputDevice *InLogger, uint32_t InFrameLag = 1);
+	// render the pending frames and shutdown the renderer on its thread.
+	void StopRenderingThread();
+
 	bool	bReqQuit;
+	FRenderingThread	*RenderingThread;
 };
 
 
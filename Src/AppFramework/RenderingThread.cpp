@@ -0,0 +1,182 @@
+//\brief
+//		rendering thread implementation.
+//
+
+#include <chrono>
+#include "AppFramework/RenderingThread.h"
+
+
+static double GetThreadSeconds()
+{
+	typedef std::chrono::steady_clock FClock;
+	return std::chrono::duration<double>(FClock::now().time_since_epoch()).count();
+}
+
+FRenderingThread::FRenderingThread()
+	: Renderer(nullptr)
+	, Logger(nullptr)
+	, FrameLag(1)
+	, GameFrames(0)
+	, RenderFrames(0)
+	, bInFrame(false)
+	, PendingTask(nullptr)
+	, bQuit(false)
+	, GameWaitSeconds(0.0)
+	, RenderIdleSeconds(0.0)
+{
+}
+
+FRenderingThread::~FRenderingThread()
+{
+	Stop();
+}
+
+bool FRenderingThread::Start(FRenderer *InRenderer, FOutputDevice *InLogger, uint32_t InFrameLag)
+{
+	assert(InRenderer != nullptr);
+	if (IsRunning())
+	{
+		return false;
+	}
+
+	Renderer = InRenderer;
+	Logger = InLogger;
+	FrameLag = std::min(std::max(InFrameLag, 1u), 2u);
+
+	CommandLists.resize(FrameLag + 1);
+	for (size_t k = 0; k < CommandLists.size(); k++)
+	{
+		CommandLists[k] = new FRHICommandList();
+	}
+
+	GameFrames = RenderFrames = 0;
+	bInFrame = false;
+	PendingTask = nullptr;
+	bQuit = false;
+	GameWaitSeconds = RenderIdleSeconds = 0.0;
+
+	Thread = std::thread(&FRenderingThread::ThreadMain, this);
+
+	// the context of the renderer is created on the rendering thread
+	FRenderer *TheRenderer = Renderer;
+	FOutputDevice *TheLogger = Logger;
+	ExecuteOnRenderThread([TheRenderer, TheLogger](FRenderer*) { TheRenderer->Init(TheLogger); });
+
+	if (Logger)
+	{
+		Logger->Log(Log_Info, "Rendering thread started, frame lag: %u", FrameLag);
+	}
+	return true;
+}
+
+void FRenderingThread::Stop()
+{
+	if (!IsRunning())
+	{
+		return;
+	}
+
+	assert(!bInFrame);
+	ExecuteOnRenderThread([](FRenderer *InRenderer) { InRenderer->Shutdown(); });
+
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		bQuit = true;
+	}
+	FrameEvent.notify_all();
+	Thread.join();
+
+	for (size_t k = 0; k < CommandLists.size(); k++)
+	{
+		delete CommandLists[k];
+	}
+	CommandLists.clear();
+}
+
+FRHICommandList& FRenderingThread::BeginFrame()
+{
+	assert(IsRunning() && !bInFrame);
+
+	std::unique_lock<std::mutex> Lock(Mutex);
+	if (GameFrames - RenderFrames > FrameLag)
+	{
+		double StartTime = GetThreadSeconds();
+		DoneEvent.wait(Lock, [this] { return GameFrames - RenderFrames <= FrameLag; });
+		GameWaitSeconds += GetThreadSeconds() - StartTime;
+	}
+
+	bInFrame = true;
+	return *CommandLists[GameFrames % CommandLists.size()];
+}
+
+void FRenderingThread::EndFrame()
+{
+	assert(bInFrame);
+
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		bInFrame = false;
+		GameFrames++;
+	}
+	FrameEvent.notify_one();
+}
+
+void FRenderingThread::ExecuteOnRenderThread(const std::function<void(FRenderer*)> &InTask)
+{
+	assert(IsRunning());
+
+	std::unique_lock<std::mutex> Lock(Mutex);
+	DoneEvent.wait(Lock, [this] { return PendingTask == nullptr; });
+
+	PendingTask = &InTask;
+	FrameEvent.notify_one();
+	DoneEvent.wait(Lock, [this, &InTask] { return PendingTask != &InTask; });
+}
+
+void FRenderingThread::FlushFrames()
+{
+	assert(IsRunning());
+
+	std::unique_lock<std::mutex> Lock(Mutex);
+	DoneEvent.wait(Lock, [this] { return RenderFrames == GameFrames; });
+}
+
+void FRenderingThread::ThreadMain()
+{
+	std::unique_lock<std::mutex> Lock(Mutex);
+
+	for (;;)
+	{
+		double StartTime = GetThreadSeconds();
+		FrameEvent.wait(Lock, [this] { return RenderFrames < GameFrames || PendingTask || bQuit; });
+		RenderIdleSeconds += GetThreadSeconds() - StartTime;
+
+		// the frames go first, a task runs after the frames submitted before it.
+		if (RenderFrames < GameFrames)
+		{
+			FRHICommandList *CommandList = CommandLists[RenderFrames % CommandLists.size()];
+
+			Lock.unlock();
+			CommandList->Execute(Renderer);
+			Lock.lock();
+
+			RenderFrames++;
+			DoneEvent.notify_all();
+		}
+		else if (PendingTask)
+		{
+			const std::function<void(FRenderer*)> *Task = PendingTask;
+
+			Lock.unlock();
+			(*Task)(Renderer);
+			Lock.lock();
+
+			PendingTask = nullptr;
+			DoneEvent.notify_all();
+		}
+		else if (bQuit)
+		{
+			break;
+		}
+	}
+}
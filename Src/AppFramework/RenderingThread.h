@@ -0,0 +1,79 @@
+// \brief
+//		Rendering thread: owns the renderer (and its GL context), executes the frames
+//		recorded by the game thread with a lag of 1 or 2 frames.
+//
+
+#ifndef __JETX_RENDERING_THREAD_H__
+#define __JETX_RENDERING_THREAD_H__
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include "Foundation/JetX.h"
+#include "Foundation/OutputDevice.h"
+#include "Renderer/Renderer.h"
+#include "Renderer/RHICommandList.h"
+
+
+// the renderer is initialized on the rendering thread, all the calls must then be made through
+// a frame command list or ExecuteOnRenderThread(), including the resource creation & release.
+class FRenderingThread
+{
+public:
+	FRenderingThread();
+	~FRenderingThread();
+
+	// InFrameLag: frames the game thread can run ahead of the rendering thread, 1 or 2.
+	bool Start(FRenderer *InRenderer, FOutputDevice *InLogger, uint32_t InFrameLag = 1);
+	// finish the submitted frames, shutdown the renderer and join the thread.
+	void Stop();
+
+	bool IsRunning() const { return Thread.joinable(); }
+	uint32_t GetFrameLag() const { return FrameLag; }
+
+	// game thread: the command list of the next frame, waits while the rendering thread is FrameLag frames behind.
+	FRHICommandList& BeginFrame();
+	// game thread: hand the frame over to the rendering thread.
+	void EndFrame();
+
+	// the slot of the frame recorded by the game thread, in [0, FrameLag]. game data read by the
+	// rendering thread is buffered per slot, the slot is not reused before the frame is rendered.
+	uint32_t GetGameFrameSlot() const { return (uint32_t)(GameFrames % CommandLists.size()); }
+
+	// run InTask on the rendering thread after the submitted frames and wait for it.
+	void ExecuteOnRenderThread(const std::function<void(FRenderer*)> &InTask);
+	// wait for all the submitted frames.
+	void FlushFrames();
+
+	// seconds the game thread waited for the rendering thread, and the rendering thread for the frames.
+	double GetGameWaitSeconds() const { return GameWaitSeconds; }
+	double GetRenderIdleSeconds() const { return RenderIdleSeconds; }
+
+protected:
+	void ThreadMain();
+
+	FRenderer			*Renderer;
+	FOutputDevice		*Logger;
+	uint32_t			FrameLag;
+
+	std::thread				Thread;
+	std::mutex				Mutex;
+	std::condition_variable	FrameEvent;		// a frame or a task is pending for the rendering thread
+	std::condition_variable	DoneEvent;		// a frame or a task is completed
+
+	// FrameLag + 1 lists, the frames [RenderFrames, GameFrames) are waiting or being rendered.
+	std::vector<FRHICommandList*>	CommandLists;
+	uint64_t				GameFrames;
+	uint64_t				RenderFrames;
+	bool					bInFrame;
+
+	const std::function<void(FRenderer*)>	*PendingTask;
+	bool					bQuit;
+
+	double					GameWaitSeconds;
+	double					RenderIdleSeconds;
+};
+
+#endif // __JETX_RENDERING_THREAD_H__
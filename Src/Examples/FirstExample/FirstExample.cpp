@@ -66,6 +66,8 @@ public:
 		
 		GraphicRender->Init(LogConsole);
 		GraphicRender->DumpCapabilities();
+		// the programs of the last run are loaded instead of linked
+		GraphicRender->SetProgramCacheDirectory("ProgramCache");
 
 		Viewport = GraphicRender->RHICreateViewport(MainWindow->GetNativeHandle(), 500, 500, false);
 		assert(Viewport.IsValidRef());
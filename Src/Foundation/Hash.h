@@ -0,0 +1,176 @@
+//\brief
+//		content hashing & the open-addressing cache of the immutable objects (states...).
+//		a key type provides GetTypeHash(const Key&) and operator==.
+//
+
+#ifndef __JETX_HASH_H__
+#define __JETX_HASH_H__
+
+#include <vector>
+#include <string>
+#include "JetX.h"
+
+
+inline uint32_t HashCombine(uint32_t InHash, uint32_t InValue)
+{
+	return InHash ^ (InValue + 0x9e3779b9 + (InHash << 6) + (InHash >> 2));
+}
+
+inline uint32_t GetTypeHash(uint32_t InValue)
+{
+	// the low bits select the slot, mix the high bits in (murmur3 finalizer).
+	InValue ^= InValue >> 16;
+	InValue *= 0x85ebca6b;
+	InValue ^= InValue >> 13;
+	InValue *= 0xc2b2ae35;
+	InValue ^= InValue >> 16;
+	return InValue;
+}
+
+inline uint32_t GetTypeHash(int32_t InValue)
+{
+	return GetTypeHash((uint32_t)InValue);
+}
+
+inline uint32_t GetTypeHash(bool InValue)
+{
+	return InValue ? 1 : 0;
+}
+
+inline uint32_t GetTypeHash(float InValue)
+{
+	// 0.f == -0.f
+	uint32_t Bits = 0;
+	if (InValue != 0.f)
+	{
+		memcpy(&Bits, &InValue, sizeof(Bits));
+	}
+	return GetTypeHash(Bits);
+}
+
+inline uint32_t GetTypeHash(const void *InPointer)
+{
+	const uint64_t kValue = (uint64_t)(uintptr_t)InPointer;
+	return GetTypeHash((uint32_t)kValue ^ (uint32_t)(kValue >> 32));
+}
+
+inline uint32_t GetTypeHash(const std::string &InString)
+{
+	// FNV-1a
+	uint32_t Hash = 2166136261u;
+	for (size_t k = 0; k < InString.size(); k++)
+	{
+		Hash = (Hash ^ (uint8_t)InString[k]) * 16777619u;
+	}
+	return GetTypeHash(Hash);
+}
+
+
+//TStateCache
+// the objects are never removed one by one, a cache is emptied as a whole.
+template<typename KeyType, typename ValueType>
+class TStateCache
+{
+public:
+	TStateCache()
+		: EntriesNum(0)
+		, HitsNum(0)
+		, MissesNum(0)
+	{}
+
+	// return nullptr if InKey is not in the cache.
+	ValueType* Find(const KeyType &InKey)
+	{
+		if (!Slots.empty())
+		{
+			const uint32_t kHash = GetTypeHash(InKey);
+			const uint32_t kMask = (uint32_t)Slots.size() - 1;
+			for (uint32_t Index = kHash & kMask; Slots[Index].bUsed; Index = (Index + 1) & kMask)
+			{
+				FSlot &Slot = Slots[Index];
+				if (Slot.Hash == kHash && Slot.Key == InKey)
+				{
+					HitsNum++;
+					return &Slot.Value;
+				}
+			} // end for
+		}
+
+		MissesNum++;
+		return nullptr;
+	}
+
+	// InKey must not be in the cache.
+	void Add(const KeyType &InKey, const ValueType &InValue)
+	{
+		// at most half full, the probe sequences stay short.
+		if ((EntriesNum + 1) * 2 > Slots.size())
+		{
+			Rehash(std::max<size_t>(Slots.size() * 2, 16));
+		}
+
+		Insert(GetTypeHash(InKey), InKey, InValue);
+		EntriesNum++;
+	}
+
+	void Empty()
+	{
+		Slots.clear();
+		EntriesNum = 0;
+	}
+
+	uint32_t Num() const { return EntriesNum; }
+	uint32_t GetHitsNum() const { return HitsNum; }
+	uint32_t GetMissesNum() const { return MissesNum; }
+
+private:
+	struct FSlot
+	{
+		FSlot()
+			: Hash(0)
+			, bUsed(false)
+		{}
+
+		uint32_t	Hash;
+		bool		bUsed;
+		KeyType		Key;
+		ValueType	Value;
+	};
+
+	void Insert(uint32_t InHash, const KeyType &InKey, const ValueType &InValue)
+	{
+		const uint32_t kMask = (uint32_t)Slots.size() - 1;
+		uint32_t Index = InHash & kMask;
+		while (Slots[Index].bUsed)
+		{
+			Index = (Index + 1) & kMask;
+		}
+
+		FSlot &Slot = Slots[Index];
+		Slot.Hash = InHash;
+		Slot.bUsed = true;
+		Slot.Key = InKey;
+		Slot.Value = InValue;
+	}
+
+	void Rehash(size_t InSlotsNum)
+	{
+		std::vector<FSlot> OldSlots(InSlotsNum);
+		OldSlots.swap(Slots);
+
+		for (size_t k = 0; k < OldSlots.size(); k++)
+		{
+			if (OldSlots[k].bUsed)
+			{
+				Insert(OldSlots[k].Hash, OldSlots[k].Key, OldSlots[k].Value);
+			}
+		} // end for k
+	}
+
+	std::vector<FSlot>	Slots;
+	uint32_t			EntriesNum;
+	uint32_t			HitsNum;
+	uint32_t			MissesNum;
+};
+
+#endif // __JETX_HASH_H__
@@ -0,0 +1,255 @@
+//\brief
+//		job system implementation.
+//
+
+#include <algorithm>
+#include "JobSystem.h"
+
+
+// the worker running on this thread
+static thread_local const FJobSystem	*tJobSystem = nullptr;
+static thread_local uint32_t			tWorkerIndex = 0;
+
+FJobSystem* FJobSystem::SharedInstance()
+{
+	static FJobSystem *sJobSystem = new FJobSystem();
+
+	return sJobSystem;
+}
+
+FJobSystem::FJobSystem()
+	: QueuedJobs(0)
+	, bQuit(false)
+	, bRunning(false)
+{
+}
+
+FJobSystem::~FJobSystem()
+{
+	Stop();
+}
+
+void FJobSystem::Start(uint32_t InWorkersNum)
+{
+	if (bRunning)
+	{
+		return;
+	}
+
+	if (InWorkersNum == ~0u)
+	{
+		uint32_t Cores = std::thread::hardware_concurrency();
+		InWorkersNum = Cores > 1 ? Cores - 1 : 0;
+	}
+
+	Queues.resize(InWorkersNum + 1);
+	for (size_t k = 0; k < Queues.size(); k++)
+	{
+		Queues[k] = new FWorkQueue();
+	}
+
+	QueuedJobs = 0;
+	bQuit = false;
+	bRunning = true;
+	for (uint32_t k = 0; k < InWorkersNum; k++)
+	{
+		Workers.push_back(std::thread(&FJobSystem::WorkerMain, this, k));
+	}
+}
+
+void FJobSystem::Stop()
+{
+	if (!bRunning)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(SleepMutex);
+		bQuit = true;
+	}
+	WakeUpEvent.notify_all();
+
+	for (size_t k = 0; k < Workers.size(); k++)
+	{
+		Workers[k].join();
+	}
+	Workers.clear();
+
+	// nobody waits for them, but the counters must be released
+	while (TryRunJob((uint32_t)Queues.size() - 1))
+	{
+	}
+
+	for (size_t k = 0; k < Queues.size(); k++)
+	{
+		delete Queues[k];
+	}
+	Queues.clear();
+	bRunning = false;
+}
+
+uint32_t FJobSystem::GetQueueIndex() const
+{
+	return tJobSystem == this ? tWorkerIndex : (uint32_t)Queues.size() - 1;
+}
+
+void FJobSystem::Run(const FJobFunc &InJob, FJobCounter *InCounter)
+{
+	if (InCounter)
+	{
+		InCounter->Count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	FJob Job;
+	Job.Func = InJob;
+	Job.Counter = InCounter;
+
+	if (!bRunning)
+	{
+		RunJob(Job);
+		return;
+	}
+
+	FWorkQueue *Queue = Queues[GetQueueIndex()];
+	{
+		std::lock_guard<std::mutex> Lock(Queue->Mutex);
+		Queue->Jobs.push_back(std::move(Job));
+	}
+	QueuedJobs.fetch_add(1, std::memory_order_release);
+
+	{
+		// no lost wake up between the check of a worker and its wait
+		std::lock_guard<std::mutex> Lock(SleepMutex);
+	}
+	WakeUpEvent.notify_one();
+}
+
+void FJobSystem::Wait(FJobCounter &InCounter)
+{
+	const uint32_t kQueueIndex = bRunning ? GetQueueIndex() : 0;
+
+	while (!InCounter.IsDone())
+	{
+		if (!bRunning || !TryRunJob(kQueueIndex))
+		{
+			// the remaining jobs are running on the other threads
+			std::this_thread::yield();
+		}
+	}
+}
+
+void FJobSystem::ParallelFor(uint32_t InCount, uint32_t InGrain, const std::function<void(uint32_t)> &InFunc)
+{
+	ParallelForRange(InCount, InGrain, [&InFunc](uint32_t InBegin, uint32_t InEnd) {
+		for (uint32_t Index = InBegin; Index < InEnd; Index++)
+		{
+			InFunc(Index);
+		}
+	});
+}
+
+void FJobSystem::ParallelForRange(uint32_t InCount, uint32_t InGrain, const std::function<void(uint32_t, uint32_t)> &InFunc)
+{
+	if (InCount == 0)
+	{
+		return;
+	}
+
+	InGrain = std::max(InGrain, 1u);
+	if (InCount <= InGrain || !bRunning || Workers.empty())
+	{
+		InFunc(0, InCount);
+		return;
+	}
+
+	// the first range runs on the calling thread
+	FJobCounter Counter;
+	for (uint32_t Begin = InGrain; Begin < InCount; Begin += InGrain)
+	{
+		const uint32_t End = std::min(Begin + InGrain, InCount);
+		Run([&InFunc, Begin, End]() { InFunc(Begin, End); }, &Counter);
+	}
+
+	InFunc(0, InGrain);
+	Wait(Counter);
+}
+
+void FJobSystem::WorkerMain(uint32_t InIndex)
+{
+	tJobSystem = this;
+	tWorkerIndex = InIndex;
+
+	while (!bQuit)
+	{
+		if (TryRunJob(InIndex))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> Lock(SleepMutex);
+		WakeUpEvent.wait(Lock, [this] { return bQuit || QueuedJobs.load(std::memory_order_acquire) > 0; });
+	}
+
+	tJobSystem = nullptr;
+}
+
+bool FJobSystem::PopJob(uint32_t InQueueIndex, FJob &OutJob)
+{
+	FWorkQueue *Queue = Queues[InQueueIndex];
+	std::lock_guard<std::mutex> Lock(Queue->Mutex);
+	if (Queue->Jobs.empty())
+	{
+		return false;
+	}
+
+	OutJob = std::move(Queue->Jobs.back());
+	Queue->Jobs.pop_back();
+	return true;
+}
+
+bool FJobSystem::StealJob(uint32_t InQueueIndex, FJob &OutJob)
+{
+	const uint32_t kQueuesNum = (uint32_t)Queues.size();
+	for (uint32_t k = 1; k < kQueuesNum; k++)
+	{
+		FWorkQueue *Queue = Queues[(InQueueIndex + k) % kQueuesNum];
+		std::lock_guard<std::mutex> Lock(Queue->Mutex);
+		if (!Queue->Jobs.empty())
+		{
+			OutJob = std::move(Queue->Jobs.front());
+			Queue->Jobs.pop_front();
+			return true;
+		}
+	} // end for k
+
+	return false;
+}
+
+bool FJobSystem::TryRunJob(uint32_t InQueueIndex)
+{
+	if (QueuedJobs.load(std::memory_order_acquire) <= 0)
+	{
+		return false;
+	}
+
+	FJob Job;
+	if (!PopJob(InQueueIndex, Job) && !StealJob(InQueueIndex, Job))
+	{
+		return false;
+	}
+
+	QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	RunJob(Job);
+	return true;
+}
+
+void FJobSystem::RunJob(FJob &InJob)
+{
+	InJob.Func();
+
+	if (InJob.Counter)
+	{
+		InJob.Counter->Count.fetch_sub(1, std::memory_order_release);
+	}
+}
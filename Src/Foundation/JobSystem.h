@@ -0,0 +1,105 @@
+//\brief
+//		job system: worker threads with work-stealing deques.
+//		the waiting threads run jobs while they wait, so jobs may wait for other jobs.
+//
+
+#ifndef __JETX_JOBSYSTEM_H__
+#define __JETX_JOBSYSTEM_H__
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include "JetX.h"
+
+
+typedef std::function<void()>	FJobFunc;
+
+// counts the unfinished jobs, the fence of a group of jobs.
+class FJobCounter
+{
+public:
+	FJobCounter()
+		: Count(0)
+	{}
+
+	bool IsDone() const { return Count.load(std::memory_order_acquire) == 0; }
+	int32_t GetValue() const { return Count.load(std::memory_order_acquire); }
+
+	// for the work not queued as jobs yet (e.g. tasks waiting for their prerequisites).
+	void Add(int32_t InValue) { Count.fetch_add(InValue, std::memory_order_acq_rel); }
+
+private:
+	FJobCounter(const FJobCounter&) = delete;
+	FJobCounter& operator=(const FJobCounter&) = delete;
+
+	friend class FJobSystem;
+	std::atomic<int32_t>	Count;
+};
+
+class FJobSystem
+{
+public:
+	// the job system shared by the engine.
+	static FJobSystem* SharedInstance();
+
+	FJobSystem();
+	~FJobSystem();
+
+	// InWorkersNum: worker threads, ~0 for one per core besides the calling thread.
+	void Start(uint32_t InWorkersNum = ~0u);
+	// run the remaining jobs and join the workers.
+	void Stop();
+
+	bool IsRunning() const { return bRunning; }
+	uint32_t GetWorkersNum() const { return (uint32_t)Workers.size(); }
+	// threads running the jobs of a ParallelFor, including the caller.
+	uint32_t GetConcurrency() const { return GetWorkersNum() + 1; }
+
+	// queue InJob, InCounter (optional) is decremented when the job is done.
+	// jobs are run inline when the system is not running.
+	void Run(const FJobFunc &InJob, FJobCounter *InCounter = nullptr);
+	// run jobs until InCounter reaches zero.
+	void Wait(FJobCounter &InCounter);
+
+	// InFunc(Index) for every Index in [0, InCount), InGrain indices per job. waits for all of them.
+	void ParallelFor(uint32_t InCount, uint32_t InGrain, const std::function<void(uint32_t)> &InFunc);
+	// InFunc(Begin, End) for the sub-ranges of [0, InCount), at most InGrain indices each.
+	void ParallelForRange(uint32_t InCount, uint32_t InGrain, const std::function<void(uint32_t, uint32_t)> &InFunc);
+
+protected:
+	struct FJob
+	{
+		FJobFunc		Func;
+		FJobCounter		*Counter;
+	};
+
+	// the owner pushes & pops at the back, the thieves take the oldest jobs at the front.
+	struct FWorkQueue
+	{
+		std::mutex			Mutex;
+		std::deque<FJob>	Jobs;
+	};
+
+	void WorkerMain(uint32_t InIndex);
+	uint32_t GetQueueIndex() const;
+	bool PopJob(uint32_t InQueueIndex, FJob &OutJob);
+	bool StealJob(uint32_t InQueueIndex, FJob &OutJob);
+	bool TryRunJob(uint32_t InQueueIndex);
+	void RunJob(FJob &InJob);
+
+	std::vector<std::thread>	Workers;
+	// one queue per worker, the last one is shared by the other threads.
+	std::vector<FWorkQueue*>	Queues;
+
+	std::atomic<int32_t>		QueuedJobs;
+	std::mutex					SleepMutex;
+	std::condition_variable		WakeUpEvent;
+	std::atomic<bool>			bQuit;
+	bool						bRunning;
+};
+
+#endif // __JETX_JOBSYSTEM_H__
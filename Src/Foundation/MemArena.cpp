@@ -0,0 +1,106 @@
+//\brief
+//		linear memory arena
+//
+
+#include <cstdlib>
+#include "MemArena.h"
+
+
+FMemArena::FMemArena(size_t InChunkBytes)
+	: ChunkBytes(InChunkBytes)
+	, CurrentChunk(0)
+	, CurrentOffset(0)
+	, UsedBytes(0)
+{
+	assert(ChunkBytes > 0);
+}
+
+FMemArena::~FMemArena()
+{
+	Release();
+}
+
+void* FMemArena::Alloc(size_t InBytes, size_t InAlignment)
+{
+	assert((InAlignment & (InAlignment - 1)) == 0);
+
+	// first fit in the current or the following chunks, they were kept by Reset()
+	while (CurrentChunk < Chunks.size())
+	{
+		const FChunk &Chunk = Chunks[CurrentChunk];
+		size_t Address = reinterpret_cast<size_t>(Chunk.Memory) + CurrentOffset;
+		size_t Padding = (InAlignment - (Address & (InAlignment - 1))) & (InAlignment - 1);
+
+		if (CurrentOffset + Padding + InBytes <= Chunk.Bytes)
+		{
+			void *Ptr = Chunk.Memory + CurrentOffset + Padding;
+			CurrentOffset += Padding + InBytes;
+			UsedBytes += Padding + InBytes;
+			return Ptr;
+		}
+
+		CurrentChunk++;
+		CurrentOffset = 0;
+	}
+
+	AllocChunk(InBytes + InAlignment);
+	return Alloc(InBytes, InAlignment);
+}
+
+void FMemArena::AllocChunk(size_t InMinBytes)
+{
+	FChunk Chunk;
+	Chunk.Bytes = std::max(ChunkBytes, InMinBytes);
+	Chunk.Memory = reinterpret_cast<uint8_t*>(malloc(Chunk.Bytes));
+	assert(Chunk.Memory != nullptr);
+
+	Chunks.push_back(Chunk);
+	CurrentChunk = Chunks.size() - 1;
+	CurrentOffset = 0;
+}
+
+void FMemArena::Reset()
+{
+	// the oversized chunks go back to the system, the others are reused.
+	size_t Kept = 0;
+	for (size_t k = 0; k < Chunks.size(); k++)
+	{
+		if (Chunks[k].Bytes > ChunkBytes)
+		{
+			free(Chunks[k].Memory);
+		}
+		else
+		{
+			Chunks[Kept++] = Chunks[k];
+		}
+	} // end for k
+
+	Chunks.resize(Kept);
+	CurrentChunk = 0;
+	CurrentOffset = 0;
+	UsedBytes = 0;
+}
+
+void FMemArena::Release()
+{
+	for (size_t k = 0; k < Chunks.size(); k++)
+	{
+		free(Chunks[k].Memory);
+	}
+
+	Chunks.clear();
+	CurrentChunk = 0;
+	CurrentOffset = 0;
+	UsedBytes = 0;
+}
+
+size_t FMemArena::GetReservedBytes() const
+{
+	size_t Bytes = 0;
+	for (size_t k = 0; k < Chunks.size(); k++)
+	{
+		Bytes += Chunks[k].Bytes;
+	}
+
+	return Bytes;
+}
@@ -0,0 +1,50 @@
+//\brief
+//		linear memory arena: fast allocations, freed all at once by Reset().
+// NOTE: not thread safe, every thread records into its own arena.
+//
+
+#ifndef __JETX_MEMARENA_H__
+#define __JETX_MEMARENA_H__
+
+#include <vector>
+#include "JetX.h"
+
+
+class FMemArena
+{
+public:
+	// InChunkBytes: size of the memory chunks, larger allocations get a chunk of their own.
+	FMemArena(size_t InChunkBytes = 64 * 1024);
+	~FMemArena();
+
+	// InAlignment must be a power of 2.
+	void* Alloc(size_t InBytes, size_t InAlignment = sizeof(void*));
+
+	// memory of the objects constructed in the arena, the destructors are not called here.
+	void Reset();
+	// Reset() and give the chunks back to the system.
+	void Release();
+
+	size_t GetUsedBytes() const { return UsedBytes; }
+	size_t GetReservedBytes() const;
+
+private:
+	FMemArena(const FMemArena&) = delete;
+	FMemArena& operator=(const FMemArena&) = delete;
+
+	struct FChunk
+	{
+		uint8_t		*Memory;
+		size_t		Bytes;
+	};
+
+	void AllocChunk(size_t InMinBytes);
+
+	size_t				ChunkBytes;
+	std::vector<FChunk>	Chunks;
+	size_t				CurrentChunk;
+	size_t				CurrentOffset;
+	size_t				UsedBytes;
+};
+
+#endif // __JETX_MEMARENA_H__
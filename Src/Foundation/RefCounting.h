@@ -5,9 +5,11 @@
 #ifndef __JETX_REFCOUNTING_H__
 #define __JETX_REFCOUNTING_H__
 
+#include <atomic>
 #include "JetX.h"
 
 
+// the counter is atomic, the references can be passed to other threads (e.g. in a command list).
 class FRefCountedObject
 {
 public:
@@ -44,7 +46,7 @@ public:
 	}
 
 protected:
-	int32_t	nRefCount;
+	std::atomic<int32_t>	nRefCount;
 };
 
 // smart pointer base on ref-counting
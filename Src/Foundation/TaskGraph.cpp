@@ -0,0 +1,272 @@
+//\brief
+//		task graph implementation.
+//
+
+#include <cassert>
+#include <algorithm>
+#include <chrono>
+#include "TaskGraph.h"
+
+
+static double GetTaskSeconds()
+{
+	typedef std::chrono::steady_clock FClock;
+	return std::chrono::duration<double>(FClock::now().time_since_epoch()).count();
+}
+
+FTaskGraph::FTaskGraph(FJobSystem *InJobSystem)
+	: JobSystem(InJobSystem)
+	, bDispatched(false)
+	, DispatchTime(0.0)
+	, DoneTime(0.0)
+{
+	assert(JobSystem != nullptr);
+
+	Stats.WallTime = Stats.WorkTime = Stats.CriticalPathTime = 0.0;
+}
+
+FTaskGraph::~FTaskGraph()
+{
+	if (bDispatched)
+	{
+		Wait();
+	}
+	Reset();
+}
+
+uint32_t FTaskGraph::AddPhase(const std::string &InName)
+{
+	PhaseNames.push_back(InName);
+	return (uint32_t)PhaseNames.size() - 1;
+}
+
+FTaskHandle FTaskGraph::AddTask(const std::string &InName, uint32_t InPhase, const FTaskFunc &InFunc, const FTaskHandle *InPrerequisites, uint32_t InPrerequisitesNum)
+{
+	assert(!bDispatched);
+	assert(InPhase < PhaseNames.size());
+
+	const FTaskHandle kHandle = (FTaskHandle)Tasks.size();
+
+	FTask *Task = new FTask();
+	Task->Name = InName;
+	Task->Phase = InPhase;
+	Task->Func = InFunc;
+	Task->PendingPrerequisites = 0;
+	Task->StartTime = Task->EndTime = 0.0;
+	Tasks.push_back(Task);
+
+	for (uint32_t k = 0; k < InPrerequisitesNum; k++)
+	{
+		AddPrerequisite(kHandle, InPrerequisites[k]);
+	}
+
+	return kHandle;
+}
+
+void FTaskGraph::AddPrerequisite(FTaskHandle InTask, FTaskHandle InPrerequisite)
+{
+	assert(!bDispatched);
+	if (InPrerequisite == TASK_HANDLE_NONE)
+	{
+		return;
+	}
+
+	assert(InPrerequisite < InTask && InTask < Tasks.size());
+	Tasks[InTask]->Prerequisites.push_back(InPrerequisite);
+	Tasks[InPrerequisite]->Dependents.push_back(InTask);
+}
+
+void FTaskGraph::Dispatch()
+{
+	assert(!bDispatched);
+	bDispatched = true;
+
+	DispatchTime = GetTaskSeconds();
+	GraphCounter.Add((int32_t)Tasks.size());
+	for (size_t k = 0; k < Tasks.size(); k++)
+	{
+		FTask *Task = Tasks[k];
+		Task->PendingPrerequisites = (int32_t)Task->Prerequisites.size();
+		Task->Completion.Add(1);
+	}
+
+	// the tasks may complete during the loop, the roots were found before.
+	std::vector<FTaskHandle> Roots;
+	for (size_t k = 0; k < Tasks.size(); k++)
+	{
+		if (Tasks[k]->Prerequisites.empty())
+		{
+			Roots.push_back((FTaskHandle)k);
+		}
+	}
+	for (size_t k = 0; k < Roots.size(); k++)
+	{
+		SubmitTask(Roots[k]);
+	}
+}
+
+void FTaskGraph::SubmitTask(FTaskHandle InTask)
+{
+	JobSystem->Run([this, InTask]() { RunTask(InTask); });
+}
+
+void FTaskGraph::RunTask(FTaskHandle InTask)
+{
+	FTask *Task = Tasks[InTask];
+
+	Task->StartTime = GetTaskSeconds();
+	if (Task->Func)
+	{
+		Task->Func();
+	}
+	Task->EndTime = GetTaskSeconds();
+
+	for (size_t k = 0; k < Task->Dependents.size(); k++)
+	{
+		FTask *Dependent = Tasks[Task->Dependents[k]];
+		if (Dependent->PendingPrerequisites.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			SubmitTask(Task->Dependents[k]);
+		}
+	} // end for k
+
+	Task->Completion.Add(-1);
+	GraphCounter.Add(-1);
+}
+
+void FTaskGraph::Wait()
+{
+	if (!bDispatched)
+	{
+		return;
+	}
+
+	JobSystem->Wait(GraphCounter);
+	DoneTime = GetTaskSeconds();
+	bDispatched = false;
+
+	ComputeStats();
+}
+
+void FTaskGraph::WaitForTask(FTaskHandle InTask)
+{
+	assert(bDispatched && InTask < Tasks.size());
+	JobSystem->Wait(Tasks[InTask]->Completion);
+}
+
+void FTaskGraph::WaitForPhase(uint32_t InPhase)
+{
+	for (size_t k = 0; k < Tasks.size(); k++)
+	{
+		if (Tasks[k]->Phase == InPhase)
+		{
+			WaitForTask((FTaskHandle)k);
+		}
+	}
+}
+
+bool FTaskGraph::IsTaskDone(FTaskHandle InTask) const
+{
+	return Tasks[InTask]->Completion.IsDone();
+}
+
+void FTaskGraph::Reset()
+{
+	assert(!bDispatched);
+
+	for (size_t k = 0; k < Tasks.size(); k++)
+	{
+		delete Tasks[k];
+	}
+	Tasks.clear();
+}
+
+void FTaskGraph::ComputeStats()
+{
+	const double kToMs = 1000.0;
+
+	Stats.WallTime = (DoneTime - DispatchTime) * kToMs;
+	Stats.WorkTime = 0.0;
+	Stats.CriticalPathTime = 0.0;
+	Stats.CriticalPath.clear();
+
+	Stats.Phases.resize(PhaseNames.size());
+	for (size_t k = 0; k < PhaseNames.size(); k++)
+	{
+		FTaskGraphStats::FPhaseStats &Phase = Stats.Phases[k];
+		Phase.Name = PhaseNames[k];
+		Phase.TasksNum = 0;
+		Phase.StartTime = Phase.EndTime = Phase.WorkTime = 0.0;
+	}
+
+	// the prerequisites are always before their dependents, one pass in order
+	// gives the longest chain finishing at every task.
+	std::vector<double> ChainTime(Tasks.size(), 0.0);
+	std::vector<FTaskHandle> ChainPrev(Tasks.size(), TASK_HANDLE_NONE);
+	FTaskHandle ChainEnd = TASK_HANDLE_NONE;
+
+	for (size_t k = 0; k < Tasks.size(); k++)
+	{
+		const FTask *Task = Tasks[k];
+		const double kDuration = (Task->EndTime - Task->StartTime) * kToMs;
+		const double kStart = (Task->StartTime - DispatchTime) * kToMs;
+		const double kEnd = (Task->EndTime - DispatchTime) * kToMs;
+
+		FTaskGraphStats::FPhaseStats &Phase = Stats.Phases[Task->Phase];
+		Phase.StartTime = Phase.TasksNum ? std::min(Phase.StartTime, kStart) : kStart;
+		Phase.EndTime = Phase.TasksNum ? std::max(Phase.EndTime, kEnd) : kEnd;
+		Phase.WorkTime += kDuration;
+		Phase.TasksNum++;
+		Stats.WorkTime += kDuration;
+
+		for (size_t p = 0; p < Task->Prerequisites.size(); p++)
+		{
+			const FTaskHandle kPrev = Task->Prerequisites[p];
+			if (ChainPrev[k] == TASK_HANDLE_NONE || ChainTime[kPrev] > ChainTime[ChainPrev[k]])
+			{
+				ChainPrev[k] = kPrev;
+			}
+		}
+		ChainTime[k] = kDuration + (ChainPrev[k] != TASK_HANDLE_NONE ? ChainTime[ChainPrev[k]] : 0.0);
+
+		if (ChainEnd == TASK_HANDLE_NONE || ChainTime[k] > ChainTime[ChainEnd])
+		{
+			ChainEnd = (FTaskHandle)k;
+		}
+	} // end for k
+
+	if (ChainEnd != TASK_HANDLE_NONE)
+	{
+		Stats.CriticalPathTime = ChainTime[ChainEnd];
+		for (FTaskHandle Handle = ChainEnd; Handle != TASK_HANDLE_NONE; Handle = ChainPrev[Handle])
+		{
+			Stats.CriticalPath.push_back(Handle);
+		}
+		std::reverse(Stats.CriticalPath.begin(), Stats.CriticalPath.end());
+	}
+}
+
+void FTaskGraph::DumpStats(FOutputDevice &OutDevice) const
+{
+	OutDevice.Log(Log_Info, "TaskGraph: %u tasks, wall %.3f ms, work %.3f ms, critical path %.3f ms, parallelism %.2f",
+		GetTasksNum(), Stats.WallTime, Stats.WorkTime, Stats.CriticalPathTime,
+		Stats.CriticalPathTime > 0.0 ? Stats.WorkTime / Stats.CriticalPathTime : 0.0);
+
+	for (size_t k = 0; k < Stats.Phases.size(); k++)
+	{
+		const FTaskGraphStats::FPhaseStats &Phase = Stats.Phases[k];
+		OutDevice.Log(Log_Info, "  phase %s: %u tasks, [%.3f, %.3f] ms, work %.3f ms",
+			Phase.Name.c_str(), Phase.TasksNum, Phase.StartTime, Phase.EndTime, Phase.WorkTime);
+	}
+
+	std::string Path;
+	for (size_t k = 0; k < Stats.CriticalPath.size(); k++)
+	{
+		if (k > 0)
+		{
+			Path += " -> ";
+		}
+		Path += Stats.CriticalPath[k] < Tasks.size() ? Tasks[Stats.CriticalPath[k]]->Name : std::string("?");
+	}
+	OutDevice.Log(Log_Info, "  critical path: %s", Path.c_str());
+}
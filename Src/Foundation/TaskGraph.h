@@ -0,0 +1,115 @@
+//\brief
+//		task graph: the work of a frame as a DAG of tasks run by the job system.
+//		a task starts when all its prerequisites are done; tasks are grouped in named
+//		phases for the statistics, the critical path is measured after every execution.
+//
+
+#ifndef __JETX_TASKGRAPH_H__
+#define __JETX_TASKGRAPH_H__
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include "JetX.h"
+#include "JobSystem.h"
+#include "OutputDevice.h"
+
+
+typedef uint32_t	FTaskHandle;
+#define TASK_HANDLE_NONE	(~0u)
+
+typedef std::function<void()>	FTaskFunc;
+
+// statistics of the last execution, in milliseconds.
+struct FTaskGraphStats
+{
+	struct FPhaseStats
+	{
+		std::string		Name;
+		uint32_t		TasksNum;
+		double			StartTime;	// since the start of the execution
+		double			EndTime;
+		double			WorkTime;	// sum of the task durations
+	};
+
+	double		WallTime;
+	double		WorkTime;
+	double		CriticalPathTime;
+	// the longest chain of dependent tasks, the first task first.
+	std::vector<FTaskHandle>	CriticalPath;
+	std::vector<FPhaseStats>	Phases;
+};
+
+class FTaskGraph
+{
+public:
+	FTaskGraph(FJobSystem *InJobSystem = FJobSystem::SharedInstance());
+	~FTaskGraph();
+
+	// phases are labels of the tasks, e.g. "Input", "Animation", "Culling", "DrawList", "Submit".
+	uint32_t AddPhase(const std::string &InName);
+
+	// a task without InFunc is an event: done as soon as its prerequisites are.
+	// the prerequisites are tasks added before, so the graph has no cycle.
+	FTaskHandle AddTask(const std::string &InName, uint32_t InPhase, const FTaskFunc &InFunc, const FTaskHandle *InPrerequisites = nullptr, uint32_t InPrerequisitesNum = 0);
+	FTaskHandle AddTask(const std::string &InName, uint32_t InPhase, const FTaskFunc &InFunc, const std::vector<FTaskHandle> &InPrerequisites)
+	{
+		return AddTask(InName, InPhase, InFunc, InPrerequisites.data(), (uint32_t)InPrerequisites.size());
+	}
+	// InTask waits for InPrerequisite too, before the graph is dispatched.
+	void AddPrerequisite(FTaskHandle InTask, FTaskHandle InPrerequisite);
+
+	// start the tasks without prerequisites, the others follow as they become ready.
+	void Dispatch();
+	// run tasks until the whole graph is done, then compute the statistics.
+	void Wait();
+	// run tasks until InTask is done (its completion event).
+	void WaitForTask(FTaskHandle InTask);
+	// run tasks until the tasks of InPhase are done.
+	void WaitForPhase(uint32_t InPhase);
+	bool IsTaskDone(FTaskHandle InTask) const;
+
+	// Dispatch() and Wait()
+	void Execute() { Dispatch(); Wait(); }
+
+	// remove the tasks, the phases are kept. the graph must not be running.
+	void Reset();
+
+	uint32_t GetTasksNum() const { return (uint32_t)Tasks.size(); }
+	const std::string& GetTaskName(FTaskHandle InTask) const { return Tasks[InTask]->Name; }
+
+	const FTaskGraphStats& GetStats() const { return Stats; }
+	void DumpStats(FOutputDevice &OutDevice) const;
+
+protected:
+	struct FTask
+	{
+		std::string					Name;
+		uint32_t					Phase;
+		FTaskFunc					Func;
+		std::vector<FTaskHandle>	Prerequisites;
+		std::vector<FTaskHandle>	Dependents;
+
+		std::atomic<int32_t>		PendingPrerequisites;
+		FJobCounter					Completion;
+		double						StartTime;
+		double						EndTime;
+	};
+
+	void SubmitTask(FTaskHandle InTask);
+	void RunTask(FTaskHandle InTask);
+	void ComputeStats();
+
+	FJobSystem					*JobSystem;
+	std::vector<std::string>	PhaseNames;
+	std::vector<FTask*>			Tasks;
+
+	FJobCounter					GraphCounter;
+	bool						bDispatched;
+	double						DispatchTime;
+	double						DoneTime;
+	FTaskGraphStats				Stats;
+};
+
+#endif // __JETX_TASKGRAPH_H__
@@ -0,0 +1,295 @@
+// \brief
+//		Draw queue implementation.
+//
+
+#include <cassert>
+#include <algorithm>
+#include "Foundation/Hash.h"
+#include "DrawQueue.h"
+
+
+// FDrawSortKey
+static inline uint64_t PackKeyField(uint32_t InValue, uint32_t InBits)
+{
+	return (uint64_t)(InValue & ((1u << InBits) - 1));
+}
+
+uint64_t FDrawSortKey::MakeOpaque(uint32_t InPass, uint32_t InProgram, uint32_t InMaterial, uint32_t InVertexBuffer, float InDepth)
+{
+	uint64_t Key = PackKeyField(InPass, PassBits);
+	Key = (Key << 1);
+	Key = (Key << ProgramBits) | PackKeyField(InProgram, ProgramBits);
+	Key = (Key << MaterialBits) | PackKeyField(InMaterial, MaterialBits);
+	Key = (Key << VertexBufferBits) | PackKeyField(InVertexBuffer, VertexBufferBits);
+	Key = (Key << DepthBits) | QuantizeDepth(InDepth);
+	return Key;
+}
+
+uint64_t FDrawSortKey::MakeTranslucent(uint32_t InPass, float InDepth, uint32_t InProgram, uint32_t InMaterial, uint32_t InVertexBuffer)
+{
+	uint64_t Key = PackKeyField(InPass, PassBits);
+	Key = (Key << 1) | 1;
+	Key = (Key << DepthBits) | (((1u << DepthBits) - 1) - QuantizeDepth(InDepth));
+	Key = (Key << ProgramBits) | PackKeyField(InProgram, ProgramBits);
+	Key = (Key << MaterialBits) | PackKeyField(InMaterial, MaterialBits);
+	Key = (Key << VertexBufferBits) | PackKeyField(InVertexBuffer, VertexBufferBits);
+	return Key;
+}
+
+uint32_t FDrawSortKey::GetResourceId(const void *InResource)
+{
+	// the fields are narrower than the ids, the null resources are 0
+	return InResource ? GetTypeHash(InResource) : 0;
+}
+
+uint32_t FDrawSortKey::QuantizeDepth(float InDepth)
+{
+	const float kDepth = (std::min)((std::max)(InDepth, 0.f), 1.f);
+	return (uint32_t)(kDepth * (float)((1u << DepthBits) - 1));
+}
+
+// FDrawBindings
+void FDrawBindings::SetTexture(uint32_t InTexIndex, const FRHITextureRef &InTexture, const FRHISamplerStateRef &InSamplerState)
+{
+	assert(InTexIndex < MaxTextureUnits);
+	Textures[InTexIndex] = InTexture;
+	Samplers[InTexIndex] = InSamplerState;
+	TexturesNum = (std::max)(TexturesNum, InTexIndex + 1);
+}
+
+void FDrawBindings::SetUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer)
+{
+	assert(InBindIndex < MaxUniformBufferBindings);
+	UniformBuffers[InBindIndex] = InBuffer;
+	UniformBuffersNum = (std::max)(UniformBuffersNum, InBindIndex + 1);
+}
+
+// FDrawQueue
+FDrawQueue::FDrawQueue()
+	: bSorted(true)
+	, PerDrawUniformBindIndex(0)
+{
+}
+
+void FDrawQueue::SetPerDrawUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer)
+{
+	assert(InBindIndex < MaxUniformBufferBindings);
+	assert(Packets.empty());
+
+	PerDrawUniformBindIndex = InBindIndex;
+	PerDrawUniformBuffer = InBuffer;
+}
+
+void FDrawQueue::AddDraw(uint64_t InSortKey, const FDrawPacket &InPacket, const void *InPerDrawUniforms)
+{
+	// the changes of the draws in the order they were added
+	if (Packets.empty() || Packets.back().PipelineState.DeRef() != InPacket.PipelineState.DeRef())
+	{
+		PendingStats.UnsortedPipelineChanges++;
+	}
+	if (Packets.empty() || Packets.back().Bindings.DeRef() != InPacket.Bindings.DeRef())
+	{
+		PendingStats.UnsortedBindingsChanges++;
+	}
+
+	FSortEntry Entry;
+	Entry.Key = InSortKey;
+	Entry.Packet = (uint32_t)Packets.size();
+	bSorted = bSorted && (Entries.empty() || Entries.back().Key <= InSortKey);
+	Entries.push_back(Entry);
+	Packets.push_back(InPacket);
+
+	uint32_t UniformOffset = ~0u;
+	if (InPerDrawUniforms && PerDrawUniformBuffer.IsValidRef())
+	{
+		const uint32_t kBytes = PerDrawUniformBuffer->GetBytes();
+		UniformOffset = (uint32_t)PerDrawUniformData.size();
+		PerDrawUniformData.resize(UniformOffset + kBytes);
+		::memcpy(&PerDrawUniformData[UniformOffset], InPerDrawUniforms, kBytes);
+	}
+	PerDrawUniformOffsets.push_back(UniformOffset);
+}
+
+void FDrawQueue::Sort()
+{
+	if (!bSorted)
+	{
+		RadixSort();
+		bSorted = true;
+	}
+}
+
+// LSD radix sort by bytes, stable. the passes whose byte is the same for all the keys are skipped,
+// so the high bits shared by the draws of a pass cost nothing.
+void FDrawQueue::RadixSort()
+{
+	const size_t kEntriesNum = Entries.size();
+	if (kEntriesNum < 2)
+	{
+		return;
+	}
+
+	uint32_t Histograms[8][256];
+	::memset(Histograms, 0, sizeof(Histograms));
+	for (size_t Index = 0; Index < kEntriesNum; Index++)
+	{
+		const uint64_t kKey = Entries[Index].Key;
+		for (uint32_t Digit = 0; Digit < 8; Digit++)
+		{
+			Histograms[Digit][(kKey >> (Digit * 8)) & 0xFF]++;
+		}
+	} // end for Index
+
+	SortScratch.resize(kEntriesNum);
+	FSortEntry *Source = &Entries[0];
+	FSortEntry *Dest = &SortScratch[0];
+	for (uint32_t Digit = 0; Digit < 8; Digit++)
+	{
+		uint32_t *Histogram = Histograms[Digit];
+		const uint32_t kShift = Digit * 8;
+		if (Histogram[(Source[0].Key >> kShift) & 0xFF] == kEntriesNum)
+		{
+			continue;
+		}
+
+		uint32_t Offset = 0;
+		for (uint32_t Bucket = 0; Bucket < 256; Bucket++)
+		{
+			const uint32_t kCount = Histogram[Bucket];
+			Histogram[Bucket] = Offset;
+			Offset += kCount;
+		}
+		for (size_t Index = 0; Index < kEntriesNum; Index++)
+		{
+			Dest[Histogram[(Source[Index].Key >> kShift) & 0xFF]++] = Source[Index];
+		}
+		std::swap(Source, Dest);
+	} // end for Digit
+
+	if (Source != &Entries[0])
+	{
+		Entries.swap(SortScratch);
+	}
+}
+
+void FDrawQueue::Submit(FRenderer *InRenderer)
+{
+	assert(InRenderer);
+	Sort();
+
+	// the states set by the previous draw of the queue, the first draw sets all of its states.
+	const FRHIGraphicsPipelineState *PipelineState = nullptr;
+	int32_t StencilRef = 0;
+	FLinearColor BlendColor(0.f, 0.f, 0.f, 0.f);
+	const FDrawBindings *Bindings = nullptr;
+	const FRHITexture *Textures[MaxTextureUnits] = {};
+	const FRHISamplerState *Samplers[MaxTextureUnits] = {};
+	const FRHIUniformBuffer *UniformBuffers[MaxUniformBufferBindings] = {};
+	const FRHIVertexBuffer *VertexStreams[MaxDrawPacketStreams] = {};
+	bool bFirst = true;
+	bool bPerDrawUniformBound = false;
+
+	FDrawQueueStats &Stats = PendingStats;
+	for (size_t Index = 0; Index < Entries.size(); Index++)
+	{
+		const uint32_t kPacketIndex = Entries[Index].Packet;
+		FDrawPacket &Packet = Packets[kPacketIndex];
+
+		if (bFirst || Packet.PipelineState.DeRef() != PipelineState || Packet.StencilRef != StencilRef || Packet.BlendColor != BlendColor)
+		{
+			InRenderer->RHISetGraphicsPipelineState(Packet.PipelineState, Packet.StencilRef, Packet.BlendColor);
+			PipelineState = Packet.PipelineState.DeRef();
+			StencilRef = Packet.StencilRef;
+			BlendColor = Packet.BlendColor;
+			Stats.PipelineChanges++;
+		}
+
+		FDrawBindings *PacketBindings = Packet.Bindings.DeRef();
+		if (PacketBindings && (bFirst || PacketBindings != Bindings))
+		{
+			for (uint32_t Unit = 0; Unit < PacketBindings->TexturesNum; Unit++)
+			{
+				if (bFirst || PacketBindings->Textures[Unit].DeRef() != Textures[Unit])
+				{
+					InRenderer->RHISetTexture(Unit, PacketBindings->Textures[Unit]);
+					Textures[Unit] = PacketBindings->Textures[Unit].DeRef();
+					Stats.TextureBinds++;
+				}
+				if (PacketBindings->Samplers[Unit].IsValidRef() && (bFirst || PacketBindings->Samplers[Unit].DeRef() != Samplers[Unit]))
+				{
+					InRenderer->RHISetSamplerState(Unit, PacketBindings->Samplers[Unit]);
+					Samplers[Unit] = PacketBindings->Samplers[Unit].DeRef();
+				}
+			} // end for Unit
+			for (uint32_t Binding = 0; Binding < PacketBindings->UniformBuffersNum; Binding++)
+			{
+				if (bFirst || PacketBindings->UniformBuffers[Binding].DeRef() != UniformBuffers[Binding])
+				{
+					InRenderer->RHISetUniformBuffer(Binding, PacketBindings->UniformBuffers[Binding]);
+					UniformBuffers[Binding] = PacketBindings->UniformBuffers[Binding].DeRef();
+					Stats.UniformBufferBinds++;
+				}
+			} // end for Binding
+			Bindings = PacketBindings;
+			Stats.BindingsChanges++;
+		}
+
+		for (uint32_t Stream = 0; Stream < MaxDrawPacketStreams; Stream++)
+		{
+			if (Packet.VertexStreams[Stream].DeRef() != VertexStreams[Stream])
+			{
+				InRenderer->SetVertexStreamSource(Stream, Packet.VertexStreams[Stream]);
+				VertexStreams[Stream] = Packet.VertexStreams[Stream].DeRef();
+				Stats.VertexStreamBinds++;
+			}
+		} // end for Stream
+
+		const uint32_t kUniformOffset = PerDrawUniformOffsets[kPacketIndex];
+		if (kUniformOffset != ~0u)
+		{
+			// a volatile buffer moves at every update, the renderer rebinds the range at the draw.
+			InRenderer->RHIUpdateUniformBuffer(PerDrawUniformBuffer, &PerDrawUniformData[kUniformOffset]);
+			if (!bPerDrawUniformBound || UniformBuffers[PerDrawUniformBindIndex] != PerDrawUniformBuffer.DeRef())
+			{
+				InRenderer->RHISetUniformBuffer(PerDrawUniformBindIndex, PerDrawUniformBuffer);
+				UniformBuffers[PerDrawUniformBindIndex] = PerDrawUniformBuffer.DeRef();
+				bPerDrawUniformBound = true;
+				Stats.UniformBufferBinds++;
+			}
+			Stats.PerDrawUniformUpdates++;
+		}
+
+		if (Packet.IndexBuffer.IsValidRef())
+		{
+			InRenderer->DrawIndexedPrimitiveInstanced(Packet.IndexBuffer, Packet.Mode, Packet.Start, Packet.Count, Packet.Instances);
+		}
+		else
+		{
+			InRenderer->DrawArrayedPrimitiveInstanced(Packet.Mode, Packet.Start, Packet.Count, Packet.Instances);
+		}
+		Stats.Draws++;
+		bFirst = false;
+	} // end for Index
+
+	LastSubmitStats = Stats;
+	Reset();
+}
+
+void FDrawQueue::Reset()
+{
+	Packets.clear();
+	Entries.clear();
+	PerDrawUniformData.clear();
+	PerDrawUniformOffsets.clear();
+	PendingStats = FDrawQueueStats();
+	bSorted = true;
+}
+
+void FDrawQueue::DumpStats(FOutputDevice &OutDevice) const
+{
+	const FDrawQueueStats &Stats = LastSubmitStats;
+	OutDevice.Log(Log_Info, "Draw Queue: %u draws, pipeline changes %u (%u unsorted), bindings changes %u (%u unsorted)",
+		Stats.Draws, Stats.PipelineChanges, Stats.UnsortedPipelineChanges, Stats.BindingsChanges, Stats.UnsortedBindingsChanges);
+	OutDevice.Log(Log_Info, "    Texture binds: %u, Uniform buffer binds: %u, Vertex stream binds: %u, Per draw uniform updates: %u",
+		Stats.TextureBinds, Stats.UniformBufferBinds, Stats.VertexStreamBinds, Stats.PerDrawUniformUpdates);
+}
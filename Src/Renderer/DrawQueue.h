@@ -0,0 +1,161 @@
+// \brief
+//		Draw queue: the draws are pushed as packets with a 64 bits sort key, radix sorted by the key
+//		and replayed through FRenderer, so the draws sharing the states are submitted together.
+//
+
+#ifndef __JETX_DRAW_QUEUE_H__
+#define __JETX_DRAW_QUEUE_H__
+
+#include <vector>
+#include <cstring>
+#include "Foundation/JetX.h"
+#include "Foundation/RefCounting.h"
+#include "Foundation/OutputDevice.h"
+#include "Renderer.h"
+
+
+/** The vertex streams of a draw packet */
+enum { MaxDrawPacketStreams = 4 };
+
+// the sort key, from the most significant bits:
+//	opaque:       pass (4) | 0 | program (12) | material (12) | vertex buffer (11) | depth (24)
+//	translucent:  pass (4) | 1 | inverted depth (24) | program (12) | material (12) | vertex buffer (11)
+// the opaque draws of a pass are grouped by states then drawn front to back, the translucent ones
+// follow them back to front.
+struct FDrawSortKey
+{
+	enum
+	{
+		PassBits = 4,
+		ProgramBits = 12,
+		MaterialBits = 12,
+		VertexBufferBits = 11,
+		DepthBits = 24
+	};
+
+	static uint64_t MakeOpaque(uint32_t InPass, uint32_t InProgram, uint32_t InMaterial, uint32_t InVertexBuffer, float InDepth);
+	static uint64_t MakeTranslucent(uint32_t InPass, float InDepth, uint32_t InProgram, uint32_t InMaterial, uint32_t InVertexBuffer);
+
+	// an id of the resource for the fields above, the resources sharing an id are just less coherent.
+	static uint32_t GetResourceId(const void *InResource);
+	// InDepth is the view depth normalized in [0, 1]
+	static uint32_t QuantizeDepth(float InDepth);
+
+	static uint32_t GetPass(uint64_t InKey) { return (uint32_t)(InKey >> (64 - PassBits)); }
+	static bool IsTranslucent(uint64_t InKey) { return ((InKey >> (63 - PassBits)) & 1) != 0; }
+};
+
+// the textures, the samplers & the uniform buffers of a material, shared by its draws.
+class FDrawBindings : public FRefCountedObject
+{
+public:
+	FDrawBindings()
+		: TexturesNum(0)
+		, UniformBuffersNum(0)
+	{}
+
+	void SetTexture(uint32_t InTexIndex, const FRHITextureRef &InTexture, const FRHISamplerStateRef &InSamplerState);
+	void SetUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer);
+
+	// the units [0, TexturesNum) & the bindings [0, UniformBuffersNum) are set by the draws.
+	FRHITextureRef			Textures[MaxTextureUnits];
+	FRHISamplerStateRef		Samplers[MaxTextureUnits];
+	uint32_t				TexturesNum;
+	FRHIUniformBufferRef	UniformBuffers[MaxUniformBufferBindings];
+	uint32_t				UniformBuffersNum;
+};
+
+typedef TRefCountPtr<FDrawBindings> FDrawBindingsRef;
+
+// a draw of the queue
+struct FDrawPacket
+{
+	FDrawPacket()
+		: StencilRef(0)
+		, BlendColor(0.f, 0.f, 0.f, 0.f)
+		, Mode(PT_Triangles)
+		, Start(0)
+		, Count(0)
+		, Instances(1)
+	{}
+
+	FRHIGraphicsPipelineStateRef	PipelineState;
+	int32_t							StencilRef;
+	FLinearColor					BlendColor;
+	FDrawBindingsRef				Bindings;
+	FRHIVertexBufferRef				VertexStreams[MaxDrawPacketStreams];
+	// a null index buffer draws the vertices [Start, Start + Count)
+	FRHIIndexBufferRef				IndexBuffer;
+	EPrimitiveType					Mode;
+	uint32_t						Start;
+	uint32_t						Count;
+	uint32_t						Instances;
+};
+
+// the renderer calls of a submit, the unsorted ones are counted in the order of AddDraw.
+struct FDrawQueueStats
+{
+	FDrawQueueStats()
+	{
+		::memset(this, 0, sizeof(*this));
+	}
+
+	uint32_t	Draws;
+	uint32_t	PipelineChanges;
+	uint32_t	UnsortedPipelineChanges;
+	uint32_t	BindingsChanges;
+	uint32_t	UnsortedBindingsChanges;
+	uint32_t	TextureBinds;
+	uint32_t	UniformBufferBinds;
+	uint32_t	VertexStreamBinds;
+	uint32_t	PerDrawUniformUpdates;
+};
+
+// FDrawQueue
+// filled by one thread, submitted by the thread owning the renderer. the draws with the same key
+// keep the order they were added in.
+class FDrawQueue
+{
+public:
+	FDrawQueue();
+
+	// the contents of InBuffer are given per draw to AddDraw, then written before each draw.
+	void SetPerDrawUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer);
+	// InPerDrawUniforms: the contents of the per draw uniform buffer, copied.
+	void AddDraw(uint64_t InSortKey, const FDrawPacket &InPacket, const void *InPerDrawUniforms = nullptr);
+
+	void Sort();
+	// sort the draws if needed, replay them into InRenderer, then reset the queue.
+	void Submit(FRenderer *InRenderer);
+	// drop the draws without submitting them.
+	void Reset();
+
+	uint32_t GetDrawsNum() const { return (uint32_t)Packets.size(); }
+	const FDrawQueueStats& GetLastSubmitStats() const { return LastSubmitStats; }
+	void DumpStats(FOutputDevice &OutDevice) const;
+
+protected:
+	struct FSortEntry
+	{
+		uint64_t	Key;
+		uint32_t	Packet;
+	};
+
+	void RadixSort();
+
+	std::vector<FDrawPacket>	Packets;
+	std::vector<FSortEntry>		Entries;
+	std::vector<FSortEntry>		SortScratch;
+	bool						bSorted;
+
+	// per draw uniforms, ~0 for the draws without them
+	FRHIUniformBufferRef		PerDrawUniformBuffer;
+	uint32_t					PerDrawUniformBindIndex;
+	std::vector<uint8_t>		PerDrawUniformData;
+	std::vector<uint32_t>		PerDrawUniformOffsets;
+
+	FDrawQueueStats				PendingStats;
+	FDrawQueueStats				LastSubmitStats;
+};
+
+#endif // __JETX_DRAW_QUEUE_H__
@@ -0,0 +1,1409 @@
+// \brief
+//		Null Renderer implementation.
+//
+
+#include <cassert>
+#include <stdio.h>
+#include <stdarg.h>
+
+#include "NullRenderer.h"
+
+
+static uint32_t GetVertexElementBytes(EVertexElementType InType)
+{
+	switch (InType)
+	{
+	case VET_Float1:		return 4;
+	case VET_Float2:		return 8;
+	case VET_Float3:		return 12;
+	case VET_Float4:		return 16;
+	case VET_PackedNormal:	return 4;
+	case VET_UByte4:		return 4;
+	case VET_UByte4N:		return 4;
+	case VET_Color:			return 4;
+	case VET_Short2:		return 4;
+	case VET_Short4:		return 8;
+	case VET_Short2N:		return 4;
+	case VET_Half2:			return 4;
+	case VET_Half4:			return 8;
+	case VET_Short4N:		return 8;
+	case VET_UShort2:		return 4;
+	case VET_UShort4:		return 8;
+	case VET_UShort2N:		return 4;
+	case VET_UShort4N:		return 8;
+	case VET_URGB10A2N:		return 4;
+	case VET_Int1:			return 4;
+	case VET_Int2:			return 8;
+	case VET_Int3:			return 12;
+	case VET_Int4:			return 16;
+	default:
+		return 0;
+	}
+}
+
+void FNullRendererStats::Accumulate(const FNullRendererStats &InOther)
+{
+	const uint64_t *Src = reinterpret_cast<const uint64_t*>(&InOther);
+	uint64_t *Dst = reinterpret_cast<uint64_t*>(this);
+	const size_t kCount = sizeof(FNullRendererStats) / sizeof(uint64_t);
+
+	for (size_t k = 0; k < kCount; k++)
+	{
+		Dst[k] += Src[k];
+	}
+}
+
+FNullRenderer::FNullRenderer()
+	: Logger(nullptr)
+	, ViewportDrawing(nullptr)
+	, bInFrame(false)
+	, FrameCounter(0)
+	, TransientVertexHead(0)
+{
+	TransientIndexHeads[0] = TransientIndexHeads[1] = 0;
+}
+
+//Init
+void FNullRenderer::Init(FOutputDevice *LogOutputDevice)
+{
+	Logger = LogOutputDevice;
+	ViewportDrawing = nullptr;
+	bInFrame = false;
+	FrameCounter = 0;
+
+	if (Logger)
+	{
+		Logger->Log(Log_Info, "Running on the Null renderer, nothing will be displayed.");
+	}
+
+	RenderContext.ScissorRect.x = RenderContext.ScissorRect.y = 0;
+	RenderContext.ScissorRect.width = RenderContext.ScissorRect.height = 0;
+	RenderContext.ViewportBox.x = RenderContext.ViewportBox.y = 0;
+	RenderContext.ViewportBox.width = RenderContext.ViewportBox.height = 0;
+	RenderContext.ViewportBox.zMin = 0.f;
+	RenderContext.ViewportBox.zMax = 1.f;
+	RenderContext.StencilRef = 0;
+	RenderContext.BlendColor = FLinearColor(0.f, 0.f, 0.f, 0.f);
+
+	// same defaults as the OpenGL renderer
+	RHISetRasterizerState(RHICreateRasterizerState(FRasterizerStateInitializerRHI(FM_Solid)));
+	RHISetDepthStencilState(RHICreateDepthStencilState(FDepthStencilStateInitializerRHI(true)), 0);
+
+	FBlendStateInitializerRHI::FRenderTargetBlendState TargetBlend;
+	RHISetBlendState(RHICreateBlendState(FBlendStateInitializerRHI(TargetBlend)), FLinearColor(0.f, 0.f, 0.f, 0.f));
+
+	FRHISamplerStateRef SamplerState = RHICreateSamplerState(FSamplerStateInitializerRHI(SF_Bilinear));
+	for (uint32_t k = 0; k < MaxTextureUnits; k++)
+	{
+		RHISetSamplerState(k, SamplerState);
+	} // end for k
+
+	PendingStatesSet.VertexDeclDirty = true;
+	PendingStatesSet.VertexStreamsDirty = true;
+	PendingStatesSet.TexturesDirty = false;
+	UpdatePendingStates();
+
+	// the default states do not count
+	ResetStats();
+}
+
+void FNullRenderer::Shutdown()
+{
+	RenderContext = FRenderContext();
+	PendingStatesSet = FPendingStatesSet();
+	ViewportDrawing = nullptr;
+
+	TransientVertexBuffer.SafeRelease();
+	TransientIndexBuffers[0].SafeRelease();
+	TransientIndexBuffers[1].SafeRelease();
+	ActiveOcclusionQuery.SafeRelease();
+	ConditionalRenderQuery.SafeRelease();
+}
+
+//Capabilities
+void FNullRenderer::DumpCapabilities()
+{
+	if (Logger)
+	{
+		Logger->Log(Log_Info, "Null Renderer Capabilities:");
+		Logger->Log(Log_Info, "MaxSimultaneousRenderTargets: %d", MaxSimultaneousRenderTargets);
+		Logger->Log(Log_Info, "MaxTextureUnits: %d", MaxTextureUnits);
+		Logger->Log(Log_Info, "MaxVertexStreamSources: %d", MaxVertexStreamSources);
+		Logger->Log(Log_Info, "MaxVertexAttributes: %d", MaxVertexAttributes);
+		Logger->Log(Log_Info, "MaxUniformBufferBindings: %d", MaxUniformBufferBindings);
+	}
+}
+
+//render viewport
+FRHIViewportRef FNullRenderer::RHICreateViewport(void* InWindowHandle, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen)
+{
+	FrameStats.ResourcesCreated++;
+	return new FRHINullViewport(InWindowHandle, SizeX, SizeY, bIsFullscreen);
+}
+
+void FNullRenderer::RHIResizeViewport(FRHIViewportRef InViewport, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen)
+{
+	FRHINullViewport *Viewport = dynamic_cast<FRHINullViewport*>(InViewport.DeRef());
+	if (Viewport)
+	{
+		Viewport->Resize(SizeX, SizeY, bIsFullscreen);
+	}
+}
+
+bool FNullRenderer::RHIGetAvailableResolutions(FScreenResolutionArray& Resolutions, bool bIgnoreRefreshRate)
+{
+	FScreenResolution Resolution;
+	Resolution.Width = 1920;
+	Resolution.Height = 1080;
+	Resolution.RefreshRate = bIgnoreRefreshRate ? 0 : 60;
+
+	Resolutions.clear();
+	Resolutions.push_back(Resolution);
+	return true;
+}
+
+void FNullRenderer::RHIGetSupportedResolution(uint32_t& Width, uint32_t& Height)
+{
+	// any resolution is fine
+}
+
+//Resource Creating
+FRHISamplerStateRef FNullRenderer::RHICreateSamplerState(const FSamplerStateInitializerRHI &SamplerStateInitializer)
+{
+	FrameStats.ResourcesCreated++;
+	return new FRHINullSamplerState(SamplerStateInitializer);
+}
+
+FRHIRasterizerStateRef FNullRenderer::RHICreateRasterizerState(const FRasterizerStateInitializerRHI &RasterizerStateInitializer)
+{
+	FrameStats.ResourcesCreated++;
+	return new FRHINullRasterizerState(RasterizerStateInitializer);
+}
+
+FRHIDepthStencilStateRef FNullRenderer::RHICreateDepthStencilState(const FDepthStencilStateInitializerRHI &DepthStencilStateInitializer)
+{
+	FrameStats.ResourcesCreated++;
+	return new FRHINullDepthStencilState(DepthStencilStateInitializer);
+}
+
+FRHIBlendStateRef FNullRenderer::RHICreateBlendState(const FBlendStateInitializerRHI &BlendStateInitializer)
+{
+	if (BlendStateInitializer.TargetsNum > MaxSimultaneousRenderTargets)
+	{
+		ValidationError("blend state with %u targets, max is %d", BlendStateInitializer.TargetsNum, MaxSimultaneousRenderTargets);
+	}
+
+	FrameStats.ResourcesCreated++;
+	return new FRHINullBlendState(BlendStateInitializer);
+}
+
+// data buffers
+FRHIVertexBufferRef FNullRenderer::RHICreateVertexBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess, EBufferUsage InUsage)
+{
+	FRHINullVertexBuffer *VBuffer = new FRHINullVertexBuffer(this);
+	if (VBuffer->Initialize(InBytes, InData, InAccess, InUsage))
+	{
+		FrameStats.ResourcesCreated++;
+		FrameStats.BufferBytesUploaded += InData ? InBytes : 0;
+		return VBuffer;
+	}
+
+	delete VBuffer;
+	return FRHIVertexBufferRef();
+}
+
+FRHIIndexBufferRef FNullRenderer::RHICreateIndexBuffer(uint32_t InBytes, const void *InData, uint16_t InStride, EBufferAccess InAccess, EBufferUsage InUsage)
+{
+	FRHINullIndexBuffer *IBuffer = new FRHINullIndexBuffer(this);
+	if (IBuffer->Initialize(InBytes, InData, InStride, InAccess, InUsage))
+	{
+		FrameStats.ResourcesCreated++;
+		FrameStats.BufferBytesUploaded += InData ? InBytes : 0;
+		return IBuffer;
+	}
+
+	delete IBuffer;
+	return FRHIIndexBufferRef();
+}
+
+FRHIIndirectBufferRef FNullRenderer::RHICreateIndirectBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess)
+{
+	FRHINullIndirectBuffer *ArgsBuffer = new FRHINullIndirectBuffer(this);
+	if (ArgsBuffer->Initialize(InBytes, InData, InAccess, BU_Draw))
+	{
+		FrameStats.ResourcesCreated++;
+		FrameStats.BufferBytesUploaded += InData ? InBytes : 0;
+		return ArgsBuffer;
+	}
+
+	delete ArgsBuffer;
+	return FRHIIndirectBufferRef();
+}
+
+void FNullRenderer::FillDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, const void *InData)
+{
+	FNullBuffer *NullBuffer = dynamic_cast<FNullBuffer*>(InBuffer.DeRef());
+	if (!NullBuffer)
+	{
+		ValidationError("fill an invalid buffer");
+		return;
+	}
+
+	if (NullBuffer->FillData(InOffset, InBytes, InData))
+	{
+		FrameStats.BufferBytesUploaded += InBytes;
+	}
+}
+
+void* FNullRenderer::LockDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, EBufferLockMode InMode)
+{
+	FNullBuffer *NullBuffer = dynamic_cast<FNullBuffer*>(InBuffer.DeRef());
+	if (!NullBuffer)
+	{
+		ValidationError("lock an invalid buffer");
+		return nullptr;
+	}
+
+	FrameStats.BufferLocks++;
+	return NullBuffer->Lock(InOffset, InBytes, InMode);
+}
+
+void FNullRenderer::UnLockDataBuffer(FRHIDataBufferRef InBuffer)
+{
+	FNullBuffer *NullBuffer = dynamic_cast<FNullBuffer*>(InBuffer.DeRef());
+	if (!NullBuffer)
+	{
+		ValidationError("unlock an invalid buffer");
+		return;
+	}
+
+	if (NullBuffer->UnLock())
+	{
+		FrameStats.BufferBytesUploaded += (NullBuffer->LockMode & BL_FlushExplicit) ? NullBuffer->FlushedBytes : NullBuffer->LockBytes;
+	}
+}
+
+void FNullRenderer::FlushDataBufferRange(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes)
+{
+	FNullBuffer *NullBuffer = dynamic_cast<FNullBuffer*>(InBuffer.DeRef());
+	if (!NullBuffer)
+	{
+		ValidationError("flush an invalid buffer");
+		return;
+	}
+
+	NullBuffer->FlushRange(InOffset, InBytes);
+}
+
+// uniform buffers
+FRHIUniformBufferRef FNullRenderer::RHICreateUniformBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess)
+{
+	FRHINullUniformBuffer *UBuffer = new FRHINullUniformBuffer(this);
+	if (UBuffer->Initialize(InBytes, InData, InAccess))
+	{
+		FrameStats.ResourcesCreated++;
+		FrameStats.BufferBytesUploaded += InData ? InBytes : 0;
+		return UBuffer;
+	}
+
+	delete UBuffer;
+	return FRHIUniformBufferRef();
+}
+
+void FNullRenderer::RHIUpdateUniformBuffer(const FRHIUniformBufferRef &InBuffer, const void *InData)
+{
+	FRHINullUniformBuffer *NullBuffer = dynamic_cast<FRHINullUniformBuffer*>(InBuffer.DeRef());
+	if (!NullBuffer || !InData)
+	{
+		ValidationError("update an invalid uniform buffer");
+		return;
+	}
+	NullBuffer->Update(InData, FrameCounter);
+	FrameStats.UniformBufferUpdates++;
+	FrameStats.BufferBytesUploaded += NullBuffer->GetBytes();
+}
+
+// transient geometry
+void* FNullRenderer::RHIAllocTransientVertices(uint32_t InBytes, uint32_t InStride, FRHIVertexBufferRef &OutBuffer, uint32_t &OutFirstVertex)
+{
+	if (InStride == 0 || InBytes == 0 || InBytes > NullTransientVertexBytes)
+	{
+		ValidationError("transient vertices: %u bytes, stride %u", InBytes, InStride);
+		return nullptr;
+	}
+	if (!TransientVertexBuffer.IsValidRef())
+	{
+		TransientVertexBuffer = new FRHINullVertexBuffer(this);
+		TransientVertexBuffer->Initialize(NullTransientVertexBytes, nullptr, BA_Stream, BU_Draw);
+	}
+
+	uint32_t Offset = (TransientVertexHead + InStride - 1) / InStride * InStride;
+	if (Offset + InBytes > NullTransientVertexBytes)
+	{
+		ValidationError("the transient vertices of the frame exceed %u bytes, the first ones are overwritten", (uint32_t)NullTransientVertexBytes);
+		Offset = 0;
+	}
+	TransientVertexHead = Offset + InBytes;
+	FrameStats.TransientBytes += InBytes;
+
+	OutBuffer = TransientVertexBuffer.DeRef();
+	OutFirstVertex = Offset / InStride;
+	return &TransientVertexBuffer->Memory[Offset];
+}
+
+void* FNullRenderer::RHIAllocTransientIndices(uint32_t InCount, uint16_t InStride, FRHIIndexBufferRef &OutBuffer, uint32_t &OutFirstIndex)
+{
+	const uint32_t kBytes = InCount * InStride;
+	if ((InStride != sizeof(uint16_t) && InStride != sizeof(uint32_t)) || kBytes == 0 || kBytes > NullTransientIndexBytes)
+	{
+		ValidationError("transient indices: %u indices, stride %u", InCount, (uint32_t)InStride);
+		return nullptr;
+	}
+
+	const uint32_t kStream = InStride == sizeof(uint16_t) ? 0 : 1;
+	FRHINullIndexBufferRef &IndexBuffer = TransientIndexBuffers[kStream];
+	if (!IndexBuffer.IsValidRef())
+	{
+		IndexBuffer = new FRHINullIndexBuffer(this);
+		IndexBuffer->Initialize(NullTransientIndexBytes, nullptr, InStride, BA_Stream, BU_Draw);
+	}
+
+	uint32_t Offset = (TransientIndexHeads[kStream] + InStride - 1) / InStride * InStride;
+	if (Offset + kBytes > NullTransientIndexBytes)
+	{
+		ValidationError("the transient indices of the frame exceed %u bytes, the first ones are overwritten", (uint32_t)NullTransientIndexBytes);
+		Offset = 0;
+	}
+	TransientIndexHeads[kStream] = Offset + kBytes;
+	FrameStats.TransientBytes += kBytes;
+
+	OutBuffer = IndexBuffer.DeRef();
+	OutFirstIndex = Offset / InStride;
+	return &IndexBuffer->Memory[Offset];
+}
+
+// vertex input layout
+FRHIVertexDeclarationRef FNullRenderer::RHICreateVertexInputLayout(const FVertexElement *InVertexElements, uint32_t InCount)
+{
+	for (uint32_t Index = 0; Index < InCount; Index++)
+	{
+		const FVertexElement &Element = InVertexElements[Index];
+		if (Element.StreamIndex >= MaxVertexStreamSources || Element.AttributeIndex >= MaxVertexAttributes)
+		{
+			ValidationError("vertex element %u out of range: stream=%u, attribute=%u", Index, Element.StreamIndex, Element.AttributeIndex);
+		}
+		if (GetVertexElementBytes(Element.DataType) == 0)
+		{
+			ValidationError("vertex element %u has invalid type %d", Index, (int32_t)Element.DataType);
+		}
+	} // end for
+
+	FrameStats.ResourcesCreated++;
+	return new FRHINullVertexDeclaration(InVertexElements, InCount);
+}
+
+// textures
+bool FNullRenderer::ValidateTextureDesc(const char *InKind, uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat)
+{
+	if (InSizeX == 0 || InSizeY == 0 || InLayers == 0 || InMips > GetFullMipsNum(InSizeX, InSizeY) || GetPixelFormatBytes(InFormat) == 0)
+	{
+		ValidationError("create a %s of %ux%ux%u, %u mips, format %d", InKind, InSizeX, InSizeY, InLayers, InMips, (int32_t)InFormat);
+		return false;
+	}
+	return true;
+}
+
+FRHITexture2DRef FNullRenderer::RHICreateTexture2D(uint32_t InSizeX, uint32_t InSizeY, uint32_t InMips, EPixelFormat InFormat)
+{
+	const uint32_t kMips = InMips > 0 ? InMips : GetFullMipsNum(InSizeX, InSizeY);
+	if (!ValidateTextureDesc("texture2d", InSizeX, InSizeY, 1, kMips, InFormat))
+	{
+		return FRHITexture2DRef();
+	}
+
+	FrameStats.ResourcesCreated++;
+	return new FRHINullTexture2D(InSizeX, InSizeY, kMips, InFormat);
+}
+
+FRHITexture2DArrayRef FNullRenderer::RHICreateTexture2DArray(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat)
+{
+	const uint32_t kMips = InMips > 0 ? InMips : GetFullMipsNum(InSizeX, InSizeY);
+	if (!ValidateTextureDesc("texture2d array", InSizeX, InSizeY, InLayers, kMips, InFormat))
+	{
+		return FRHITexture2DArrayRef();
+	}
+
+	FrameStats.ResourcesCreated++;
+	return new FRHINullTexture2DArray(InSizeX, InSizeY, InLayers, kMips, InFormat);
+}
+
+FRHITextureCubeRef FNullRenderer::RHICreateTextureCube(uint32_t InSize, uint32_t InMips, EPixelFormat InFormat)
+{
+	const uint32_t kMips = InMips > 0 ? InMips : GetFullMipsNum(InSize, InSize);
+	if (!ValidateTextureDesc("texture cube", InSize, InSize, CubeFace_MAX, kMips, InFormat))
+	{
+		return FRHITextureCubeRef();
+	}
+
+	FrameStats.ResourcesCreated++;
+	return new FRHINullTextureCube(InSize, kMips, InFormat);
+}
+
+void FNullRenderer::RHIUpdateTexture(const FRHITextureRef &InTexture, uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData)
+{
+	FNullTexture *NullTexture = dynamic_cast<FNullTexture*>(InTexture.DeRef());
+	if (!NullTexture || !InData)
+	{
+		ValidationError("update an invalid texture");
+		return;
+	}
+	if (InMip >= InTexture->GetNumMips() || InLayer >= InTexture->GetSizeZ()
+		|| InX + InWidth > GetMipSize(InTexture->GetSizeX(), InMip) || InY + InHeight > GetMipSize(InTexture->GetSizeY(), InMip))
+	{
+		ValidationError("texture update (%u,%u %ux%u) of mip %u layer %u is out of the texture", InX, InY, InWidth, InHeight, InMip, InLayer);
+		return;
+	}
+
+	NullTexture->MarkWritten(InMip, InLayer);
+	FrameStats.TextureBytesUploaded += (uint64_t)InWidth * InHeight * GetPixelFormatBytes(InTexture->GetFormat());
+}
+
+void FNullRenderer::RHIGenerateMips(const FRHITextureRef &InTexture)
+{
+	FNullTexture *NullTexture = dynamic_cast<FNullTexture*>(InTexture.DeRef());
+	if (!NullTexture)
+	{
+		ValidationError("generate the mips of an invalid texture");
+		return;
+	}
+	if (!NullTexture->IsWritten())
+	{
+		ValidationError("generate the mips of a texture without mip 0");
+	}
+
+	NullTexture->MarkMipsGenerated();
+}
+
+// render targets
+FRHIRenderBufferRef FNullRenderer::RHICreateRenderBuffer(uint32_t InSizeX, uint32_t InSizeY, EPixelFormat InFormat, uint32_t InSamples)
+{
+	if (InSizeX == 0 || InSizeY == 0 || InSamples == 0 || GetPixelFormatBytes(InFormat) == 0)
+	{
+		ValidationError("create a render buffer of %ux%u, format %d, %u samples", InSizeX, InSizeY, (int32_t)InFormat, InSamples);
+		return FRHIRenderBufferRef();
+	}
+
+	FrameStats.ResourcesCreated++;
+	return new FRHIRenderBuffer(InSizeX, InSizeY, InFormat, InSamples);
+}
+
+FRHIFrameBufferRef FNullRenderer::RHICreateFrameBuffer(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget)
+{
+	const char *Error = CheckFrameBufferTargets(InColorTargets, InColorTargetsNum, InDepthStencilTarget);
+	if (Error)
+	{
+		ValidationError("create a frame buffer: %s", Error);
+		return FRHIFrameBufferRef();
+	}
+
+	FrameStats.ResourcesCreated++;
+	return new FRHIFrameBuffer(InColorTargets, InColorTargetsNum, InDepthStencilTarget);
+}
+
+// queries
+FRHIOcclusionQueryRef FNullRenderer::RHICreateOcclusionQuery()
+{
+	FrameStats.ResourcesCreated++;
+	return new FRHINullOcclusionQuery();
+}
+
+// shader
+FRHIVertexShaderRef FNullRenderer::RHICreateVertexShader(const char *InSource, int32_t InLength)
+{
+	if (!InSource)
+	{
+		ValidationError("create a vertex shader without source");
+		return FRHIVertexShaderRef();
+	}
+
+	FrameStats.ResourcesCreated++;
+	return new FRHINullVertexShader(InSource, InLength);
+}
+
+FRHIPixelShaderRef FNullRenderer::RHICreatePixelShader(const char *InSource, int32_t InLength)
+{
+	if (!InSource)
+	{
+		ValidationError("create a pixel shader without source");
+		return FRHIPixelShaderRef();
+	}
+
+	FrameStats.ResourcesCreated++;
+	return new FRHINullPixelShader(InSource, InLength);
+}
+
+FRHIGPUProgramRef FNullRenderer::RHICreateGPUProgram(const FRHIVertexShaderRef &InVShader, const FRHIPixelShaderRef &InPShader)
+{
+	std::vector<FRHIShaderRef> Shaders;
+	Shaders.push_back(InVShader.DeRef());
+	Shaders.push_back(InPShader.DeRef());
+
+	return RHICreateGPUProgram(Shaders);
+}
+
+FRHIGPUProgramRef FNullRenderer::RHICreateGPUProgram(const std::vector<FRHIShaderRef> &InShaders)
+{
+	bool bHasVertexShader = false, bHasPixelShader = false;
+	for (size_t Index = 0; Index < InShaders.size(); Index++)
+	{
+		if (!InShaders[Index].IsValidRef())
+		{
+			ValidationError("link a program with an invalid shader");
+			return FRHIGPUProgramRef();
+		}
+
+		bHasVertexShader |= InShaders[Index]->Type() == RRT_VertexShader;
+		bHasPixelShader |= InShaders[Index]->Type() == RRT_PixelShader;
+	}
+	if (!bHasVertexShader || !bHasPixelShader)
+	{
+		ValidationError("link a program without vertex or pixel shader");
+		return FRHIGPUProgramRef();
+	}
+
+	FRHINullGPUProgram *GPUProgram = new FRHINullGPUProgram(this);
+	for (size_t Index = 0; Index < InShaders.size(); Index++)
+	{
+		GPUProgram->AddShader(InShaders[Index]);
+	}
+
+	FrameStats.ResourcesCreated++;
+	return GPUProgram;
+}
+
+//State Setting
+void FNullRenderer::RHISetSamplerState(uint32_t InTexIndex, const FRHISamplerStateRef &InSamplerState)
+{
+	if (InTexIndex >= MaxTextureUnits)
+	{
+		ValidationError("sampler index %u out of range", InTexIndex);
+		return;
+	}
+
+	if (InSamplerState.IsValidRef())
+	{
+		FRHINullSamplerState *NullSampler = dynamic_cast<FRHINullSamplerState*>(InSamplerState.DeRef());
+		assert(NullSampler != nullptr);
+
+		PendingStatesSet.TextureSamplers[InTexIndex] = NullSampler;
+	}
+}
+
+void FNullRenderer::RHISetTexture(uint32_t InTexIndex, const FRHITextureRef &InTexture)
+{
+	if (InTexIndex >= MaxTextureUnits)
+	{
+		ValidationError("texture index %u out of range", InTexIndex);
+		return;
+	}
+	if (InTexture.IsValidRef() && dynamic_cast<FNullTexture*>(InTexture.DeRef()) == nullptr)
+	{
+		ValidationError("set an invalid texture at unit %u", InTexIndex);
+		return;
+	}
+
+	PendingStatesSet.Textures[InTexIndex] = InTexture;
+	PendingStatesSet.TexturesDirty = true;
+}
+
+void FNullRenderer::RHISetRasterizerState(const FRHIRasterizerStateRef &InRasterizerState)
+{
+	if (InRasterizerState.IsValidRef())
+	{
+		FRHINullRasterizerState *NullRasterizerState = dynamic_cast<FRHINullRasterizerState*>(InRasterizerState.DeRef());
+		assert(NullRasterizerState != nullptr);
+
+		PendingStatesSet.RasterizerState = NullRasterizerState;
+	}
+}
+
+void FNullRenderer::RHISetDepthStencilState(const FRHIDepthStencilStateRef &InDepthStencilState, int32_t InStencilRef)
+{
+	if (InDepthStencilState.IsValidRef())
+	{
+		FRHINullDepthStencilState *NullDepthStencilState = dynamic_cast<FRHINullDepthStencilState*>(InDepthStencilState.DeRef());
+		assert(NullDepthStencilState != nullptr);
+
+		PendingStatesSet.DepthStencilState = NullDepthStencilState;
+	}
+
+	PendingStatesSet.StencilRef = InStencilRef;
+}
+
+void FNullRenderer::RHISetBlendState(const FRHIBlendStateRef &InBlendState, const FLinearColor &InBlendColor)
+{
+	if (InBlendState.IsValidRef())
+	{
+		FRHINullBlendState *NullBlendState = dynamic_cast<FRHINullBlendState*>(InBlendState.DeRef());
+		assert(NullBlendState != nullptr);
+
+		PendingStatesSet.BlendState = NullBlendState;
+	}
+
+	PendingStatesSet.BlendColor = InBlendColor;
+}
+
+void FNullRenderer::RHISetFrameBuffer(const FRHIFrameBufferRef &InFrameBuffer)
+{
+	if (RenderContext.FrameBuffer.DeRef() != InFrameBuffer.DeRef())
+	{
+		RenderContext.FrameBuffer = InFrameBuffer;
+		FrameStats.FrameBufferBinds++;
+	}
+	else
+	{
+		FrameStats.RedundantStateSets++;
+	}
+}
+
+void FNullRenderer::RHISetViewport(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight, float InMinZ, float InMaxZ)
+{
+	if (InWidth < 0 || InHeight < 0 || InMinZ < 0.f || InMaxZ > 1.f)
+	{
+		ValidationError("invalid viewport: %d, %d, %d, %d, [%f, %f]", InX, InY, InWidth, InHeight, InMinZ, InMaxZ);
+	}
+
+	FViewportBox &Box = RenderContext.ViewportBox;
+	if (InX != Box.x || InY != Box.y || InWidth != Box.width || InHeight != Box.height || InMinZ != Box.zMin || InMaxZ != Box.zMax)
+	{
+		Box.x = InX;
+		Box.y = InY;
+		Box.width = InWidth;
+		Box.height = InHeight;
+		Box.zMin = InMinZ;
+		Box.zMax = InMaxZ;
+		FrameStats.ViewportChanges++;
+	}
+	else
+	{
+		FrameStats.RedundantStateSets++;
+	}
+}
+
+void FNullRenderer::RHISetScissorRect(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight)
+{
+	if (InWidth < 0 || InHeight < 0)
+	{
+		ValidationError("invalid scissor rect: %d, %d, %d, %d", InX, InY, InWidth, InHeight);
+	}
+
+	FIntRect &Rect = RenderContext.ScissorRect;
+	if (InX != Rect.x || InY != Rect.y || InWidth != Rect.width || InHeight != Rect.height)
+	{
+		Rect.x = InX;
+		Rect.y = InY;
+		Rect.width = InWidth;
+		Rect.height = InHeight;
+		FrameStats.ScissorChanges++;
+	}
+	else
+	{
+		FrameStats.RedundantStateSets++;
+	}
+}
+
+void FNullRenderer::SetVertexStreamSource(uint32_t InStreamIndex, const FRHIVertexBufferRef &InVertexBuffer)
+{
+	if (InStreamIndex >= MaxVertexStreamSources)
+	{
+		ValidationError("vertex stream index %u out of range", InStreamIndex);
+		return;
+	}
+
+	FRHINullVertexBuffer *NullVertexBuffer = dynamic_cast<FRHINullVertexBuffer*>(InVertexBuffer.DeRef());
+	if (PendingStatesSet.VertexStreams[InStreamIndex].DeRef() != NullVertexBuffer)
+	{
+		PendingStatesSet.VertexStreamsDirty = true;
+		PendingStatesSet.VertexStreams[InStreamIndex] = NullVertexBuffer;
+	}
+	else
+	{
+		FrameStats.RedundantStateSets++;
+	}
+}
+
+void FNullRenderer::SetVertexInputLayout(const FRHIVertexDeclarationRef &InVertexDecl)
+{
+	FRHINullVertexDeclaration *NullVertexDecl = dynamic_cast<FRHINullVertexDeclaration*>(InVertexDecl.DeRef());
+	if (PendingStatesSet.VertexDecl.DeRef() != NullVertexDecl)
+	{
+		PendingStatesSet.VertexDeclDirty = true;
+		PendingStatesSet.VertexDecl = NullVertexDecl;
+	}
+	else
+	{
+		FrameStats.RedundantStateSets++;
+	}
+}
+
+void FNullRenderer::SetGPUProgram(const FRHIGPUProgramRef &InProgram)
+{
+	FRHINullGPUProgram *NullProgram = dynamic_cast<FRHINullGPUProgram*>(InProgram.DeRef());
+	if (RenderContext.GPUProgram.DeRef() != NullProgram)
+	{
+		RenderContext.GPUProgram = NullProgram;
+		FrameStats.ProgramBinds++;
+	}
+	else
+	{
+		FrameStats.RedundantStateSets++;
+	}
+}
+
+void FNullRenderer::RHISetUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer)
+{
+	if (InBindIndex >= MaxUniformBufferBindings)
+	{
+		ValidationError("uniform buffer slot %u out of range", InBindIndex);
+		return;
+	}
+
+	FRHINullUniformBuffer *NullBuffer = dynamic_cast<FRHINullUniformBuffer*>(InBuffer.DeRef());
+	if (PendingStatesSet.UniformBuffers[InBindIndex].DeRef() != NullBuffer)
+	{
+		PendingStatesSet.UniformBuffers[InBindIndex] = NullBuffer;
+	}
+	else
+	{
+		FrameStats.RedundantStateSets++;
+	}
+}
+
+//Draw Commands
+void FNullRenderer::RHIBeginDrawingViewport(FRHIViewportRef Viewport)
+{
+	FRHINullViewport *NullViewport = dynamic_cast<FRHINullViewport*>(Viewport.DeRef());
+	if (!NullViewport)
+	{
+		ValidationError("begin drawing an invalid viewport");
+		return;
+	}
+	if (ViewportDrawing && ViewportDrawing != NullViewport)
+	{
+		ValidationError("begin drawing a viewport while another one is drawing");
+	}
+
+	ViewportDrawing = NullViewport;
+	RHISetFrameBuffer(FRHIFrameBufferRef());
+}
+
+void FNullRenderer::RHIEndDrawingViewport(FRHIViewportRef Viewport, bool bPresent, bool bLockToVsync)
+{
+	FRHINullViewport *NullViewport = dynamic_cast<FRHINullViewport*>(Viewport.DeRef());
+	if (!NullViewport || NullViewport != ViewportDrawing)
+	{
+		ValidationError("end drawing a viewport which is not drawing");
+	}
+
+	ViewportDrawing = nullptr;
+}
+
+void FNullRenderer::RHIBeginFrame()
+{
+	if (bInFrame)
+	{
+		ValidationError("begin frame twice");
+	}
+
+	bInFrame = true;
+	// with the calls made since the end of the last frame
+	TotalStats.Accumulate(FrameStats);
+	FrameStats.Reset();
+}
+
+void FNullRenderer::RHIEndFrame()
+{
+	if (!bInFrame)
+	{
+		ValidationError("end frame without begin");
+	}
+
+	const uint32_t kOpenScopes = TimerScopes.EndFrame();
+	if (kOpenScopes > 0)
+	{
+		ValidationError("%u timer scopes are still open at the end of the frame", kOpenScopes);
+	}
+
+	bInFrame = false;
+	FrameCounter++;
+	TransientVertexHead = 0;
+	TransientIndexHeads[0] = TransientIndexHeads[1] = 0;
+	FrameStats.Frames++;
+}
+
+void FNullRenderer::RHIClear(bool bClearColor, const FLinearColor &InColor, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil)
+{
+	RHIClearMRT(bClearColor, &InColor, 1, bClearDepth, InDepth, bClearStencil, InStencil);
+}
+
+void FNullRenderer::RHIClearMRT(bool bClearColor, const FLinearColor *InColors, uint32_t InColorsNum, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil)
+{
+	if (bClearColor && (!InColors || InColorsNum > MaxSimultaneousRenderTargets))
+	{
+		ValidationError("clear %u color targets", InColorsNum);
+	}
+	if (bClearDepth && (InDepth < 0.f || InDepth > 1.f))
+	{
+		ValidationError("clear depth %f out of [0, 1]", InDepth);
+	}
+	if (!ViewportDrawing && !RenderContext.FrameBuffer.IsValidRef())
+	{
+		ValidationError("clear outside of BeginDrawingViewport/EndDrawingViewport");
+	}
+	if (bClearColor && RenderContext.FrameBuffer.IsValidRef() && InColorsNum > RenderContext.FrameBuffer->GetColorTargetsNum())
+	{
+		ValidationError("clear %u color targets of a frame buffer of %u", InColorsNum, RenderContext.FrameBuffer->GetColorTargetsNum());
+	}
+
+	MarkFrameBufferWritten();
+	FrameStats.Clears++;
+}
+
+void FNullRenderer::RHIResolveFrameBuffer(const FRHIFrameBufferRef &InSource, const FRHIFrameBufferRef &InDest)
+{
+	if (!InSource.IsValidRef() || !InDest.IsValidRef() || InSource.DeRef() == InDest.DeRef())
+	{
+		ValidationError("resolve an invalid frame buffer");
+		return;
+	}
+	if (InSource->GetSizeX() != InDest->GetSizeX() || InSource->GetSizeY() != InDest->GetSizeY())
+	{
+		ValidationError("resolve a frame buffer of %ux%u into one of %ux%u", InSource->GetSizeX(), InSource->GetSizeY(), InDest->GetSizeX(), InDest->GetSizeY());
+		return;
+	}
+	if (InDest->GetSamples() > 1)
+	{
+		ValidationError("resolve into a multisampled frame buffer");
+	}
+
+	const bool bColor = InSource->GetColorTargetsNum() > 0 && InDest->GetColorTargetsNum() > 0;
+	if (bColor && InSource->GetColorTarget(0).GetFormat() != InDest->GetColorTarget(0).GetFormat())
+	{
+		ValidationError("resolve between the color formats %d and %d", (int32_t)InSource->GetColorTarget(0).GetFormat(), (int32_t)InDest->GetColorTarget(0).GetFormat());
+	}
+
+	// the targets of the destination are written
+	FRHIFrameBufferRef FrameBuffer = RenderContext.FrameBuffer;
+	RenderContext.FrameBuffer = InDest;
+	MarkFrameBufferWritten();
+	RenderContext.FrameBuffer = FrameBuffer;
+
+	FrameStats.FrameBufferResolves++;
+}
+
+void FNullRenderer::DrawIndexedPrimitive(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount)
+{
+	FNullRenderer::DrawIndexedPrimitiveInstanced(InIndexBuffer, InMode, InStart, InCount, 1);
+}
+
+void FNullRenderer::DrawIndexedPrimitiveInstanced(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances)
+{
+	UpdatePendingStates();
+
+	FRHINullIndexBuffer *NullIndexBuffer = dynamic_cast<FRHINullIndexBuffer*>(InIndexBuffer.DeRef());
+	if (!NullIndexBuffer)
+	{
+		ValidationError("draw indexed without index buffer");
+		return;
+	}
+	if (NullIndexBuffer->bIsLocked)
+	{
+		ValidationError("draw with a locked index buffer");
+	}
+	if ((uint64_t)InStart + InCount > NullIndexBuffer->GetIndexCount())
+	{
+		ValidationError("draw indices [%u, %u) out of index buffer with %u indices", InStart, InStart + InCount, NullIndexBuffer->GetIndexCount());
+	}
+
+	// the vertex range is not checked here, it would need to scan the indices.
+	if (!ValidateDrawState(InMode, 0))
+	{
+		return;
+	}
+
+	if (RenderContext.IndexBuffer.DeRef() != NullIndexBuffer)
+	{
+		RenderContext.IndexBuffer = NullIndexBuffer;
+		FrameStats.IndexBufferBinds++;
+	}
+
+	MarkFrameBufferWritten();
+	FrameStats.DrawCalls++;
+	FrameStats.Instances += InInstances;
+	FrameStats.Vertices += (uint64_t)InCount * InInstances;
+	if (ActiveOcclusionQuery.IsValidRef())
+	{
+		ActiveOcclusionQuery->Samples += (uint64_t)InCount * InInstances;
+	}
+}
+
+void FNullRenderer::DrawArrayedPrimitive(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount)
+{
+	FNullRenderer::DrawArrayedPrimitiveInstanced(InMode, InStart, InCount, 1);
+}
+
+void FNullRenderer::DrawArrayedPrimitiveInstanced(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances)
+{
+	UpdatePendingStates();
+
+	if (!ValidateDrawState(InMode, InStart + InCount))
+	{
+		return;
+	}
+
+	MarkFrameBufferWritten();
+	FrameStats.DrawCalls++;
+	FrameStats.Instances += InInstances;
+	FrameStats.Vertices += (uint64_t)InCount * InInstances;
+	if (ActiveOcclusionQuery.IsValidRef())
+	{
+		ActiveOcclusionQuery->Samples += (uint64_t)InCount * InInstances;
+	}
+}
+
+void FNullRenderer::DrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset)
+{
+	FNullRenderer::MultiDrawIndexedPrimitiveIndirect(InIndexBuffer, InMode, InArgsBuffer, InOffset, 1, 0);
+}
+
+void FNullRenderer::MultiDrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t InStride)
+{
+	UpdatePendingStates();
+
+	FRHINullIndexBuffer *NullIndexBuffer = dynamic_cast<FRHINullIndexBuffer*>(InIndexBuffer.DeRef());
+	FRHINullIndirectBuffer *ArgsBuffer = dynamic_cast<FRHINullIndirectBuffer*>(InArgsBuffer.DeRef());
+	if (!NullIndexBuffer)
+	{
+		ValidationError("draw indexed without index buffer");
+		return;
+	}
+	uint32_t Stride = InStride;
+	const char *Error = CheckIndirectArgs(ArgsBuffer, InOffset, InDrawsNum, Stride);
+	if (Error)
+	{
+		ValidationError("indirect draw: %s", Error);
+		return;
+	}
+	if (NullIndexBuffer->bIsLocked || ArgsBuffer->bIsLocked)
+	{
+		ValidationError("indirect draw with a locked %s buffer", NullIndexBuffer->bIsLocked ? "index" : "arguments");
+	}
+	if (!ValidateDrawState(InMode, 0))
+	{
+		return;
+	}
+
+	if (RenderContext.IndexBuffer.DeRef() != NullIndexBuffer)
+	{
+		RenderContext.IndexBuffer = NullIndexBuffer;
+		FrameStats.IndexBufferBinds++;
+	}
+
+	const uint8_t *Args = ArgsBuffer->GetData() + InOffset;
+	for (uint32_t k = 0; k < InDrawsNum; k++, Args += Stride)
+	{
+		FDrawIndexedIndirectArgs DrawArgs;
+		::memcpy(&DrawArgs, Args, sizeof(DrawArgs));
+		if ((uint64_t)DrawArgs.FirstIndex + DrawArgs.IndexCount > NullIndexBuffer->GetIndexCount())
+		{
+			ValidationError("indirect draw %u: indices [%u, %u) out of index buffer with %u indices", k, DrawArgs.FirstIndex, DrawArgs.FirstIndex + DrawArgs.IndexCount, NullIndexBuffer->GetIndexCount());
+			continue;
+		}
+		if (DrawArgs.IndexCount == 0 || DrawArgs.InstanceCount == 0)
+		{
+			continue;
+		}
+
+		FrameStats.DrawCalls++;
+		FrameStats.Instances += DrawArgs.InstanceCount;
+		FrameStats.Vertices += (uint64_t)DrawArgs.IndexCount * DrawArgs.InstanceCount;
+		if (ActiveOcclusionQuery.IsValidRef())
+		{
+			ActiveOcclusionQuery->Samples += (uint64_t)DrawArgs.IndexCount * DrawArgs.InstanceCount;
+		}
+	} // end for k
+
+	MarkFrameBufferWritten();
+	FrameStats.IndirectSubmits++;
+}
+
+//GPU Profiling
+void FNullRenderer::RHIBeginTimerQuery(const char *InName)
+{
+	if (!InName)
+	{
+		ValidationError("timer scope without a name");
+	}
+	TimerScopes.BeginScope(InName);
+	FrameStats.TimerScopes++;
+}
+
+void FNullRenderer::RHIEndTimerQuery()
+{
+	if (!TimerScopes.EndScope())
+	{
+		ValidationError("end of a timer scope which was not begun");
+	}
+}
+
+bool FNullRenderer::RHIGetGPUFrameTimings(FGPUFrameTimings &OutTimings)
+{
+	return TimerScopes.GetFrameTimings(OutTimings);
+}
+
+//Occlusion Queries
+void FNullRenderer::RHIBeginOcclusionQuery(const FRHIOcclusionQueryRef &InQuery)
+{
+	FRHINullOcclusionQuery *Query = dynamic_cast<FRHINullOcclusionQuery*>(InQuery.DeRef());
+	if (!Query)
+	{
+		ValidationError("begin an invalid occlusion query");
+		return;
+	}
+	if (ActiveOcclusionQuery.IsValidRef())
+	{
+		ValidationError("begin an occlusion query while another one is active");
+		return;
+	}
+	if (Query == ConditionalRenderQuery.DeRef())
+	{
+		ValidationError("begin the occlusion query of the conditional render in progress");
+	}
+
+	Query->Samples = 0;
+	Query->bEnded = false;
+	ActiveOcclusionQuery = Query;
+	FrameStats.OcclusionQueries++;
+}
+
+void FNullRenderer::RHIEndOcclusionQuery(const FRHIOcclusionQueryRef &InQuery)
+{
+	if (!InQuery.IsValidRef() || ActiveOcclusionQuery.DeRef() != InQuery.DeRef())
+	{
+		ValidationError("end an occlusion query which is not active");
+		return;
+	}
+
+	ActiveOcclusionQuery->bEnded = true;
+	ActiveOcclusionQuery.SafeRelease();
+}
+
+bool FNullRenderer::RHIGetOcclusionQueryResult(const FRHIOcclusionQueryRef &InQuery, uint64_t &OutSamples, bool bWait)
+{
+	FRHINullOcclusionQuery *Query = dynamic_cast<FRHINullOcclusionQuery*>(InQuery.DeRef());
+	if (!Query || Query == ActiveOcclusionQuery.DeRef())
+	{
+		ValidationError("read the result of an invalid or active occlusion query");
+		return false;
+	}
+	if (!Query->bEnded)
+	{
+		return false;
+	}
+
+	OutSamples = Query->Samples;
+	return true;
+}
+
+void FNullRenderer::RHIBeginConditionalRender(const FRHIOcclusionQueryRef &InQuery, bool bWait)
+{
+	FRHINullOcclusionQuery *Query = dynamic_cast<FRHINullOcclusionQuery*>(InQuery.DeRef());
+	if (!Query || !Query->bEnded)
+	{
+		ValidationError("conditional render on an occlusion query which is not ended");
+		return;
+	}
+	if (ConditionalRenderQuery.IsValidRef())
+	{
+		ValidationError("conditional render inside another one");
+		return;
+	}
+
+	ConditionalRenderQuery = Query;
+	FrameStats.ConditionalRenders++;
+}
+
+void FNullRenderer::RHIEndConditionalRender()
+{
+	if (!ConditionalRenderQuery.IsValidRef())
+	{
+		ValidationError("end a conditional render which was not begun");
+		return;
+	}
+
+	ConditionalRenderQuery.SafeRelease();
+}
+
+//Statistics
+void FNullRenderer::ResetStats()
+{
+	FrameStats.Reset();
+	TotalStats.Reset();
+}
+
+FNullRendererStats FNullRenderer::GetTotalStats() const
+{
+	FNullRendererStats Stats = TotalStats;
+	Stats.Accumulate(FrameStats);
+	return Stats;
+}
+
+void FNullRenderer::DumpStats(FOutputDevice &OutDevice) const
+{
+	const FNullRendererStats Stats = GetTotalStats();
+
+	OutDevice.Log(Log_Info, "Null Renderer Stats (%llu frames):", (unsigned long long)Stats.Frames);
+	OutDevice.Log(Log_Info, "    DrawCalls: %llu, Instances: %llu, Vertices: %llu, IndirectSubmits: %llu, Clears: %llu",
+		(unsigned long long)Stats.DrawCalls, (unsigned long long)Stats.Instances, (unsigned long long)Stats.Vertices,
+		(unsigned long long)Stats.IndirectSubmits, (unsigned long long)Stats.Clears);
+	OutDevice.Log(Log_Info, "    ProgramBinds: %llu, IndexBufferBinds: %llu, VertexStreamBinds: %llu, VertexLayoutChanges: %llu, UniformUpdates: %llu",
+		(unsigned long long)Stats.ProgramBinds, (unsigned long long)Stats.IndexBufferBinds, (unsigned long long)Stats.VertexStreamBinds,
+		(unsigned long long)Stats.VertexLayoutChanges, (unsigned long long)Stats.UniformUpdates);
+	OutDevice.Log(Log_Info, "    UniformBufferBinds: %llu, UniformBufferUpdates: %llu, TextureBinds: %llu, FrameBufferBinds: %llu, FrameBufferResolves: %llu",
+		(unsigned long long)Stats.UniformBufferBinds, (unsigned long long)Stats.UniformBufferUpdates, (unsigned long long)Stats.TextureBinds,
+		(unsigned long long)Stats.FrameBufferBinds, (unsigned long long)Stats.FrameBufferResolves);
+	OutDevice.Log(Log_Info, "    StateChanges: Rasterizer=%llu, DepthStencil=%llu, Blend=%llu, Sampler=%llu, Viewport=%llu, Scissor=%llu, Redundant=%llu",
+		(unsigned long long)Stats.RasterizerStateChanges, (unsigned long long)Stats.DepthStencilStateChanges, (unsigned long long)Stats.BlendStateChanges,
+		(unsigned long long)Stats.SamplerStateChanges, (unsigned long long)Stats.ViewportChanges, (unsigned long long)Stats.ScissorChanges,
+		(unsigned long long)Stats.RedundantStateSets);
+	OutDevice.Log(Log_Info, "    ResourcesCreated: %llu, BufferBytesUploaded: %llu, BufferLocks: %llu, TransientBytes: %llu, TextureBytesUploaded: %llu",
+		(unsigned long long)Stats.ResourcesCreated, (unsigned long long)Stats.BufferBytesUploaded, (unsigned long long)Stats.BufferLocks,
+		(unsigned long long)Stats.TransientBytes, (unsigned long long)Stats.TextureBytesUploaded);
+	OutDevice.Log(Log_Info, "    TimerScopes: %llu, OcclusionQueries: %llu, ConditionalRenders: %llu, ValidationErrors: %llu", (unsigned long long)Stats.TimerScopes,
+		(unsigned long long)Stats.OcclusionQueries, (unsigned long long)Stats.ConditionalRenders, (unsigned long long)Stats.ValidationErrors);
+}
+
+//Helpers
+void FNullRenderer::ValidationError(const char *InFormat, ...)
+{
+	FrameStats.ValidationErrors++;
+
+	if (Logger)
+	{
+		char szBuf[1024];
+
+		va_list ap;
+		va_start(ap, InFormat);
+		vsnprintf(szBuf, sizeof(szBuf), InFormat, ap);
+		va_end(ap);
+
+		Logger->Log(Log_Error, "Null Renderer validation: %s", szBuf);
+	}
+}
+
+void FNullRenderer::UpdatePendingStates()
+{
+	// count the changes the same way the OpenGL renderer would apply them
+	if (PendingStatesSet.RasterizerState.IsValidRef())
+	{
+		if (PendingStatesSet.RasterizerState.DeRef() != RenderContext.RasterizerState.DeRef())
+		{
+			RenderContext.RasterizerState = PendingStatesSet.RasterizerState;
+			FrameStats.RasterizerStateChanges++;
+		}
+		PendingStatesSet.RasterizerState = nullptr;
+	}
+
+	for (uint32_t k = 0; k < MaxTextureUnits; k++)
+	{
+		if (PendingStatesSet.TextureSamplers[k].IsValidRef())
+		{
+			if (PendingStatesSet.TextureSamplers[k].DeRef() != RenderContext.TextureSamplers[k].DeRef())
+			{
+				RenderContext.TextureSamplers[k] = PendingStatesSet.TextureSamplers[k];
+				FrameStats.SamplerStateChanges++;
+			}
+			PendingStatesSet.TextureSamplers[k] = nullptr;
+		}
+	} // end for k
+
+	if (PendingStatesSet.TexturesDirty)
+	{
+		for (uint32_t k = 0; k < MaxTextureUnits; k++)
+		{
+			if (PendingStatesSet.Textures[k].DeRef() != RenderContext.Textures[k].DeRef())
+			{
+				RenderContext.Textures[k] = PendingStatesSet.Textures[k];
+				FrameStats.TextureBinds++;
+			}
+		} // end for k
+		PendingStatesSet.TexturesDirty = false;
+	}
+
+	if (PendingStatesSet.DepthStencilState.IsValidRef())
+	{
+		if (PendingStatesSet.DepthStencilState.DeRef() != RenderContext.DepthStencilState.DeRef()
+			|| PendingStatesSet.StencilRef != RenderContext.StencilRef)
+		{
+			RenderContext.DepthStencilState = PendingStatesSet.DepthStencilState;
+			RenderContext.StencilRef = PendingStatesSet.StencilRef;
+			FrameStats.DepthStencilStateChanges++;
+		}
+		PendingStatesSet.DepthStencilState = nullptr;
+	}
+
+	if (PendingStatesSet.BlendState.IsValidRef())
+	{
+		if (PendingStatesSet.BlendState.DeRef() != RenderContext.BlendState.DeRef()
+			|| RenderContext.BlendColor != PendingStatesSet.BlendColor)
+		{
+			RenderContext.BlendState = PendingStatesSet.BlendState;
+			RenderContext.BlendColor = PendingStatesSet.BlendColor;
+			FrameStats.BlendStateChanges++;
+		}
+		PendingStatesSet.BlendState = nullptr;
+	}
+
+	if (PendingStatesSet.VertexDeclDirty || PendingStatesSet.VertexStreamsDirty)
+	{
+		if (PendingStatesSet.VertexDeclDirty)
+		{
+			FrameStats.VertexLayoutChanges++;
+			RenderContext.VertexDecl = PendingStatesSet.VertexDecl;
+		}
+		for (uint32_t k = 0; k < MaxVertexStreamSources; k++)
+		{
+			if (RenderContext.VertexStreams[k].DeRef() != PendingStatesSet.VertexStreams[k].DeRef())
+			{
+				RenderContext.VertexStreams[k] = PendingStatesSet.VertexStreams[k];
+				FrameStats.VertexStreamBinds++;
+			}
+		} // end for k
+
+		PendingStatesSet.VertexDeclDirty = false;
+		PendingStatesSet.VertexStreamsDirty = false;
+	}
+
+	// one range bind per slot whose buffer or contents moved
+	for (uint32_t k = 0; k < MaxUniformBufferBindings; k++)
+	{
+		FRHINullUniformBuffer *Pending = PendingStatesSet.UniformBuffers[k].DeRef();
+		if (!Pending)
+		{
+			continue;
+		}
+		if (!Pending->bWritten)
+		{
+			ValidationError("uniform buffer at slot %u is used before it was written", k);
+		}
+		else if (Pending->IsVolatile() && Pending->UpdateFrame != FrameCounter)
+		{
+			ValidationError("volatile uniform buffer at slot %u was written in frame %llu, used in frame %llu",
+				k, (unsigned long long)Pending->UpdateFrame, (unsigned long long)FrameCounter);
+		}
+
+		if (RenderContext.UniformBuffers[k].DeRef() != Pending || RenderContext.UniformBufferVersions[k] != Pending->Version)
+		{
+			RenderContext.UniformBuffers[k] = Pending;
+			RenderContext.UniformBufferVersions[k] = Pending->Version;
+			FrameStats.UniformBufferBinds++;
+		}
+	} // end for k
+
+	if (RenderContext.GPUProgram.IsValidRef())
+	{
+		FrameStats.UniformUpdates += RenderContext.GPUProgram->UpdateUniformVariables();
+	}
+}
+
+void FNullRenderer::MarkFrameBufferWritten()
+{
+	const FRHIFrameBuffer *FrameBuffer = RenderContext.FrameBuffer.DeRef();
+	if (!FrameBuffer)
+	{
+		return;
+	}
+
+	for (uint32_t k = 0; k <= FrameBuffer->GetColorTargetsNum(); k++)
+	{
+		const FRHIRenderTargetView &View = k < FrameBuffer->GetColorTargetsNum() ? FrameBuffer->GetColorTarget(k) : FrameBuffer->GetDepthStencilTarget();
+		FNullTexture *Texture = dynamic_cast<FNullTexture*>(View.Texture.DeRef());
+		if (Texture)
+		{
+			Texture->MarkWritten(View.MipIndex, View.LayerIndex);
+		}
+	} // end for k
+}
+
+bool FNullRenderer::ValidateDrawState(EPrimitiveType InMode, uint32_t InVerticesNeeded)
+{
+	bool bValid = true;
+
+	if (InMode >= PT_Max)
+	{
+		ValidationError("draw with invalid primitive type %d", (int32_t)InMode);
+		bValid = false;
+	}
+	if (!ViewportDrawing && !RenderContext.FrameBuffer.IsValidRef())
+	{
+		ValidationError("draw outside of BeginDrawingViewport/EndDrawingViewport");
+	}
+	if (!RenderContext.GPUProgram.IsValidRef())
+	{
+		ValidationError("draw without gpu program");
+		bValid = false;
+	}
+	for (uint32_t k = 0; k < MaxTextureUnits; k++)
+	{
+		FNullTexture *Texture = dynamic_cast<FNullTexture*>(RenderContext.Textures[k].DeRef());
+		if (Texture && !Texture->IsWritten())
+		{
+			ValidationError("texture at unit %u is sampled before it was written", k);
+		}
+		if (Texture && RenderContext.FrameBuffer.IsValidRef() && RenderContext.FrameBuffer->IsAttached(RenderContext.Textures[k].DeRef()))
+		{
+			ValidationError("texture at unit %u is sampled while the frame buffer draws into it", k);
+		}
+	} // end for k
+	if (!RenderContext.VertexDecl.IsValidRef())
+	{
+		ValidationError("draw without vertex input layout");
+		return false;
+	}
+
+	const FVertexElementsList &Elements = RenderContext.VertexDecl->VertexElements;
+	for (size_t Index = 0; Index < Elements.size(); Index++)
+	{
+		const FVertexElement &Element = Elements[Index];
+		if (Element.StreamIndex >= MaxVertexStreamSources)
+		{
+			bValid = false;
+			continue;
+		}
+
+		FRHINullVertexBuffer *Stream = RenderContext.VertexStreams[Element.StreamIndex];
+		if (!Stream)
+		{
+			ValidationError("vertex stream %u is not bound", Element.StreamIndex);
+			bValid = false;
+			continue;
+		}
+		if (Stream->bIsLocked)
+		{
+			ValidationError("draw with a locked vertex buffer at stream %u", Element.StreamIndex);
+		}
+
+		// check the range of the non-instanced streams
+		if (InVerticesNeeded > 0 && Element.Divisor == 0)
+		{
+			const uint64_t kLastByte = (uint64_t)(InVerticesNeeded - 1) * Element.Stride + Element.Offset + GetVertexElementBytes(Element.DataType);
+			if (kLastByte > Stream->GetBytes())
+			{
+				ValidationError("vertex stream %u overflow: need %llu bytes, has %u", Element.StreamIndex, (unsigned long long)kLastByte, Stream->GetBytes());
+				bValid = false;
+			}
+		}
+	} // end for
+
+	return bValid;
+}
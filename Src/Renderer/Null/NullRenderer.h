@@ -0,0 +1,295 @@
+// \brief
+//		Null renderer: a headless backend which tracks resources and states
+//		in memory, validates the calls and counts the work without touching a GPU.
+//
+
+#ifndef __JETX_NULL_RENDERER_H__
+#define __JETX_NULL_RENDERER_H__
+
+#include <vector>
+#include "Renderer/Renderer.h"
+#include "NullResource.h"
+
+
+/** The sizes of the per-frame transient geometry buffers */
+enum { NullTransientVertexBytes = 4 * 1024 * 1024 };
+enum { NullTransientIndexBytes = 1024 * 1024 };
+
+// counters of the null renderer
+struct FNullRendererStats
+{
+	FNullRendererStats()
+	{
+		Reset();
+	}
+
+	void Reset()
+	{
+		::memset(this, 0, sizeof(*this));
+	}
+
+	void Accumulate(const FNullRendererStats &InOther);
+
+	// draws
+	uint64_t	DrawCalls;
+	uint64_t	Instances;
+	uint64_t	Vertices;		// indices for indexed draws
+	uint64_t	IndirectSubmits;	// API calls of the indirect draws, their draws are in DrawCalls
+	uint64_t	Clears;
+
+	// binds
+	uint64_t	ProgramBinds;
+	uint64_t	IndexBufferBinds;
+	uint64_t	VertexStreamBinds;
+	uint64_t	VertexLayoutChanges;
+	uint64_t	UniformUpdates;
+	uint64_t	UniformBufferBinds;		// range binds, a volatile buffer moves at every update
+	uint64_t	UniformBufferUpdates;
+	uint64_t	TextureBinds;
+	uint64_t	FrameBufferBinds;
+	uint64_t	FrameBufferResolves;
+	uint64_t	TimerScopes;
+	uint64_t	OcclusionQueries;
+	uint64_t	ConditionalRenders;
+
+	// state changes, only the effective ones are counted.
+	uint64_t	RasterizerStateChanges;
+	uint64_t	DepthStencilStateChanges;
+	uint64_t	BlendStateChanges;
+	uint64_t	SamplerStateChanges;
+	uint64_t	ViewportChanges;
+	uint64_t	ScissorChanges;
+	uint64_t	RedundantStateSets;
+
+	// resources
+	uint64_t	ResourcesCreated;
+	uint64_t	BufferBytesUploaded;
+	uint64_t	BufferLocks;
+	uint64_t	TransientBytes;
+	uint64_t	TextureBytesUploaded;
+
+	uint64_t	Frames;
+	uint64_t	ValidationErrors;
+};
+
+//FNullRenderer
+class FNullRenderer : public FRenderer
+{
+public:
+	FNullRenderer();
+
+	//Init
+	virtual void Init(FOutputDevice *LogOutputDevice) override;
+	virtual void Shutdown() override;
+
+	//Capabilities
+	virtual void DumpCapabilities() override;
+
+//render viewport
+	virtual FRHIViewportRef RHICreateViewport(void* InWindowHandle, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen) override;
+	virtual void RHIResizeViewport(FRHIViewportRef InViewport, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen) override;
+
+	virtual bool RHIGetAvailableResolutions(FScreenResolutionArray& Resolutions, bool bIgnoreRefreshRate) override;
+	virtual void RHIGetSupportedResolution(uint32_t& Width, uint32_t& Height) override;
+
+//Resource Creating
+	// states
+	virtual FRHISamplerStateRef RHICreateSamplerState(const FSamplerStateInitializerRHI &SamplerStateInitializer) override;
+	virtual FRHIRasterizerStateRef RHICreateRasterizerState(const FRasterizerStateInitializerRHI &RasterizerStateInitializer) override;
+	virtual FRHIDepthStencilStateRef RHICreateDepthStencilState(const FDepthStencilStateInitializerRHI &DepthStencilStateInitializer) override;
+	virtual FRHIBlendStateRef RHICreateBlendState(const FBlendStateInitializerRHI &BlendStateInitializer) override;
+
+	// data buffers
+	virtual FRHIVertexBufferRef RHICreateVertexBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess, EBufferUsage InUsage) override;
+	virtual FRHIIndexBufferRef RHICreateIndexBuffer(uint32_t InBytes, const void *InData, uint16_t InStride, EBufferAccess InAccess, EBufferUsage InUsage) override;
+	virtual FRHIIndirectBufferRef RHICreateIndirectBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess) override;
+
+	virtual void FillDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, const void *InData) override;
+	virtual void* LockDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, EBufferLockMode InMode) override;
+	virtual void UnLockDataBuffer(FRHIDataBufferRef InBuffer) override;
+	virtual void FlushDataBufferRange(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes) override;
+
+	// uniform buffers
+	virtual FRHIUniformBufferRef RHICreateUniformBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess) override;
+	virtual void RHIUpdateUniformBuffer(const FRHIUniformBufferRef &InBuffer, const void *InData) override;
+
+	// transient geometry
+	virtual void* RHIAllocTransientVertices(uint32_t InBytes, uint32_t InStride, FRHIVertexBufferRef &OutBuffer, uint32_t &OutFirstVertex) override;
+	virtual void* RHIAllocTransientIndices(uint32_t InCount, uint16_t InStride, FRHIIndexBufferRef &OutBuffer, uint32_t &OutFirstIndex) override;
+
+	// vertex input layout
+	virtual FRHIVertexDeclarationRef RHICreateVertexInputLayout(const FVertexElement *InVertexElements, uint32_t InCount) override;
+
+	// textures
+	virtual FRHITexture2DRef RHICreateTexture2D(uint32_t InSizeX, uint32_t InSizeY, uint32_t InMips, EPixelFormat InFormat) override;
+	virtual FRHITexture2DArrayRef RHICreateTexture2DArray(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat) override;
+	virtual FRHITextureCubeRef RHICreateTextureCube(uint32_t InSize, uint32_t InMips, EPixelFormat InFormat) override;
+	virtual void RHIUpdateTexture(const FRHITextureRef &InTexture, uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData) override;
+	virtual void RHIGenerateMips(const FRHITextureRef &InTexture) override;
+
+	// render targets
+	virtual FRHIRenderBufferRef RHICreateRenderBuffer(uint32_t InSizeX, uint32_t InSizeY, EPixelFormat InFormat, uint32_t InSamples) override;
+	virtual FRHIFrameBufferRef RHICreateFrameBuffer(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget) override;
+
+	// queries
+	virtual FRHIOcclusionQueryRef RHICreateOcclusionQuery() override;
+
+	// shader
+	virtual FRHIVertexShaderRef RHICreateVertexShader(const char *InSource, int32_t InLength = -1) override;
+	virtual FRHIPixelShaderRef RHICreatePixelShader(const char *InSource, int32_t InLength = -1) override;
+	virtual FRHIGPUProgramRef RHICreateGPUProgram(const FRHIVertexShaderRef &InVShader, const FRHIPixelShaderRef &InPShader) override;
+	virtual FRHIGPUProgramRef RHICreateGPUProgram(const std::vector<FRHIShaderRef> &InShaders) override;
+
+//State Setting
+	virtual void RHISetSamplerState(uint32_t InTexIndex, const FRHISamplerStateRef &InSamplerState) override;
+	virtual void RHISetTexture(uint32_t InTexIndex, const FRHITextureRef &InTexture) override;
+	virtual void RHISetRasterizerState(const FRHIRasterizerStateRef &InRasterizerState) override;
+	virtual void RHISetDepthStencilState(const FRHIDepthStencilStateRef &InDepthStencilState, int32_t InStencilRef) override;
+	virtual void RHISetBlendState(const FRHIBlendStateRef &InBlendState, const FLinearColor &InBlendColor) override;
+
+	virtual void RHISetFrameBuffer(const FRHIFrameBufferRef &InFrameBuffer) override;
+	virtual void RHISetViewport(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight, float InMinZ, float InMaxZ) override;
+	virtual void RHISetScissorRect(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight) override;
+
+	virtual void SetVertexStreamSource(uint32_t InStreamIndex, const FRHIVertexBufferRef &InVertexBuffer) override;
+	virtual void SetVertexInputLayout(const FRHIVertexDeclarationRef &InVertexDecl) override;
+	virtual void SetGPUProgram(const FRHIGPUProgramRef &InProgram) override;
+	virtual void RHISetUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer) override;
+
+//Draw Commands
+	virtual void RHIBeginDrawingViewport(FRHIViewportRef Viewport) override;
+	virtual void RHIEndDrawingViewport(FRHIViewportRef Viewport, bool bPresent, bool bLockToVsync) override;
+	virtual void RHIBeginFrame() override;
+	virtual void RHIEndFrame() override;
+
+	virtual void RHIClear(bool bClearColor, const FLinearColor &InColor, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil) override;
+	virtual void RHIClearMRT(bool bClearColor, const FLinearColor *InColors, uint32_t InColorsNum, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil) override;
+
+	virtual void RHIResolveFrameBuffer(const FRHIFrameBufferRef &InSource, const FRHIFrameBufferRef &InDest) override;
+
+	// draw primitives
+	virtual void DrawIndexedPrimitive(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount) override;
+	virtual void DrawIndexedPrimitiveInstanced(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances) override;
+	virtual void DrawArrayedPrimitive(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount) override;
+	virtual void DrawArrayedPrimitiveInstanced(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances) override;
+	// the arguments are read back and checked as the direct draws.
+	virtual void DrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset) override;
+	virtual void MultiDrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t InStride) override;
+
+//GPU Profiling
+	// the scopes are checked, their times are the ones of the calls.
+	virtual void RHIBeginTimerQuery(const char *InName) override;
+	virtual void RHIEndTimerQuery() override;
+	virtual bool RHIGetGPUFrameTimings(FGPUFrameTimings &OutTimings) override;
+
+//Occlusion Queries
+	// the results are known at the end, the conditional draws are counted as the others.
+	virtual void RHIBeginOcclusionQuery(const FRHIOcclusionQueryRef &InQuery) override;
+	virtual void RHIEndOcclusionQuery(const FRHIOcclusionQueryRef &InQuery) override;
+	virtual bool RHIGetOcclusionQueryResult(const FRHIOcclusionQueryRef &InQuery, uint64_t &OutSamples, bool bWait) override;
+	virtual void RHIBeginConditionalRender(const FRHIOcclusionQueryRef &InQuery, bool bWait) override;
+	virtual void RHIEndConditionalRender() override;
+
+//Statistics
+	// counters of the frame in progress (or the last one after RHIEndFrame)
+	const FNullRendererStats& GetFrameStats() const { return FrameStats; }
+	// counters accumulated since Init or the last ResetStats, the frame in progress & the calls out of the frames included
+	FNullRendererStats GetTotalStats() const;
+	void ResetStats();
+	void DumpStats(FOutputDevice &OutDevice) const;
+
+//Helpers
+	// log a validation failure and count it.
+	void ValidationError(const char *InFormat, ...);
+
+protected:
+	void UpdatePendingStates();
+	bool ValidateDrawState(EPrimitiveType InMode, uint32_t InVerticesNeeded);
+	// the draws write the textures of the frame buffer
+	void MarkFrameBufferWritten();
+	bool ValidateTextureDesc(const char *InKind, uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat);
+
+protected:
+	struct FViewportBox
+	{
+		int32_t x, y, width, height;
+		float zMin, zMax;
+	};
+	struct FIntRect
+	{
+		int32_t x, y, width, height;
+	};
+
+	// Render Context, the states seen by the draws
+	struct FRenderContext
+	{
+		FIntRect						ScissorRect;
+		FViewportBox					ViewportBox;
+		FRHIFrameBufferRef				FrameBuffer;
+
+		FRHINullRasterizerStateRef		RasterizerState;
+		FRHINullSamplerStateRef			TextureSamplers[MaxTextureUnits];
+		FRHITextureRef					Textures[MaxTextureUnits];
+		FRHINullDepthStencilStateRef	DepthStencilState;
+		int32_t							StencilRef;
+		FRHINullBlendStateRef			BlendState;
+		FLinearColor					BlendColor;
+
+		FRHINullVertexDeclarationRef	VertexDecl;
+		FRHINullVertexBufferRef			VertexStreams[MaxVertexStreamSources];
+		FRHINullIndexBufferRef			IndexBuffer;
+
+		FRHINullGPUProgramRef			GPUProgram;
+
+		FRHINullUniformBufferRef		UniformBuffers[MaxUniformBufferBindings];
+		uint32_t						UniformBufferVersions[MaxUniformBufferBindings];
+	};
+
+	// Pending States Set to execute
+	struct FPendingStatesSet
+	{
+		FRHINullRasterizerStateRef		RasterizerState;
+		FRHINullSamplerStateRef			TextureSamplers[MaxTextureUnits];
+		FRHINullDepthStencilStateRef	DepthStencilState;
+		int32_t							StencilRef;
+		FRHINullBlendStateRef			BlendState;
+		FLinearColor					BlendColor;
+
+		FRHINullVertexDeclarationRef	VertexDecl;
+		FRHINullVertexBufferRef			VertexStreams[MaxVertexStreamSources];
+		bool							VertexDeclDirty;
+		bool							VertexStreamsDirty;
+
+		FRHINullUniformBufferRef		UniformBuffers[MaxUniformBufferBindings];
+
+		FRHITextureRef					Textures[MaxTextureUnits];
+		bool							TexturesDirty;
+	};
+
+	FOutputDevice		*Logger;
+
+	FRHINullViewport	*ViewportDrawing;
+	bool				bInFrame;
+	uint64_t			FrameCounter;
+
+	FRenderContext		RenderContext;
+	FPendingStatesSet	PendingStatesSet;
+
+	// transient geometry, rewound at every frame. same sizes as the OpenGL stream buffers.
+	FRHINullVertexBufferRef	TransientVertexBuffer;
+	uint32_t				TransientVertexHead;
+	// 16 & 32 bits indices
+	FRHINullIndexBufferRef	TransientIndexBuffers[2];
+	uint32_t				TransientIndexHeads[2];
+
+	// the frame stats are folded into the totals when the next frame begins
+	FNullRendererStats	FrameStats;
+	FNullRendererStats	TotalStats;
+
+	FCPUTimerScopes		TimerScopes;
+
+	FRHINullOcclusionQueryRef	ActiveOcclusionQuery;
+	FRHINullOcclusionQueryRef	ConditionalRenderQuery;
+};
+
+#endif //__JETX_NULL_RENDERER_H__
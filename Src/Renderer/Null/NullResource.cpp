@@ -0,0 +1,395 @@
+// \brief
+//		Null RHI resources implementation.
+//
+
+#include <cassert>
+#include "NullResource.h"
+#include "NullRenderer.h"
+
+
+//////////////////////////////////////////////////////////////////////////
+// Data Buffer
+FNullBuffer::~FNullBuffer()
+{
+	if (bIsLocked)
+	{
+		Renderer->ValidationError("buffer released while it is locked");
+	}
+}
+
+bool FNullBuffer::Initialize(uint32_t InBytes, const void *InData, EBufferAccess InAccess, EBufferUsage InUsage)
+{
+	if (InBytes == 0)
+	{
+		Renderer->ValidationError("create a buffer with zero bytes");
+		return false;
+	}
+
+	Access = InAccess;
+	Usage = InUsage;
+	Memory.resize(InBytes);
+	if (InData)
+	{
+		::memcpy(&Memory[0], InData, InBytes);
+	}
+
+	return true;
+}
+
+bool FNullBuffer::FillData(uint32_t InOffset, uint32_t InBytes, const void *InData)
+{
+	if (bIsLocked)
+	{
+		Renderer->ValidationError("fill a locked buffer");
+		return false;
+	}
+	if (!InData || (uint64_t)InOffset + InBytes > Memory.size())
+	{
+		Renderer->ValidationError("fill buffer out of range: offset=%u, bytes=%u, size=%u", InOffset, InBytes, (uint32_t)Memory.size());
+		return false;
+	}
+
+	::memcpy(&Memory[InOffset], InData, InBytes);
+	return true;
+}
+
+void* FNullBuffer::Lock(uint32_t InOffset, uint32_t InBytes, EBufferLockMode InMode)
+{
+	if (bIsLocked)
+	{
+		Renderer->ValidationError("lock a buffer twice");
+		return nullptr;
+	}
+	if (InBytes == 0 || (uint64_t)InOffset + InBytes > Memory.size())
+	{
+		Renderer->ValidationError("lock buffer out of range: offset=%u, bytes=%u, size=%u", InOffset, InBytes, (uint32_t)Memory.size());
+		return nullptr;
+	}
+
+	const uint32_t kMode = InMode & BL_ModeMask;
+	if (kMode > BL_WriteNoOverwrite || (InMode & ~(BL_ModeMask | BL_FlushExplicit)))
+	{
+		Renderer->ValidationError("lock buffer with invalid mode 0x%x", (uint32_t)InMode);
+		return nullptr;
+	}
+	if (kMode == BL_ReadOnly && (InMode & BL_FlushExplicit))
+	{
+		Renderer->ValidationError("explicit flush of a buffer locked read-only");
+		return nullptr;
+	}
+
+	if (kMode == BL_WriteDiscard)
+	{
+		// the contents are undefined after a discard, make the stale reads visible.
+		::memset(&Memory[0], 0xCD, Memory.size());
+	}
+
+	bIsLocked = true;
+	LockOffset = InOffset;
+	LockBytes = InBytes;
+	LockMode = InMode;
+	FlushedBytes = 0;
+	return &Memory[InOffset];
+}
+
+bool FNullBuffer::FlushRange(uint32_t InOffset, uint32_t InBytes)
+{
+	if (!bIsLocked || !(LockMode & BL_FlushExplicit))
+	{
+		Renderer->ValidationError("flush a buffer which is not locked with BL_FlushExplicit");
+		return false;
+	}
+	if ((uint64_t)InOffset + InBytes > LockBytes)
+	{
+		Renderer->ValidationError("flush out of the locked range: offset=%u, bytes=%u, locked=%u", InOffset, InBytes, LockBytes);
+		return false;
+	}
+
+	FlushedBytes += InBytes;
+	return true;
+}
+
+bool FNullBuffer::UnLock()
+{
+	if (!bIsLocked)
+	{
+		Renderer->ValidationError("unlock a buffer which is not locked");
+		return false;
+	}
+
+	bIsLocked = false;
+	return true;
+}
+
+bool FRHINullIndexBuffer::Initialize(uint32_t InBytes, const void *InData, uint16_t InStride, EBufferAccess InAccess, EBufferUsage InUsage)
+{
+	if (InStride != sizeof(uint16_t) && InStride != sizeof(uint32_t))
+	{
+		Renderer->ValidationError("index buffer stride must be 2 or 4, got %u", InStride);
+		return false;
+	}
+	if (InBytes % InStride)
+	{
+		Renderer->ValidationError("index buffer size %u is not a multiple of stride %u", InBytes, InStride);
+		return false;
+	}
+
+	Stride = InStride;
+	return FNullBuffer::Initialize(InBytes, InData, InAccess, InUsage);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Uniform Buffer
+bool FRHINullUniformBuffer::Initialize(uint32_t InBytes, const void *InData, EBufferAccess InAccess)
+{
+	if (!FNullBuffer::Initialize(InBytes, InData, InAccess, BU_Draw))
+	{
+		return false;
+	}
+
+	// a volatile buffer has no contents until its first update
+	bWritten = InData != nullptr || !IsVolatile();
+	return true;
+}
+
+void FRHINullUniformBuffer::Update(const void *InData, uint64_t InFrame)
+{
+	::memcpy(&Memory[0], InData, Memory.size());
+	if (IsVolatile())
+	{
+		// a new range of the ring
+		Version++;
+	}
+	UpdateFrame = InFrame;
+	bWritten = true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Texture
+void FNullTexture::MarkMipsGenerated()
+{
+	for (uint32_t Layer = 0; Layer < Layers; Layer++)
+	{
+		if (WrittenMips[Layer * Mips])
+		{
+			for (uint32_t Mip = 1; Mip < Mips; Mip++)
+			{
+				WrittenMips[Layer * Mips + Mip] = true;
+			}
+		}
+	} // end for Layer
+}
+
+bool FNullTexture::IsWritten() const
+{
+	for (uint32_t Layer = 0; Layer < Layers; Layer++)
+	{
+		if (!WrittenMips[Layer * Mips])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Shaders
+static std::string MakeShaderSource(const char *InSource, int32_t InLength)
+{
+	if (!InSource)
+	{
+		return std::string();
+	}
+
+	return InLength < 0 ? std::string(InSource) : std::string(InSource, InLength);
+}
+
+FRHINullVertexShader::FRHINullVertexShader(const char *InSource, int32_t InLength)
+	: Source(MakeShaderSource(InSource, InLength))
+{
+}
+
+void FRHINullVertexShader::Dump(class FOutputDevice &OutDevice)
+{
+	OutDevice.Log(Log_Info, "Null-Shader Dump Debug Info:");
+	OutDevice.Log(Log_Info, "    Vertex Shader, %d bytes source", (int32_t)Source.size());
+}
+
+FRHINullPixelShader::FRHINullPixelShader(const char *InSource, int32_t InLength)
+	: Source(MakeShaderSource(InSource, InLength))
+{
+}
+
+void FRHINullPixelShader::Dump(class FOutputDevice &OutDevice)
+{
+	OutDevice.Log(Log_Info, "Null-Shader Dump Debug Info:");
+	OutDevice.Log(Log_Info, "    Pixel Shader, %d bytes source", (int32_t)Source.size());
+}
+
+//////////////////////////////////////////////////////////////////////////
+// GPU Program
+void FRHINullGPUProgram::AddShader(const FRHIShaderRef &InShader)
+{
+	Shaders.push_back(InShader);
+}
+
+void FRHINullGPUProgram::Dump(class FOutputDevice &OutDevice)
+{
+	OutDevice.Log(Log_Info, "Null-Program Dump Debug Info:");
+	OutDevice.Log(Log_Info, "    Shaders Count: %d", (int32_t)Shaders.size());
+	OutDevice.Log(Log_Info, "    Queried Uniforms Count: %d", (int32_t)Uniforms.size());
+	for (size_t Index = 0; Index < Uniforms.size(); Index++)
+	{
+		const FNullUniform &Element = Uniforms[Index];
+		OutDevice.Log(Log_Info, "       name=%s, bytes=%d", Element.Name.c_str(), (int32_t)Element.Data.size());
+	}
+	OutDevice.Log(Log_Info, "    Uniform Blocks Count: %d", (int32_t)UniformBlocks.size());
+	for (size_t Index = 0; Index < UniformBlocks.size(); Index++)
+	{
+		const FNullUniformBlock &Element = UniformBlocks[Index];
+		OutDevice.Log(Log_Info, "       name=%s, binding=%u", Element.Name.c_str(), Element.BindIndex);
+	}
+}
+
+bool FRHINullGPUProgram::SetUniformBufferBinding(const std::string &InBlockName, uint32_t InBindIndex)
+{
+	if (InBindIndex >= MaxUniformBufferBindings)
+	{
+		Renderer->ValidationError("uniform block %s bound to slot %u out of range", InBlockName.c_str(), InBindIndex);
+		return false;
+	}
+
+	for (size_t Index = 0; Index < UniformBlocks.size(); Index++)
+	{
+		if (UniformBlocks[Index].Name == InBlockName)
+		{
+			UniformBlocks[Index].BindIndex = InBindIndex;
+			return true;
+		}
+	}
+
+	FNullUniformBlock NewBlock;
+	NewBlock.Name = InBlockName;
+	NewBlock.BindIndex = InBindIndex;
+	UniformBlocks.push_back(NewBlock);
+	return true;
+}
+
+int32_t FRHINullGPUProgram::GetUniformHandle(const std::string &InName)
+{
+	for (size_t Index = 0; Index < Uniforms.size(); Index++)
+	{
+		if (Uniforms[Index].Name == InName)
+		{
+			return (int32_t)Index;
+		}
+	}
+
+	FNullUniform NewUniform;
+	NewUniform.Name = InName;
+	NewUniform.Modified = false;
+	Uniforms.push_back(NewUniform);
+
+	return (int32_t)Uniforms.size() - 1;
+}
+
+bool FRHINullGPUProgram::SetUniformCommon(int32_t InHandle, const void *V, uint32_t InBytes)
+{
+	if (!V || InHandle < 0 || InHandle >= (int32_t)Uniforms.size())
+	{
+		Renderer->ValidationError("set uniform with invalid handle %d", InHandle);
+		return false;
+	}
+
+	FNullUniform &Element = Uniforms[InHandle];
+	if (!Element.Data.empty() && Element.Data.size() != InBytes)
+	{
+		Renderer->ValidationError("uniform %s set with %u bytes, was %u bytes", Element.Name.c_str(), InBytes, (uint32_t)Element.Data.size());
+	}
+
+	Element.Data.resize(InBytes);
+	::memcpy(&Element.Data[0], V, InBytes);
+	Element.Modified = true;
+	return true;
+}
+
+bool FRHINullGPUProgram::SetUniform1iv(int32_t InHandle, const int32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(int32_t) * InCount);
+}
+
+bool FRHINullGPUProgram::SetUniform2iv(int32_t InHandle, const int32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(int32_t) * 2 * InCount);
+}
+
+bool FRHINullGPUProgram::SetUniform3iv(int32_t InHandle, const int32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(int32_t) * 3 * InCount);
+}
+
+bool FRHINullGPUProgram::SetUniform4iv(int32_t InHandle, const int32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(int32_t) * 4 * InCount);
+}
+
+bool FRHINullGPUProgram::SetUniform1uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(uint32_t) * InCount);
+}
+
+bool FRHINullGPUProgram::SetUniform2uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(uint32_t) * 2 * InCount);
+}
+
+bool FRHINullGPUProgram::SetUniform3uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(uint32_t) * 3 * InCount);
+}
+
+bool FRHINullGPUProgram::SetUniform4uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(uint32_t) * 4 * InCount);
+}
+
+bool FRHINullGPUProgram::SetUniform1fv(int32_t InHandle, const float *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(float) * InCount);
+}
+
+bool FRHINullGPUProgram::SetUniform2fv(int32_t InHandle, const float *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(float) * 2 * InCount);
+}
+
+bool FRHINullGPUProgram::SetUniform3fv(int32_t InHandle, const float *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(float) * 3 * InCount);
+}
+
+bool FRHINullGPUProgram::SetUniform4fv(int32_t InHandle, const float *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(float) * 4 * InCount);
+}
+
+bool FRHINullGPUProgram::SetUniformMatrix4fv(int32_t InHandle, const float *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(float) * 16 * InCount);
+}
+
+uint32_t FRHINullGPUProgram::UpdateUniformVariables()
+{
+	uint32_t UpdatedCount = 0;
+	for (size_t Index = 0; Index < Uniforms.size(); Index++)
+	{
+		FNullUniform &Element = Uniforms[Index];
+		if (Element.Modified)
+		{
+			Element.Modified = false;
+			UpdatedCount++;
+		}
+	} // end for
+
+	return UpdatedCount;
+}
@@ -0,0 +1,357 @@
+// \brief
+//		Null RHI resources. keep everything in system memory, no GPU is touched.
+//
+
+#ifndef __JETX_NULL_RESOURCE_H__
+#define __JETX_NULL_RESOURCE_H__
+
+#include <string>
+#include <vector>
+#include "Foundation/JetX.h"
+#include "Renderer/RendererDefs.h"
+#include "Renderer/RendererState.h"
+#include "Renderer/RHIResource.h"
+
+
+// state blocks, remember the initializer only.
+class FRHINullSamplerState : public FRHISamplerState
+{
+public:
+	FRHINullSamplerState(const FSamplerStateInitializerRHI &InInitializer)
+		: Initializer(InInitializer)
+	{}
+
+	FSamplerStateInitializerRHI	Initializer;
+};
+
+class FRHINullRasterizerState : public FRHIRasterizerState
+{
+public:
+	FRHINullRasterizerState(const FRasterizerStateInitializerRHI &InInitializer)
+		: Initializer(InInitializer)
+	{}
+
+	FRasterizerStateInitializerRHI	Initializer;
+};
+
+class FRHINullDepthStencilState : public FRHIDepthStencilState
+{
+public:
+	FRHINullDepthStencilState(const FDepthStencilStateInitializerRHI &InInitializer)
+		: Initializer(InInitializer)
+	{}
+
+	FDepthStencilStateInitializerRHI	Initializer;
+};
+
+class FRHINullBlendState : public FRHIBlendState
+{
+public:
+	FRHINullBlendState(const FBlendStateInitializerRHI &InInitializer)
+		: Initializer(InInitializer)
+	{}
+
+	FBlendStateInitializerRHI	Initializer;
+};
+
+// data buffer, the content lives in a system memory block.
+class FNullBuffer
+{
+public:
+	FNullBuffer(class FNullRenderer *InRenderer)
+		: Renderer(InRenderer)
+		, Access(BA_None)
+		, Usage(BU_None)
+		, bIsLocked(false)
+		, LockOffset(0)
+		, LockBytes(0)
+		, LockMode(BL_ReadOnly)
+		, FlushedBytes(0)
+	{}
+
+	virtual ~FNullBuffer();
+
+	bool Initialize(uint32_t InBytes, const void *InData, EBufferAccess InAccess, EBufferUsage InUsage);
+
+	// return false if the range is out of the buffer.
+	bool FillData(uint32_t InOffset, uint32_t InBytes, const void *InData);
+
+	void* Lock(uint32_t InOffset, uint32_t InBytes, EBufferLockMode InMode);
+	bool UnLock();
+	// locked with BL_FlushExplicit, InOffset is relative to the locked range.
+	bool FlushRange(uint32_t InOffset, uint32_t InBytes);
+
+	uint32_t GetBytes() const { return (uint32_t)Memory.size(); }
+	const uint8_t* GetData() const { return Memory.empty() ? nullptr : &Memory[0]; }
+
+public:
+	class FNullRenderer	*Renderer;
+
+	std::vector<uint8_t>	Memory;
+	EBufferAccess	Access;
+	EBufferUsage	Usage;
+	bool			bIsLocked;
+	uint32_t		LockOffset;
+	uint32_t		LockBytes;
+	EBufferLockMode	LockMode;
+	uint32_t		FlushedBytes;
+};
+
+class FRHINullVertexBuffer : public FRHIVertexBuffer, public FNullBuffer
+{
+public:
+	FRHINullVertexBuffer(class FNullRenderer *InRenderer)
+		: FNullBuffer(InRenderer)
+	{}
+
+	virtual uint32_t GetBytes() override { return FNullBuffer::GetBytes(); }
+};
+
+class FRHINullIndexBuffer : public FRHIIndexBuffer, public FNullBuffer
+{
+public:
+	FRHINullIndexBuffer(class FNullRenderer *InRenderer)
+		: FNullBuffer(InRenderer)
+		, Stride(0)
+	{}
+
+	virtual uint32_t GetBytes() override { return FNullBuffer::GetBytes(); }
+	virtual uint32_t GetIndexCount() override { return Stride ? GetBytes() / Stride : 0; }
+
+	bool Initialize(uint32_t InBytes, const void *InData, uint16_t InStride, EBufferAccess InAccess, EBufferUsage InUsage);
+
+	// the stride must be 2 or 4
+	uint16_t GetStride() const { return Stride; }
+
+protected:
+	uint16_t	Stride;
+};
+
+class FRHINullIndirectBuffer : public FRHIIndirectBuffer, public FNullBuffer
+{
+public:
+	FRHINullIndirectBuffer(class FNullRenderer *InRenderer)
+		: FNullBuffer(InRenderer)
+	{}
+
+	virtual uint32_t GetBytes() override { return FNullBuffer::GetBytes(); }
+};
+
+// uniform buffer, every update of a volatile one (BA_Dynamic/BA_Stream) is a new range to bind.
+class FRHINullUniformBuffer : public FRHIUniformBuffer, public FNullBuffer
+{
+public:
+	FRHINullUniformBuffer(class FNullRenderer *InRenderer)
+		: FNullBuffer(InRenderer)
+		, Version(0)
+		, UpdateFrame(0)
+		, bWritten(false)
+	{}
+
+	virtual uint32_t GetBytes() override { return FNullBuffer::GetBytes(); }
+
+	bool Initialize(uint32_t InBytes, const void *InData, EBufferAccess InAccess);
+	void Update(const void *InData, uint64_t InFrame);
+
+	bool IsVolatile() const { return Access != BA_Static; }
+
+	uint32_t	Version;
+	uint64_t	UpdateFrame;
+	bool		bWritten;
+};
+
+// texture, no pixel is kept: only the mips which were written.
+class FNullTexture
+{
+public:
+	FNullTexture(uint32_t InLayers, uint32_t InMips)
+		: Layers(InLayers)
+		, Mips(InMips)
+		, WrittenMips(InLayers * InMips, false)
+	{}
+
+	virtual ~FNullTexture() {}
+
+	void MarkWritten(uint32_t InMip, uint32_t InLayer) { WrittenMips[InLayer * Mips + InMip] = true; }
+	// the mips below mip 0 of the layers with a mip 0.
+	void MarkMipsGenerated();
+	// every layer has (a part of) its mip 0.
+	bool IsWritten() const;
+
+	uint32_t	Layers;
+	uint32_t	Mips;
+	std::vector<bool>	WrittenMips;
+};
+
+class FRHINullTexture2D : public FRHITexture2D, public FNullTexture
+{
+public:
+	FRHINullTexture2D(uint32_t InSizeX, uint32_t InSizeY, uint32_t InMips, EPixelFormat InFormat)
+		: FRHITexture2D(InSizeX, InSizeY, InMips, InFormat)
+		, FNullTexture(1, InMips)
+	{}
+};
+
+class FRHINullTexture2DArray : public FRHITexture2DArray, public FNullTexture
+{
+public:
+	FRHINullTexture2DArray(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat)
+		: FRHITexture2DArray(InSizeX, InSizeY, InLayers, InMips, InFormat)
+		, FNullTexture(InLayers, InMips)
+	{}
+};
+
+class FRHINullTextureCube : public FRHITextureCube, public FNullTexture
+{
+public:
+	FRHINullTextureCube(uint32_t InSize, uint32_t InMips, EPixelFormat InFormat)
+		: FRHITextureCube(InSize, InMips, InFormat)
+		, FNullTexture(CubeFace_MAX, InMips)
+	{}
+};
+
+// vertex declaration
+class FRHINullVertexDeclaration : public FRHIVertexDeclaration
+{
+public:
+	FRHINullVertexDeclaration(const FVertexElement *InVertexElements, uint32_t InCount)
+		: VertexElements(InVertexElements, InVertexElements + InCount)
+	{}
+
+	FVertexElementsList		VertexElements;
+};
+
+// shaders, keep the source for debugging.
+class FRHINullVertexShader : public FRHIVertexShader
+{
+public:
+	FRHINullVertexShader(const char *InSource, int32_t InLength);
+
+	virtual void Dump(class FOutputDevice &OutDevice) override;
+
+	std::string		Source;
+};
+
+class FRHINullPixelShader : public FRHIPixelShader
+{
+public:
+	FRHINullPixelShader(const char *InSource, int32_t InLength);
+
+	virtual void Dump(class FOutputDevice &OutDevice) override;
+
+	std::string		Source;
+};
+
+// gpu program
+// there is no compiler to reflect the uniforms, so a handle is allocated
+// the first time a name is queried.
+class FRHINullGPUProgram : public FRHIGPUProgram
+{
+public:
+	FRHINullGPUProgram(class FNullRenderer *InRenderer)
+		: Renderer(InRenderer)
+	{}
+
+	void AddShader(const FRHIShaderRef &InShader);
+
+	virtual void Dump(class FOutputDevice &OutDevice) override;
+	// get uniform parameter handle
+	virtual int32_t GetUniformHandle(const std::string &InName) override;
+
+	virtual bool SetUniform1iv(int32_t InHandle, const int32_t *V, uint32_t InCount) override;
+	virtual bool SetUniform2iv(int32_t InHandle, const int32_t *V, uint32_t InCount) override;
+	virtual bool SetUniform3iv(int32_t InHandle, const int32_t *V, uint32_t InCount) override;
+	virtual bool SetUniform4iv(int32_t InHandle, const int32_t *V, uint32_t InCount) override;
+
+	virtual bool SetUniform1uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount) override;
+	virtual bool SetUniform2uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount) override;
+	virtual bool SetUniform3uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount) override;
+	virtual bool SetUniform4uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount) override;
+
+	virtual bool SetUniform1fv(int32_t InHandle, const float *V, uint32_t InCount) override;
+	virtual bool SetUniform2fv(int32_t InHandle, const float *V, uint32_t InCount) override;
+	virtual bool SetUniform3fv(int32_t InHandle, const float *V, uint32_t InCount) override;
+	virtual bool SetUniform4fv(int32_t InHandle, const float *V, uint32_t InCount) override;
+
+	virtual bool SetUniformMatrix4fv(int32_t InHandle, const float *V, uint32_t InCount) override;
+
+	// there is no reflection, every block name is accepted.
+	virtual bool SetUniformBufferBinding(const std::string &InBlockName, uint32_t InBindIndex) override;
+
+	// count the modified uniforms and clear the flags, return the count.
+	uint32_t UpdateUniformVariables();
+
+protected:
+	bool SetUniformCommon(int32_t InHandle, const void *V, uint32_t InBytes);
+
+	struct FNullUniform
+	{
+		std::string				Name;
+		std::vector<uint8_t>	Data;
+		bool					Modified;
+	};
+
+	class FNullRenderer	*Renderer;
+
+	std::vector<FRHIShaderRef>	Shaders;
+	std::vector<FNullUniform>	Uniforms;
+
+	struct FNullUniformBlock
+	{
+		std::string		Name;
+		uint32_t		BindIndex;
+	};
+	std::vector<FNullUniformBlock>	UniformBlocks;
+};
+
+// viewport
+class FRHINullViewport : public FRHIViewport
+{
+public:
+	FRHINullViewport(void *InWindowHandle, uint32_t InSizeX, uint32_t InSizeY, bool InbIsFullscreen)
+		: WindowHandle(InWindowHandle)
+		, SizeX(InSizeX)
+		, SizeY(InSizeY)
+		, bIsFullscreen(InbIsFullscreen)
+	{}
+
+	void Resize(uint32_t InSizeX, uint32_t InSizeY, bool InbIsFullscreen)
+	{
+		SizeX = InSizeX;
+		SizeY = InSizeY;
+		bIsFullscreen = InbIsFullscreen;
+	}
+
+	void		*WindowHandle;
+	uint32_t	SizeX;
+	uint32_t	SizeY;
+	bool		bIsFullscreen;
+};
+
+// occlusion query, nothing is rasterized: the vertices of the draws are counted as the samples so
+// that they are never taken as hidden.
+class FRHINullOcclusionQuery : public FRHIOcclusionQuery
+{
+public:
+	FRHINullOcclusionQuery()
+		: Samples(0)
+		, bEnded(false)
+	{}
+
+	uint64_t	Samples;
+	bool		bEnded;
+};
+
+typedef TRefCountPtr<FRHINullSamplerState>		FRHINullSamplerStateRef;
+typedef TRefCountPtr<FRHINullRasterizerState>	FRHINullRasterizerStateRef;
+typedef TRefCountPtr<FRHINullDepthStencilState>	FRHINullDepthStencilStateRef;
+typedef TRefCountPtr<FRHINullBlendState>		FRHINullBlendStateRef;
+typedef TRefCountPtr<FRHINullVertexBuffer>		FRHINullVertexBufferRef;
+typedef TRefCountPtr<FRHINullIndexBuffer>		FRHINullIndexBufferRef;
+typedef TRefCountPtr<FRHINullUniformBuffer>		FRHINullUniformBufferRef;
+typedef TRefCountPtr<FRHINullVertexDeclaration>	FRHINullVertexDeclarationRef;
+typedef TRefCountPtr<FRHINullGPUProgram>		FRHINullGPUProgramRef;
+typedef TRefCountPtr<FRHINullViewport>			FRHINullViewportRef;
+typedef TRefCountPtr<FRHINullOcclusionQuery>	FRHINullOcclusionQueryRef;
+
+#endif // __JETX_NULL_RESOURCE_H__
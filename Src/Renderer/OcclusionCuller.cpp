@@ -0,0 +1,227 @@
+// \brief
+//		Occlusion culler implementation.
+//
+
+#include <cassert>
+#include "OcclusionCuller.h"
+
+
+// the 12 triangles of a box, counter-clockwise seen from out of it. the corner k has the max x
+// if (k & 1), the max y if (k & 2), the max z if (k & 4).
+static const uint32_t kBoxIndices[36] = {
+	0, 2, 1,  1, 2, 3,		// -z
+	4, 5, 6,  5, 7, 6,		// +z
+	0, 1, 4,  1, 5, 4,		// -y
+	2, 6, 3,  3, 6, 7,		// +y
+	0, 4, 2,  2, 4, 6,		// -x
+	1, 3, 5,  3, 7, 5		// +x
+};
+
+FOcclusionCuller::FOcclusionCuller()
+	: Renderer(nullptr)
+	, bConditionalRender(false)
+	, bInObjectDraw(false)
+	, FrameCounter(0)
+	, NearPlane(0.f)
+{
+	ViewOrigin[0] = ViewOrigin[1] = ViewOrigin[2] = 0.f;
+}
+
+FOcclusionCuller::~FOcclusionCuller()
+{
+	Release();
+}
+
+void FOcclusionCuller::Init(FRenderer *InRenderer, const FRHIGraphicsPipelineStateRef &InBoxPipelineState)
+{
+	assert(InRenderer != nullptr);
+
+	Renderer = InRenderer;
+	BoxPipelineState = InBoxPipelineState;
+	FrameCounter = 0;
+}
+
+void FOcclusionCuller::Release()
+{
+	Objects.clear();
+	BoxPipelineState.SafeRelease();
+	Renderer = nullptr;
+}
+
+uint32_t FOcclusionCuller::AddObject()
+{
+	Objects.push_back(FObject());
+	return (uint32_t)Objects.size() - 1;
+}
+
+void FOcclusionCuller::BeginFrame(const float InViewOrigin[3], float InNearPlane)
+{
+	ViewOrigin[0] = InViewOrigin[0];
+	ViewOrigin[1] = InViewOrigin[1];
+	ViewOrigin[2] = InViewOrigin[2];
+	NearPlane = InNearPlane;
+	PendingStats = FOcclusionCullerStats();
+}
+
+void FOcclusionCuller::EndFrame()
+{
+	assert(!bInObjectDraw);
+
+	for (size_t k = 0; k < Objects.size(); k++)
+	{
+		Objects[k].TestedQuery = -1;
+	} // end for k
+
+	LastFrameStats = PendingStats;
+	FrameCounter++;
+}
+
+bool FOcclusionCuller::TestObject(uint32_t InObject, const float InBoxMin[3], const float InBoxMax[3])
+{
+	assert(InObject < Objects.size() && Renderer);
+
+	FObject &Object = Objects[InObject];
+	PendingStats.Objects++;
+	PollResults(Object);
+
+	// the near plane would clip the box: it is visible
+	bool bViewInside = true;
+	for (uint32_t k = 0; k < 3; k++)
+	{
+		bViewInside = bViewInside && ViewOrigin[k] >= InBoxMin[k] - NearPlane && ViewOrigin[k] <= InBoxMax[k] + NearPlane;
+	}
+	if (bViewInside)
+	{
+		// the results in flight are older
+		Object.ResultFrame = FrameCounter;
+		Object.bResultValid = true;
+		Object.bVisible = true;
+		PendingStats.ViewInside++;
+		return true;
+	}
+
+	// an object which was not tested lately (out of the view) is visible until its next result
+	const bool bResultRecent = Object.bResultValid && FrameCounter - Object.ResultFrame <= OcclusionQueryLatency + 1;
+	const bool bVisible = !bResultRecent || Object.bVisible;
+
+	if (!DrawBox(Object, InBoxMin, InBoxMax))
+	{
+		PendingStats.QueriesBusy++;
+	}
+
+	if (!bVisible)
+	{
+		PendingStats.Culled++;
+	}
+	return bVisible;
+}
+
+void FOcclusionCuller::BeginObjectDraw(uint32_t InObject)
+{
+	assert(InObject < Objects.size() && !bInObjectDraw);
+
+	const FObject &Object = Objects[InObject];
+	if (bConditionalRender && Object.TestedQuery >= 0)
+	{
+		Renderer->RHIBeginConditionalRender(Object.Queries[Object.TestedQuery], false);
+		bInObjectDraw = true;
+		PendingStats.ConditionalDraws++;
+	}
+}
+
+void FOcclusionCuller::EndObjectDraw()
+{
+	if (bInObjectDraw)
+	{
+		Renderer->RHIEndConditionalRender();
+		bInObjectDraw = false;
+	}
+}
+
+void FOcclusionCuller::PollResults(FObject &InObject)
+{
+	// the queries end in order, the oldest is read first.
+	for (uint32_t k = 0; k < OcclusionQueryLatency; k++)
+	{
+		const uint32_t kSlot = (InObject.NextQuery + k) % OcclusionQueryLatency;
+		if (!InObject.bPending[kSlot])
+		{
+			continue;
+		}
+
+		uint64_t Samples = 0;
+		if (!Renderer->RHIGetOcclusionQueryResult(InObject.Queries[kSlot], Samples, false))
+		{
+			break;
+		}
+
+		InObject.bPending[kSlot] = false;
+		if (!InObject.bResultValid || InObject.QueryFrames[kSlot] >= InObject.ResultFrame)
+		{
+			InObject.ResultFrame = InObject.QueryFrames[kSlot];
+			InObject.bResultValid = true;
+			InObject.bVisible = Samples > 0;
+		}
+	} // end for k
+}
+
+bool FOcclusionCuller::DrawBox(FObject &InObject, const float InBoxMin[3], const float InBoxMax[3])
+{
+	const uint32_t kSlot = InObject.NextQuery;
+	if (InObject.bPending[kSlot])
+	{
+		return false;
+	}
+
+	FRHIOcclusionQueryRef &Query = InObject.Queries[kSlot];
+	if (!Query.IsValidRef())
+	{
+		Query = Renderer->RHICreateOcclusionQuery();
+		if (!Query.IsValidRef())
+		{
+			return false;
+		}
+	}
+
+	FRHIVertexBufferRef VertexBuffer;
+	FRHIIndexBufferRef IndexBuffer;
+	uint32_t FirstVertex = 0, FirstIndex = 0;
+	float *Corners = reinterpret_cast<float*>(Renderer->RHIAllocTransientVertices(8 * 3 * sizeof(float), 3 * sizeof(float), VertexBuffer, FirstVertex));
+	uint32_t *Indices = Corners ? reinterpret_cast<uint32_t*>(Renderer->RHIAllocTransientIndices(36, sizeof(uint32_t), IndexBuffer, FirstIndex)) : nullptr;
+	if (!Indices)
+	{
+		return false;
+	}
+
+	for (uint32_t k = 0; k < 8; k++)
+	{
+		Corners[k * 3 + 0] = (k & 1) ? InBoxMax[0] : InBoxMin[0];
+		Corners[k * 3 + 1] = (k & 2) ? InBoxMax[1] : InBoxMin[1];
+		Corners[k * 3 + 2] = (k & 4) ? InBoxMax[2] : InBoxMin[2];
+	} // end for k
+	for (uint32_t k = 0; k < 36; k++)
+	{
+		Indices[k] = kBoxIndices[k] + FirstVertex;
+	} // end for k
+
+	Renderer->RHISetGraphicsPipelineState(BoxPipelineState, 0, FLinearColor(0.f, 0.f, 0.f, 0.f));
+	Renderer->SetVertexStreamSource(0, VertexBuffer);
+
+	Renderer->RHIBeginOcclusionQuery(Query);
+	Renderer->DrawIndexedPrimitive(IndexBuffer, PT_Triangles, FirstIndex, 36);
+	Renderer->RHIEndOcclusionQuery(Query);
+
+	InObject.QueryFrames[kSlot] = FrameCounter;
+	InObject.bPending[kSlot] = true;
+	InObject.NextQuery = (kSlot + 1) % OcclusionQueryLatency;
+	InObject.TestedQuery = (int32_t)kSlot;
+	PendingStats.Queries++;
+	return true;
+}
+
+void FOcclusionCuller::DumpStats(FOutputDevice &OutDevice) const
+{
+	const FOcclusionCullerStats &Stats = LastFrameStats;
+	OutDevice.Log(Log_Info, "Occlusion Culler: %u objects, %u box queries, %u culled, %u with the view inside, %u without a free query, %u conditional draws",
+		Stats.Objects, Stats.Queries, Stats.Culled, Stats.ViewInside, Stats.QueriesBusy, Stats.ConditionalDraws);
+}
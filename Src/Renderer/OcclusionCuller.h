@@ -0,0 +1,127 @@
+// \brief
+//		Occlusion culler: the bounding boxes of the large meshes are drawn into occlusion queries,
+//		a mesh whose box counted no sample in a previous frame is not drawn.
+//
+
+#ifndef __JETX_OCCLUSION_CULLER_H__
+#define __JETX_OCCLUSION_CULLER_H__
+
+#include <vector>
+#include <cstring>
+#include "Foundation/JetX.h"
+#include "Foundation/OutputDevice.h"
+#include "Renderer.h"
+
+
+/** The queries of an object in flight, the results are read that many frames late at worst */
+enum { OcclusionQueryLatency = 3 };
+
+// the calls of a frame
+struct FOcclusionCullerStats
+{
+	FOcclusionCullerStats()
+	{
+		::memset(this, 0, sizeof(*this));
+	}
+
+	uint32_t	Objects;		// tested by TestObject
+	uint32_t	Queries;		// boxes drawn
+	uint32_t	Culled;			// draws skipped by a result
+	uint32_t	ViewInside;		// boxes containing the view origin, not drawn
+	uint32_t	QueriesBusy;	// no query was free, the object kept its last result
+	uint32_t	ConditionalDraws;
+};
+
+// FOcclusionCuller
+// the boxes are tested after the occluders are drawn, an object is drawn unless the latest result of its
+// box known counted no sample. the results are polled without waiting: a mesh showing up again is drawn
+// a frame or two late, unless its draw is a conditional render on the box just tested.
+//
+//	if (Culler.TestObject(Mesh.OcclusionId, Mesh.BoxMin, Mesh.BoxMax))
+//	{
+//		Culler.BeginObjectDraw(Mesh.OcclusionId);
+//		... the draws of the mesh, their states are set again ...
+//		Culler.EndObjectDraw();
+//	}
+class FOcclusionCuller
+{
+public:
+	FOcclusionCuller();
+	~FOcclusionCuller();
+
+	// InBoxPipelineState draws the boxes: float3 world positions from the stream 0, depth test without
+	// depth nor color writes. its program transforms them by the view projection of the frame, the
+	// triangles are counter-clockwise seen from out of the box.
+	void Init(FRenderer *InRenderer, const FRHIGraphicsPipelineStateRef &InBoxPipelineState);
+	void Release();
+
+	// the draws of the objects tested are conditional renders on their boxes (GPU side culling of the
+	// objects whose result was not known yet).
+	void SetConditionalRender(bool bEnable) { bConditionalRender = bEnable; }
+
+	// a new object tested across the frames, return its id.
+	uint32_t AddObject();
+
+	// InViewOrigin & InNearPlane: the boxes within the near plane of the view origin are not tested.
+	void BeginFrame(const float InViewOrigin[3], float InNearPlane);
+	void EndFrame();
+
+	// read the results of InObject, draw its box into a new query. the pipeline state & the vertex stream
+	// 0 are changed. return false if its draw is skipped.
+	bool TestObject(uint32_t InObject, const float InBoxMin[3], const float InBoxMax[3]);
+	// around the draws of an object drawn in this frame, they are a conditional render if it is enabled.
+	void BeginObjectDraw(uint32_t InObject);
+	void EndObjectDraw();
+
+	const FOcclusionCullerStats& GetLastFrameStats() const { return LastFrameStats; }
+	void DumpStats(FOutputDevice &OutDevice) const;
+
+protected:
+	struct FObject
+	{
+		FObject()
+			: NextQuery(0)
+			, ResultFrame(0)
+			, bResultValid(false)
+			, bVisible(true)
+			, TestedQuery(-1)
+		{
+			for (uint32_t k = 0; k < OcclusionQueryLatency; k++)
+			{
+				QueryFrames[k] = 0;
+				bPending[k] = false;
+			}
+		}
+
+		FRHIOcclusionQueryRef	Queries[OcclusionQueryLatency];
+		uint32_t				QueryFrames[OcclusionQueryLatency];
+		bool					bPending[OcclusionQueryLatency];
+		uint32_t				NextQuery;		// the oldest query, reused next
+
+		// the latest result known
+		uint32_t				ResultFrame;
+		bool					bResultValid;
+		bool					bVisible;
+
+		// the query drawn in this frame, -1 if none
+		int32_t					TestedQuery;
+	};
+
+	void PollResults(FObject &InObject);
+	bool DrawBox(FObject &InObject, const float InBoxMin[3], const float InBoxMax[3]);
+
+	FRenderer						*Renderer;
+	FRHIGraphicsPipelineStateRef	BoxPipelineState;
+	bool							bConditionalRender;
+	bool							bInObjectDraw;
+
+	std::vector<FObject>			Objects;
+	uint32_t						FrameCounter;
+	float							ViewOrigin[3];
+	float							NearPlane;
+
+	FOcclusionCullerStats			PendingStats;
+	FOcclusionCullerStats			LastFrameStats;
+};
+
+#endif // __JETX_OCCLUSION_CULLER_H__
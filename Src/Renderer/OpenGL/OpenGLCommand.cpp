@@ -31,6 +31,22 @@ static GLenum TranslatePrimitiveType(EPrimitiveType InType)
 	}
 }
 
+// the vertices of a primitive of a list, 0 for the strips, the fans & the loops which can't be joined.
+static uint32_t GetListPrimitiveVertices(EPrimitiveType InType)
+{
+	switch (InType)
+	{
+	case PT_Points:
+		return 1;
+	case PT_Lines:
+		return 2;
+	case PT_Triangles:
+		return 3;
+	default:
+		return 0;
+	}
+}
+
 void FOpenGLRenderer::RHISetSamplerState(uint32_t InTexIndex, const FRHISamplerStateRef &InSamplerState)
 {
 	if (InSamplerState.IsValidRef())
@@ -40,7 +56,27 @@ void FOpenGLRenderer::RHISetSamplerState(uint32_t InTexIndex, const FRHISamplerS
 		FRHIOpenGLSamplerState *OpenGLSampler = dynamic_cast<FRHIOpenGLSamplerState*>(InSamplerState.DeRef());
 		assert(OpenGLSampler != nullptr);
 
-		PendingStatesSet.TextureSamplers[InTexIndex] = OpenGLSampler;
+		// the pending states are cleared once applied
+		FRHIOpenGLSamplerState *Effective = PendingStatesSet.TextureSamplers[InTexIndex] ? PendingStatesSet.TextureSamplers[InTexIndex].DeRef() : RenderContext.TextureSamplers[InTexIndex].DeRef();
+		if (Effective != OpenGLSampler)
+		{
+			FlushDrawBatch();
+			PendingStatesSet.TextureSamplers[InTexIndex] = OpenGLSampler;
+			PendingStatesSet.DirtyBits |= 1u << (PSB_SamplerShift + InTexIndex);
+		}
+	}
+}
+
+void FOpenGLRenderer::RHISetTexture(uint32_t InTexIndex, const FRHITextureRef &InTexture)
+{
+	assert(InTexIndex < MaxTextureUnits);
+	assert(!InTexture.IsValidRef() || dynamic_cast<FOpenGLTexture*>(InTexture.DeRef()) != nullptr);
+
+	if (PendingStatesSet.Textures[InTexIndex].DeRef() != InTexture.DeRef())
+	{
+		FlushDrawBatch();
+		PendingStatesSet.Textures[InTexIndex] = InTexture;
+		PendingStatesSet.DirtyBits |= 1u << (PSB_TextureShift + InTexIndex);
 	}
 }
 
@@ -51,18 +87,34 @@ void FOpenGLRenderer::RHISetRasterizerState(const FRHIRasterizerStateRef &InRast
 		FRHIOpenGLRasterizerState *OpenGLRasterizerState = dynamic_cast<FRHIOpenGLRasterizerState*>(InRasterizerState.DeRef());
 		assert(OpenGLRasterizerState != nullptr);
 
-		PendingStatesSet.RasterizerState = OpenGLRasterizerState;
+		FRHIOpenGLRasterizerState *Effective = PendingStatesSet.RasterizerState ? PendingStatesSet.RasterizerState.DeRef() : RenderContext.RasterizerState.DeRef();
+		if (Effective != OpenGLRasterizerState)
+		{
+			FlushDrawBatch();
+			PendingStatesSet.RasterizerState = OpenGLRasterizerState;
+			PendingStatesSet.DirtyBits |= PSB_RasterizerState;
+			RenderContext.PipelineState = nullptr;
+		}
 	}
 }
 
 void FOpenGLRenderer::RHISetDepthStencilState(const FRHIDepthStencilStateRef &InDepthStencilState, int32_t InStencilRef)
 {
+	FRHIOpenGLDepthStencilState *Effective = PendingStatesSet.DepthStencilState ? PendingStatesSet.DepthStencilState.DeRef() : RenderContext.DepthStencilState.DeRef();
+	if (Effective == InDepthStencilState.DeRef() && PendingStatesSet.StencilRef == InStencilRef)
+	{
+		return;
+	}
+	FlushDrawBatch();
+
 	if (InDepthStencilState.IsValidRef())
 	{
 		FRHIOpenGLDepthStencilState *OpenGLDepthStencilState = dynamic_cast<FRHIOpenGLDepthStencilState*>(InDepthStencilState.DeRef());
 		assert(OpenGLDepthStencilState != nullptr);
 
 		PendingStatesSet.DepthStencilState = OpenGLDepthStencilState;
+		PendingStatesSet.DirtyBits |= PSB_DepthStencilState;
+		RenderContext.PipelineState = nullptr;
 	}
 
 	PendingStatesSet.StencilRef = InStencilRef;
@@ -70,17 +122,37 @@ void FOpenGLRenderer::RHISetDepthStencilState(const FRHIDepthStencilStateRef &In
 
 void FOpenGLRenderer::RHISetBlendState(const FRHIBlendStateRef &InBlendState, const FLinearColor &InBlendColor)
 {
+	FRHIOpenGLBlendState *Effective = PendingStatesSet.BlendState ? PendingStatesSet.BlendState.DeRef() : RenderContext.BlendState.DeRef();
+	if (Effective == InBlendState.DeRef() && !(PendingStatesSet.BlendColor != InBlendColor))
+	{
+		return;
+	}
+	FlushDrawBatch();
+
 	if (InBlendState.IsValidRef())
 	{
 		FRHIOpenGLBlendState *OpenGLBlendState = dynamic_cast<FRHIOpenGLBlendState*>(InBlendState.DeRef());
 		assert(OpenGLBlendState != nullptr);
 
 		PendingStatesSet.BlendState = OpenGLBlendState;
+		PendingStatesSet.DirtyBits |= PSB_BlendState;
+		RenderContext.PipelineState = nullptr;
 	}
 
 	PendingStatesSet.BlendColor = InBlendColor;
 }
 
+void FOpenGLRenderer::RHISetFrameBuffer(const FRHIFrameBufferRef &InFrameBuffer)
+{
+	FRHIOpenGLFrameBuffer *FrameBuffer = dynamic_cast<FRHIOpenGLFrameBuffer*>(InFrameBuffer.DeRef());
+	if (RenderContext.FrameBuffer.DeRef() != FrameBuffer)
+	{
+		FlushDrawBatch();
+	}
+	RenderContext.FrameBuffer = FrameBuffer;
+	CachedBindFrameBuffer(GL_DRAW_FRAMEBUFFER, FrameBuffer ? FrameBuffer->NativeResource() : 0);
+}
+
 void FOpenGLRenderer::RHISetViewport(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight, float InMinZ, float InMaxZ)
 {
 	if (InX != RenderContext.ViewportBox.x
@@ -89,6 +161,7 @@ void FOpenGLRenderer::RHISetViewport(int32_t InX, int32_t InY, int32_t InWidth,
 		|| InHeight != RenderContext.ViewportBox.height
 		)
 	{
+		FlushDrawBatch();
 		glViewport(InX, InY, InWidth, InHeight);
 		RenderContext.ViewportBox.x = InX;
 		RenderContext.ViewportBox.y = InY;
@@ -100,6 +173,7 @@ void FOpenGLRenderer::RHISetViewport(int32_t InX, int32_t InY, int32_t InWidth,
 		|| InMaxZ != RenderContext.ViewportBox.zMax
 		)
 	{
+		FlushDrawBatch();
 		glDepthRangef(InMinZ, InMaxZ);
 		RenderContext.ViewportBox.zMin = InMinZ;
 		RenderContext.ViewportBox.zMax = InMaxZ;
@@ -114,6 +188,7 @@ void FOpenGLRenderer::RHISetScissorRect(int32_t InX, int32_t InY, int32_t InWidt
 		|| InHeight != RenderContext.ScissorRect.height
 		)
 	{
+		FlushDrawBatch();
 		glScissor(InX, InY, InWidth, InHeight);
 		RenderContext.ScissorRect.x = InX;
 		RenderContext.ScissorRect.y = InY;
@@ -130,6 +205,8 @@ void FOpenGLRenderer::RHIClear(bool bClearColor, const FLinearColor &InColor, bo
 
 void FOpenGLRenderer::RHIClearMRT(bool bClearColor, const FLinearColor *InColors, uint32_t InColorsNum, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil)
 {
+	FlushDrawBatch();
+
 	if (bClearColor)
 	{
 		assert(InColorsNum <= MaxSimultaneousRenderTargets);
@@ -218,7 +295,8 @@ void FOpenGLRenderer::SetVertexStreamSource(uint32_t InStreamIndex, const FRHIVe
 
 	if (PendingStatesSet.VertexStreams[InStreamIndex].DeRef() != OpenGLVertexBuffer)
 	{
-		PendingStatesSet.VertexStreamsDirty = GL_TRUE;
+		FlushDrawBatch();
+		PendingStatesSet.DirtyBits |= PSB_VertexInputs;
 		PendingStatesSet.VertexStreams[InStreamIndex] = OpenGLVertexBuffer;
 	}
 }
@@ -228,8 +306,10 @@ void FOpenGLRenderer::SetVertexInputLayout(const FRHIVertexDeclarationRef &InVer
 	FRHIOpenGLVertexDeclaration *OpenGLVertexDecl = dynamic_cast<FRHIOpenGLVertexDeclaration*>(InVertexDecl.DeRef());
 	if (PendingStatesSet.VertexDecl.DeRef() != OpenGLVertexDecl)
 	{
-		PendingStatesSet.VertexDeclDirty = GL_TRUE;
+		FlushDrawBatch();
+		PendingStatesSet.DirtyBits |= PSB_VertexInputs;
 		PendingStatesSet.VertexDecl = OpenGLVertexDecl;
+		RenderContext.PipelineState = nullptr;
 	}
 }
 
@@ -238,17 +318,118 @@ void FOpenGLRenderer::SetGPUProgram(const FRHIGPUProgramRef &InProgram)
 	FRHIOpenGLGPUProgram *OpenGLProgram = dynamic_cast<FRHIOpenGLGPUProgram*>(InProgram.DeRef());
 	if (RenderContext.GPUProgram.DeRef() != OpenGLProgram)
 	{
-		GLuint Resource = 0;
-		if (OpenGLProgram)
-		{
-			Resource = OpenGLProgram->NativeResource();
-		}
-		glUseProgram(Resource);
+		// used by the next draw, see UpdateGPUProgram
+		FlushDrawBatch();
 		RenderContext.GPUProgram = OpenGLProgram;
+		RenderContext.PipelineState = nullptr;
+	}
+}
+
+void FOpenGLRenderer::RHISetUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer)
+{
+	assert(InBindIndex < MaxUniformBufferBindings);
+
+	FRHIOpenGLUniformBuffer *OpenGLBuffer = dynamic_cast<FRHIOpenGLUniformBuffer*>(InBuffer.DeRef());
+	if (PendingStatesSet.UniformBuffers[InBindIndex].DeRef() != OpenGLBuffer)
+	{
+		FlushDrawBatch();
+		PendingStatesSet.UniformBuffers[InBindIndex] = OpenGLBuffer;
+		PendingStatesSet.DirtyBits |= PSB_UniformBuffers;
 	}
 }
 
 // draw primitives
+void FOpenGLRenderer::RHIResolveFrameBuffer(const FRHIFrameBufferRef &InSource, const FRHIFrameBufferRef &InDest)
+{
+	FRHIOpenGLFrameBuffer *Source = dynamic_cast<FRHIOpenGLFrameBuffer*>(InSource.DeRef());
+	FRHIOpenGLFrameBuffer *Dest = dynamic_cast<FRHIOpenGLFrameBuffer*>(InDest.DeRef());
+	if (!Source || !Dest || Source == Dest)
+	{
+		return;
+	}
+
+	GLbitfield Mask = 0;
+	if (Source->GetColorTargetsNum() > 0 && Dest->GetColorTargetsNum() > 0)
+	{
+		Mask |= GL_COLOR_BUFFER_BIT;
+	}
+	if (Source->GetDepthStencilTarget().IsValid() && Dest->GetDepthStencilTarget().IsValid())
+	{
+		Mask |= GL_DEPTH_BUFFER_BIT;
+		if (Source->GetDepthStencilTarget().GetFormat() == PF_Depth24Stencil8 && Dest->GetDepthStencilTarget().GetFormat() == PF_Depth24Stencil8)
+		{
+			Mask |= GL_STENCIL_BUFFER_BIT;
+		}
+	}
+	if (Mask == 0)
+	{
+		return;
+	}
+	FlushDrawBatch();
+
+	// the blit is scissored as the draws.
+	if (RenderContext.bEnableScissorTest)
+	{
+		glDisable(GL_SCISSOR_TEST);
+	}
+
+	// the read buffer of both is the color attachment 0
+	CachedBindFrameBuffer(GL_READ_FRAMEBUFFER, Source->NativeResource());
+	CachedBindFrameBuffer(GL_DRAW_FRAMEBUFFER, Dest->NativeResource());
+	const GLint kSizeX = (GLint)Source->GetSizeX(), kSizeY = (GLint)Source->GetSizeY();
+	glBlitFramebuffer(0, 0, kSizeX, kSizeY, 0, 0, kSizeX, kSizeY, Mask, GL_NEAREST);
+	CachedBindFrameBuffer(GL_DRAW_FRAMEBUFFER, GetDrawingFrameBuffer());
+
+	if (RenderContext.bEnableScissorTest)
+	{
+		glEnable(GL_SCISSOR_TEST);
+	}
+	CheckError(__FILE__, __LINE__);
+}
+
+bool FOpenGLRenderer::UpdatePendingDrawStates()
+{
+	const uint32_t kDirtyBits = PendingStatesSet.DirtyBits;
+	if (kDirtyBits)
+	{
+		if (kDirtyBits & PSB_RasterizerState)
+		{
+			UpdatePendingRasterizerState();
+		}
+		if (kDirtyBits & PSB_Samplers)
+		{
+			UpdatePendingSamplers();
+		}
+		if (kDirtyBits & PSB_Textures)
+		{
+			UpdatePendingTextures();
+		}
+		if (kDirtyBits & PSB_DepthStencilState)
+		{
+			UpdatePendingDepthStencilState();
+		}
+		if (kDirtyBits & PSB_BlendState)
+		{
+			UpdatePendingBlendState();
+		}
+		if (kDirtyBits & PSB_VertexInputs)
+		{
+			UpdatePendingVertexInputLayout();
+		}
+		if (kDirtyBits & PSB_StreamBuffers)
+		{
+			FlushStreamBuffers();
+		}
+		if (kDirtyBits & PSB_UniformBuffers)
+		{
+			UpdatePendingUniformBuffers();
+		}
+		PendingStatesSet.DirtyBits = 0;
+	}
+
+	return UpdateGPUProgram();
+}
+
 void FOpenGLRenderer::DrawIndexedPrimitive(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount)
 {
 	FOpenGLRenderer::DrawIndexedPrimitiveInstanced(InIndexBuffer, InMode, InStart, InCount, 1);
@@ -256,18 +437,56 @@ void FOpenGLRenderer::DrawIndexedPrimitive(const FRHIIndexBufferRef &InIndexBuff
 
 void FOpenGLRenderer::DrawIndexedPrimitiveInstanced(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances)
 {
+	FRHIOpenGLIndexBuffer *OpenGLIndexBuffer = dynamic_cast<FRHIOpenGLIndexBuffer*>(InIndexBuffer.DeRef());
+	assert(OpenGLIndexBuffer);
+
+	if (bDrawMerging && InInstances == 1)
+	{
+		const GLvoid *kStartPtr = (GLvoid*)(uintptr_t)(InStart * OpenGLIndexBuffer->GetStride());
+		DrawMergeStats.Draws++;
+
+		// no state was set since the held draws, see FlushDrawBatch
+		if (!DrawBatch.Counts.empty() && DrawBatch.IndexBuffer.DeRef() == OpenGLIndexBuffer && DrawBatch.Mode == InMode)
+		{
+			const uint32_t kVerticesPerPrimitive = GetListPrimitiveVertices(InMode);
+			if (kVerticesPerPrimitive > 0 && InStart == DrawBatch.EndIndex
+				&& (InCount % kVerticesPerPrimitive) == 0 && (DrawBatch.Counts.back() % kVerticesPerPrimitive) == 0)
+			{
+				DrawBatch.Counts.back() += InCount;
+				DrawMergeStats.ContiguousMerges++;
+			}
+			else
+			{
+				DrawBatch.Counts.push_back(InCount);
+				DrawBatch.Offsets.push_back(kStartPtr);
+				DrawMergeStats.MultiDrawMerges++;
+			}
+			DrawBatch.EndIndex = InStart + InCount;
+			return;
+		}
+
+		FlushDrawBatch();
+		if (!UpdatePendingDrawStates())
+		{
+			return;
+		}
+
+		DrawBatch.IndexBuffer = OpenGLIndexBuffer;
+		DrawBatch.Mode = InMode;
+		DrawBatch.EndIndex = InStart + InCount;
+		DrawBatch.Counts.push_back(InCount);
+		DrawBatch.Offsets.push_back(kStartPtr);
+		return;
+	}
+
 	// update pending state
-	UpdatePendingRasterizerState();
-	UpdatePendingSamplers();
-	UpdatePendingDepthStencilState();
-	UpdatePendingBlendState();
-	UpdatePendingVertexInputLayout();
-	UpdateGPUProgram();
-	// TODO: update texture
+	FlushDrawBatch();
+	if (!UpdatePendingDrawStates())
+	{
+		return;
+	}
 
 	// emit draw command
-	FRHIOpenGLIndexBuffer *OpenGLIndexBuffer = dynamic_cast<FRHIOpenGLIndexBuffer*>(InIndexBuffer.DeRef());
-	assert(OpenGLIndexBuffer);
 
 	GLenum IndexType = OpenGLIndexBuffer->GetStride() == sizeof(GLushort) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
 	GLuint StartPtr = InStart * OpenGLIndexBuffer->GetStride();
@@ -285,15 +504,226 @@ void FOpenGLRenderer::DrawArrayedPrimitive(EPrimitiveType InMode, uint32_t InSta
 void FOpenGLRenderer::DrawArrayedPrimitiveInstanced(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances)
 {
 	// update pending state
-	UpdatePendingRasterizerState();
-	UpdatePendingSamplers();
-	UpdatePendingDepthStencilState();
-	UpdatePendingBlendState();
-	UpdatePendingVertexInputLayout();
-	UpdateGPUProgram();
-	// TODO: update texture
+	FlushDrawBatch();
+	if (!UpdatePendingDrawStates())
+	{
+		return;
+	}
 
 	// emit draw command
 	glDrawArraysInstanced(TranslatePrimitiveType(InMode), InStart, InCount, InInstances);
 	CheckError(__FILE__, __LINE__);
 }
+
+void FOpenGLRenderer::DrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset)
+{
+	FOpenGLRenderer::MultiDrawIndexedPrimitiveIndirect(InIndexBuffer, InMode, InArgsBuffer, InOffset, 1, 0);
+}
+
+void FOpenGLRenderer::MultiDrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t InStride)
+{
+	FRHIOpenGLIndexBuffer *OpenGLIndexBuffer = dynamic_cast<FRHIOpenGLIndexBuffer*>(InIndexBuffer.DeRef());
+	FRHIOpenGLIndirectBuffer *ArgsBuffer = dynamic_cast<FRHIOpenGLIndirectBuffer*>(InArgsBuffer.DeRef());
+	assert(OpenGLIndexBuffer);
+
+	uint32_t Stride = InStride;
+	const char *Error = CheckIndirectArgs(ArgsBuffer, InOffset, InDrawsNum, Stride);
+	if (Error)
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "indirect draw skipped: %s", Error);
+		}
+		return;
+	}
+	if (InDrawsNum == 0)
+	{
+		return;
+	}
+
+	// update pending state
+	FlushDrawBatch();
+	if (!UpdatePendingDrawStates())
+	{
+		return;
+	}
+
+	const GLenum kMode = TranslatePrimitiveType(InMode);
+	const GLuint kIndexStride = OpenGLIndexBuffer->GetStride();
+	const GLenum kIndexType = kIndexStride == sizeof(GLushort) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	CachedBindBuffer(ElementArray_Buffer, OpenGLIndexBuffer->NativeResource());
+
+	// emit draw command
+	if (cap_MultiDrawIndirect)
+	{
+		CachedBindBuffer(DrawIndirect_Buffer, ArgsBuffer->NativeResource());
+		glMultiDrawElementsIndirect(kMode, kIndexType, (GLvoid*)(uintptr_t)InOffset, InDrawsNum, InStride);
+	}
+	else if (cap_DrawIndirect)
+	{
+		CachedBindBuffer(DrawIndirect_Buffer, ArgsBuffer->NativeResource());
+		for (uint32_t k = 0; k < InDrawsNum; k++)
+		{
+			glDrawElementsIndirect(kMode, kIndexType, (GLvoid*)(uintptr_t)(InOffset + k * Stride));
+		}
+	}
+	else
+	{
+		// the base instance is dropped without ARB_base_instance
+		const uint8_t *Args = ArgsBuffer->GetSystemMemory() + InOffset;
+		for (uint32_t k = 0; k < InDrawsNum; k++, Args += Stride)
+		{
+			FDrawIndexedIndirectArgs DrawArgs;
+			::memcpy(&DrawArgs, Args, sizeof(DrawArgs));
+			if (DrawArgs.IndexCount == 0 || DrawArgs.InstanceCount == 0)
+			{
+				continue;
+			}
+
+			const GLvoid *kStartPtr = (GLvoid*)(uintptr_t)(DrawArgs.FirstIndex * kIndexStride);
+			if (cap_BaseInstance)
+			{
+				glDrawElementsInstancedBaseVertexBaseInstance(kMode, DrawArgs.IndexCount, kIndexType, kStartPtr, DrawArgs.InstanceCount, DrawArgs.BaseVertex, DrawArgs.BaseInstance);
+			}
+			else
+			{
+				glDrawElementsInstancedBaseVertex(kMode, DrawArgs.IndexCount, kIndexType, kStartPtr, DrawArgs.InstanceCount, DrawArgs.BaseVertex);
+			}
+		} // end for k
+	}
+	CheckError(__FILE__, __LINE__);
+}
+
+//GPU Profiling
+void FOpenGLRenderer::RHIBeginTimerQuery(const char *InName)
+{
+	// the held draws belong before the timestamp
+	FlushDrawBatch();
+	TimerQueries.BeginScope(InName);
+	CheckError(__FILE__, __LINE__);
+}
+
+void FOpenGLRenderer::RHIEndTimerQuery()
+{
+	FlushDrawBatch();
+	TimerQueries.EndScope();
+	CheckError(__FILE__, __LINE__);
+}
+
+bool FOpenGLRenderer::RHIGetGPUFrameTimings(FGPUFrameTimings &OutTimings)
+{
+	return TimerQueries.GetFrameTimings(OutTimings);
+}
+
+//Occlusion Queries
+void FOpenGLRenderer::RHIBeginOcclusionQuery(const FRHIOcclusionQueryRef &InQuery)
+{
+	FRHIOpenGLOcclusionQuery *Query = dynamic_cast<FRHIOpenGLOcclusionQuery*>(InQuery.DeRef());
+	if (!Query || ActiveOcclusionQuery.IsValidRef())
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, Query ? "begin an occlusion query while another one is active" : "begin an invalid occlusion query");
+		}
+		return;
+	}
+
+	// the held draws are not counted
+	FlushDrawBatch();
+	Query->Begin();
+	ActiveOcclusionQuery = Query;
+	CheckError(__FILE__, __LINE__);
+}
+
+void FOpenGLRenderer::RHIEndOcclusionQuery(const FRHIOcclusionQueryRef &InQuery)
+{
+	if (!InQuery.IsValidRef() || ActiveOcclusionQuery.DeRef() != InQuery.DeRef())
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "end an occlusion query which is not active");
+		}
+		return;
+	}
+
+	FlushDrawBatch();
+	ActiveOcclusionQuery->End();
+	ActiveOcclusionQuery.SafeRelease();
+	CheckError(__FILE__, __LINE__);
+}
+
+bool FOpenGLRenderer::RHIGetOcclusionQueryResult(const FRHIOcclusionQueryRef &InQuery, uint64_t &OutSamples, bool bWait)
+{
+	FRHIOpenGLOcclusionQuery *Query = dynamic_cast<FRHIOpenGLOcclusionQuery*>(InQuery.DeRef());
+	if (!Query || Query == ActiveOcclusionQuery.DeRef())
+	{
+		return false;
+	}
+
+	return Query->GetResult(OutSamples, bWait);
+}
+
+void FOpenGLRenderer::RHIBeginConditionalRender(const FRHIOcclusionQueryRef &InQuery, bool bWait)
+{
+	FRHIOpenGLOcclusionQuery *Query = dynamic_cast<FRHIOpenGLOcclusionQuery*>(InQuery.DeRef());
+	if (!Query || !Query->IsEnded() || Query == ActiveOcclusionQuery.DeRef() || ConditionalRenderQuery.IsValidRef())
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "conditional render on an occlusion query which is not ended, or inside another one");
+		}
+		return;
+	}
+
+	// the draws are merged only inside the same condition
+	FlushDrawBatch();
+	glBeginConditionalRender(Query->NativeResource(), bWait ? GL_QUERY_WAIT : GL_QUERY_NO_WAIT);
+	ConditionalRenderQuery = Query;
+	CheckError(__FILE__, __LINE__);
+}
+
+void FOpenGLRenderer::RHIEndConditionalRender()
+{
+	if (!ConditionalRenderQuery.IsValidRef())
+	{
+		return;
+	}
+
+	FlushDrawBatch();
+	glEndConditionalRender();
+	ConditionalRenderQuery.SafeRelease();
+	CheckError(__FILE__, __LINE__);
+}
+
+void FOpenGLRenderer::SubmitDrawBatch()
+{
+	FRHIOpenGLIndexBuffer *OpenGLIndexBuffer = DrawBatch.IndexBuffer;
+	const GLenum kMode = TranslatePrimitiveType(DrawBatch.Mode);
+	const GLenum kIndexType = OpenGLIndexBuffer->GetStride() == sizeof(GLushort) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+	// a resource creation might have bound another index buffer
+	CachedBindBuffer(ElementArray_Buffer, OpenGLIndexBuffer->NativeResource());
+	if (DrawBatch.Counts.size() == 1)
+	{
+		glDrawElements(kMode, DrawBatch.Counts[0], kIndexType, DrawBatch.Offsets[0]);
+	}
+	else
+	{
+		glMultiDrawElements(kMode, &DrawBatch.Counts[0], kIndexType, &DrawBatch.Offsets[0], (GLsizei)DrawBatch.Counts.size());
+	}
+	CheckError(__FILE__, __LINE__);
+	DrawMergeStats.Submits++;
+
+	DrawBatch.IndexBuffer.SafeRelease();
+	DrawBatch.Counts.clear();
+	DrawBatch.Offsets.clear();
+}
+
+void FOpenGLRenderer::SetDrawMergingEnabled(bool bEnabled)
+{
+	if (!bEnabled)
+	{
+		FlushDrawBatch();
+	}
+	bDrawMerging = bEnabled;
+}
@@ -37,14 +37,22 @@ static GLenum TranslateBufferAccessUsage(EBufferAccess InAccess, EBufferUsage In
 
 static GLbitfield TranslateBufferLockMode(EBufferLockMode InMode)
 {
-	switch (InMode)
+	// the explicit flush needs write access
+	const GLbitfield kFlushBit = (InMode & BL_FlushExplicit) ? GL_MAP_FLUSH_EXPLICIT_BIT : 0;
+
+	switch (InMode & BL_ModeMask)
 	{
 	case BL_ReadOnly:
+		assert(kFlushBit == 0);
 		return GL_MAP_READ_BIT;
 	case BL_WriteOnly:
-		return GL_MAP_WRITE_BIT;
+		return GL_MAP_WRITE_BIT | kFlushBit;
 	case BL_ReadWrite:
-		return (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT);
+		return (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT) | kFlushBit;
+	case BL_WriteDiscard:
+		return (GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT) | kFlushBit;
+	case BL_WriteNoOverwrite:
+		return (GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT) | kFlushBit;
 	default:
 		assert(0);
 		return (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT);
@@ -93,6 +101,41 @@ bool FOpenGLBuffer::Initialize(uint32_t InBytes, const void *InData, EBufferAcce
 	return false;
 }
 
+bool FOpenGLBuffer::InitializeStorage(uint32_t InBytes, GLbitfield InFlags)
+{
+	glGenBuffers(1, &Resource);
+	if (Resource != 0)
+	{
+		Bytes = InBytes;
+		Access = BA_Stream;
+		Usage = BU_Draw;
+
+		Bind();
+		glBufferStorage(TranslateBindTarget(Type), InBytes, nullptr, InFlags);
+		return !(Renderer->CheckError(__FILE__, __LINE__));
+	}
+
+	return false;
+}
+
+bool FOpenGLBuffer::InitializeSystemMemory(uint32_t InBytes, const void *InData, EBufferAccess InAccess)
+{
+	if (InBytes == 0)
+	{
+		return false;
+	}
+
+	Bytes = InBytes;
+	Access = InAccess;
+	Usage = BU_Draw;
+	SystemMemory.resize(InBytes);
+	if (InData)
+	{
+		::memcpy(&SystemMemory[0], InData, InBytes);
+	}
+	return true;
+}
+
 void FOpenGLBuffer::UnInit()
 {
 	if (Resource)
@@ -105,6 +148,13 @@ void FOpenGLBuffer::UnInit()
 
 void FOpenGLBuffer::FillData(uint32_t InOffset, uint32_t InBytes, const void *InData)
 {
+	if (!SystemMemory.empty())
+	{
+		assert((uint64_t)InOffset + InBytes <= SystemMemory.size());
+		::memcpy(&SystemMemory[InOffset], InData, InBytes);
+		return;
+	}
+
 	Bind();
 	glBufferSubData(TranslateBindTarget(Type), InOffset, InBytes, InData);
 	Renderer->CheckError(__FILE__, __LINE__);
@@ -115,6 +165,12 @@ void* FOpenGLBuffer::Lock(uint32_t InOffset, uint32_t InBytes, EBufferLockMode I
 {
 	assert(!bIsLocked);
 	bIsLocked = true;
+	bIsFlushExplicit = (InMode & BL_FlushExplicit) != 0;
+	if (!SystemMemory.empty())
+	{
+		assert((uint64_t)InOffset + InBytes <= SystemMemory.size());
+		return &SystemMemory[InOffset];
+	}
 
 	Bind();
 	void *pData = nullptr;
@@ -128,12 +184,30 @@ void FOpenGLBuffer::UnLock()
 {
 	assert(bIsLocked);
 	bIsLocked = false;
+	bIsFlushExplicit = false;
+	if (!SystemMemory.empty())
+	{
+		return;
+	}
 
 	Bind();
 	glUnmapBuffer(TranslateBindTarget(Type));
 	Renderer->CheckError(__FILE__, __LINE__);
 }
 
+void FOpenGLBuffer::FlushRange(uint32_t InOffset, uint32_t InBytes)
+{
+	assert(bIsLocked && bIsFlushExplicit);
+	if (!SystemMemory.empty())
+	{
+		return;
+	}
+
+	Bind();
+	glFlushMappedBufferRange(TranslateBindTarget(Type), InOffset, InBytes);
+	Renderer->CheckError(__FILE__, __LINE__);
+}
+
 // Active it
 void FOpenGLBuffer::Bind()
 {
@@ -149,8 +223,9 @@ FRHIOpenGLVertexBuffer::FRHIOpenGLVertexBuffer(class FOpenGLRenderer *InRenderer
 
 //////////////////////////////////////////////////////////////////////////
 // Index Buffer
-FRHIOpenGLIndexBuffer::FRHIOpenGLIndexBuffer(class FOpenGLRenderer *InRenderer)
+FRHIOpenGLIndexBuffer::FRHIOpenGLIndexBuffer(class FOpenGLRenderer *InRenderer, uint16_t InStride)
 	: FOpenGLBuffer(InRenderer, ElementArray_Buffer)
+	, Stride(InStride)
 {
 }
 
@@ -164,3 +239,10 @@ uint32_t FRHIOpenGLIndexBuffer::GetIndexCount()
 {
 	return (Bytes / Stride);
 }
+
+//////////////////////////////////////////////////////////////////////////
+// Indirect Buffer
+FRHIOpenGLIndirectBuffer::FRHIOpenGLIndirectBuffer(class FOpenGLRenderer *InRenderer)
+	: FOpenGLBuffer(InRenderer, DrawIndirect_Buffer)
+{
+}
@@ -5,6 +5,7 @@
 #ifndef __JETX_OPENGL_DATA_BUFFER_H__
 #define __JETX_OPENGL_DATA_BUFFER_H__
 
+#include <vector>
 #include "Renderer/RendererDefs.h"
 #include "Renderer/RHIResource.h"
 #include "PlatformOpenGL.h"
@@ -38,11 +39,16 @@ public:
 		, Access(BA_None)
 		, Usage(BU_None)
 		, bIsLocked(false)
+		, bIsFlushExplicit(false)
 	{}
 	
 	virtual ~FOpenGLBuffer();
 
 	bool Initialize(uint32_t InBytes, const void *InData, EBufferAccess InAccess, EBufferUsage InUsage);
+	// immutable storage (ARB_buffer_storage), InFlags are the GL_MAP_* bits the buffer may be mapped with.
+	bool InitializeStorage(uint32_t InBytes, GLbitfield InFlags);
+	// no GL buffer, the contents are only read on the CPU (the indirect arguments without ARB_draw_indirect).
+	bool InitializeSystemMemory(uint32_t InBytes, const void *InData, EBufferAccess InAccess);
 	void UnInit();
 
 	void FillData(uint32_t InOffset, uint32_t InBytes, const void *InData);
@@ -50,10 +56,13 @@ public:
 	// Lock Buffer
 	void* Lock(uint32_t InOffset, uint32_t InBytes, EBufferLockMode InMode);
 	void UnLock();
+	// locked with BL_FlushExplicit, InOffset is relative to the locked range.
+	void FlushRange(uint32_t InOffset, uint32_t InBytes);
 
 	// Active it
 	void Bind();
 	GLuint NativeResource() const { return Resource; }
+	const uint8_t* GetSystemMemory() const { return SystemMemory.empty() ? nullptr : &SystemMemory[0]; }
 
 	static GLenum TranslateBindTarget(EBufferBindTarget InTarget);
 public:
@@ -65,6 +74,8 @@ public:
 	EBufferAccess	Access;
 	EBufferUsage	Usage;
 	bool			bIsLocked;
+	bool			bIsFlushExplicit;
+	std::vector<uint8_t>	SystemMemory;
 };
 
 // Vertex Buffer
@@ -74,15 +85,18 @@ public:
 	FRHIOpenGLVertexBuffer(class FOpenGLRenderer *InRenderer);
 	virtual ~FRHIOpenGLVertexBuffer() {}
 
+	virtual uint32_t GetBytes() override { return Bytes; }
+
 };
 
 // Index Buffer
 class FRHIOpenGLIndexBuffer : public FRHIIndexBuffer, public FOpenGLBuffer
 {
 public:
-	FRHIOpenGLIndexBuffer(class FOpenGLRenderer *InRenderer);
+	FRHIOpenGLIndexBuffer(class FOpenGLRenderer *InRenderer, uint16_t InStride = 0);
 	virtual ~FRHIOpenGLIndexBuffer() {}
 
+	virtual uint32_t GetBytes() override { return Bytes; }
 	virtual uint32_t GetIndexCount() override;
 
 	bool Initialize(uint32_t InBytes, const void *InData, uint16_t InStride, EBufferAccess InAccess, EBufferUsage InUsage);
@@ -94,7 +108,18 @@ protected:
 	uint16_t		Stride;
 };
 
+// Indirect Buffer
+class FRHIOpenGLIndirectBuffer : public FRHIIndirectBuffer, public FOpenGLBuffer
+{
+public:
+	FRHIOpenGLIndirectBuffer(class FOpenGLRenderer *InRenderer);
+	virtual ~FRHIOpenGLIndirectBuffer() {}
+
+	virtual uint32_t GetBytes() override { return Bytes; }
+};
+
 typedef TRefCountPtr<FRHIOpenGLVertexBuffer>	FRHIOpenGLVertexBufferRef;
 typedef TRefCountPtr<FRHIOpenGLIndexBuffer>		FRHIOpenGLIndexBufferRef;
+typedef TRefCountPtr<FRHIOpenGLIndirectBuffer>	FRHIOpenGLIndirectBufferRef;
 
 #endif // __JETX_OPENGL_DATA_BUFFER_H__
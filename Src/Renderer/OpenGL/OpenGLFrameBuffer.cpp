@@ -0,0 +1,133 @@
+// \brief
+//		OpenGL Render Buffer & Frame Buffer implementation.
+//
+
+#include <cassert>
+#include "OpenGLRenderer.h"
+#include "OpenGLFrameBuffer.h"
+
+
+// Render Buffer
+FRHIOpenGLRenderBuffer::~FRHIOpenGLRenderBuffer()
+{
+	if (Resource)
+	{
+		glDeleteRenderbuffers(1, &Resource);
+		Resource = 0;
+	}
+}
+
+bool FRHIOpenGLRenderBuffer::Initialize()
+{
+	FOpenGLPixelFormat GLFormat;
+	if (!FOpenGLTexture::TranslatePixelFormat(Format, GLFormat))
+	{
+		return false;
+	}
+
+	glGenRenderbuffers(1, &Resource);
+	if (Resource == 0)
+	{
+		return false;
+	}
+
+	glBindRenderbuffer(GL_RENDERBUFFER, Resource);
+	if (Samples > 1)
+	{
+		glRenderbufferStorageMultisample(GL_RENDERBUFFER, Samples, GLFormat.InternalFormat, SizeX, SizeY);
+	}
+	else
+	{
+		glRenderbufferStorage(GL_RENDERBUFFER, GLFormat.InternalFormat, SizeX, SizeY);
+	}
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	return !(Renderer->CheckError(__FILE__, __LINE__));
+}
+
+// Frame Buffer
+FRHIOpenGLFrameBuffer::~FRHIOpenGLFrameBuffer()
+{
+	if (Resource)
+	{
+		glDeleteFramebuffers(1, &Resource);
+		Renderer->OnFrameBufferDeleted(Resource);
+		Resource = 0;
+	}
+}
+
+bool FRHIOpenGLFrameBuffer::Initialize()
+{
+	glGenFramebuffers(1, &Resource);
+	if (Resource == 0)
+	{
+		return false;
+	}
+
+	Renderer->CachedBindFrameBuffer(GL_DRAW_FRAMEBUFFER, Resource);
+
+	bool bAttached = true;
+	GLenum DrawBuffers[MaxSimultaneousRenderTargets];
+	for (uint32_t k = 0; k < ColorTargetsNum; k++)
+	{
+		DrawBuffers[k] = GL_COLOR_ATTACHMENT0 + k;
+		bAttached = bAttached && AttachTarget(GL_COLOR_ATTACHMENT0 + k, ColorTargets[k]);
+	} // end for k
+	if (DepthStencilTarget.IsValid())
+	{
+		const GLenum kAttachment = DepthStencilTarget.GetFormat() == PF_Depth24Stencil8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+		bAttached = bAttached && AttachTarget(kAttachment, DepthStencilTarget);
+	}
+
+	// a depth only frame buffer has no color buffer to draw or to read.
+	if (ColorTargetsNum > 0)
+	{
+		glDrawBuffers(ColorTargetsNum, DrawBuffers);
+		glReadBuffer(GL_COLOR_ATTACHMENT0);
+	}
+	else
+	{
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+	}
+
+	const GLenum kStatus = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
+	Renderer->CachedBindFrameBuffer(GL_DRAW_FRAMEBUFFER, Renderer->GetDrawingFrameBuffer());
+
+	return bAttached && kStatus == GL_FRAMEBUFFER_COMPLETE && !(Renderer->CheckError(__FILE__, __LINE__));
+}
+
+bool FRHIOpenGLFrameBuffer::AttachTarget(GLenum InAttachment, const FRHIRenderTargetView &InView)
+{
+	if (InView.RenderBuffer.IsValidRef())
+	{
+		FRHIOpenGLRenderBuffer *RenderBuffer = dynamic_cast<FRHIOpenGLRenderBuffer*>(InView.RenderBuffer.DeRef());
+		if (!RenderBuffer)
+		{
+			return false;
+		}
+		glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, InAttachment, GL_RENDERBUFFER, RenderBuffer->NativeResource());
+		return true;
+	}
+
+	FOpenGLTexture *Texture = dynamic_cast<FOpenGLTexture*>(InView.Texture.DeRef());
+	if (!Texture)
+	{
+		return false;
+	}
+
+	switch (Texture->GetTarget())
+	{
+	case GL_TEXTURE_2D_ARRAY:
+		glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, InAttachment, Texture->NativeResource(), InView.MipIndex, InView.LayerIndex);
+		break;
+	case GL_TEXTURE_CUBE_MAP:
+		assert(InView.LayerIndex < CubeFace_MAX);
+		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, InAttachment, GL_TEXTURE_CUBE_MAP_POSITIVE_X + InView.LayerIndex, Texture->NativeResource(), InView.MipIndex);
+		break;
+	default:
+		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, InAttachment, Texture->GetTarget(), Texture->NativeResource(), InView.MipIndex);
+		break;
+	}
+	return true;
+}
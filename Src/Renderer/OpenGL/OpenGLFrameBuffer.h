@@ -0,0 +1,59 @@
+//\brief
+//		OpenGL Resource: Render Buffer & Frame Buffer
+//
+
+#ifndef __JETX_OPENGL_FRAMEBUFFER_H__
+#define __JETX_OPENGL_FRAMEBUFFER_H__
+
+#include "Renderer/RendererDefs.h"
+#include "Renderer/RHIResource.h"
+#include "PlatformOpenGL.h"
+
+
+// Render Buffer
+class FRHIOpenGLRenderBuffer : public FRHIRenderBuffer
+{
+public:
+	FRHIOpenGLRenderBuffer(class FOpenGLRenderer *InRenderer, uint32_t InSizeX, uint32_t InSizeY, EPixelFormat InFormat, uint32_t InSamples)
+		: FRHIRenderBuffer(InSizeX, InSizeY, InFormat, InSamples)
+		, Renderer(InRenderer)
+		, Resource(0)
+	{}
+	virtual ~FRHIOpenGLRenderBuffer();
+
+	bool Initialize();
+
+	GLuint NativeResource() const { return Resource; }
+
+protected:
+	class FOpenGLRenderer	*Renderer;
+	GLuint					Resource;
+};
+
+// Frame Buffer
+// the framebuffer object is complete once initialized, binding it only switches the draw target.
+class FRHIOpenGLFrameBuffer : public FRHIFrameBuffer
+{
+public:
+	FRHIOpenGLFrameBuffer(class FOpenGLRenderer *InRenderer, const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget)
+		: FRHIFrameBuffer(InColorTargets, InColorTargetsNum, InDepthStencilTarget)
+		, Renderer(InRenderer)
+		, Resource(0)
+	{}
+	virtual ~FRHIOpenGLFrameBuffer();
+
+	bool Initialize();
+
+	GLuint NativeResource() const { return Resource; }
+
+protected:
+	bool AttachTarget(GLenum InAttachment, const FRHIRenderTargetView &InView);
+
+	class FOpenGLRenderer	*Renderer;
+	GLuint					Resource;
+};
+
+typedef TRefCountPtr<FRHIOpenGLRenderBuffer>	FRHIOpenGLRenderBufferRef;
+typedef TRefCountPtr<FRHIOpenGLFrameBuffer>		FRHIOpenGLFrameBufferRef;
+
+#endif // __JETX_OPENGL_FRAMEBUFFER_H__
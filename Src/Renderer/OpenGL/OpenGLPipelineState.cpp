@@ -0,0 +1,352 @@
+// \brief
+//		methods for GL pipeline-state creating & switching
+//
+
+#include <cassert>
+#include <algorithm>
+
+#include "OpenGLPipelineState.h"
+#include "OpenGLRenderer.h"
+
+
+FRHIOpenGLGraphicsPipelineState::FRHIOpenGLGraphicsPipelineState(class FOpenGLRenderer *InRenderer, const FGraphicsPipelineStateInitializerRHI &InInitializer)
+	: FRHIGraphicsPipelineState(InInitializer)
+	, Renderer(InRenderer)
+	, Serial(0)
+{
+	RasterizerState = dynamic_cast<FRHIOpenGLRasterizerState*>(Initializer.RasterizerState.DeRef());
+	DepthStencilState = dynamic_cast<FRHIOpenGLDepthStencilState*>(Initializer.DepthStencilState.DeRef());
+	BlendState = dynamic_cast<FRHIOpenGLBlendState*>(Initializer.BlendState.DeRef());
+	GPUProgram = dynamic_cast<FRHIOpenGLGPUProgram*>(Initializer.GPUProgram.DeRef());
+	VertexDecl = dynamic_cast<FRHIOpenGLVertexDeclaration*>(Initializer.VertexDecl.DeRef());
+}
+
+uint64_t FRHIOpenGLGraphicsPipelineState::ComputeDiff(const FRHIOpenGLGraphicsPipelineState *InOther) const
+{
+	uint64_t Diff = 0;
+
+	const FOpenGLRasterizerStateData &Rasterizer = RasterizerState->Data;
+	const FOpenGLRasterizerStateData &OtherRasterizer = InOther->RasterizerState->Data;
+	if (Rasterizer.FillMode != OtherRasterizer.FillMode)
+	{
+		Diff |= PSD_PolygonMode;
+	}
+	if (Rasterizer.CullMode != OtherRasterizer.CullMode)
+	{
+		Diff |= PSD_CullFace;
+	}
+	if (Rasterizer.bEnableDepthOffset != OtherRasterizer.bEnableDepthOffset)
+	{
+		Diff |= PSD_PolygonOffsetFill;
+	}
+	if (Rasterizer.DepthOffsetFactor != OtherRasterizer.DepthOffsetFactor
+		|| Rasterizer.DepthOffsetUnits != OtherRasterizer.DepthOffsetUnits)
+	{
+		Diff |= PSD_PolygonOffset;
+	}
+
+	const FOpenGLDepthStencilStateData &DepthStencil = DepthStencilState->Data;
+	const FOpenGLDepthStencilStateData &OtherDepthStencil = InOther->DepthStencilState->Data;
+	if (DepthStencil.bEnableZTest != OtherDepthStencil.bEnableZTest)
+	{
+		Diff |= PSD_DepthTest;
+	}
+	if (DepthStencil.ZFunc != OtherDepthStencil.ZFunc)
+	{
+		Diff |= PSD_DepthFunc;
+	}
+	if (DepthStencil.bEnableZWrite != OtherDepthStencil.bEnableZWrite)
+	{
+		Diff |= PSD_DepthMask;
+	}
+	if (DepthStencil.bEnableStencilTest != OtherDepthStencil.bEnableStencilTest)
+	{
+		Diff |= PSD_StencilTest;
+	}
+	if (DepthStencil.FrontFaceStencilCompFunc != OtherDepthStencil.FrontFaceStencilCompFunc
+		|| DepthStencil.StencilReadMask != OtherDepthStencil.StencilReadMask)
+	{
+		Diff |= PSD_StencilFuncFront;
+	}
+	if (DepthStencil.FrontFaceStencilFailOp != OtherDepthStencil.FrontFaceStencilFailOp
+		|| DepthStencil.FrontFaceDepthFailOp != OtherDepthStencil.FrontFaceDepthFailOp
+		|| DepthStencil.FrontFaceDepthPassOp != OtherDepthStencil.FrontFaceDepthPassOp)
+	{
+		Diff |= PSD_StencilOpFront;
+	}
+	if (DepthStencil.BackFaceStencilCompFunc != OtherDepthStencil.BackFaceStencilCompFunc
+		|| DepthStencil.StencilReadMask != OtherDepthStencil.StencilReadMask)
+	{
+		Diff |= PSD_StencilFuncBack;
+	}
+	if (DepthStencil.BackFaceStencilFailOp != OtherDepthStencil.BackFaceStencilFailOp
+		|| DepthStencil.BackFaceDepthFailOp != OtherDepthStencil.BackFaceDepthFailOp
+		|| DepthStencil.BackFaceDepthPassOp != OtherDepthStencil.BackFaceDepthPassOp)
+	{
+		Diff |= PSD_StencilOpBack;
+	}
+	if (DepthStencil.StencilWriteMask != OtherDepthStencil.StencilWriteMask)
+	{
+		Diff |= PSD_StencilMask;
+	}
+
+	// the targets after TargetsNum keep their default blend state
+	for (uint32_t k = 0; k < MaxSimultaneousRenderTargets; k++)
+	{
+		const FOpenGLBlendStateData::FRenderTagertBlendState &Target = BlendState->Data.RenderTargetBlendStates[k];
+		const FOpenGLBlendStateData::FRenderTagertBlendState &OtherTarget = InOther->BlendState->Data.RenderTargetBlendStates[k];
+		uint64_t TargetDiff = 0;
+
+		if (Target.bEnableAlphaBlend != OtherTarget.bEnableAlphaBlend)
+		{
+			TargetDiff |= PSD_Blend;
+		}
+		if (Target.ColorBlendOp != OtherTarget.ColorBlendOp
+			|| Target.AlphaBlendOp != OtherTarget.AlphaBlendOp)
+		{
+			TargetDiff |= PSD_BlendEquation;
+		}
+		if (Target.ColorSrcFactor != OtherTarget.ColorSrcFactor
+			|| Target.ColorDstFactor != OtherTarget.ColorDstFactor
+			|| Target.AlphaSrcFactor != OtherTarget.AlphaSrcFactor
+			|| Target.AlphaDstFactor != OtherTarget.AlphaDstFactor)
+		{
+			TargetDiff |= PSD_BlendFunc;
+		}
+		if (Target.bEnableWriteR != OtherTarget.bEnableWriteR
+			|| Target.bEnableWriteG != OtherTarget.bEnableWriteG
+			|| Target.bEnableWriteB != OtherTarget.bEnableWriteB
+			|| Target.bEnableWriteA != OtherTarget.bEnableWriteA)
+		{
+			TargetDiff |= PSD_ColorMask;
+		}
+
+		Diff |= TargetDiff << (PSD_BlendTargetShift + PSD_BlendTargetBits * k);
+	} // end for k
+
+	return Diff;
+}
+
+uint64_t FRHIOpenGLGraphicsPipelineState::GetTransition(FRHIOpenGLGraphicsPipelineState *InOther)
+{
+	// the diff is symmetric, the newer state keeps it.
+	if (InOther->Serial > Serial)
+	{
+		return InOther->GetTransition(this);
+	}
+
+	std::unordered_map<uint32_t, uint64_t>::const_iterator It = Transitions.find(InOther->Serial);
+	if (It != Transitions.end())
+	{
+		return It->second;
+	}
+
+	const uint64_t Diff = ComputeDiff(InOther);
+	Transitions.insert(std::make_pair(InOther->Serial, Diff));
+	return Diff;
+}
+
+//Pipeline State Creating
+FRHIGraphicsPipelineStateRef FOpenGLRenderer::RHICreateGraphicsPipelineState(const FGraphicsPipelineStateInitializerRHI &PipelineStateInitializer)
+{
+	FRHIGraphicsPipelineStateRef *Cached = PipelineStateCache.Find(PipelineStateInitializer);
+	if (Cached)
+	{
+		return *Cached;
+	}
+
+	FRHIOpenGLGraphicsPipelineState *PipelineState = new FRHIOpenGLGraphicsPipelineState(this, PipelineStateInitializer);
+	if (PipelineState == nullptr)
+	{
+		return FRHIGraphicsPipelineStateRef();
+	}
+	assert(PipelineState->RasterizerState && PipelineState->DepthStencilState && PipelineState->BlendState);
+
+	// the switches are diffed once per pair, see GetTransition.
+	PipelineState->Serial = PipelineStatesNum++;
+
+	// add to cache
+	PipelineStateCache.Add(PipelineStateInitializer, PipelineState);
+	return PipelineState;
+}
+
+//Pipeline State Setting
+void FOpenGLRenderer::RHISetGraphicsPipelineState(const FRHIGraphicsPipelineStateRef &InPipelineState, int32_t InStencilRef, const FLinearColor &InBlendColor)
+{
+	FRHIOpenGLGraphicsPipelineState *Pending = dynamic_cast<FRHIOpenGLGraphicsPipelineState*>(InPipelineState.DeRef());
+	if (!Pending)
+	{
+		return;
+	}
+
+	FRHIOpenGLGraphicsPipelineState *Current = RenderContext.PipelineState;
+	if (Pending != Current || RenderContext.StencilRef != InStencilRef || RenderContext.BlendColor != InBlendColor)
+	{
+		FlushDrawBatch();
+	}
+
+	if (Pending != Current)
+	{
+		uint64_t Diff = PSD_All;
+		if (Current)
+		{
+			Diff = Pending->GetTransition(Current);
+		}
+
+		ApplyPipelineState(Pending, Diff, InStencilRef);
+	}
+	else if (RenderContext.StencilRef != InStencilRef)
+	{
+		const FOpenGLDepthStencilStateData &DepthStencil = Pending->DepthStencilState->Data;
+		glStencilFuncSeparate(GL_FRONT, DepthStencil.FrontFaceStencilCompFunc, InStencilRef, DepthStencil.StencilReadMask);
+		glStencilFuncSeparate(GL_BACK, DepthStencil.BackFaceStencilCompFunc, InStencilRef, DepthStencil.StencilReadMask);
+	}
+
+	if (RenderContext.BlendColor != InBlendColor)
+	{
+		glBlendColor(InBlendColor.R, InBlendColor.G, InBlendColor.B, InBlendColor.A);
+	}
+
+	RenderContext.StencilRef = InStencilRef;
+	RenderContext.BlendColor = InBlendColor;
+	PendingStatesSet.StencilRef = InStencilRef;
+	PendingStatesSet.BlendColor = InBlendColor;
+}
+
+void FOpenGLRenderer::ApplyPipelineState(FRHIOpenGLGraphicsPipelineState *InPipelineState, uint64_t InDiff, GLint InStencilRef)
+{
+	const FOpenGLRasterizerStateData &Rasterizer = InPipelineState->RasterizerState->Data;
+	if (InDiff & PSD_PolygonMode)
+	{
+		glPolygonMode(GL_FRONT_AND_BACK, Rasterizer.FillMode);
+	}
+	if (InDiff & PSD_CullFace)
+	{
+		glCullFace(Rasterizer.CullMode);
+	}
+	if (InDiff & PSD_PolygonOffsetFill)
+	{
+		if (Rasterizer.bEnableDepthOffset)
+		{
+			glEnable(GL_POLYGON_OFFSET_FILL);
+		}
+		else
+		{
+			glDisable(GL_POLYGON_OFFSET_FILL);
+		}
+	}
+	if (InDiff & PSD_PolygonOffset)
+	{
+		glPolygonOffset(Rasterizer.DepthOffsetFactor, Rasterizer.DepthOffsetUnits);
+	}
+
+	const FOpenGLDepthStencilStateData &DepthStencil = InPipelineState->DepthStencilState->Data;
+	if (InDiff & PSD_DepthTest)
+	{
+		if (DepthStencil.bEnableZTest)
+		{
+			glEnable(GL_DEPTH_TEST);
+		}
+		else
+		{
+			glDisable(GL_DEPTH_TEST);
+		}
+	}
+	if (InDiff & PSD_DepthFunc)
+	{
+		glDepthFunc(DepthStencil.ZFunc);
+	}
+	if (InDiff & PSD_DepthMask)
+	{
+		glDepthMask(DepthStencil.bEnableZWrite);
+	}
+	if (InDiff & PSD_StencilTest)
+	{
+		if (DepthStencil.bEnableStencilTest)
+		{
+			glEnable(GL_STENCIL_TEST);
+		}
+		else
+		{
+			glDisable(GL_STENCIL_TEST);
+		}
+	}
+	// the reference value is not part of the state
+	const bool bStencilRefDirty = RenderContext.StencilRef != InStencilRef;
+	if ((InDiff & PSD_StencilFuncFront) || bStencilRefDirty)
+	{
+		glStencilFuncSeparate(GL_FRONT, DepthStencil.FrontFaceStencilCompFunc, InStencilRef, DepthStencil.StencilReadMask);
+	}
+	if (InDiff & PSD_StencilOpFront)
+	{
+		glStencilOpSeparate(GL_FRONT, DepthStencil.FrontFaceStencilFailOp, DepthStencil.FrontFaceDepthFailOp, DepthStencil.FrontFaceDepthPassOp);
+	}
+	if ((InDiff & PSD_StencilFuncBack) || bStencilRefDirty)
+	{
+		glStencilFuncSeparate(GL_BACK, DepthStencil.BackFaceStencilCompFunc, InStencilRef, DepthStencil.StencilReadMask);
+	}
+	if (InDiff & PSD_StencilOpBack)
+	{
+		glStencilOpSeparate(GL_BACK, DepthStencil.BackFaceStencilFailOp, DepthStencil.BackFaceDepthFailOp, DepthStencil.BackFaceDepthPassOp);
+	}
+	if (InDiff & PSD_StencilMask)
+	{
+		glStencilMask(DepthStencil.StencilWriteMask);
+	}
+
+	const FOpenGLBlendStateData &Blend = InPipelineState->BlendState->Data;
+	for (uint32_t k = 0; k < MaxSimultaneousRenderTargets; k++)
+	{
+		const uint64_t TargetDiff = (InDiff >> (PSD_BlendTargetShift + PSD_BlendTargetBits * k)) & ((1 << PSD_BlendTargetBits) - 1);
+		if (!TargetDiff)
+		{
+			continue;
+		}
+
+		const FOpenGLBlendStateData::FRenderTagertBlendState &Target = Blend.RenderTargetBlendStates[k];
+		if (TargetDiff & PSD_Blend)
+		{
+			if (Target.bEnableAlphaBlend)
+			{
+				glEnablei(GL_BLEND, k);
+			}
+			else
+			{
+				glDisablei(GL_BLEND, k);
+			}
+		}
+		if (TargetDiff & PSD_BlendEquation)
+		{
+			glBlendEquationSeparatei(k, Target.ColorBlendOp, Target.AlphaBlendOp);
+		}
+		if (TargetDiff & PSD_BlendFunc)
+		{
+			glBlendFuncSeparatei(k, Target.ColorSrcFactor, Target.ColorDstFactor, Target.AlphaSrcFactor, Target.AlphaDstFactor);
+		}
+		if (TargetDiff & PSD_ColorMask)
+		{
+			glColorMaski(k, Target.bEnableWriteR, Target.bEnableWriteG, Target.bEnableWriteB, Target.bEnableWriteA);
+		}
+	} // end for k
+
+	// used by the next draw, see UpdateGPUProgram
+	RenderContext.GPUProgram = InPipelineState->GPUProgram;
+	if (PendingStatesSet.VertexDecl.DeRef() != InPipelineState->VertexDecl)
+	{
+		PendingStatesSet.DirtyBits |= PSB_VertexInputs;
+		PendingStatesSet.VertexDecl = InPipelineState->VertexDecl;
+	}
+	CheckError(__FILE__, __LINE__);
+
+	// keep the separate states in sync, the draws find nothing pending.
+	RenderContext.RasterizerState = InPipelineState->RasterizerState;
+	RenderContext.DepthStencilState = InPipelineState->DepthStencilState;
+	RenderContext.BlendState = InPipelineState->BlendState;
+	RenderContext.BlendStateCache = Blend;
+	PendingStatesSet.RasterizerState = nullptr;
+	PendingStatesSet.DepthStencilState = nullptr;
+	PendingStatesSet.BlendState = nullptr;
+	PendingStatesSet.DirtyBits &= ~(PSB_RasterizerState | PSB_DepthStencilState | PSB_BlendState);
+
+	RenderContext.PipelineState = InPipelineState;
+}
@@ -0,0 +1,73 @@
+//\brief
+//		OpenGL graphics pipeline state.
+//
+
+#ifndef __JETX_OPENGL_PIPELINE_STATE_H__
+#define __JETX_OPENGL_PIPELINE_STATE_H__
+
+#include <unordered_map>
+#include "Renderer/RendererDefs.h"
+#include "Renderer/RHIResource.h"
+#include "PlatformOpenGL.h"
+#include "OpenGLState.h"
+#include "OpenGLShader.h"
+#include "OpenGLVertexDeclaration.h"
+
+
+// the GL calls to switch between two pipeline states.
+enum EOpenGLPipelineStateDiff
+{
+	PSD_PolygonMode			= 1 << 0,
+	PSD_CullFace			= 1 << 1,
+	PSD_PolygonOffsetFill	= 1 << 2,
+	PSD_PolygonOffset		= 1 << 3,
+
+	PSD_DepthTest			= 1 << 4,
+	PSD_DepthFunc			= 1 << 5,
+	PSD_DepthMask			= 1 << 6,
+	PSD_StencilTest			= 1 << 7,
+	PSD_StencilFuncFront	= 1 << 8,
+	PSD_StencilOpFront		= 1 << 9,
+	PSD_StencilFuncBack		= 1 << 10,
+	PSD_StencilOpBack		= 1 << 11,
+	PSD_StencilMask			= 1 << 12,
+
+	// per render target, shifted by PSD_BlendTargetShift + 4 * target index
+	PSD_Blend				= 1 << 0,
+	PSD_BlendEquation		= 1 << 1,
+	PSD_BlendFunc			= 1 << 2,
+	PSD_ColorMask			= 1 << 3,
+};
+
+#define PSD_BlendTargetShift	16
+#define PSD_BlendTargetBits		4
+#define PSD_All					(~(uint64_t)0)
+
+class FRHIOpenGLGraphicsPipelineState : public FRHIGraphicsPipelineState
+{
+public:
+	FRHIOpenGLGraphicsPipelineState(class FOpenGLRenderer *InRenderer, const FGraphicsPipelineStateInitializerRHI &InInitializer);
+
+	// the GL calls to switch from InOther to this state, see EOpenGLPipelineStateDiff.
+	uint64_t ComputeDiff(const FRHIOpenGLGraphicsPipelineState *InOther) const;
+	// ComputeDiff memoized at the first switch between the two states.
+	uint64_t GetTransition(FRHIOpenGLGraphicsPipelineState *InOther);
+
+	class FOpenGLRenderer			*Renderer;
+
+	// the parts are kept alive by the initializer.
+	FRHIOpenGLRasterizerState		*RasterizerState;
+	FRHIOpenGLDepthStencilState		*DepthStencilState;
+	FRHIOpenGLBlendState			*BlendState;
+	FRHIOpenGLGPUProgram			*GPUProgram;
+	FRHIOpenGLVertexDeclaration		*VertexDecl;
+
+	// index in the creation order.
+	uint32_t						Serial;
+	// diffs with the states created before & switched with, by their serial.
+	std::unordered_map<uint32_t, uint64_t>	Transitions;
+};
+
+typedef TRefCountPtr<FRHIOpenGLGraphicsPipelineState> FRHIOpenGLGraphicsPipelineStateRef;
+
+#endif // __JETX_OPENGL_PIPELINE_STATE_H__
@@ -0,0 +1,238 @@
+// \brief
+//		OpenGL program binary cache implementation.
+//
+
+#include <cassert>
+#include <cstdio>
+#include <cerrno>
+#include <fstream>
+#ifdef XPLATFORM_WINDOWS
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+#include "OpenGLProgramCache.h"
+#include "OpenGLShader.h"
+
+
+// the header of a cache file, followed by Bytes of the binary
+struct FOpenGLProgramBinaryHeader
+{
+	uint32_t	Magic;
+	uint32_t	Version;
+	uint64_t	Key;
+	uint32_t	Format;
+	uint32_t	Bytes;
+};
+
+static const uint32_t kProgramBinaryMagic = 0x42504a58; // "XJPB"
+static const uint32_t kProgramBinaryVersion = 1;
+// larger files are taken as corrupted
+static const uint32_t kProgramBinaryMaxBytes = 64 * 1024 * 1024;
+
+const char *FOpenGLProgramCache::DefaultDirectory = "ProgramCache";
+
+// return false if InDirectory does not exist and can't be created
+static bool MakeDirectory(const std::string &InDirectory)
+{
+#ifdef XPLATFORM_WINDOWS
+	return _mkdir(InDirectory.c_str()) == 0 || errno == EEXIST;
+#else
+	return mkdir(InDirectory.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+// FNV-1a, 64 bits
+static uint64_t HashBytes(uint64_t InHash, const void *InData, size_t InBytes)
+{
+	const uint8_t *Bytes = reinterpret_cast<const uint8_t*>(InData);
+	for (size_t k = 0; k < InBytes; k++)
+	{
+		InHash = (InHash ^ Bytes[k]) * 1099511628211ull;
+	}
+	return InHash;
+}
+
+FOpenGLProgramCache::FOpenGLProgramCache()
+	: Logger(nullptr)
+	, Directory(std::string(DefaultDirectory) + '/')
+	, bSupported(false)
+	, Hits(0)
+	, Misses(0)
+	, Rejects(0)
+	, Saves(0)
+	, SaveFailures(0)
+{
+}
+
+void FOpenGLProgramCache::Init(FOutputDevice *InLogger, const std::string &InDriverName, bool InbSupported)
+{
+	Logger = InLogger;
+	DriverName = InDriverName;
+	bSupported = InbSupported;
+	Hits = Misses = Rejects = Saves = SaveFailures = 0;
+	SetDirectory(std::string(Directory).c_str());
+}
+
+void FOpenGLProgramCache::UnInit()
+{
+	DumpStats();
+	bSupported = false;
+}
+
+void FOpenGLProgramCache::SetDirectory(const char *InDirectory)
+{
+	Directory = InDirectory ? InDirectory : "";
+	if (!Directory.empty())
+	{
+		const char ch = Directory[Directory.length() - 1];
+		if (ch != '\\' && ch != '/')
+		{
+			Directory += '/';
+		}
+	}
+
+	if (!bSupported && !Directory.empty() && Logger)
+	{
+		Logger->Log(Log_Warning, "the driver supports no program binary format, the program cache is off");
+	}
+	else if (bSupported && !Directory.empty() && !MakeDirectory(Directory.substr(0, Directory.length() - 1)))
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Warning, "failed to create the program cache directory %s, the program cache is off", Directory.c_str());
+		}
+		Directory.clear();
+	}
+}
+
+uint64_t FOpenGLProgramCache::ComputeKey(const std::vector<FRHIShaderRef> &InShaders) const
+{
+	uint64_t Hash = 14695981039346656037ull;
+	Hash = HashBytes(Hash, DriverName.c_str(), DriverName.size() + 1);
+	for (size_t Index = 0; Index < InShaders.size(); Index++)
+	{
+		const FOpenGLShader *GLShader = dynamic_cast<const FOpenGLShader*>(InShaders[Index].DeRef());
+		assert(GLShader);
+
+		const GLenum kType = GLShader->GetShaderType();
+		const std::string &Source = GLShader->GetSource();
+		const uint64_t kLength = Source.size();
+		Hash = HashBytes(Hash, &kType, sizeof(kType));
+		Hash = HashBytes(Hash, &kLength, sizeof(kLength));
+		Hash = HashBytes(Hash, Source.c_str(), Source.size());
+	} // end for Index
+
+	return Hash;
+}
+
+std::string FOpenGLProgramCache::GetFileName(uint64_t InKey) const
+{
+	char Name[32];
+	snprintf(Name, sizeof(Name), "%016llx.glbin", (unsigned long long)InKey);
+	return Directory + Name;
+}
+
+bool FOpenGLProgramCache::Load(uint64_t InKey, GLuint InProgram)
+{
+	assert(IsEnabled());
+
+	const std::string FileName = GetFileName(InKey);
+	std::ifstream File(FileName.c_str(), std::ios::in | std::ios::binary);
+	if (!File.is_open())
+	{
+		Misses++;
+		return false;
+	}
+
+	FOpenGLProgramBinaryHeader Header;
+	std::vector<uint8_t> Binary;
+	bool bRead = File.read(reinterpret_cast<char*>(&Header), sizeof(Header)).good()
+		&& Header.Magic == kProgramBinaryMagic && Header.Version == kProgramBinaryVersion
+		&& Header.Key == InKey && Header.Bytes > 0 && Header.Bytes <= kProgramBinaryMaxBytes;
+	if (bRead)
+	{
+		Binary.resize(Header.Bytes);
+		bRead = File.read(reinterpret_cast<char*>(&Binary[0]), Header.Bytes).good();
+	}
+	File.close();
+
+	GLint LinkStatus = GL_FALSE;
+	if (bRead)
+	{
+		glProgramBinary(InProgram, (GLenum)Header.Format, &Binary[0], (GLsizei)Header.Bytes);
+		glGetProgramiv(InProgram, GL_LINK_STATUS, &LinkStatus);
+	}
+	// a format the driver dropped is an error, the program is linked from its sources.
+	while (glGetError() != GL_NO_ERROR) {}
+
+	if (LinkStatus != GL_TRUE)
+	{
+		Rejects++;
+		std::remove(FileName.c_str());
+		return false;
+	}
+
+	Hits++;
+	return true;
+}
+
+void FOpenGLProgramCache::Save(uint64_t InKey, GLuint InProgram)
+{
+	assert(IsEnabled());
+
+	GLint Bytes = 0;
+	glGetProgramiv(InProgram, GL_PROGRAM_BINARY_LENGTH, &Bytes);
+	if (Bytes <= 0 || (uint32_t)Bytes > kProgramBinaryMaxBytes)
+	{
+		SaveFailures++;
+		return;
+	}
+
+	FOpenGLProgramBinaryHeader Header;
+	std::vector<uint8_t> Binary(Bytes);
+	GLsizei BytesWritten = 0;
+	GLenum Format = 0;
+	glGetProgramBinary(InProgram, Bytes, &BytesWritten, &Format, &Binary[0]);
+	if (glGetError() != GL_NO_ERROR || BytesWritten <= 0)
+	{
+		SaveFailures++;
+		return;
+	}
+	Header.Magic = kProgramBinaryMagic;
+	Header.Version = kProgramBinaryVersion;
+	Header.Key = InKey;
+	Header.Format = (uint32_t)Format;
+	Header.Bytes = (uint32_t)BytesWritten;
+
+	// written aside, a file cut by a crash is never read.
+	const std::string FileName = GetFileName(InKey);
+	const std::string TempName = FileName + ".tmp";
+	std::ofstream File(TempName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	bool bWritten = File.is_open()
+		&& File.write(reinterpret_cast<const char*>(&Header), sizeof(Header)).good()
+		&& File.write(reinterpret_cast<const char*>(&Binary[0]), BytesWritten).good();
+	File.close();
+
+	std::remove(FileName.c_str());
+	if (!bWritten || std::rename(TempName.c_str(), FileName.c_str()) != 0)
+	{
+		std::remove(TempName.c_str());
+		if (SaveFailures++ == 0 && Logger)
+		{
+			Logger->Log(Log_Warning, "failed to write the program binary %s", FileName.c_str());
+		}
+		return;
+	}
+
+	Saves++;
+}
+
+void FOpenGLProgramCache::DumpStats() const
+{
+	if (Logger && IsEnabled())
+	{
+		Logger->Log(Log_Info, "Program cache (%s): %u hits, %u misses, %u rejected, %u saved, %u failed saves",
+			Directory.c_str(), Hits, Misses, Rejects, Saves, SaveFailures);
+	}
+}
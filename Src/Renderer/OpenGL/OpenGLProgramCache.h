@@ -0,0 +1,60 @@
+// \brief
+//		OpenGL program binary cache: the linked programs are saved by glGetProgramBinary and loaded
+//		by glProgramBinary at the next run, skipping the compiles & the links.
+//
+
+#ifndef __JETX_OPENGL_PROGRAM_CACHE_H__
+#define __JETX_OPENGL_PROGRAM_CACHE_H__
+
+#include <string>
+#include <vector>
+#include "Foundation/JetX.h"
+#include "Foundation/OutputDevice.h"
+#include "Renderer/RHIResource.h"
+#include "PlatformOpenGL.h"
+
+
+// FOpenGLProgramCache
+// a program is a file "<key>.glbin" in the directory, the key hashes the sources of its shaders & the
+// renderer, vendor & version strings of the driver: a driver update misses the old binaries. a binary
+// rejected by the driver is deleted, the program is linked from the sources and saved again.
+class FOpenGLProgramCache
+{
+public:
+	// under the working directory, the cache is on with it unless another directory is set.
+	static const char *DefaultDirectory;
+
+	FOpenGLProgramCache();
+
+	// InDriverName: identifies the driver, InbSupported: the program binaries are supported with a format at least.
+	void Init(FOutputDevice *InLogger, const std::string &InDriverName, bool InbSupported);
+	void UnInit();
+
+	// created if it does not exist (its parent does), empty or nullptr disables the cache.
+	void SetDirectory(const char *InDirectory);
+	bool IsEnabled() const { return bSupported && !Directory.empty(); }
+
+	uint64_t ComputeKey(const std::vector<FRHIShaderRef> &InShaders) const;
+	// return true if InProgram is linked from the binary of InKey.
+	bool Load(uint64_t InKey, GLuint InProgram);
+	// InProgram is linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+	void Save(uint64_t InKey, GLuint InProgram);
+
+	void DumpStats() const;
+
+protected:
+	std::string GetFileName(uint64_t InKey) const;
+
+	FOutputDevice	*Logger;
+	std::string		DriverName;
+	std::string		Directory;
+	bool			bSupported;
+
+	uint32_t		Hits;
+	uint32_t		Misses;
+	uint32_t		Rejects;		// binaries found but not accepted by the driver
+	uint32_t		Saves;
+	uint32_t		SaveFailures;
+};
+
+#endif // __JETX_OPENGL_PROGRAM_CACHE_H__
@@ -0,0 +1,261 @@
+// \brief
+//		OpenGL Query implementation.
+//
+
+#include <cassert>
+#include <utility>
+#include "OpenGLRenderer.h"
+#include "OpenGLQuery.h"
+
+
+// Occlusion Query
+FRHIOpenGLOcclusionQuery::~FRHIOpenGLOcclusionQuery()
+{
+	if (Resource)
+	{
+		glDeleteQueries(1, &Resource);
+		Resource = 0;
+	}
+}
+
+bool FRHIOpenGLOcclusionQuery::Initialize()
+{
+	glGenQueries(1, &Resource);
+	return Resource != 0;
+}
+
+void FRHIOpenGLOcclusionQuery::Begin()
+{
+	glBeginQuery(GL_SAMPLES_PASSED, Resource);
+	bPending = false;
+	bResultValid = false;
+}
+
+void FRHIOpenGLOcclusionQuery::End()
+{
+	glEndQuery(GL_SAMPLES_PASSED);
+	bPending = true;
+}
+
+bool FRHIOpenGLOcclusionQuery::GetResult(uint64_t &OutSamples, bool bWait)
+{
+	if (bPending)
+	{
+		GLint bAvailable = GL_FALSE;
+		if (!bWait)
+		{
+			glGetQueryObjectiv(Resource, GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+		}
+		if (bWait || bAvailable)
+		{
+			GLuint64 Result = 0;
+			glGetQueryObjectui64v(Resource, GL_QUERY_RESULT, &Result);
+			Samples = Result;
+			bPending = false;
+			bResultValid = true;
+		}
+	}
+
+	if (bResultValid)
+	{
+		OutSamples = Samples;
+	}
+	return bResultValid;
+}
+
+/** The queries generated at once */
+enum { OpenGLQueryBatch = 16 };
+
+FOpenGLTimerQueries::FOpenGLTimerQueries()
+	: Logger(nullptr)
+	, bTimingFrame(true)
+	, FrameCounter(0)
+	, FramesSkipped(0)
+	, bLatestValid(false)
+{
+}
+
+FOpenGLTimerQueries::~FOpenGLTimerQueries()
+{
+	assert(FreeQueries.empty() && FramesInFlight.empty());
+}
+
+void FOpenGLTimerQueries::Init(FOutputDevice *InLogger)
+{
+	Logger = InLogger;
+	bTimingFrame = true;
+	FrameCounter = 0;
+	FramesSkipped = 0;
+	bLatestValid = false;
+}
+
+void FOpenGLTimerQueries::UnInit()
+{
+	ReleaseQueries(Recording);
+	Recording = FFrame();
+	OpenScopes.clear();
+	while (!FramesInFlight.empty())
+	{
+		ReleaseQueries(FramesInFlight.front());
+		FramesInFlight.pop_front();
+	}
+
+	if (!FreeQueries.empty())
+	{
+		glDeleteQueries((GLsizei)FreeQueries.size(), &FreeQueries[0]);
+		FreeQueries.clear();
+	}
+
+	if (FramesSkipped > 0 && Logger)
+	{
+		Logger->Log(Log_Info, "GPU timer queries: %u frames were not timed, the GPU was %u frames behind", FramesSkipped, (uint32_t)OpenGLTimerQueryFrames);
+	}
+}
+
+void FOpenGLTimerQueries::BeginScope(const char *InName)
+{
+	FScope Scope;
+	Scope.Name = InName ? InName : "";
+	Scope.Depth = (uint32_t)OpenScopes.size();
+	Scope.BeginQuery = 0;
+	Scope.EndQuery = 0;
+	if (bTimingFrame)
+	{
+		Scope.BeginQuery = AllocQuery();
+		glQueryCounter(Scope.BeginQuery, GL_TIMESTAMP);
+		Recording.LastQuery = Scope.BeginQuery;
+	}
+
+	OpenScopes.push_back((uint32_t)Recording.Scopes.size());
+	Recording.Scopes.push_back(Scope);
+}
+
+void FOpenGLTimerQueries::EndScope()
+{
+	if (OpenScopes.empty())
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Warning, "end of a timer scope which was not begun");
+		}
+		return;
+	}
+
+	FScope &Scope = Recording.Scopes[OpenScopes.back()];
+	OpenScopes.pop_back();
+	if (Scope.BeginQuery)
+	{
+		Scope.EndQuery = AllocQuery();
+		glQueryCounter(Scope.EndQuery, GL_TIMESTAMP);
+		Recording.LastQuery = Scope.EndQuery;
+	}
+}
+
+void FOpenGLTimerQueries::EndFrame()
+{
+	if (!OpenScopes.empty())
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Warning, "%u timer scopes are still open at the end of the frame", (uint32_t)OpenScopes.size());
+		}
+		while (!OpenScopes.empty())
+		{
+			EndScope();
+		}
+	}
+
+	if (!Recording.Scopes.empty())
+	{
+		if (bTimingFrame)
+		{
+			Recording.Frame = FrameCounter;
+			FramesInFlight.push_back(std::move(Recording));
+		}
+		else
+		{
+			FramesSkipped++;
+		}
+	}
+	Recording = FFrame();
+	FrameCounter++;
+
+	while (!FramesInFlight.empty() && ReadFrame(FramesInFlight.front()))
+	{
+		ReleaseQueries(FramesInFlight.front());
+		FramesInFlight.pop_front();
+	}
+	bTimingFrame = FramesInFlight.size() < OpenGLTimerQueryFrames;
+}
+
+bool FOpenGLTimerQueries::GetFrameTimings(FGPUFrameTimings &OutTimings)
+{
+	if (!bLatestValid)
+	{
+		return false;
+	}
+
+	OutTimings = Latest;
+	bLatestValid = false;
+	return true;
+}
+
+GLuint FOpenGLTimerQueries::AllocQuery()
+{
+	if (FreeQueries.empty())
+	{
+		FreeQueries.resize(OpenGLQueryBatch);
+		glGenQueries(OpenGLQueryBatch, &FreeQueries[0]);
+	}
+
+	GLuint Query = FreeQueries.back();
+	FreeQueries.pop_back();
+	return Query;
+}
+
+void FOpenGLTimerQueries::ReleaseQueries(FFrame &InFrame)
+{
+	for (size_t k = 0; k < InFrame.Scopes.size(); k++)
+	{
+		FScope &Scope = InFrame.Scopes[k];
+		if (Scope.BeginQuery)
+		{
+			FreeQueries.push_back(Scope.BeginQuery);
+		}
+		if (Scope.EndQuery)
+		{
+			FreeQueries.push_back(Scope.EndQuery);
+		}
+		Scope.BeginQuery = Scope.EndQuery = 0;
+	} // end for k
+	InFrame.LastQuery = 0;
+}
+
+bool FOpenGLTimerQueries::ReadFrame(FFrame &InFrame)
+{
+	GLint bAvailable = GL_FALSE;
+	glGetQueryObjectiv(InFrame.LastQuery, GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+	if (!bAvailable)
+	{
+		return false;
+	}
+
+	Latest.Frame = InFrame.Frame;
+	Latest.Scopes.resize(InFrame.Scopes.size());
+	for (size_t k = 0; k < InFrame.Scopes.size(); k++)
+	{
+		const FScope &Scope = InFrame.Scopes[k];
+		GLuint64 BeginTime = 0, EndTime = 0;
+		glGetQueryObjectui64v(Scope.BeginQuery, GL_QUERY_RESULT, &BeginTime);
+		glGetQueryObjectui64v(Scope.EndQuery, GL_QUERY_RESULT, &EndTime);
+
+		FGPUTimerScope &Result = Latest.Scopes[k];
+		Result.Name = Scope.Name;
+		Result.Depth = Scope.Depth;
+		// in nanoseconds
+		Result.Milliseconds = EndTime > BeginTime ? (double)(EndTime - BeginTime) * 1e-6 : 0.0;
+	} // end for k
+
+	bLatestValid = true;
+	return true;
+}
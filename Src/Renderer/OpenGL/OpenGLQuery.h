@@ -0,0 +1,118 @@
+//\brief
+//		OpenGL queries: the occlusion queries & the GPU timer scopes.
+//
+
+#ifndef __JETX_OPENGL_QUERY_H__
+#define __JETX_OPENGL_QUERY_H__
+
+#include <vector>
+#include <deque>
+#include "Foundation/OutputDevice.h"
+#include "Renderer/Renderer.h"
+#include "PlatformOpenGL.h"
+
+
+// Occlusion Query
+// GL_SAMPLES_PASSED, the result of the last end is polled without waiting unless asked to.
+class FRHIOpenGLOcclusionQuery : public FRHIOcclusionQuery
+{
+public:
+	FRHIOpenGLOcclusionQuery(class FOpenGLRenderer *InRenderer)
+		: Renderer(InRenderer)
+		, Resource(0)
+		, bPending(false)
+		, bResultValid(false)
+		, Samples(0)
+	{}
+	virtual ~FRHIOpenGLOcclusionQuery();
+
+	bool Initialize();
+
+	void Begin();
+	void End();
+	// return false if the result of the last end is not known yet.
+	bool GetResult(uint64_t &OutSamples, bool bWait);
+	// ended, not necessarily done
+	bool IsEnded() const { return bPending || bResultValid; }
+
+	GLuint NativeResource() const { return Resource; }
+
+protected:
+	class FOpenGLRenderer	*Renderer;
+	GLuint					Resource;
+	// ended and not read yet
+	bool					bPending;
+	bool					bResultValid;
+	uint64_t				Samples;
+};
+
+typedef TRefCountPtr<FRHIOpenGLOcclusionQuery>	FRHIOpenGLOcclusionQueryRef;
+
+/** The frames whose timer queries are waited for, a frame beginning while they are all in flight is not timed */
+enum { OpenGLTimerQueryFrames = 4 };
+
+// FOpenGLTimerQueries
+// a scope is two timestamps (GL_TIMESTAMP) so that the scopes nest, the GL_TIME_ELAPSED queries
+// can't be active together. the frames in flight are polled at the end of the next frames, the
+// results are never waited for.
+class FOpenGLTimerQueries
+{
+public:
+	FOpenGLTimerQueries();
+	~FOpenGLTimerQueries();
+
+	void Init(FOutputDevice *InLogger);
+	void UnInit();
+
+	void BeginScope(const char *InName);
+	void EndScope();
+	// close the frame and read the frames in flight which are done.
+	void EndFrame();
+	// the latest frame read since the last call.
+	bool GetFrameTimings(FGPUFrameTimings &OutTimings);
+
+	uint32_t GetFramesSkipped() const { return FramesSkipped; }
+
+protected:
+	struct FScope
+	{
+		std::string		Name;
+		uint32_t		Depth;
+		GLuint			BeginQuery;
+		GLuint			EndQuery;
+	};
+
+	struct FFrame
+	{
+		FFrame()
+			: Frame(0)
+			, LastQuery(0)
+		{}
+
+		uint32_t				Frame;
+		std::vector<FScope>		Scopes;
+		// the timestamps are written in order, the others are done once it is.
+		GLuint					LastQuery;
+	};
+
+	GLuint AllocQuery();
+	void ReleaseQueries(FFrame &InFrame);
+	// return false if the queries of InFrame are not done yet.
+	bool ReadFrame(FFrame &InFrame);
+
+	FOutputDevice			*Logger;
+	std::vector<GLuint>		FreeQueries;
+	std::deque<FFrame>		FramesInFlight;
+
+	FFrame					Recording;
+	bool					bTimingFrame;
+	// the open scopes of Recording
+	std::vector<uint32_t>	OpenScopes;
+	uint32_t				FrameCounter;
+	uint32_t				FramesSkipped;
+
+	FGPUFrameTimings		Latest;
+	bool					bLatestValid;
+};
+
+#endif // __JETX_OPENGL_QUERY_H__
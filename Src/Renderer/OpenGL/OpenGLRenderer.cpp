@@ -28,12 +28,41 @@ void FOpenGLRenderer::Init(FOutputDevice *LogOutputDevice)
 	glGetIntegerv(GL_MAJOR_VERSION, &cap_MajorVersion);
 	glGetIntegerv(GL_MINOR_VERSION, &cap_MinorVersion);
 	glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &cap_GL_MAX_TEXTURE_IMAGE_UNITS);
+	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &cap_GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS);
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &cap_GL_MAX_TEXTURE_SIZE);
+	glGetIntegerv(GL_MAX_CUBE_MAP_TEXTURE_SIZE, &cap_GL_MAX_CUBE_MAP_TEXTURE_SIZE);
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &cap_GL_MAX_ARRAY_TEXTURE_LAYERS);
 	glGetIntegerv(GL_MAX_DRAW_BUFFERS, &cap_GL_MAX_DRAW_BUFFERS);
+	glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &cap_GL_MAX_RENDERBUFFER_SIZE);
+	glGetIntegerv(GL_MAX_SAMPLES, &cap_GL_MAX_SAMPLES);
 	glGetIntegerv(GL_MAX_ELEMENTS_VERTICES, &cap_GL_MAX_ELEMENTS_VERTICES);
 	glGetIntegerv(GL_MAX_ELEMENTS_INDICES, &cap_GL_MAX_ELEMENTS_INDICES);
+	glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &cap_GL_MAX_UNIFORM_BUFFER_BINDINGS);
+	glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &cap_GL_MAX_UNIFORM_BLOCK_SIZE);
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &cap_GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT);
+	cap_BufferStorage = (GLEW_ARB_buffer_storage || cap_MajorVersion > 4 || (cap_MajorVersion == 4 && cap_MinorVersion >= 4)) && glBufferStorage != nullptr;
+	cap_TextureStorage = (GLEW_ARB_texture_storage || cap_MajorVersion > 4 || (cap_MajorVersion == 4 && cap_MinorVersion >= 2)) && glTexStorage2D != nullptr && glTexStorage3D != nullptr;
+	cap_DrawIndirect = (GLEW_ARB_draw_indirect || cap_MajorVersion >= 4) && glDrawElementsIndirect != nullptr;
+	cap_MultiDrawIndirect = cap_DrawIndirect && (GLEW_ARB_multi_draw_indirect || cap_MajorVersion > 4 || (cap_MajorVersion == 4 && cap_MinorVersion >= 3)) && glMultiDrawElementsIndirect != nullptr;
+	cap_BaseInstance = (GLEW_ARB_base_instance || cap_MajorVersion > 4 || (cap_MajorVersion == 4 && cap_MinorVersion >= 2)) && glDrawElementsInstancedBaseVertexBaseInstance != nullptr;
+	GLint ProgramBinaryFormats = 0;
+	cap_ProgramBinary = (GLEW_ARB_get_program_binary || cap_MajorVersion > 4 || (cap_MajorVersion == 4 && cap_MinorVersion >= 1)) && glProgramBinary != nullptr && glGetProgramBinary != nullptr;
+	if (cap_ProgramBinary)
+	{
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &ProgramBinaryFormats);
+		cap_ProgramBinary = ProgramBinaryFormats > 0;
+	}
+	cap_ParallelShaderCompile = GLEW_ARB_parallel_shader_compile && glMaxShaderCompilerThreadsARB != nullptr;
+	if (cap_ParallelShaderCompile)
+	{
+		// as many threads as the driver wants
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+	}
 
 	assert(cap_GL_MAX_DRAW_BUFFERS >= MaxSimultaneousRenderTargets);
 	assert(cap_GL_MAX_TEXTURE_IMAGE_UNITS >= MaxTextureUnits);
+	assert(cap_GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS > MaxTextureUnits);
+	assert(cap_GL_MAX_UNIFORM_BUFFER_BINDINGS >= MaxUniformBufferBindings);
 
 	// Init States
 	RenderContext.ScissorRect = FIntRect();
@@ -101,26 +130,72 @@ void FOpenGLRenderer::Init(FOutputDevice *LogOutputDevice)
 	UpdatePendingBlendState(true);
 	CheckError(__FILE__, __LINE__);
 
-	// create vertex array object and active it.
-	glGenVertexArrays(1, &RenderContext.SharedVAO);
-	glBindVertexArray(RenderContext.SharedVAO);
+	// create vertex array object and active it, the draws bind the cached ones.
+	glGenVertexArrays(1, &RenderContext.SharedVAO.Resource);
+	glBindVertexArray(RenderContext.SharedVAO.Resource);
+	RenderContext.VertexArray = &RenderContext.SharedVAO;
 
 	for (uint32_t k = 0; k < MaxBufferBinds; k++)
 	{
 		RenderContext.BufferBinds[k] = 0;
 	}
+	for (uint32_t k = 0; k < MaxUniformBufferBindings; k++)
+	{
+		RenderContext.UniformBufferBinds[k].Buffer = 0;
+		RenderContext.UniformBufferBinds[k].Offset = 0;
+		RenderContext.UniformBufferBinds[k].Size = 0;
+	}
+	for (uint32_t k = 0; k <= MaxTextureUnits; k++)
+	{
+		RenderContext.TextureBinds[k].Target = GL_NONE;
+		RenderContext.TextureBinds[k].Texture = 0;
+	}
+	RenderContext.ActiveTextureUnit = 0;
+	glActiveTexture(GL_TEXTURE0);
+	// the texture updates are tightly packed
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	// draw to the viewport
+	RenderContext.DrawFrameBufferBind = 0;
+	RenderContext.ReadFrameBufferBind = 0;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	// stream buffers
+	FrameCounter = 0;
+	TimerQueries.Init(Logger);
+	std::string DriverName = std::string((const char*)glGetString(GL_RENDERER)) + "|" + (const char*)glGetString(GL_VENDOR) + "|" + (const char*)glGetString(GL_VERSION);
+	ProgramCache.Init(Logger, DriverName, cap_ProgramBinary);
+	if (!UniformRingBuffer.Initialize(&UniformRingStorage, OpenGLUniformRingBytes, cap_BufferStorage) && Logger)
+	{
+		Logger->Log(Log_Error, "failed to create the uniform ring buffer (%u bytes)", (uint32_t)OpenGLUniformRingBytes);
+	}
+	TransientVertexBuffer = new FRHIOpenGLVertexBuffer(this);
+	if (!TransientVertexStream.Initialize(TransientVertexBuffer, OpenGLTransientVertexBytes, cap_BufferStorage) && Logger)
+	{
+		Logger->Log(Log_Error, "failed to create the transient vertex buffer (%u bytes)", (uint32_t)OpenGLTransientVertexBytes);
+	}
+	for (uint32_t k = 0; k < 2; k++)
+	{
+		TransientIndexBuffers[k] = new FRHIOpenGLIndexBuffer(this, k == 0 ? sizeof(uint16_t) : sizeof(uint32_t));
+		if (!TransientIndexStreams[k].Initialize(TransientIndexBuffers[k], OpenGLTransientIndexBytes, cap_BufferStorage) && Logger)
+		{
+			Logger->Log(Log_Error, "failed to create the transient index buffer (%u bytes)", (uint32_t)OpenGLTransientIndexBytes);
+		}
+	}
+	if (!PixelUnpackStream.Initialize(&PixelUnpackStorage, OpenGLPixelUnpackBytes, cap_BufferStorage) && Logger)
+	{
+		Logger->Log(Log_Error, "failed to create the pixel unpack buffer (%u bytes)", (uint32_t)OpenGLPixelUnpackBytes);
+	}
+	// bound by the texture updates only
+	CachedBindBuffer(PixelUnpack_Buffer, 0);
 
-	// Vertex Inputs
-	PendingStatesSet.VertexDeclDirty = true;
-	PendingStatesSet.VertexStreamsDirty = true;
+	// the states not forced above are applied by the first draw
+	PendingStatesSet.DirtyBits = PSB_All & ~(PSB_RasterizerState | PSB_Samplers | PSB_DepthStencilState | PSB_BlendState);
 }
 
 void FOpenGLRenderer::Shutdown()
 {
-	if (RenderContext.SharedVAO)
-	{
-		glDeleteVertexArrays(1, &RenderContext.SharedVAO);
-	}
+	FlushDrawBatch();
 
 	// release resource
 	RenderContext.RasterizerState.SafeRelease();
@@ -141,6 +216,63 @@ void FOpenGLRenderer::Shutdown()
 	}
 	PendingStatesSet.VertexDecl.SafeRelease();
 	RenderContext.GPUProgram.SafeRelease();
+	RenderContext.DrawProgram.SafeRelease();
+	PendingPrograms.clear();
+	for (uint32_t Index = 0; Index < MaxUniformBufferBindings; Index++)
+	{
+		PendingStatesSet.UniformBuffers[Index].SafeRelease();
+	}
+	for (uint32_t Index = 0; Index < MaxTextureUnits; Index++)
+	{
+		PendingStatesSet.Textures[Index].SafeRelease();
+	}
+	if (Logger)
+	{
+		Logger->Log(Log_Info, "Stream buffers (%s):", cap_BufferStorage ? "persistent" : "orphaning");
+		Logger->Log(Log_Info, "    Uniforms: %u bytes allocated, %u waits for the GPU, %u orphans", UniformRingBuffer.GetBytesAllocated(), UniformRingBuffer.GetWaitsNum(), UniformRingBuffer.GetOrphansNum());
+		Logger->Log(Log_Info, "    Vertices: %u bytes allocated, %u waits for the GPU, %u orphans", TransientVertexStream.GetBytesAllocated(), TransientVertexStream.GetWaitsNum(), TransientVertexStream.GetOrphansNum());
+		for (uint32_t k = 0; k < 2; k++)
+		{
+			Logger->Log(Log_Info, "    Indices%u: %u bytes allocated, %u waits for the GPU, %u orphans", k == 0 ? 16 : 32, TransientIndexStreams[k].GetBytesAllocated(), TransientIndexStreams[k].GetWaitsNum(), TransientIndexStreams[k].GetOrphansNum());
+		}
+		Logger->Log(Log_Info, "    Pixels: %u bytes allocated, %u waits for the GPU, %u orphans", PixelUnpackStream.GetBytesAllocated(), PixelUnpackStream.GetWaitsNum(), PixelUnpackStream.GetOrphansNum());
+	}
+	UniformRingBuffer.UnInit();
+	TransientVertexStream.UnInit();
+	TransientVertexBuffer.SafeRelease();
+	for (uint32_t k = 0; k < 2; k++)
+	{
+		TransientIndexStreams[k].UnInit();
+		TransientIndexBuffers[k].SafeRelease();
+	}
+	PixelUnpackStream.UnInit();
+
+	RenderContext.PipelineState.SafeRelease();
+	RenderContext.FrameBuffer.SafeRelease();
+
+	DumpStateCacheStats();
+	DumpDrawMergeStats();
+	ActiveOcclusionQuery.SafeRelease();
+	ConditionalRenderQuery.SafeRelease();
+	TimerQueries.UnInit();
+	if (Logger && AsyncPrograms > 0)
+	{
+		Logger->Log(Log_Info, "Async programs: %u created (%s), %u draws with a fallback, %u draws skipped",
+			AsyncPrograms, cap_ParallelShaderCompile ? "parallel compile" : "built per frame", FallbackDraws, SkippedDraws);
+	}
+	ProgramCache.UnInit();
+	EmptyVertexArrayCache();
+	if (RenderContext.SharedVAO.Resource)
+	{
+		glDeleteVertexArrays(1, &RenderContext.SharedVAO.Resource);
+		RenderContext.SharedVAO.Resource = 0;
+	}
+	PipelineStatesNum = 0;
+	PipelineStateCache.Empty();
+	SamplerStateCache.Empty();
+	RasterizerStateCache.Empty();
+	DepthStencilStateCache.Empty();
+	BlendStateCache.Empty();
 
 	PlatformShutdownOpenGLContext(PlatformGLContext);
 	ViewportDrawing = nullptr;
@@ -153,12 +285,52 @@ void FOpenGLRenderer::DumpCapabilities()
 	{
 		Logger->Log(Log_Info, "GL %d.%d Capabilities:", cap_MajorVersion, cap_MinorVersion);
 		Logger->Log(Log_Info, "cap_GL_MAX_TEXTURE_IMAGE_UNITS: %d", cap_GL_MAX_TEXTURE_IMAGE_UNITS);
+		Logger->Log(Log_Info, "cap_GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS: %d", cap_GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS);
+		Logger->Log(Log_Info, "cap_GL_MAX_TEXTURE_SIZE: %d", cap_GL_MAX_TEXTURE_SIZE);
+		Logger->Log(Log_Info, "cap_GL_MAX_CUBE_MAP_TEXTURE_SIZE: %d", cap_GL_MAX_CUBE_MAP_TEXTURE_SIZE);
+		Logger->Log(Log_Info, "cap_GL_MAX_ARRAY_TEXTURE_LAYERS: %d", cap_GL_MAX_ARRAY_TEXTURE_LAYERS);
 		Logger->Log(Log_Info, "cap_GL_MAX_DRAW_BUFFERS: %d", cap_GL_MAX_DRAW_BUFFERS);
+		Logger->Log(Log_Info, "cap_GL_MAX_RENDERBUFFER_SIZE: %d", cap_GL_MAX_RENDERBUFFER_SIZE);
+		Logger->Log(Log_Info, "cap_GL_MAX_SAMPLES: %d", cap_GL_MAX_SAMPLES);
 		Logger->Log(Log_Info, "cap_GL_MAX_ELEMENTS_VERTICES: %d", cap_GL_MAX_ELEMENTS_VERTICES);
 		Logger->Log(Log_Info, "cap_GL_MAX_ELEMENTS_INDICES: %d", cap_GL_MAX_ELEMENTS_INDICES);
+		Logger->Log(Log_Info, "cap_GL_MAX_UNIFORM_BUFFER_BINDINGS: %d", cap_GL_MAX_UNIFORM_BUFFER_BINDINGS);
+		Logger->Log(Log_Info, "cap_GL_MAX_UNIFORM_BLOCK_SIZE: %d", cap_GL_MAX_UNIFORM_BLOCK_SIZE);
+		Logger->Log(Log_Info, "cap_GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT: %d", cap_GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT);
+		Logger->Log(Log_Info, "cap_BufferStorage: %d", cap_BufferStorage ? 1 : 0);
+		Logger->Log(Log_Info, "cap_TextureStorage: %d", cap_TextureStorage ? 1 : 0);
+		Logger->Log(Log_Info, "cap_DrawIndirect: %d", cap_DrawIndirect ? 1 : 0);
+		Logger->Log(Log_Info, "cap_MultiDrawIndirect: %d", cap_MultiDrawIndirect ? 1 : 0);
+		Logger->Log(Log_Info, "cap_BaseInstance: %d", cap_BaseInstance ? 1 : 0);
+		Logger->Log(Log_Info, "cap_ProgramBinary: %d", cap_ProgramBinary ? 1 : 0);
+		Logger->Log(Log_Info, "cap_ParallelShaderCompile: %d", cap_ParallelShaderCompile ? 1 : 0);
 	}
 }
 
+void FOpenGLRenderer::DumpStateCacheStats()
+{
+	if (Logger)
+	{
+		Logger->Log(Log_Info, "State caches (objects/hits/misses): sampler %u/%u/%u, rasterizer %u/%u/%u, depth-stencil %u/%u/%u, blend %u/%u/%u, pipeline %u/%u/%u",
+			SamplerStateCache.Num(), SamplerStateCache.GetHitsNum(), SamplerStateCache.GetMissesNum(),
+			RasterizerStateCache.Num(), RasterizerStateCache.GetHitsNum(), RasterizerStateCache.GetMissesNum(),
+			DepthStencilStateCache.Num(), DepthStencilStateCache.GetHitsNum(), DepthStencilStateCache.GetMissesNum(),
+			BlendStateCache.Num(), BlendStateCache.GetHitsNum(), BlendStateCache.GetMissesNum(),
+			PipelineStateCache.Num(), PipelineStateCache.GetHitsNum(), PipelineStateCache.GetMissesNum());
+		Logger->Log(Log_Info, "Vertex arrays (objects/hits/misses): %u/%u/%u", (uint32_t)VertexArrayCache.size(), VertexArrayHits, VertexArrayMisses);
+	}
+}
+
+void FOpenGLRenderer::DumpDrawMergeStats()
+{
+	if (Logger)
+	{
+		const FOpenGLDrawMergeStats &Stats = DrawMergeStats;
+		Logger->Log(Log_Info, "Draw merging (%s): %llu indexed draws in %llu submits, %llu merged into the previous range, %llu into a multi-draw",
+			bDrawMerging ? "enabled" : "disabled", (unsigned long long)Stats.Draws, (unsigned long long)Stats.Submits,
+			(unsigned long long)Stats.ContiguousMerges, (unsigned long long)Stats.MultiDrawMerges);
+	}
+}
 
 //Others
 void FOpenGLRenderer::AddViewport(class FRHIOpenGLViewport *InViewport)
@@ -208,6 +380,7 @@ void FOpenGLRenderer::RHIResizeViewport(FRHIViewportRef InViewport, uint32_t Siz
 		FRHIOpenGLViewport *Viewport = dynamic_cast<FRHIOpenGLViewport *>(InViewport.DeRef());
 		assert(Viewport);
 
+		FlushDrawBatch();
 		Viewport->Resize(SizeX, SizeY, bIsFullscreen);
 	}
 }
@@ -236,9 +409,11 @@ void FOpenGLRenderer::RHIBeginDrawingViewport(FRHIViewportRef Viewport)
 
 	if (GLViewport != ViewportDrawing)
 	{
+		FlushDrawBatch();
 		PlatformActiveViewportContext(PlatformGLContext, GLViewport->GetViewportContext());
 		ViewportDrawing = GLViewport;
 	}
+	RHISetFrameBuffer(FRHIFrameBufferRef());
 }
 
 void FOpenGLRenderer::RHIEndDrawingViewport(FRHIViewportRef Viewport, bool bPresent, bool bLockToVsync)
@@ -249,6 +424,7 @@ void FOpenGLRenderer::RHIEndDrawingViewport(FRHIViewportRef Viewport, bool bPres
 	assert(GLViewport);
 	assert(ViewportDrawing == GLViewport);
 
+	FlushDrawBatch();
 	glFlush();
 	PlatformSwapBuffers(PlatformGLContext, GLViewport->GetViewportContext());
 }
@@ -260,7 +436,19 @@ void FOpenGLRenderer::RHIBeginFrame()
 
 void FOpenGLRenderer::RHIEndFrame()
 {
-
+	FlushDrawBatch();
+
+	// the volatile uniform buffers, the transient geometry & the texture updates of the frame are read by the commands before the fences.
+	UniformRingBuffer.EndFrame();
+	TransientVertexStream.EndFrame();
+	TransientIndexStreams[0].EndFrame();
+	TransientIndexStreams[1].EndFrame();
+	PixelUnpackStream.EndFrame();
+	TimerQueries.EndFrame();
+	UpdatePendingPrograms();
+	FrameCounter++;
+	// the volatile uniform buffers are checked again in the new frame
+	PendingStatesSet.DirtyBits |= PSB_UniformBuffers;
 }
 
 void FOpenGLRenderer::UpdatePendingRasterizerState(bool bForce)
@@ -624,7 +812,7 @@ void FOpenGLRenderer::UpdatePendingBlendState(bool bForce)
 
 void FOpenGLRenderer::UpdatePendingVertexInputLayout(bool bForce)
 {
-	bool bNeedUpdate = PendingStatesSet.VertexDeclDirty || PendingStatesSet.VertexStreamsDirty || bForce;
+	bool bNeedUpdate = (PendingStatesSet.DirtyBits & PSB_VertexInputs) || bForce;
 	if (!bNeedUpdate)
 	{
 		return;
@@ -632,41 +820,212 @@ void FOpenGLRenderer::UpdatePendingVertexInputLayout(bool bForce)
 
 	assert(PendingStatesSet.VertexDecl.IsValidRef());
 
-	GLboolean VertexAttrisEnables[MaxVertexAttributes] = { GL_FALSE };
+	FVertexArrayKey Key;
+	Key.VertexDecl = PendingStatesSet.VertexDecl.DeRef();
 	const FOpenGLVertexElementsList &VertexElementList = PendingStatesSet.VertexDecl->VertexInputLayout;
 	for (size_t Index = 0; Index < VertexElementList.size(); Index++)
 	{
-		const FOpenGLVertexElement &Element = VertexElementList[Index];
-		const GLuint kStreamIndex = Element.StreamIndex;
-		const GLuint kAttriIndex = Element.AttributeIndex;
-
-		assert(kAttriIndex < MaxVertexAttributes);
+		const GLuint kStreamIndex = VertexElementList[Index].StreamIndex;
 		assert(kStreamIndex < MaxVertexStreamSources);
 
 		FRHIOpenGLVertexBuffer *SourceStream = PendingStatesSet.VertexStreams[kStreamIndex];
 		assert(SourceStream);
+		Key.Streams[kStreamIndex] = SourceStream->NativeResource();
+	} // end for
 
-		CachedEnableVertexAttributePointer(SourceStream->NativeResource(), Element);
-		VertexAttrisEnables[kAttriIndex] = GL_TRUE;
+	FVertexArrayCache::iterator It = VertexArrayCache.find(Key);
+	if (It != VertexArrayCache.end())
+	{
+		// its attributes were set when it was created
+		VertexArrayHits++;
+		CachedBindVertexArray(&It->second);
+		return;
+	}
+
+	VertexArrayMisses++;
+	if (VertexArrayCache.size() >= OpenGLMaxCachedVertexArrays)
+	{
+		EmptyVertexArrayCache();
+	}
+
+	FVertexArray &VertexArray = VertexArrayCache[Key];
+	VertexArray.VertexDecl = PendingStatesSet.VertexDecl;
+	glGenVertexArrays(1, &VertexArray.Resource);
+	CachedBindVertexArray(&VertexArray);
+
+	// all the attributes of a new VAO are disabled
+	for (size_t Index = 0; Index < VertexElementList.size(); Index++)
+	{
+		const FOpenGLVertexElement &Element = VertexElementList[Index];
+		assert(Element.AttributeIndex < MaxVertexAttributes);
+
+		CachedEnableVertexAttributePointer(Key.Streams[Element.StreamIndex], Element);
 	} // end for
+}
+
+void FOpenGLRenderer::CachedBindVertexArray(FVertexArray *InVertexArray)
+{
+	FVertexArray *Current = RenderContext.VertexArray;
+	if (Current == InVertexArray)
+	{
+		return;
+	}
+
+	FlushDrawBatch();
+	if (Current)
+	{
+		Current->ElementArrayBuffer = RenderContext.BufferBinds[ElementArray_Buffer];
+	}
+	glBindVertexArray(InVertexArray->Resource);
+	RenderContext.BufferBinds[ElementArray_Buffer] = InVertexArray->ElementArrayBuffer;
+	RenderContext.VertexArray = InVertexArray;
+}
+
+void FOpenGLRenderer::EmptyVertexArrayCache()
+{
+	CachedBindVertexArray(&RenderContext.SharedVAO);
+	for (FVertexArrayCache::iterator It = VertexArrayCache.begin(); It != VertexArrayCache.end(); ++It)
+	{
+		glDeleteVertexArrays(1, &It->second.Resource);
+	}
+	VertexArrayCache.clear();
+}
 
-	for (GLuint Index = 0; Index < MaxVertexAttributes; Index++)
+void FOpenGLRenderer::UpdatePendingUniformBuffers()
+{
+	for (uint32_t Index = 0; Index < MaxUniformBufferBindings; Index++)
 	{
-		if (VertexAttrisEnables[Index] == GL_FALSE && RenderContext.VAOState.VertexInputAttris[Index].Enabled)
+		FRHIOpenGLUniformBuffer *Pending = PendingStatesSet.UniformBuffers[Index].DeRef();
+		if (!Pending || !Pending->BindBuffer)
 		{
-			glDisableVertexAttribArray(Index);
-			CheckError(__FILE__, __LINE__);
-			RenderContext.VAOState.VertexInputAttris[Index].Enabled = GL_FALSE;
+			continue;
 		}
-	} // end for
+		if (Pending->IsVolatile() && Pending->UpdateFrame != FrameCounter && Logger)
+		{
+			Logger->Log(Log_Warning, "uniform buffer at slot %u was not updated in this frame, its contents may be overwritten", Index);
+		}
+
+		FRenderContext::FUniformBufferBind &Current = RenderContext.UniformBufferBinds[Index];
+		if (Current.Buffer != Pending->BindBuffer || Current.Offset != Pending->BindOffset || Current.Size != (GLsizeiptr)Pending->Bytes)
+		{
+			glBindBufferRange(GL_UNIFORM_BUFFER, Index, Pending->BindBuffer, Pending->BindOffset, Pending->Bytes);
+			// the generic bind point changes too
+			RenderContext.BufferBinds[Uniform_Buffer] = Pending->BindBuffer;
+
+			Current.Buffer = Pending->BindBuffer;
+			Current.Offset = Pending->BindOffset;
+			Current.Size = Pending->Bytes;
+		}
+	} // end for Index
+}
+
+void FOpenGLRenderer::UpdatePendingTextures()
+{
+	// only the units set since the last draw
+	uint32_t DirtyUnits = (PendingStatesSet.DirtyBits & PSB_Textures) >> PSB_TextureShift;
+	for (uint32_t Index = 0; DirtyUnits; Index++, DirtyUnits >>= 1)
+	{
+		if (!(DirtyUnits & 1))
+		{
+			continue;
+		}
+
+		FOpenGLTexture *Pending = dynamic_cast<FOpenGLTexture*>(PendingStatesSet.Textures[Index].DeRef());
+		if (Pending)
+		{
+			CachedBindTexture(Index, Pending->GetTarget(), Pending->NativeResource());
+		}
+		else
+		{
+			CachedBindTexture(Index, RenderContext.TextureBinds[Index].Target, 0);
+		}
+	} // end for Index
+
+	PendingStatesSet.DirtyBits &= ~PSB_Textures;
 }
 
-void FOpenGLRenderer::UpdateGPUProgram()
+void FOpenGLRenderer::FlushStreamBuffers()
+{
+	UniformRingBuffer.Flush();
+	TransientVertexStream.Flush();
+	TransientIndexStreams[0].Flush();
+	TransientIndexStreams[1].Flush();
+}
+
+bool FOpenGLRenderer::UpdateGPUProgram()
 {
 	assert(RenderContext.GPUProgram.IsValidRef());
-	if (RenderContext.GPUProgram.IsValidRef())
+
+	FRHIOpenGLGPUProgram *Program = RenderContext.GPUProgram.DeRef();
+	if (Program && !Program->IsReady())
+	{
+		Program = Program->GetFallback();
+		if (Program && Program->IsReady())
+		{
+			FallbackDraws++;
+		}
+		else
+		{
+			SkippedDraws++;
+			return false;
+		}
+	}
+	if (!Program)
+	{
+		return false;
+	}
+
+	if (RenderContext.DrawProgram.DeRef() != Program)
 	{
-		RenderContext.GPUProgram->UpdateUniformVariables();
+		glUseProgram(Program->NativeResource());
+		RenderContext.DrawProgram = Program;
+	}
+	Program->UpdateUniformVariables();
+	return true;
+}
+
+void FOpenGLRenderer::UpdatePendingPrograms()
+{
+	uint32_t BuildsLeft = OpenGLProgramBuildsPerFrame;
+	for (size_t Index = 0; Index < PendingPrograms.size(); )
+	{
+		FRHIOpenGLGPUProgram *Program = PendingPrograms[Index].DeRef();
+		if (Program->IsQueued() && BuildsLeft > 0)
+		{
+			// read at once, the driver does not compile in the background.
+			BuildsLeft--;
+			if (Program->BeginBuild())
+			{
+				OnProgramBuilt(Program, Program->FinishBuild());
+			}
+			else
+			{
+				OnProgramBuilt(Program, false);
+			}
+		}
+		else if (Program->IsBuilding() && Program->IsLinkDone())
+		{
+			OnProgramBuilt(Program, Program->FinishBuild());
+		}
+
+		if (Program->IsQueued() || Program->IsBuilding())
+		{
+			Index++;
+		}
+		else
+		{
+			PendingPrograms[Index] = PendingPrograms.back();
+			PendingPrograms.pop_back();
+		}
+	} // end for Index
+}
+
+void FOpenGLRenderer::OnProgramBuilt(FRHIOpenGLGPUProgram *InProgram, bool bSucceeded)
+{
+	if (Logger && (!bSucceeded || InProgram->HasFailed()))
+	{
+		Logger->Log(Log_Error, "failed to build an async GPU program:");
+		InProgram->Dump(*Logger);
 	}
 }
 
@@ -676,7 +1035,7 @@ void FOpenGLRenderer::UpdateGPUProgram()
 void FOpenGLRenderer::CachedEnableVertexAttributePointer(GLuint InBuffer, const FOpenGLVertexElement &InVertexElement)
 {
 	const GLuint kAttriIndex = InVertexElement.AttributeIndex;
-	FVertexInputAttribute &CurrentInputAttribute = RenderContext.VAOState.VertexInputAttris[kAttriIndex];
+	FVertexInputAttribute &CurrentInputAttribute = RenderContext.VertexArray->State.VertexInputAttris[kAttriIndex];
 
 	if (CurrentInputAttribute.Buffer != InBuffer ||
 		CurrentInputAttribute.Type != InVertexElement.Type ||
@@ -731,6 +1090,81 @@ void FOpenGLRenderer::CachedBindBuffer(EBufferBindTarget InBindPoint, GLuint InB
 	}
 }
 
+void FOpenGLRenderer::CachedBindTexture(GLuint InUnit, GLenum InTarget, GLuint InTexture)
+{
+	FRenderContext::FTextureBind &Current = RenderContext.TextureBinds[InUnit];
+	if (Current.Target == InTarget && Current.Texture == InTexture)
+	{
+		return;
+	}
+
+	if (RenderContext.ActiveTextureUnit != InUnit)
+	{
+		glActiveTexture(GL_TEXTURE0 + InUnit);
+		RenderContext.ActiveTextureUnit = InUnit;
+	}
+	// a unit keeps one texture per target, the previous one must not be sampled by another sampler type.
+	if (Current.Target != InTarget && Current.Target != GL_NONE && Current.Texture != 0)
+	{
+		glBindTexture(Current.Target, 0);
+	}
+	if (InTarget != GL_NONE)
+	{
+		glBindTexture(InTarget, InTexture);
+	}
+
+	Current.Target = InTarget;
+	Current.Texture = InTexture;
+}
+
+void FOpenGLRenderer::BindTextureForUpdate(GLenum InTarget, GLuint InTexture)
+{
+	CachedBindTexture(MaxTextureUnits, InTarget, InTexture);
+	if (RenderContext.ActiveTextureUnit != MaxTextureUnits)
+	{
+		glActiveTexture(GL_TEXTURE0 + MaxTextureUnits);
+		RenderContext.ActiveTextureUnit = MaxTextureUnits;
+	}
+}
+
+void FOpenGLRenderer::OnTextureDeleted(GLuint InTexture)
+{
+	for (uint32_t Index = 0; Index <= MaxTextureUnits; Index++)
+	{
+		if (RenderContext.TextureBinds[Index].Texture == InTexture)
+		{
+			RenderContext.TextureBinds[Index].Texture = 0;
+			if (Index < MaxTextureUnits)
+			{
+				PendingStatesSet.DirtyBits |= 1u << (PSB_TextureShift + Index);
+			}
+		}
+	}
+}
+
+void FOpenGLRenderer::CachedBindFrameBuffer(GLenum InTarget, GLuint InFrameBuffer)
+{
+	GLuint &Current = InTarget == GL_READ_FRAMEBUFFER ? RenderContext.ReadFrameBufferBind : RenderContext.DrawFrameBufferBind;
+	if (Current != InFrameBuffer)
+	{
+		glBindFramebuffer(InTarget, InFrameBuffer);
+		Current = InFrameBuffer;
+	}
+}
+
+void FOpenGLRenderer::OnFrameBufferDeleted(GLuint InFrameBuffer)
+{
+	// deleting a bound framebuffer object binds 0
+	if (RenderContext.DrawFrameBufferBind == InFrameBuffer)
+	{
+		RenderContext.DrawFrameBufferBind = 0;
+	}
+	if (RenderContext.ReadFrameBufferBind == InFrameBuffer)
+	{
+		RenderContext.ReadFrameBufferBind = 0;
+	}
+}
+
 void FOpenGLRenderer::OnBufferDeleted(EBufferBindTarget InBindPoint, GLuint InBuffer)
 {
 	if (RenderContext.BufferBinds[InBindPoint] == InBuffer)
@@ -740,18 +1174,57 @@ void FOpenGLRenderer::OnBufferDeleted(EBufferBindTarget InBindPoint, GLuint InBu
 	
 	switch (InBindPoint)
 	{
-	case Array_Buffer:
+	case Uniform_Buffer:
 	{
-		for (uint32_t Index = 0; Index < MaxVertexAttributes; Index++)
+		for (uint32_t Index = 0; Index < MaxUniformBufferBindings; Index++)
 		{
-			FVertexInputAttribute &Entry = RenderContext.VAOState.VertexInputAttris[Index];
+			FRenderContext::FUniformBufferBind &Entry = RenderContext.UniformBufferBinds[Index];
 			if (Entry.Buffer == InBuffer)
 			{
 				Entry.Buffer = 0;
+				PendingStatesSet.DirtyBits |= PSB_UniformBuffers;
 			}
 		}
 	}
 		break;
+	case Array_Buffer:
+	{
+		// the VAOs reading the buffer are deleted, its name may be reused.
+		for (FVertexArrayCache::iterator It = VertexArrayCache.begin(); It != VertexArrayCache.end(); )
+		{
+			const FVertexArrayKey &Key = It->first;
+			if (std::find(Key.Streams, Key.Streams + MaxVertexStreamSources, InBuffer) == Key.Streams + MaxVertexStreamSources)
+			{
+				++It;
+				continue;
+			}
+
+			if (RenderContext.VertexArray == &It->second)
+			{
+				CachedBindVertexArray(&RenderContext.SharedVAO);
+				PendingStatesSet.DirtyBits |= PSB_VertexInputs;
+			}
+			glDeleteVertexArrays(1, &It->second.Resource);
+			It = VertexArrayCache.erase(It);
+		} // end for It
+	}
+		break;
+	case ElementArray_Buffer:
+	{
+		// deleting the buffer only unbinds it from the bound VAO
+		for (FVertexArrayCache::iterator It = VertexArrayCache.begin(); It != VertexArrayCache.end(); ++It)
+		{
+			if (It->second.ElementArrayBuffer == InBuffer)
+			{
+				It->second.ElementArrayBuffer = 0;
+			}
+		}
+		if (RenderContext.SharedVAO.ElementArrayBuffer == InBuffer)
+		{
+			RenderContext.SharedVAO.ElementArrayBuffer = 0;
+		}
+	}
+		break;
 	default:
 		break;
 	}
@@ -5,21 +5,59 @@
 #ifndef __JETX_OPENGL_RENDERER_H__
 #define __JETX_OPENGL_RENDERER_H__
 
-#include <map>
 #include <vector>
+#include <cstring>
+#include <unordered_map>
+#include "Foundation/Hash.h"
 #include "Renderer/Renderer.h"
 #include "PlatformOpenGL.h"
 #include "OpenGLState.h"
 #include "OpenGLDataBuffer.h"
+#include "OpenGLStreamBuffer.h"
+#include "OpenGLUniformBuffer.h"
+#include "OpenGLTexture.h"
+#include "OpenGLFrameBuffer.h"
 #include "OpenGLVertexDeclaration.h"
 #include "OpenGLShader.h"
+#include "OpenGLProgramCache.h"
+#include "OpenGLPipelineState.h"
+#include "OpenGLQuery.h"
 
 
+// the cached VAOs are all deleted when there are more
+enum { OpenGLMaxCachedVertexArrays = 1024 };
+// the async programs built at a frame end without a parallel shader compile
+enum { OpenGLProgramBuildsPerFrame = 4 };
+
+// the indexed draws merged by FOpenGLRenderer
+struct FOpenGLDrawMergeStats
+{
+	FOpenGLDrawMergeStats()
+	{
+		::memset(this, 0, sizeof(*this));
+	}
+
+	uint64_t	Draws;				// indexed draws of a single instance
+	uint64_t	Submits;			// glDrawElements & glMultiDrawElements issued for them
+	uint64_t	ContiguousMerges;	// draws appended to the index range of the previous one
+	uint64_t	MultiDrawMerges;	// draws added as another range of a glMultiDrawElements
+};
+
 //FOpenGLRenderer
 class FOpenGLRenderer : public FRenderer
 {
 public:
-	FOpenGLRenderer() {}
+	FOpenGLRenderer()
+		: PipelineStatesNum(0)
+		, VertexArrayHits(0)
+		, VertexArrayMisses(0)
+		, UniformRingStorage(this, Uniform_Buffer)
+		, PixelUnpackStorage(this, PixelUnpack_Buffer)
+		, bDrawMerging(false)
+		, AsyncPrograms(0)
+		, FallbackDraws(0)
+		, SkippedDraws(0)
+	{}
 
 	//Init
 	virtual void Init(FOutputDevice *LogOutputDevice) override;
@@ -41,39 +79,66 @@ public:
 	virtual FRHIRasterizerStateRef RHICreateRasterizerState(const FRasterizerStateInitializerRHI &RasterizerStateInitializer) override;
 	virtual FRHIDepthStencilStateRef RHICreateDepthStencilState(const FDepthStencilStateInitializerRHI &DepthStencilStateInitializer) override;
 	virtual FRHIBlendStateRef RHICreateBlendState(const FBlendStateInitializerRHI &BlendStateInitializer) override;
+	virtual FRHIGraphicsPipelineStateRef RHICreateGraphicsPipelineState(const FGraphicsPipelineStateInitializerRHI &PipelineStateInitializer) override;
 
 	// vertex buffers
 	virtual FRHIVertexBufferRef RHICreateVertexBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess, EBufferUsage InUsage) override;
 	virtual FRHIIndexBufferRef RHICreateIndexBuffer(uint32_t InBytes, const void *InData, uint16_t InStride, EBufferAccess InAccess, EBufferUsage InUsage) override;
+	virtual FRHIIndirectBufferRef RHICreateIndirectBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess) override;
 
 	virtual void FillDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, const void *InData) override;
 	virtual void* LockDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, EBufferLockMode InMode) override;
 	virtual void UnLockDataBuffer(FRHIDataBufferRef InBuffer) override;
+	virtual void FlushDataBufferRange(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes) override;
+
+	// uniform buffers
+	virtual FRHIUniformBufferRef RHICreateUniformBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess) override;
+	virtual void RHIUpdateUniformBuffer(const FRHIUniformBufferRef &InBuffer, const void *InData) override;
+
+	// transient geometry
+	virtual void* RHIAllocTransientVertices(uint32_t InBytes, uint32_t InStride, FRHIVertexBufferRef &OutBuffer, uint32_t &OutFirstVertex) override;
+	virtual void* RHIAllocTransientIndices(uint32_t InCount, uint16_t InStride, FRHIIndexBufferRef &OutBuffer, uint32_t &OutFirstIndex) override;
 
 	// vertex input layout
 	virtual FRHIVertexDeclarationRef RHICreateVertexInputLayout(const FVertexElement *InVertexElements, uint32_t InCount) override;
 
 	// textures
-	//virtual FRHITexture2DRef RHICreateTexture2D() override;
+	virtual FRHITexture2DRef RHICreateTexture2D(uint32_t InSizeX, uint32_t InSizeY, uint32_t InMips, EPixelFormat InFormat) override;
+	virtual FRHITexture2DArrayRef RHICreateTexture2DArray(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat) override;
+	virtual FRHITextureCubeRef RHICreateTextureCube(uint32_t InSize, uint32_t InMips, EPixelFormat InFormat) override;
+	virtual void RHIUpdateTexture(const FRHITextureRef &InTexture, uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData) override;
+	virtual void RHIGenerateMips(const FRHITextureRef &InTexture) override;
+
+	// render targets
+	virtual FRHIRenderBufferRef RHICreateRenderBuffer(uint32_t InSizeX, uint32_t InSizeY, EPixelFormat InFormat, uint32_t InSamples) override;
+	virtual FRHIFrameBufferRef RHICreateFrameBuffer(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget) override;
+
+	// queries
+	virtual FRHIOcclusionQueryRef RHICreateOcclusionQuery() override;
 
 	// shader
 	virtual FRHIVertexShaderRef RHICreateVertexShader(const char *InSource, int32_t InLength = -1) override;
 	virtual FRHIPixelShaderRef RHICreatePixelShader(const char *InSource, int32_t InLength = -1) override;
 	virtual FRHIGPUProgramRef RHICreateGPUProgram(const FRHIVertexShaderRef &InVShader, const FRHIPixelShaderRef &InPShader) override;
 	virtual FRHIGPUProgramRef RHICreateGPUProgram(const std::vector<FRHIShaderRef> &InShaders) override;
+	virtual FRHIGPUProgramRef RHICreateGPUProgramAsync(const std::vector<FRHIShaderRef> &InShaders, const FRHIGPUProgramRef &InFallback = FRHIGPUProgramRef()) override;
 
 //State Setting
 	virtual void RHISetSamplerState(uint32_t InTexIndex, const FRHISamplerStateRef &InSamplerState) override;
+	virtual void RHISetTexture(uint32_t InTexIndex, const FRHITextureRef &InTexture) override;
 	virtual void RHISetRasterizerState(const FRHIRasterizerStateRef &InRasterizerState) override;
 	virtual void RHISetDepthStencilState(const FRHIDepthStencilStateRef &InDepthStencilState, int32_t InStencilRef) override;
 	virtual void RHISetBlendState(const FRHIBlendStateRef &InBlendState, const FLinearColor &InBlendColor) override;
+	virtual void RHISetGraphicsPipelineState(const FRHIGraphicsPipelineStateRef &InPipelineState, int32_t InStencilRef, const FLinearColor &InBlendColor) override;
 
+	virtual void RHISetFrameBuffer(const FRHIFrameBufferRef &InFrameBuffer) override;
 	virtual void RHISetViewport(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight, float InMinZ, float InMaxZ) override;
 	virtual void RHISetScissorRect(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight) override;
 
 	virtual void SetVertexStreamSource(uint32_t InStreamIndex, const FRHIVertexBufferRef &InVertexBuffer) override;
 	virtual void SetVertexInputLayout(const FRHIVertexDeclarationRef &InVertexDecl) override;
 	virtual void SetGPUProgram(const FRHIGPUProgramRef &InProgram) override;
+	virtual void RHISetUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer) override;
 
 //Draw Commands
 	virtual void RHIBeginDrawingViewport(FRHIViewportRef Viewport) override;
@@ -84,11 +149,30 @@ public:
 	virtual void RHIClear(bool bClearColor, const FLinearColor &InColor, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil) override;
 	virtual void RHIClearMRT(bool bClearColor, const FLinearColor *InColors, uint32_t InColorsNum, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil) override;
 
+	virtual void RHIResolveFrameBuffer(const FRHIFrameBufferRef &InSource, const FRHIFrameBufferRef &InDest) override;
+
 	// draw primitives
 	virtual void DrawIndexedPrimitive(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount) override;
 	virtual void DrawIndexedPrimitiveInstanced(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances) override;
 	virtual void DrawArrayedPrimitive(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount) override;
 	virtual void DrawArrayedPrimitiveInstanced(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances) override;
+	// GL 4.3 (ARB_multi_draw_indirect) submits the draws at once, GL 4.0 (ARB_draw_indirect) one by one,
+	// below the arguments are kept in system memory and drawn by a CPU loop.
+	virtual void DrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset) override;
+	virtual void MultiDrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t InStride) override;
+
+//GPU Profiling
+	virtual void RHIBeginTimerQuery(const char *InName) override;
+	virtual void RHIEndTimerQuery() override;
+	virtual bool RHIGetGPUFrameTimings(FGPUFrameTimings &OutTimings) override;
+
+//Occlusion Queries
+	virtual void RHIBeginOcclusionQuery(const FRHIOcclusionQueryRef &InQuery) override;
+	virtual void RHIEndOcclusionQuery(const FRHIOcclusionQueryRef &InQuery) override;
+	virtual bool RHIGetOcclusionQueryResult(const FRHIOcclusionQueryRef &InQuery, uint64_t &OutSamples, bool bWait) override;
+	// glBeginConditionalRender with GL_QUERY_WAIT or GL_QUERY_NO_WAIT
+	virtual void RHIBeginConditionalRender(const FRHIOcclusionQueryRef &InQuery, bool bWait) override;
+	virtual void RHIEndConditionalRender() override;
 
 //Others
 	void AddViewport(class FRHIOpenGLViewport *InViewport);
@@ -96,8 +180,43 @@ public:
 
 	void CachedBindBuffer(EBufferBindTarget InBindPoint, GLuint InBuffer);
 	void OnBufferDeleted(EBufferBindTarget InBindPoint, GLuint InBuffer);
+	// bind on the update unit, past the units of the draws.
+	void BindTextureForUpdate(GLenum InTarget, GLuint InTexture);
+	void OnTextureDeleted(GLuint InTexture);
+	// InTarget is GL_DRAW_FRAMEBUFFER or GL_READ_FRAMEBUFFER
+	void CachedBindFrameBuffer(GLenum InTarget, GLuint InFrameBuffer);
+	void OnFrameBufferDeleted(GLuint InFrameBuffer);
+	// the framebuffer object the draws go to, 0 for the viewport.
+	GLuint GetDrawingFrameBuffer() const { return RenderContext.FrameBuffer.IsValidRef() ? RenderContext.FrameBuffer->NativeResource() : 0; }
+
+	FOpenGLStreamBuffer& GetUniformRingBuffer() { return UniformRingBuffer; }
+	uint32_t GetUniformBufferAlignment() const { return (uint32_t)cap_GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT; }
+	FOpenGLStreamBuffer& GetPixelUnpackBuffer() { return PixelUnpackStream; }
+	bool SupportsTextureStorage() const { return cap_TextureStorage; }
+	uint32_t GetFrameCounter() const { return FrameCounter; }
+
+	// off by default. the indexed draws of a single instance are held until a state or a uniform of the
+	// program in use changes: the next draws with the same index buffer & mode are merged into one
+	// glDrawElements when their ranges follow each other in a list, into one glMultiDrawElements otherwise.
+	virtual void SetDrawMergingEnabled(bool bEnabled) override;
+	bool IsDrawMergingEnabled() const { return bDrawMerging; }
+	const FOpenGLDrawMergeStats& GetDrawMergeStats() const { return DrawMergeStats; }
+
+	// FOpenGLProgramCache::DefaultDirectory unless set, see FRenderer.
+	virtual void SetProgramCacheDirectory(const char *InDirectory) override { ProgramCache.SetDirectory(InDirectory); }
+	FOpenGLProgramCache& GetProgramCache() { return ProgramCache; }
+
+	// the async programs link on the driver threads with GL_ARB_parallel_shader_compile, they are built a few
+	// per frame otherwise.
+	bool SupportsParallelShaderCompile() const { return cap_ParallelShaderCompile; }
+	void OnProgramBuilt(FRHIOpenGLGPUProgram *InProgram, bool bSucceeded);
+	// a uniform value of InProgram changed, the draws held with it are submitted first.
+	void OnProgramUniformChanged(FRHIOpenGLGPUProgram *InProgram) { if (RenderContext.DrawProgram.DeRef() == InProgram) FlushDrawBatch(); }
 
 //Helpers
+	void DumpStateCacheStats();
+	void DumpDrawMergeStats();
+
 	//\brief
 	//	return true if has error.
 	bool CheckError(const char* FILE, int LINE);
@@ -111,14 +230,31 @@ public:
     void ReleaseViewportContext(FPlatformViewportContext* InContext);
     void ResizeViewportContext(FPlatformViewportContext* InContext, uint32_t SizeX, uint32_t SizeY, bool bFullscreen, bool bWasFullscreen);
 protected:
+	struct FVertexArray;
+
 	void UpdatePendingRasterizerState(bool bForce=false);
 	void UpdatePendingSamplers(bool bForce=false);
 	void UpdatePendingDepthStencilState(bool bForce=false);
 	void UpdatePendingBlendState(bool bForce=false);
 	void UpdatePendingVertexInputLayout(bool bForce=false);
+	void UpdatePendingUniformBuffers();
+	void UpdatePendingTextures();
+	void FlushStreamBuffers();
 	void CachedEnableVertexAttributePointer(GLuint InBuffer, const FOpenGLVertexElement &InVertexElement);
-
-	void UpdateGPUProgram();
+	void CachedBindVertexArray(FVertexArray *InVertexArray);
+	void EmptyVertexArrayCache();
+	void CachedBindTexture(GLuint InUnit, GLenum InTarget, GLuint InTexture);
+
+	// return false if the draw is skipped: its program is not ready, nor a fallback.
+	bool UpdateGPUProgram();
+	// flush all the pending states before a draw, return false if it is skipped.
+	bool UpdatePendingDrawStates();
+	// begin the queued async programs & finish the linked ones.
+	void UpdatePendingPrograms();
+	// submit the held draws, before anything changes the states they were issued with.
+	void FlushDrawBatch() { if (!DrawBatch.Counts.empty()) SubmitDrawBatch(); }
+	void SubmitDrawBatch();
+	void ApplyPipelineState(FRHIOpenGLGraphicsPipelineState *InPipelineState, uint64_t InDiff, GLint InStencilRef);
 
 protected:
 	struct FIntRect
@@ -181,6 +317,54 @@ protected:
 		// GLuint					ElementArrayBuffer;  /* it is same with Element-array BufferBind Point */
 	};
 
+	// a cached VAO is set once for a vertex declaration & the vertex buffers its elements read.
+	struct FVertexArrayKey
+	{
+		FVertexArrayKey()
+			: VertexDecl(nullptr)
+		{
+			::memset(Streams, 0, sizeof(Streams));
+		}
+
+		bool operator==(const FVertexArrayKey &Other) const
+		{
+			return VertexDecl == Other.VertexDecl && ::memcmp(Streams, Other.Streams, sizeof(Streams)) == 0;
+		}
+
+		const FRHIOpenGLVertexDeclaration	*VertexDecl;
+		GLuint								Streams[MaxVertexStreamSources];	// 0 for the unused streams
+	};
+
+	struct FVertexArrayKeyHash
+	{
+		size_t operator()(const FVertexArrayKey &InKey) const
+		{
+			uint32_t Hash = GetTypeHash(InKey.VertexDecl);
+			for (uint32_t k = 0; k < MaxVertexStreamSources; k++)
+			{
+				Hash = HashCombine(Hash, InKey.Streams[k]);
+			}
+			return Hash;
+		}
+	};
+
+	struct FVertexArray
+	{
+		FVertexArray()
+			: Resource(0)
+			, ElementArrayBuffer(0)
+		{}
+
+		GLuint							Resource;
+		// the element array binding belongs to the VAO, kept while another one is bound.
+		GLuint							ElementArrayBuffer;
+		FVertexArrayObjectState			State;
+		// held by the cache, the address of a key is not reused by another declaration.
+		FRHIOpenGLVertexDeclarationRef	VertexDecl;
+	};
+
+	typedef std::unordered_map<FVertexArrayKey, FVertexArray, FVertexArrayKeyHash> FVertexArrayCache;
+
 	// Render Context
 	struct FRenderContext
 	{
@@ -199,20 +383,69 @@ protected:
 		FOpenGLBlendStateData		BlendStateCache;
 		FLinearColor				BlendColor;
 
-		GLuint						SharedVAO;
+		// bound out of the draws
+		FVertexArray				SharedVAO;
 		GLuint						BufferBinds[MaxBufferBinds];
 
-		// Vertex Input Attributes
-		FVertexArrayObjectState		VAOState;
+		// indexed uniform buffer binds
+		struct FUniformBufferBind
+		{
+			GLuint		Buffer;
+			GLintptr	Offset;
+			GLsizeiptr	Size;
+		};
+		FUniformBufferBind			UniformBufferBinds[MaxUniformBufferBindings];
+
+		// texture binds per unit, one more unit for the updates.
+		struct FTextureBind
+		{
+			GLenum		Target;
+			GLuint		Texture;
+		};
+		FTextureBind				TextureBinds[MaxTextureUnits + 1];
+		GLuint						ActiveTextureUnit;
+
+		// frame buffer of the draws, null for the viewport.
+		FRHIOpenGLFrameBufferRef	FrameBuffer;
+		GLuint						DrawFrameBufferBind;
+		GLuint						ReadFrameBufferBind;
 
-		// GPU Program
+		// Vertex Input Attributes, the bound VAO
+		FVertexArray				*VertexArray;
+
+		// GPU Program set, the one in use is it or its fallback.
 		FRHIOpenGLGPUProgramRef		GPUProgram;
+		FRHIOpenGLGPUProgramRef		DrawProgram;
+
+		// the states above match it, null after a separate state was set.
+		FRHIOpenGLGraphicsPipelineStateRef	PipelineState;
+	};
+
+	// the dirty bits of the pending states set, a bit per texture unit for the samplers & the textures.
+	enum EPendingStateBits
+	{
+		PSB_SamplerShift = 0,
+		PSB_TextureShift = MaxTextureUnits,
+		PSB_Samplers = ((1u << MaxTextureUnits) - 1) << PSB_SamplerShift,
+		PSB_Textures = ((1u << MaxTextureUnits) - 1) << PSB_TextureShift,
+		PSB_RasterizerState = 1u << (2 * MaxTextureUnits),
+		PSB_DepthStencilState = PSB_RasterizerState << 1,
+		PSB_BlendState = PSB_RasterizerState << 2,
+		PSB_VertexInputs = PSB_RasterizerState << 3,
+		PSB_UniformBuffers = PSB_RasterizerState << 4,		// the ranges of the volatile buffers move at the updates
+		PSB_StreamBuffers = PSB_RasterizerState << 5,		// written since the last draw
+		PSB_All = (PSB_StreamBuffers << 1) - 1
 	};
 
 	// Pending States Set to execute
 	struct FPendingStatesSet
 	{
-		FPendingStatesSet() {}
+		FPendingStatesSet()
+			: DirtyBits(PSB_All)
+		{}
+
+		// set by the RHISet* calls, a draw with no bit set flushes nothing.
+		uint32_t						DirtyBits;
 
 		FRHIOpenGLRasterizerStateRef	RasterizerState;
 		FRHIOpenGLSamplerStateRef		TextureSamplers[MaxTextureUnits];
@@ -226,8 +459,20 @@ protected:
 		// Vertex Inputs
 		FRHIOpenGLVertexDeclarationRef	VertexDecl;
 		FRHIOpenGLVertexBufferRef		VertexStreams[MaxVertexStreamSources];
-		GLboolean						VertexDeclDirty;
-		GLboolean						VertexStreamsDirty;
+
+		FRHIOpenGLUniformBufferRef		UniformBuffers[MaxUniformBufferBindings];
+
+		FRHITextureRef					Textures[MaxTextureUnits];
+	};
+
+	// the held draws, the states are the ones of the first.
+	struct FDrawBatch
+	{
+		FRHIOpenGLIndexBufferRef	IndexBuffer;
+		EPrimitiveType				Mode;
+		uint32_t					EndIndex;	// past the range of the last draw
+		std::vector<GLsizei>		Counts;
+		std::vector<const GLvoid*>	Offsets;
 	};
 
 protected:
@@ -240,18 +485,74 @@ protected:
 	FRenderContext			RenderContext;
 	FPendingStatesSet		PendingStatesSet;
 
-	std::map<FSamplerStateInitializerRHI, FRHISamplerStateRef> SamplerStateCache;
-	std::map<FRasterizerStateInitializerRHI, FRHIRasterizerStateRef> RasterizerStateCache;
-	std::map<FDepthStencilStateInitializerRHI, FRHIDepthStencilStateRef> DepthStencilStateCache;
-	std::map<FBlendStateInitializerRHI, FRHIBlendStateRef> BlendStateCache;
+	TStateCache<FSamplerStateInitializerRHI, FRHISamplerStateRef> SamplerStateCache;
+	TStateCache<FRasterizerStateInitializerRHI, FRHIRasterizerStateRef> RasterizerStateCache;
+	TStateCache<FDepthStencilStateInitializerRHI, FRHIDepthStencilStateRef> DepthStencilStateCache;
+	TStateCache<FBlendStateInitializerRHI, FRHIBlendStateRef> BlendStateCache;
+	TStateCache<FGraphicsPipelineStateInitializerRHI, FRHIGraphicsPipelineStateRef> PipelineStateCache;
+	// the serial of the next pipeline state
+	uint32_t					PipelineStatesNum;
+
+	// the VAOs of the vertex inputs set by the draws
+	FVertexArrayCache			VertexArrayCache;
+	uint32_t					VertexArrayHits;
+	uint32_t					VertexArrayMisses;
+
+	// stream buffers
+	FOpenGLBuffer				UniformRingStorage;
+	FOpenGLStreamBuffer			UniformRingBuffer;
+	FRHIOpenGLVertexBufferRef	TransientVertexBuffer;
+	FOpenGLStreamBuffer			TransientVertexStream;
+	// 16 & 32 bits indices
+	FRHIOpenGLIndexBufferRef	TransientIndexBuffers[2];
+	FOpenGLStreamBuffer			TransientIndexStreams[2];
+	FOpenGLBuffer				PixelUnpackStorage;
+	FOpenGLStreamBuffer			PixelUnpackStream;
+	uint32_t					FrameCounter;
+
+	// draw merging
+	bool						bDrawMerging;
+	FDrawBatch					DrawBatch;
+	FOpenGLDrawMergeStats		DrawMergeStats;
+
+	// program binaries
+	FOpenGLProgramCache			ProgramCache;
+	// async programs not built yet
+	std::vector<FRHIOpenGLGPUProgramRef>	PendingPrograms;
+	uint32_t					AsyncPrograms;
+	uint32_t					FallbackDraws;
+	uint32_t					SkippedDraws;
+
+	// gpu profiling
+	FOpenGLTimerQueries			TimerQueries;
+
+	// occlusion queries, kept alive while they are active
+	FRHIOpenGLOcclusionQueryRef	ActiveOcclusionQuery;
+	FRHIOpenGLOcclusionQueryRef	ConditionalRenderQuery;
 
 	//capabilities
 	GLint		cap_MajorVersion;
 	GLint		cap_MinorVersion;
 	GLint		cap_GL_MAX_TEXTURE_IMAGE_UNITS;
+	GLint		cap_GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS;
+	GLint		cap_GL_MAX_TEXTURE_SIZE;
+	GLint		cap_GL_MAX_CUBE_MAP_TEXTURE_SIZE;
+	GLint		cap_GL_MAX_ARRAY_TEXTURE_LAYERS;
 	GLint		cap_GL_MAX_DRAW_BUFFERS;
+	GLint		cap_GL_MAX_RENDERBUFFER_SIZE;
+	GLint		cap_GL_MAX_SAMPLES;
 	GLint		cap_GL_MAX_ELEMENTS_VERTICES;
 	GLint		cap_GL_MAX_ELEMENTS_INDICES;
+	GLint		cap_GL_MAX_UNIFORM_BUFFER_BINDINGS;
+	GLint		cap_GL_MAX_UNIFORM_BLOCK_SIZE;
+	GLint		cap_GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT;
+	bool		cap_BufferStorage;
+	bool		cap_TextureStorage;
+	bool		cap_DrawIndirect;
+	bool		cap_MultiDrawIndirect;
+	bool		cap_BaseInstance;
+	bool		cap_ProgramBinary;
+	bool		cap_ParallelShaderCompile;
 };
 
 #endif //__JETX_OPENGL_RENDERER_H__
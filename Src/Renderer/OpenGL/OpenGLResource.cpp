@@ -4,6 +4,8 @@
 
 #include "OpenGLDataBuffer.h"
 #include "OpenGLShader.h"
+#include "OpenGLTexture.h"
+#include "OpenGLFrameBuffer.h"
 #include "OpenGLRenderer.h"
 
 
@@ -32,11 +34,25 @@ FRHIIndexBufferRef FOpenGLRenderer::RHICreateIndexBuffer(uint32_t InBytes, const
 	return FRHIIndexBufferRef();
 }
 
+FRHIIndirectBufferRef FOpenGLRenderer::RHICreateIndirectBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess)
+{
+	FRHIOpenGLIndirectBuffer *ArgsBuffer = new FRHIOpenGLIndirectBuffer(this);
+	const bool bInitialized = cap_DrawIndirect ? ArgsBuffer->Initialize(InBytes, InData, InAccess, BU_Draw) : ArgsBuffer->InitializeSystemMemory(InBytes, InData, InAccess);
+	if (bInitialized)
+	{
+		return ArgsBuffer;
+	}
+
+	delete ArgsBuffer;
+	return FRHIIndirectBufferRef();
+}
+
 void FOpenGLRenderer::FillDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, const void *InData)
 {
 	FOpenGLBuffer *OpenGLBuffer = dynamic_cast<FOpenGLBuffer*>(InBuffer.DeRef());
 	if (OpenGLBuffer)
 	{
+		FlushDrawBatch();
 		OpenGLBuffer->FillData(InOffset, InBytes, InData);
 	}
 }
@@ -46,6 +62,8 @@ void* FOpenGLRenderer::LockDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOff
 	FOpenGLBuffer *OpenGLBuffer = dynamic_cast<FOpenGLBuffer*>(InBuffer.DeRef());
 	if (OpenGLBuffer)
 	{
+		// the held draws read the contents before the writes
+		FlushDrawBatch();
 		return OpenGLBuffer->Lock(InOffset, InBytes, InMode);
 	}
 
@@ -61,11 +79,263 @@ void FOpenGLRenderer::UnLockDataBuffer(FRHIDataBufferRef InBuffer)
 	}
 }
 
+void FOpenGLRenderer::FlushDataBufferRange(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes)
+{
+	FOpenGLBuffer *OpenGLBuffer = dynamic_cast<FOpenGLBuffer*>(InBuffer.DeRef());
+	if (OpenGLBuffer)
+	{
+		OpenGLBuffer->FlushRange(InOffset, InBytes);
+	}
+}
+
+// uniform buffers
+FRHIUniformBufferRef FOpenGLRenderer::RHICreateUniformBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess)
+{
+	if (InBytes == 0 || InBytes > (uint32_t)cap_GL_MAX_UNIFORM_BLOCK_SIZE)
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "uniform buffer of %u bytes, the limit is %d bytes", InBytes, cap_GL_MAX_UNIFORM_BLOCK_SIZE);
+		}
+		return FRHIUniformBufferRef();
+	}
+
+	FRHIOpenGLUniformBuffer *UBuffer = new FRHIOpenGLUniformBuffer(this);
+	if (UBuffer && UBuffer->Initialize(InBytes, InData, InAccess))
+	{
+		return UBuffer;
+	}
+
+	delete UBuffer;
+	return FRHIUniformBufferRef();
+}
+
+void FOpenGLRenderer::RHIUpdateUniformBuffer(const FRHIUniformBufferRef &InBuffer, const void *InData)
+{
+	FRHIOpenGLUniformBuffer *OpenGLBuffer = dynamic_cast<FRHIOpenGLUniformBuffer*>(InBuffer.DeRef());
+	if (OpenGLBuffer && InData)
+	{
+		FlushDrawBatch();
+		OpenGLBuffer->Update(InData);
+		// the volatile buffers move in the uniform ring
+		PendingStatesSet.DirtyBits |= PSB_UniformBuffers | PSB_StreamBuffers;
+	}
+}
+
+// transient geometry
+void* FOpenGLRenderer::RHIAllocTransientVertices(uint32_t InBytes, uint32_t InStride, FRHIVertexBufferRef &OutBuffer, uint32_t &OutFirstVertex)
+{
+	assert(InStride > 0);
+	uint32_t Offset = 0;
+	FlushDrawBatch();
+	PendingStatesSet.DirtyBits |= PSB_StreamBuffers;
+	void *Memory = TransientVertexStream.Allocate(InBytes, InStride, Offset);
+	if (!Memory)
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "transient vertices of %u bytes, the stream buffer has %u bytes", InBytes, (uint32_t)OpenGLTransientVertexBytes);
+		}
+		return nullptr;
+	}
+
+	OutBuffer = TransientVertexBuffer.DeRef();
+	OutFirstVertex = Offset / InStride;
+	return Memory;
+}
+
+void* FOpenGLRenderer::RHIAllocTransientIndices(uint32_t InCount, uint16_t InStride, FRHIIndexBufferRef &OutBuffer, uint32_t &OutFirstIndex)
+{
+	assert(InStride == sizeof(uint16_t) || InStride == sizeof(uint32_t));
+	const uint32_t kStream = InStride == sizeof(uint16_t) ? 0 : 1;
+	uint32_t Offset = 0;
+	FlushDrawBatch();
+	PendingStatesSet.DirtyBits |= PSB_StreamBuffers;
+	void *Memory = TransientIndexStreams[kStream].Allocate(InCount * InStride, InStride, Offset);
+	if (!Memory)
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "%u transient indices, the stream buffer has %u bytes", InCount, (uint32_t)OpenGLTransientIndexBytes);
+		}
+		return nullptr;
+	}
+
+	OutBuffer = TransientIndexBuffers[kStream].DeRef();
+	OutFirstIndex = Offset / InStride;
+	return Memory;
+}
+
 FRHIVertexDeclarationRef FOpenGLRenderer::RHICreateVertexInputLayout(const FVertexElement *InVertexElements, uint32_t InCount)
 {
 	return new FRHIOpenGLVertexDeclaration(InVertexElements, InCount);
 }
 
+// textures
+FRHITexture2DRef FOpenGLRenderer::RHICreateTexture2D(uint32_t InSizeX, uint32_t InSizeY, uint32_t InMips, EPixelFormat InFormat)
+{
+	const uint32_t kMips = InMips > 0 ? InMips : GetFullMipsNum(InSizeX, InSizeY);
+	if (InSizeX == 0 || InSizeY == 0 || InSizeX > (uint32_t)cap_GL_MAX_TEXTURE_SIZE || InSizeY > (uint32_t)cap_GL_MAX_TEXTURE_SIZE
+		|| kMips > GetFullMipsNum(InSizeX, InSizeY) || GetPixelFormatBytes(InFormat) == 0)
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "texture2d %ux%u of %u mips and format %d, the size limit is %d", InSizeX, InSizeY, kMips, (int32_t)InFormat, cap_GL_MAX_TEXTURE_SIZE);
+		}
+		return FRHITexture2DRef();
+	}
+
+	FRHIOpenGLTexture2D *Texture = new FRHIOpenGLTexture2D(this, InSizeX, InSizeY, kMips, InFormat);
+	if (Texture && Texture->Initialize(InSizeX, InSizeY, 1, kMips))
+	{
+		return Texture;
+	}
+
+	delete Texture;
+	return FRHITexture2DRef();
+}
+
+FRHITexture2DArrayRef FOpenGLRenderer::RHICreateTexture2DArray(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat)
+{
+	const uint32_t kMips = InMips > 0 ? InMips : GetFullMipsNum(InSizeX, InSizeY);
+	if (InSizeX == 0 || InSizeY == 0 || InSizeX > (uint32_t)cap_GL_MAX_TEXTURE_SIZE || InSizeY > (uint32_t)cap_GL_MAX_TEXTURE_SIZE
+		|| InLayers == 0 || InLayers > (uint32_t)cap_GL_MAX_ARRAY_TEXTURE_LAYERS
+		|| kMips > GetFullMipsNum(InSizeX, InSizeY) || GetPixelFormatBytes(InFormat) == 0)
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "texture2d array %ux%ux%u of %u mips and format %d, the limits are %d & %d layers", InSizeX, InSizeY, InLayers, kMips, (int32_t)InFormat,
+				cap_GL_MAX_TEXTURE_SIZE, cap_GL_MAX_ARRAY_TEXTURE_LAYERS);
+		}
+		return FRHITexture2DArrayRef();
+	}
+
+	FRHIOpenGLTexture2DArray *Texture = new FRHIOpenGLTexture2DArray(this, InSizeX, InSizeY, InLayers, kMips, InFormat);
+	if (Texture && Texture->Initialize(InSizeX, InSizeY, InLayers, kMips))
+	{
+		return Texture;
+	}
+
+	delete Texture;
+	return FRHITexture2DArrayRef();
+}
+
+FRHITextureCubeRef FOpenGLRenderer::RHICreateTextureCube(uint32_t InSize, uint32_t InMips, EPixelFormat InFormat)
+{
+	const uint32_t kMips = InMips > 0 ? InMips : GetFullMipsNum(InSize, InSize);
+	if (InSize == 0 || InSize > (uint32_t)cap_GL_MAX_CUBE_MAP_TEXTURE_SIZE || kMips > GetFullMipsNum(InSize, InSize) || GetPixelFormatBytes(InFormat) == 0)
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "texture cube %u of %u mips and format %d, the size limit is %d", InSize, kMips, (int32_t)InFormat, cap_GL_MAX_CUBE_MAP_TEXTURE_SIZE);
+		}
+		return FRHITextureCubeRef();
+	}
+
+	FRHIOpenGLTextureCube *Texture = new FRHIOpenGLTextureCube(this, InSize, kMips, InFormat);
+	if (Texture && Texture->Initialize(InSize, InSize, CubeFace_MAX, kMips))
+	{
+		return Texture;
+	}
+
+	delete Texture;
+	return FRHITextureCubeRef();
+}
+
+void FOpenGLRenderer::RHIUpdateTexture(const FRHITextureRef &InTexture, uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData)
+{
+	FOpenGLTexture *OpenGLTexture = dynamic_cast<FOpenGLTexture*>(InTexture.DeRef());
+	if (!OpenGLTexture || !InData)
+	{
+		return;
+	}
+
+	if (InMip >= InTexture->GetNumMips() || InLayer >= InTexture->GetSizeZ()
+		|| InX + InWidth > GetMipSize(InTexture->GetSizeX(), InMip) || InY + InHeight > GetMipSize(InTexture->GetSizeY(), InMip))
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "texture update (%u,%u %ux%u) of mip %u layer %u is out of the texture", InX, InY, InWidth, InHeight, InMip, InLayer);
+		}
+		return;
+	}
+
+	FlushDrawBatch();
+	OpenGLTexture->Update(InMip, InLayer, InX, InY, InWidth, InHeight, InData);
+}
+
+void FOpenGLRenderer::RHIGenerateMips(const FRHITextureRef &InTexture)
+{
+	FOpenGLTexture *OpenGLTexture = dynamic_cast<FOpenGLTexture*>(InTexture.DeRef());
+	if (OpenGLTexture)
+	{
+		FlushDrawBatch();
+		OpenGLTexture->GenerateMips();
+	}
+}
+
+// render targets
+FRHIRenderBufferRef FOpenGLRenderer::RHICreateRenderBuffer(uint32_t InSizeX, uint32_t InSizeY, EPixelFormat InFormat, uint32_t InSamples)
+{
+	if (InSizeX == 0 || InSizeY == 0 || InSizeX > (uint32_t)cap_GL_MAX_RENDERBUFFER_SIZE || InSizeY > (uint32_t)cap_GL_MAX_RENDERBUFFER_SIZE
+		|| InSamples == 0 || InSamples > (uint32_t)cap_GL_MAX_SAMPLES || GetPixelFormatBytes(InFormat) == 0)
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "render buffer %ux%u of format %d and %u samples, the limits are %d and %d samples", InSizeX, InSizeY, (int32_t)InFormat, InSamples, cap_GL_MAX_RENDERBUFFER_SIZE, cap_GL_MAX_SAMPLES);
+		}
+		return FRHIRenderBufferRef();
+	}
+
+	FRHIOpenGLRenderBuffer *RenderBuffer = new FRHIOpenGLRenderBuffer(this, InSizeX, InSizeY, InFormat, InSamples);
+	if (RenderBuffer && RenderBuffer->Initialize())
+	{
+		return RenderBuffer;
+	}
+
+	delete RenderBuffer;
+	return FRHIRenderBufferRef();
+}
+
+FRHIFrameBufferRef FOpenGLRenderer::RHICreateFrameBuffer(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget)
+{
+	const char *Error = CheckFrameBufferTargets(InColorTargets, InColorTargetsNum, InDepthStencilTarget);
+	if (Error)
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "failed to create the frame buffer: %s", Error);
+		}
+		return FRHIFrameBufferRef();
+	}
+
+	FRHIOpenGLFrameBuffer *FrameBuffer = new FRHIOpenGLFrameBuffer(this, InColorTargets, InColorTargetsNum, InDepthStencilTarget);
+	if (FrameBuffer && FrameBuffer->Initialize())
+	{
+		return FrameBuffer;
+	}
+
+	if (Logger)
+	{
+		Logger->Log(Log_Error, "the frame buffer of %u color targets is incomplete", InColorTargetsNum);
+	}
+	delete FrameBuffer;
+	return FRHIFrameBufferRef();
+}
+
+// queries
+FRHIOcclusionQueryRef FOpenGLRenderer::RHICreateOcclusionQuery()
+{
+	FRHIOpenGLOcclusionQuery *Query = new FRHIOpenGLOcclusionQuery(this);
+	if (Query && Query->Initialize())
+	{
+		return Query;
+	}
+
+	delete Query;
+	return FRHIOcclusionQueryRef();
+}
+
 // shader
 FRHIVertexShaderRef FOpenGLRenderer::RHICreateVertexShader(const char *InSource, int32_t InLength)
 {
@@ -115,3 +385,29 @@ FRHIGPUProgramRef FOpenGLRenderer::RHICreateGPUProgram(const std::vector<FRHISha
 
 	return GPUProgram;
 }
+
+FRHIGPUProgramRef FOpenGLRenderer::RHICreateGPUProgramAsync(const std::vector<FRHIShaderRef> &InShaders, const FRHIGPUProgramRef &InFallback)
+{
+	FRHIOpenGLGPUProgram *GPUProgram = new FRHIOpenGLGPUProgram(this);
+	if (!GPUProgram)
+	{
+		return FRHIGPUProgramRef();
+	}
+
+	for (uint32_t Index = 0; Index < InShaders.size(); Index++)
+	{
+		GPUProgram->AddShader(InShaders[Index].DeRef());
+	}
+	GPUProgram->SetFallback(dynamic_cast<FRHIOpenGLGPUProgram*>(InFallback.DeRef()));
+
+	// the compiles & the link are issued now, their status is read once the driver is done.
+	if (cap_ParallelShaderCompile && !GPUProgram->BeginBuild())
+	{
+		delete GPUProgram; GPUProgram = nullptr;
+		return FRHIGPUProgramRef();
+	}
+	AsyncPrograms++;
+	PendingPrograms.push_back(GPUProgram);
+
+	return GPUProgram;
+}
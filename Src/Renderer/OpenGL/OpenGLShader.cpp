@@ -3,6 +3,7 @@
 //
 
 #include <cassert>
+#include <cstdio>
 #include "OpenGLRenderer.h"
 #include "OpenGLShader.h"
 
@@ -10,15 +11,54 @@
 FOpenGLShader::FOpenGLShader(GLenum InType, const GLchar *InSource, GLint InLength)
 	: ShaderType(InType)
 	, Resource(0)
+	, bStatusQueried(false)
 	, CompileStatus(GL_FALSE)
 	, InfoLogLength(0)
 	, InfoLog(nullptr)
 {
 	assert(InSource);
 
+	if (InLength < 0)
+	{
+		Source = InSource;
+	}
+	else
+	{
+		Source.assign(InSource, InLength);
+	}
+}
+
+FOpenGLShader::~FOpenGLShader()
+{
+	if (Resource)
+	{
+		glDeleteShader(Resource);
+	}
+	delete[] InfoLog;
+}
+
+void FOpenGLShader::Compile()
+{
+	if (Resource)
+	{
+		return;
+	}
+
+	const GLchar *SourcePtr = Source.c_str();
+	const GLint kLength = (GLint)Source.size();
 	Resource = glCreateShader(ShaderType);
-	glShaderSource(Resource, 1, &InSource, &InLength);
+	glShaderSource(Resource, 1, &SourcePtr, &kLength);
 	glCompileShader(Resource);
+}
+
+void FOpenGLShader::QueryCompileStatus()
+{
+	if (!Resource || bStatusQueried)
+	{
+		return;
+	}
+
+	bStatusQueried = true;
 	glGetShaderiv(Resource, GL_COMPILE_STATUS, &CompileStatus);
 	glGetShaderiv(Resource, GL_INFO_LOG_LENGTH, &InfoLogLength);
 
@@ -32,21 +72,16 @@ FOpenGLShader::FOpenGLShader(GLenum InType, const GLchar *InSource, GLint InLeng
 	}
 }
 
-FOpenGLShader::~FOpenGLShader()
-{
-	glDeleteShader(Resource);
-	delete[] InfoLog;
-}
-
 bool FOpenGLShader::IsValid() const
 {
-	return glIsShader(Resource) == GL_TRUE;
+	return Resource && glIsShader(Resource) == GL_TRUE;
 }
 
 void FOpenGLShader::DumpDebugInfo(FOutputDevice &OutDevice)
 {
+	QueryCompileStatus();
 	OutDevice.Log(Log_Info, "GL-Shader Dump Debug Info:");
-	OutDevice.Log(Log_Info, "    CompileStatus: %s", (CompileStatus ? "TRUE" : "FALSE"));
+	OutDevice.Log(Log_Info, "    CompileStatus: %s", (!Resource ? "NOT COMPILED" : (CompileStatus ? "TRUE" : "FALSE")));
 	OutDevice.Log(Log_Info, "    Info Log: %s", (InfoLog ? InfoLog : ""));
 }
 
@@ -122,6 +157,10 @@ static int32_t GetUniformElementSize(GLenum InType)
 	case GL_SAMPLER_2D:
 	case GL_SAMPLER_3D:
 	case GL_SAMPLER_CUBE:
+	case GL_SAMPLER_2D_ARRAY:
+	case GL_SAMPLER_2D_SHADOW:
+	case GL_SAMPLER_2D_ARRAY_SHADOW:
+	case GL_SAMPLER_CUBE_SHADOW:
 		return sizeof(GLint);
 
 	default:
@@ -131,37 +170,87 @@ static int32_t GetUniformElementSize(GLenum InType)
 }
 
 FOpenGLProgramUniformInput::FOpenGLProgramUniformInput()
-	: Data(nullptr)
-	, DataLen(0)
+	: Modified(false)
 {}
 
 FOpenGLProgramUniformInput::FOpenGLProgramUniformInput(const GLchar* InName, GLenum InType, GLint InSize, GLint InLocation)
 	: FOpenGLProgramInput(InName, InType, InSize, InLocation)
 	, Modified(false)
 {
-	DataLen = GetUniformElementSize(InType);
-	assert(DataLen > 0);
+	const int32_t kElementBytes = GetUniformElementSize(InType);
+	assert(kElementBytes > 0 && InSize > 0);
 
-	Data = new uint8_t[DataLen];
-	assert(Data);
+	// see ReadValue
+	Data.resize(kElementBytes * std::max<GLint>(InSize, 1), 0);
+}
 
-	if (Data)
+void FOpenGLProgramUniformInput::ReadValue(GLuint InProgram)
+{
+	if (Data.empty() || Location < 0)
 	{
-		::memset(Data, 0, DataLen);
+		return;
 	}
-}
 
-FOpenGLProgramUniformInput::~FOpenGLProgramUniformInput()
-{
-	if (Data)
+	// the elements of an array have their own locations, "Name[k]"
+	const uint32_t kElementBytes = (uint32_t)Data.size() / (uint32_t)std::max<GLint>(Size, 1);
+	std::string BaseName(Name);
+	const size_t kBracket = BaseName.rfind("[0]");
+	if (kBracket != std::string::npos && kBracket + 3 == BaseName.size())
 	{
-		delete[] Data; Data = nullptr;
+		BaseName.resize(kBracket);
 	}
+
+	for (GLint k = 0; k < Size; k++)
+	{
+		GLint ElementLocation = Location;
+		if (k > 0)
+		{
+			char Suffix[16];
+			snprintf(Suffix, sizeof(Suffix), "[%d]", k);
+			ElementLocation = glGetUniformLocation(InProgram, (BaseName + Suffix).c_str());
+			if (ElementLocation < 0)
+			{
+				continue;
+			}
+		}
+
+		void *Element = &Data[kElementBytes * k];
+		switch (Type)
+		{
+		case GL_FLOAT:
+		case GL_FLOAT_VEC2:
+		case GL_FLOAT_VEC3:
+		case GL_FLOAT_VEC4:
+		case GL_FLOAT_MAT4:
+			glGetUniformfv(InProgram, ElementLocation, (GLfloat*)Element);
+			break;
+
+		case GL_UNSIGNED_INT:
+		case GL_UNSIGNED_INT_VEC2:
+		case GL_UNSIGNED_INT_VEC3:
+		case GL_UNSIGNED_INT_VEC4:
+		case GL_BOOL:
+		case GL_BOOL_VEC2:
+		case GL_BOOL_VEC3:
+		case GL_BOOL_VEC4:
+			glGetUniformuiv(InProgram, ElementLocation, (GLuint*)Element);
+			break;
+
+		default:
+			// the ints & the samplers
+			glGetUniformiv(InProgram, ElementLocation, (GLint*)Element);
+			break;
+		}
+	} // end for k
 }
 
 
 FRHIOpenGLGPUProgram::FRHIOpenGLGPUProgram(class FOpenGLRenderer *InRenderer)
 	: Renderer(InRenderer)
+	, BuildState(BS_Queued)
+	, PollFrame(~0u)
+	, bSaveToCache(false)
+	, CacheKey(0)
 	, Resource(0)
 	, LinkStatus(GL_FALSE)
 	, InfoLogLength(0)
@@ -186,22 +275,85 @@ void FRHIOpenGLGPUProgram::AddShader(const FRHIShaderRef &InShader)
 
 bool FRHIOpenGLGPUProgram::Build()
 {
+	return BeginBuild() && FinishBuild();
+}
+
+bool FRHIOpenGLGPUProgram::BeginBuild()
+{
+	assert(BuildState == BS_Queued);
+
+	BuildState = BS_Building;
 	Resource = glCreateProgram();
 	if (Resource == 0)
 	{
+		BuildState = BS_Done;
 		return false;
 	}
 
+	FOpenGLProgramCache &ProgramCache = Renderer->GetProgramCache();
+	const bool bCached = ProgramCache.IsEnabled();
+	CacheKey = bCached ? ProgramCache.ComputeKey(Shaders) : 0;
+	if (bCached && ProgramCache.Load(CacheKey, Resource))
+	{
+		return true;
+	}
+
 	for (uint32_t Index = 0; Index < Shaders.size(); Index++)
 	{
 		FOpenGLShader *GLShader = dynamic_cast<FOpenGLShader*>(Shaders[Index].DeRef());
 		assert(GLShader);
 
+		GLShader->Compile();
 		glAttachShader(Resource, GLShader->NativeResource());
 	} // end for Index
 
+	if (bCached)
+	{
+		glProgramParameteri(Resource, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
 	glLinkProgram(Resource);
+	bSaveToCache = bCached;
+	return true;
+}
+
+bool FRHIOpenGLGPUProgram::IsLinkDone() const
+{
+	if (BuildState != BS_Building || !Renderer->SupportsParallelShaderCompile())
+	{
+		return true;
+	}
+
+	GLint Completed = GL_FALSE;
+	glGetProgramiv(Resource, GL_COMPLETION_STATUS_ARB, &Completed);
+	return Completed == GL_TRUE;
+}
+
+bool FRHIOpenGLGPUProgram::IsReady()
+{
+	if (BuildState == BS_Building && PollFrame != Renderer->GetFrameCounter())
+	{
+		// the programs without a parallel compile are built by FOpenGLRenderer::UpdatePendingPrograms
+		PollFrame = Renderer->GetFrameCounter();
+		if (Renderer->SupportsParallelShaderCompile() && IsLinkDone())
+		{
+			Renderer->OnProgramBuilt(this, FinishBuild());
+		}
+	}
+
+	return BuildState == BS_Done && LinkStatus == GL_TRUE;
+}
+
+bool FRHIOpenGLGPUProgram::FinishBuild()
+{
+	assert(BuildState == BS_Building);
+
+	BuildState = BS_Done;
 	glGetProgramiv(Resource, GL_LINK_STATUS, &LinkStatus);
+	if (bSaveToCache && LinkStatus == GL_TRUE)
+	{
+		Renderer->GetProgramCache().Save(CacheKey, Resource);
+	}
+	bSaveToCache = false;
 	glGetProgramiv(Resource, GL_INFO_LOG_LENGTH, &InfoLogLength);
 
 	if (InfoLogLength > 0)
@@ -229,14 +381,56 @@ bool FRHIOpenGLGPUProgram::Build()
 		Attributes.push_back(FOpenGLProgramInput(VarName, VarType, VarSize, VarLocation));
 	} // end for
 
-	  // get active uniforms
+	  // get active uniforms, the members of the blocks come from the uniform buffers.
 	for (GLint Index = 0; Index < UniformsNum; Index++)
 	{
+		GLuint UniformIndex = (GLuint)Index;
+		GLint BlockIndex = -1;
+		glGetActiveUniformsiv(Resource, 1, &UniformIndex, GL_UNIFORM_BLOCK_INDEX, &BlockIndex);
+		if (BlockIndex >= 0)
+		{
+			continue;
+		}
+
 		glGetActiveUniform(Resource, Index, sizeof(VarName), nullptr, &VarSize, &VarType, VarName);
 		VarLocation = glGetUniformLocation(Resource, VarName);
 		Uniforms.push_back(FOpenGLProgramUniformInput(VarName, VarType, VarSize, VarLocation));
+		// a first set equal to the value in the program is skipped, an array is uploaded whole.
+		Uniforms.back().ReadValue(Resource);
+
+		const int32_t kHandle = (int32_t)Uniforms.size() - 1;
+		std::string Name(VarName);
+		UniformHandles.Add(Name, kHandle);
+		// the arrays are reported as "Name[0]"
+		const size_t kBracket = Name.rfind("[0]");
+		if (kBracket != std::string::npos && kBracket + 3 == Name.size())
+		{
+			Name.resize(kBracket);
+			if (!UniformHandles.Find(Name))
+			{
+				UniformHandles.Add(Name, kHandle);
+			}
+		}
+	} // end for
+
+	// get active uniform blocks
+	GLint		BlocksNum;
+	glGetProgramiv(Resource, GL_ACTIVE_UNIFORM_BLOCKS, &BlocksNum);
+	for (GLint Index = 0; Index < BlocksNum; Index++)
+	{
+		GLint BlockBytes = 0, BlockBinding = 0;
+		glGetActiveUniformBlockName(Resource, Index, sizeof(VarName), nullptr, VarName);
+		glGetActiveUniformBlockiv(Resource, Index, GL_UNIFORM_BLOCK_DATA_SIZE, &BlockBytes);
+		glGetActiveUniformBlockiv(Resource, Index, GL_UNIFORM_BLOCK_BINDING, &BlockBinding);
+		UniformBlocks.push_back(FOpenGLProgramInput(VarName, (GLenum)BlockBinding, BlockBytes, Index));
 	} // end for
 
+	for (size_t Index = 0; Index < PendingBlockBindings.size(); Index++)
+	{
+		SetUniformBufferBinding(PendingBlockBindings[Index].Name, (uint32_t)PendingBlockBindings[Index].Location);
+	} // end for
+	PendingBlockBindings.clear();
+
 	return !Renderer->CheckError(__FILE__, __LINE__);
 }
 
@@ -246,6 +440,7 @@ void FRHIOpenGLGPUProgram::Dump(class FOutputDevice &OutDevice)
 	OutDevice.Log(Log_Info, "    LinkStatus: %s", (LinkStatus ? "TRUE" : "FALSE"));
 	OutDevice.Log(Log_Info, "    Active Attributes Count: %d", Attributes.size());
 	OutDevice.Log(Log_Info, "    Active Uniforms Count: %d", Uniforms.size());
+	OutDevice.Log(Log_Info, "    Active Uniform Blocks Count: %d", UniformBlocks.size());
 	OutDevice.Log(Log_Info, "    Info Log: %s", (InfoLog ? InfoLog : ""));
 	OutDevice.Log(Log_Info, "    Input Attributes List:");
 	// dump attributes
@@ -263,6 +458,13 @@ void FRHIOpenGLGPUProgram::Dump(class FOutputDevice &OutDevice)
 		OutDevice.Log(Log_Info, "       name=%s, type=%s, size=%d, location=%d", Element.Name.c_str(),
 			FOpenGLRenderer::LookupShaderUniformTypeName(Element.Type), Element.Size, Element.Location);
 	}
+	// dump uniform blocks
+	OutDevice.Log(Log_Info, "    Uniform Block List:");
+	for (size_t Index = 0; Index < UniformBlocks.size(); Index++)
+	{
+		const FOpenGLProgramInput &Element = UniformBlocks[Index];
+		OutDevice.Log(Log_Info, "       name=%s, bytes=%d, binding=%d", Element.Name.c_str(), Element.Size, (int32_t)Element.Type);
+	}
 }
 
 bool FRHIOpenGLGPUProgram::IsValid() const
@@ -273,16 +475,35 @@ bool FRHIOpenGLGPUProgram::IsValid() const
 // get uniform parameter handle
 int32_t FRHIOpenGLGPUProgram::GetUniformHandle(const std::string &InName)
 {
-	for (size_t Index = 0; Index < Uniforms.size(); Index++)
+	const int32_t *Handle = UniformHandles.Find(InName);
+	return Handle ? *Handle : -1;
+}
+
+bool FRHIOpenGLGPUProgram::SetUniformBufferBinding(const std::string &InBlockName, uint32_t InBindIndex)
+{
+	assert(InBindIndex < MaxUniformBufferBindings);
+
+	if (BuildState != BS_Done)
 	{
-		const FOpenGLProgramInput &Element = Uniforms[Index];
-		if (Element.Name == InName)
+		PendingBlockBindings.push_back(FOpenGLProgramInput(InBlockName.c_str(), 0, 0, (GLint)InBindIndex));
+		return true;
+	}
+
+	for (size_t Index = 0; Index < UniformBlocks.size(); Index++)
+	{
+		FOpenGLProgramInput &Element = UniformBlocks[Index];
+		if (Element.Name == InBlockName)
 		{
-			return (int32_t)Index;
+			if (Element.Type != (GLenum)InBindIndex)
+			{
+				glUniformBlockBinding(Resource, (GLuint)Element.Location, InBindIndex);
+				Element.Type = (GLenum)InBindIndex;
+			}
+			return true;
 		}
 	}
 
-	return -1;
+	return false;
 }
 
 bool FRHIOpenGLGPUProgram::SetUniformCommon(int32_t InHandle, const void *V, uint32_t InBytes, uint32_t /*InCount*/)
@@ -298,8 +519,20 @@ bool FRHIOpenGLGPUProgram::SetUniformCommon(int32_t InHandle, const void *V, uin
 		return false;
 	}
 
+	// the same value is not uploaded again
+	if (::memcmp(Element.DataPtr(), V, InBytes) == 0)
+	{
+		return true;
+	}
+
+	// the held draws were issued with the former value
+	Renderer->OnProgramUniformChanged(this);
 	::memcpy(Element.DataPtr(), V, InBytes);
-	Element.SetModified(true);
+	if (!Element.GetModified())
+	{
+		Element.SetModified(true);
+		DirtyUniforms.push_back(InHandle);
+	}
 	return true;
 }
 
@@ -370,14 +603,10 @@ bool FRHIOpenGLGPUProgram::SetUniformMatrix4fv(int32_t InHandle, const float *V,
 
 void FRHIOpenGLGPUProgram::UpdateUniformVariables()
 {
-	for (size_t Index = 0; Index < Uniforms.size(); Index++)
+	for (size_t Index = 0; Index < DirtyUniforms.size(); Index++)
 	{
-		FOpenGLProgramUniformInput &Element = Uniforms[Index];
-		
-		if (!Element.GetModified())
-		{
-			continue;
-		}
+		FOpenGLProgramUniformInput &Element = Uniforms[DirtyUniforms[Index]];
+		assert(Element.GetModified());
 
 		Element.SetModified(false);
 		switch (Element.Type)
@@ -433,6 +662,10 @@ void FRHIOpenGLGPUProgram::UpdateUniformVariables()
 		case GL_SAMPLER_2D:
 		case GL_SAMPLER_3D:
 		case GL_SAMPLER_CUBE:
+		case GL_SAMPLER_2D_ARRAY:
+		case GL_SAMPLER_2D_SHADOW:
+		case GL_SAMPLER_2D_ARRAY_SHADOW:
+		case GL_SAMPLER_CUBE_SHADOW:
 			glUniform1iv(Element.Location, Element.Size, (GLint*)Element.DataPtr());
 			break;
 
@@ -440,4 +673,6 @@ void FRHIOpenGLGPUProgram::UpdateUniformVariables()
 			assert(0);
 		}
 	} // end for
+
+	DirtyUniforms.clear();
 }
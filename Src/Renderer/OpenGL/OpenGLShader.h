@@ -11,17 +11,24 @@
 #include "Renderer/RHIResource.h"
 #include "PlatformOpenGL.h"
 
+#include <string>
 #include <vector>
 
 
 // \brief
-//		OpenGL Shader
+//		OpenGL Shader, compiled by the first program linked from it: the programs loaded from the
+//		binary cache compile none.
 class FOpenGLShader
 {
 public:
 	virtual ~FOpenGLShader();
 
+	// issue the compile once, its status is read by the dumps only: the link reports the errors.
+	void Compile();
+
 	GLuint NativeResource() const { return Resource; }
+	GLenum GetShaderType() const { return ShaderType; }
+	const std::string& GetSource() const { return Source; }
 	bool IsValid() const;
 	void DumpDebugInfo(FOutputDevice &OutDevice);
 
@@ -29,8 +36,12 @@ protected:
 	FOpenGLShader(GLenum InType, const GLchar *InSource, GLint InLength = -1);
 
 private:
+	void QueryCompileStatus();
+
 	GLenum		ShaderType;
+	std::string	Source;
 	GLuint		Resource;
+	bool		bStatusQueried;
 	GLint		CompileStatus;
 	GLint		InfoLogLength;
 	GLchar     *InfoLog;
@@ -91,25 +102,25 @@ public:
 	GLint			Location;
 };
 
-// uniform variable
+// uniform variable, the data holds the Size elements of an array.
 class FOpenGLProgramUniformInput : public FOpenGLProgramInput 
 {
 public:
 	FOpenGLProgramUniformInput();
 	FOpenGLProgramUniformInput(const GLchar* InName, GLenum InType, GLint InSize, GLint InLocation);
 
-	~FOpenGLProgramUniformInput();
-
 	bool GetModified() const { return Modified; }
 	void SetModified(bool InDirty) { Modified = InDirty; }
 
-	void* DataPtr() const { return Data; }
-	uint32_t DataBytes() const { return DataLen; }
+	void* DataPtr() { return Data.empty() ? nullptr : &Data[0]; }
+	uint32_t DataBytes() const { return (uint32_t)Data.size(); }
+
+	// read the values of the linked InProgram, the initializers of the GLSL included.
+	void ReadValue(GLuint InProgram);
 
 protected:
-	uint8_t		*Data;
-	uint32_t	 DataLen;
-	bool		 Modified;
+	std::vector<uint8_t>	Data;
+	bool					Modified;
 };
 
 // Uniform Input Block
@@ -145,7 +156,21 @@ public:
 	virtual ~FRHIOpenGLGPUProgram();
 
 	void AddShader(const FRHIShaderRef &InShader);
+	// InFallback is drawn with until this one is ready.
+	void SetFallback(FRHIOpenGLGPUProgram *InFallback) { Fallback = InFallback; }
+	FRHIOpenGLGPUProgram* GetFallback() const { return Fallback.DeRef(); }
+
+	// compile & link at once, the status is read.
 	bool Build();
+	// issue the compiles & the link, FinishBuild reads them once IsLinkDone.
+	bool BeginBuild();
+	bool IsLinkDone() const;
+	bool FinishBuild();
+	bool IsQueued() const { return BuildState == BS_Queued; }
+	bool IsBuilding() const { return BuildState == BS_Building; }
+
+	virtual bool IsReady() override;
+	virtual bool HasFailed() override { return BuildState == BS_Done && LinkStatus != GL_TRUE; }
 
 	virtual void Dump(class FOutputDevice &OutDevice) override;
 	// get uniform parameter handle
@@ -168,6 +193,8 @@ public:
 
 	virtual bool SetUniformMatrix4fv(int32_t InHandle, const float *V, uint32_t InCount) override;
 
+	virtual bool SetUniformBufferBinding(const std::string &InBlockName, uint32_t InBindIndex) override;
+
 	void UpdateUniformVariables();
 
 	GLuint NativeResource() const { return Resource; }
@@ -178,6 +205,19 @@ protected:
 private:
 	class FOpenGLRenderer	*Renderer;
 
+	enum EBuildState
+	{
+		BS_Queued,		// no call issued yet
+		BS_Building,	// the link is issued, its status not read
+		BS_Done
+	};
+
+	EBuildState	BuildState;
+	uint32_t	PollFrame;		// the completion is polled once a frame
+	bool		bSaveToCache;
+	uint64_t	CacheKey;
+	TRefCountPtr<FRHIOpenGLGPUProgram>	Fallback;
+
 	GLuint		Resource;
 	GLint		LinkStatus;
 	GLint		InfoLogLength;
@@ -186,6 +226,14 @@ private:
 	std::vector<FRHIShaderRef>			Shaders;
 	std::vector<FOpenGLProgramInput>	Attributes;
 	std::vector<FOpenGLProgramUniformInput>	Uniforms;
+	// the handles by name, an array is found by "Name" & "Name[0]".
+	TStateCache<std::string, int32_t>	UniformHandles;
+	// the uniforms set to a new value since the last draw
+	std::vector<int32_t>				DirtyUniforms;
+	// uniform blocks: Location is the block index, Size the data bytes, Type the binding slot.
+	std::vector<FOpenGLProgramInput>	UniformBlocks;
+	// the bindings set before the link is done: Location is the slot.
+	std::vector<FOpenGLProgramInput>	PendingBlockBindings;
 };
 
 typedef TRefCountPtr<FRHIOpenGLGPUProgram>	FRHIOpenGLGPUProgramRef;
@@ -175,10 +175,10 @@ bool FRHIOpenGLSamplerState::Initialize()
 //State Resource Creating
 FRHISamplerStateRef FOpenGLRenderer::RHICreateSamplerState(const FSamplerStateInitializerRHI &SamplerStateInitializer)
 {
-	std::map<FSamplerStateInitializerRHI, FRHISamplerStateRef>::iterator Target = SamplerStateCache.find(SamplerStateInitializer);
-	if (Target != SamplerStateCache.end())
+	FRHISamplerStateRef *Cached = SamplerStateCache.Find(SamplerStateInitializer);
+	if (Cached)
 	{
-		return Target->second;
+		return *Cached;
 	}
 
 	FRHIOpenGLSamplerState *SamplerState = new FRHIOpenGLSamplerState(this);
@@ -214,16 +214,16 @@ FRHISamplerStateRef FOpenGLRenderer::RHICreateSamplerState(const FSamplerStateIn
 	}
 
 	// add to cache
-	SamplerStateCache.insert(std::make_pair(SamplerStateInitializer, SamplerState));
+	SamplerStateCache.Add(SamplerStateInitializer, SamplerState);
 	return SamplerState;
 }
 
 FRHIRasterizerStateRef FOpenGLRenderer::RHICreateRasterizerState(const FRasterizerStateInitializerRHI &RasterizerStateInitializer)
 {
-	std::map<FRasterizerStateInitializerRHI, FRHIRasterizerStateRef>::iterator Target = RasterizerStateCache.find(RasterizerStateInitializer);
-	if (Target != RasterizerStateCache.end())
+	FRHIRasterizerStateRef *Cached = RasterizerStateCache.Find(RasterizerStateInitializer);
+	if (Cached)
 	{
-		return Target->second;
+		return *Cached;
 	}
 
 	FRHIOpenGLRasterizerState *RasterizerState = new FRHIOpenGLRasterizerState(this);
@@ -241,16 +241,16 @@ FRHIRasterizerStateRef FOpenGLRenderer::RHICreateRasterizerState(const FRasteriz
 	RasterizerState->Data.bEnableDepthOffset = (RasterizerStateInitializer.DepthOffsetFactor != 0.f && RasterizerStateInitializer.DepthOffsetUnits != 0.f);
 
 	// add to cache
-	RasterizerStateCache.insert(std::make_pair(RasterizerStateInitializer, RasterizerState));
+	RasterizerStateCache.Add(RasterizerStateInitializer, RasterizerState);
 	return RasterizerState;
 }
 
 FRHIDepthStencilStateRef FOpenGLRenderer::RHICreateDepthStencilState(const FDepthStencilStateInitializerRHI &DepthStencilStateInitializer)
 {
-	std::map<FDepthStencilStateInitializerRHI, FRHIDepthStencilStateRef>::iterator Target = DepthStencilStateCache.find(DepthStencilStateInitializer);
-	if (Target != DepthStencilStateCache.end())
+	FRHIDepthStencilStateRef *Cached = DepthStencilStateCache.Find(DepthStencilStateInitializer);
+	if (Cached)
 	{
-		return Target->second;
+		return *Cached;
 	}
 
 	FRHIOpenGLDepthStencilState *DepthStencilState = new FRHIOpenGLDepthStencilState(this);
@@ -278,16 +278,16 @@ FRHIDepthStencilStateRef FOpenGLRenderer::RHICreateDepthStencilState(const FDept
 	DepthStencilState->Data.StencilWriteMask = DepthStencilStateInitializer.StencilWriteMask;
 
 	// add to cache
-	DepthStencilStateCache.insert(std::make_pair(DepthStencilStateInitializer, DepthStencilState));
+	DepthStencilStateCache.Add(DepthStencilStateInitializer, DepthStencilState);
 	return DepthStencilState;
 }
 
 FRHIBlendStateRef FOpenGLRenderer::RHICreateBlendState(const FBlendStateInitializerRHI &BlendStateInitializer)
 {
-	std::map<FBlendStateInitializerRHI, FRHIBlendStateRef>::iterator Target = BlendStateCache.find(BlendStateInitializer);
-	if (Target != BlendStateCache.end())
+	FRHIBlendStateRef *Cached = BlendStateCache.Find(BlendStateInitializer);
+	if (Cached)
 	{
-		return Target->second;
+		return *Cached;
 	}
 
 	FRHIOpenGLBlendState *BlendState = new FRHIOpenGLBlendState(this);
@@ -318,7 +318,7 @@ FRHIBlendStateRef FOpenGLRenderer::RHICreateBlendState(const FBlendStateInitiali
 	} // end for k
 
 	// add to cache
-	BlendStateCache.insert(std::make_pair(BlendStateInitializer, BlendState));
+	BlendStateCache.Add(BlendStateInitializer, BlendState);
 	return BlendState;
 }
 
@@ -0,0 +1,257 @@
+// \brief
+//		OpenGL Stream Buffer implementation.
+//
+
+#include <cassert>
+#include <cstring>
+#include "OpenGLRenderer.h"
+#include "OpenGLStreamBuffer.h"
+
+
+static const GLbitfield kPersistentMapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+FOpenGLStreamBuffer::FOpenGLStreamBuffer()
+	: Buffer(nullptr)
+	, Bytes(0)
+	, bPersistent(false)
+	, Memory(nullptr)
+	, Head(0)
+	, RegionStart(0)
+	, DirtyStart(0)
+	, TailStart(0)
+	, TailEnd(0)
+	, bOrphanPending(false)
+	, BytesAllocated(0)
+	, WaitsNum(0)
+	, OrphansNum(0)
+{
+}
+
+FOpenGLStreamBuffer::~FOpenGLStreamBuffer()
+{
+	assert(Memory == nullptr);
+}
+
+bool FOpenGLStreamBuffer::Initialize(FOpenGLBuffer *InBuffer, uint32_t InBytes, bool bInPersistent)
+{
+	Buffer = InBuffer;
+	Bytes = InBytes;
+	bPersistent = bInPersistent;
+	Head = RegionStart = DirtyStart = 0;
+	TailStart = TailEnd = 0;
+	bOrphanPending = false;
+
+	if (bPersistent)
+	{
+		if (!Buffer->InitializeStorage(Bytes, kPersistentMapFlags))
+		{
+			return false;
+		}
+
+		Buffer->Bind();
+		Memory = reinterpret_cast<uint8_t*>(glMapBufferRange(FOpenGLBuffer::TranslateBindTarget(Buffer->Type), 0, Bytes, kPersistentMapFlags));
+		return !(Buffer->Renderer->CheckError(__FILE__, __LINE__)) && Memory != nullptr;
+	}
+
+	if (!Buffer->Initialize(Bytes, nullptr, BA_Stream, BU_Draw))
+	{
+		return false;
+	}
+
+	Shadow.resize(Bytes);
+	Memory = &Shadow[0];
+	return true;
+}
+
+void FOpenGLStreamBuffer::UnInit()
+{
+	for (size_t k = 0; k < FencedRegions.size(); k++)
+	{
+		glDeleteSync(FencedRegions[k].Fence);
+	}
+	FencedRegions.clear();
+
+	if (bPersistent && Memory)
+	{
+		Buffer->Bind();
+		glUnmapBuffer(FOpenGLBuffer::TranslateBindTarget(Buffer->Type));
+	}
+	Memory = nullptr;
+	Shadow.clear();
+
+	if (Buffer)
+	{
+		Buffer->UnInit();
+		Buffer = nullptr;
+	}
+	Bytes = Head = RegionStart = DirtyStart = 0;
+	TailStart = TailEnd = 0;
+	bOrphanPending = false;
+}
+
+void* FOpenGLStreamBuffer::Allocate(uint32_t InBytes, uint32_t InAlignment, uint32_t &OutOffset)
+{
+	if (!Memory || InBytes == 0 || InBytes > Bytes)
+	{
+		return nullptr;
+	}
+
+	// the alignment of the vertices is their stride, not a power of two.
+	const uint32_t kAlignment = InAlignment > 0 ? InAlignment : 1;
+	uint32_t Offset = (Head + kAlignment - 1) / kAlignment * kAlignment;
+	if (Offset + InBytes > Bytes)
+	{
+		if (bPersistent)
+		{
+			// the draws reading the end are not issued yet, it is fenced after them. the end left by
+			// the previous wrap was read by the draws issued since.
+			FenceTail();
+			TailStart = RegionStart;
+			TailEnd = Head;
+		}
+		else if (!bOrphanPending)
+		{
+			// the draws issued keep the old storage, the next one may read the end not uploaded yet.
+			TailStart = DirtyStart;
+			TailEnd = Head;
+			bOrphanPending = true;
+		}
+		Offset = 0;
+		RegionStart = DirtyStart = 0;
+	}
+
+	if (bPersistent)
+	{
+		WaitForRegion(Offset, Offset + InBytes);
+	}
+
+	Head = Offset + InBytes;
+	BytesAllocated += InBytes;
+
+	OutOffset = Offset;
+	return Memory + Offset;
+}
+
+void FOpenGLStreamBuffer::Flush()
+{
+	// the persistent mapping is coherent
+	if (bPersistent)
+	{
+		return;
+	}
+
+	if (bOrphanPending)
+	{
+		Buffer->Bind();
+		glBufferData(FOpenGLBuffer::TranslateBindTarget(Buffer->Type), Bytes, nullptr, GL_STREAM_DRAW);
+		Buffer->Renderer->CheckError(__FILE__, __LINE__);
+		OrphansNum++;
+		bOrphanPending = false;
+
+		Upload(TailStart, TailEnd);
+		TailStart = TailEnd = 0;
+	}
+
+	Upload(DirtyStart, Head);
+	DirtyStart = Head;
+}
+
+void FOpenGLStreamBuffer::Upload(uint32_t InStart, uint32_t InEnd)
+{
+	if (InEnd <= InStart)
+	{
+		return;
+	}
+
+	// only appended since the storage was orphaned, the GPU never reads this range.
+	const GLenum kTarget = FOpenGLBuffer::TranslateBindTarget(Buffer->Type);
+	Buffer->Bind();
+	void *Mapped = glMapBufferRange(kTarget, InStart, InEnd - InStart, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if (Mapped)
+	{
+		memcpy(Mapped, Memory + InStart, InEnd - InStart);
+		glUnmapBuffer(kTarget);
+	}
+	else
+	{
+		glBufferSubData(kTarget, InStart, InEnd - InStart, Memory + InStart);
+	}
+	Buffer->Renderer->CheckError(__FILE__, __LINE__);
+}
+
+void FOpenGLStreamBuffer::EndFrame()
+{
+	if (bPersistent)
+	{
+		FenceRegion();
+	}
+	else
+	{
+		Flush();
+	}
+}
+
+void FOpenGLStreamBuffer::FenceTail()
+{
+	if (TailEnd > TailStart)
+	{
+		FFencedRegion Region;
+		Region.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		Region.Start = TailStart;
+		Region.End = TailEnd;
+		FencedRegions.push_back(Region);
+	}
+	TailStart = TailEnd = 0;
+}
+
+void FOpenGLStreamBuffer::FenceRegion()
+{
+	FenceTail();
+	if (Head > RegionStart)
+	{
+		FFencedRegion Region;
+		Region.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		Region.Start = RegionStart;
+		Region.End = Head;
+		FencedRegions.push_back(Region);
+		RegionStart = Head;
+	}
+}
+
+void FOpenGLStreamBuffer::WaitForRegion(uint32_t InStart, uint32_t InEnd)
+{
+	// the end left by the wrap is read by the draws issued so far.
+	if (TailEnd > TailStart && TailStart < InEnd && InStart < TailEnd)
+	{
+		FenceTail();
+	}
+
+	// the fences are signaled in order, waiting for the oldest ones first never waits too long.
+	for (;;)
+	{
+		bool bOverlapped = false;
+		for (size_t k = 0; k < FencedRegions.size() && !bOverlapped; k++)
+		{
+			bOverlapped = FencedRegions[k].Start < InEnd && InStart < FencedRegions[k].End;
+		}
+		if (!bOverlapped)
+		{
+			break;
+		}
+
+		FFencedRegion &Oldest = FencedRegions.front();
+		GLenum Result = glClientWaitSync(Oldest.Fence, 0, 0);
+		if (Result == GL_TIMEOUT_EXPIRED)
+		{
+			// the GPU is a whole buffer behind
+			WaitsNum++;
+			do
+			{
+				Result = glClientWaitSync(Oldest.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			} while (Result == GL_TIMEOUT_EXPIRED);
+		}
+
+		glDeleteSync(Oldest.Fence);
+		FencedRegions.pop_front();
+	}
+}
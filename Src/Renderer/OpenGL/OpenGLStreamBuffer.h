@@ -0,0 +1,89 @@
+//\brief
+//		OpenGL streaming buffer: per-frame suballocations of one large buffer.
+//
+
+#ifndef __JETX_OPENGL_STREAM_BUFFER_H__
+#define __JETX_OPENGL_STREAM_BUFFER_H__
+
+#include <vector>
+#include <deque>
+#include "Renderer/RendererDefs.h"
+#include "PlatformOpenGL.h"
+#include "OpenGLDataBuffer.h"
+
+
+/** The sizes of the stream buffers of the transient geometry */
+enum { OpenGLTransientVertexBytes = 4 * 1024 * 1024 };
+enum { OpenGLTransientIndexBytes = 1024 * 1024 };
+
+// FOpenGLStreamBuffer
+// hands out ranges of one large buffer, the allocations are written by the CPU without a sync point.
+// persistent: the buffer is mapped once (ARB_buffer_storage) and written directly, the regions the GPU
+//    may still read are guarded by fences (one per frame). the end of the buffer left when it wraps is
+//    fenced after the draws reading it, at the frame end or before the buffer reaches it again.
+// fallback: the data is gathered in a shadow copy and appended unsynchronized before the draws,
+//    the storage is orphaned by the first flush after the buffer wraps: the data left at the end and
+//    not uploaded yet is uploaded again, the next draw may read it.
+class FOpenGLStreamBuffer
+{
+public:
+	FOpenGLStreamBuffer();
+	~FOpenGLStreamBuffer();
+
+	// create the storage of InBuffer, the stream never owns it.
+	bool Initialize(FOpenGLBuffer *InBuffer, uint32_t InBytes, bool bInPersistent);
+	void UnInit();
+
+	// InBytes at an offset multiple of InAlignment, written by the caller before the next Flush.
+	// return nullptr if it does not fit in the buffer at all.
+	void* Allocate(uint32_t InBytes, uint32_t InAlignment, uint32_t &OutOffset);
+	// upload the data allocated since the last flush, before the draws reading it.
+	void Flush();
+	// fence the allocations of the frame.
+	void EndFrame();
+
+	FOpenGLBuffer* GetBuffer() const { return Buffer; }
+	bool IsPersistent() const { return bPersistent; }
+
+	// statistics
+	uint32_t GetBytesAllocated() const { return BytesAllocated; }
+	uint32_t GetWaitsNum() const { return WaitsNum; }
+	uint32_t GetOrphansNum() const { return OrphansNum; }
+
+protected:
+	// [Start, End) of the buffer, read by the commands before Fence.
+	struct FFencedRegion
+	{
+		GLsync		Fence;
+		uint32_t	Start;
+		uint32_t	End;
+	};
+
+	void FenceRegion();
+	void FenceTail();
+	void WaitForRegion(uint32_t InStart, uint32_t InEnd);
+	void Upload(uint32_t InStart, uint32_t InEnd);
+
+	FOpenGLBuffer			*Buffer;
+	uint32_t				Bytes;
+	bool					bPersistent;
+
+	// the persistent mapping or the shadow copy.
+	uint8_t					*Memory;
+	std::vector<uint8_t>	Shadow;
+
+	uint32_t				Head;
+	uint32_t				RegionStart;	// start of the region not fenced yet
+	uint32_t				DirtyStart;		// start of the data not uploaded yet
+	// [TailStart, TailEnd) allocated before the buffer wrapped, not fenced (persistent) or not uploaded (fallback) yet.
+	uint32_t				TailStart;
+	uint32_t				TailEnd;
+	bool					bOrphanPending;
+	std::deque<FFencedRegion>	FencedRegions;
+
+	uint32_t				BytesAllocated;
+	uint32_t				WaitsNum;
+	uint32_t				OrphansNum;
+};
+
+#endif // __JETX_OPENGL_STREAM_BUFFER_H__
@@ -0,0 +1,178 @@
+// \brief
+//		OpenGL Texture implementation.
+//
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include "OpenGLRenderer.h"
+#include "OpenGLTexture.h"
+
+
+bool FOpenGLTexture::TranslatePixelFormat(EPixelFormat InFormat, FOpenGLPixelFormat &OutFormat)
+{
+	static const FOpenGLPixelFormat kFormatTable[PF_Max] =
+	{
+		{ GL_NONE, GL_NONE, GL_NONE },								// PF_Unknown
+		{ GL_R8, GL_RED, GL_UNSIGNED_BYTE },						// PF_R8
+		{ GL_RG8, GL_RG, GL_UNSIGNED_BYTE },						// PF_RG8
+		{ GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE },					// PF_RGBA8
+		{ GL_SRGB8_ALPHA8, GL_RGBA, GL_UNSIGNED_BYTE },				// PF_SRGB8_A8
+		{ GL_R16F, GL_RED, GL_HALF_FLOAT },							// PF_R16F
+		{ GL_RG16F, GL_RG, GL_HALF_FLOAT },							// PF_RG16F
+		{ GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT },						// PF_RGBA16F
+		{ GL_R32F, GL_RED, GL_FLOAT },								// PF_R32F
+		{ GL_RG32F, GL_RG, GL_FLOAT },								// PF_RG32F
+		{ GL_RGBA32F, GL_RGBA, GL_FLOAT },							// PF_RGBA32F
+		{ GL_R11F_G11F_B10F, GL_RGB, GL_UNSIGNED_INT_10F_11F_11F_REV },	// PF_R11G11B10F
+		{ GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT },	// PF_Depth24
+		{ GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8 },	// PF_Depth24Stencil8
+		{ GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT },		// PF_Depth32F
+	};
+
+	if (InFormat <= PF_Unknown || InFormat >= PF_Max)
+	{
+		return false;
+	}
+
+	OutFormat = kFormatTable[InFormat];
+	return true;
+}
+
+FOpenGLTexture::~FOpenGLTexture()
+{
+	UnInit();
+}
+
+bool FOpenGLTexture::Initialize(uint32_t InSizeX, uint32_t InSizeY, uint32_t InSizeZ, uint32_t InMips)
+{
+	FOpenGLPixelFormat GLFormat;
+	if (!TranslatePixelFormat(PixelFormat, GLFormat))
+	{
+		return false;
+	}
+
+	glGenTextures(1, &Resource);
+	if (Resource == 0)
+	{
+		return false;
+	}
+
+	Renderer->BindTextureForUpdate(Target, Resource);
+	if (Renderer->SupportsTextureStorage())
+	{
+		if (Target == GL_TEXTURE_2D_ARRAY)
+		{
+			glTexStorage3D(Target, InMips, GLFormat.InternalFormat, InSizeX, InSizeY, InSizeZ);
+		}
+		else
+		{
+			glTexStorage2D(Target, InMips, GLFormat.InternalFormat, InSizeX, InSizeY);
+		}
+	}
+	else
+	{
+		// the same chain by levels, clamped so the texture is complete.
+		for (uint32_t Mip = 0; Mip < InMips; Mip++)
+		{
+			const GLsizei kSizeX = GetMipSize(InSizeX, Mip);
+			const GLsizei kSizeY = GetMipSize(InSizeY, Mip);
+			if (Target == GL_TEXTURE_2D_ARRAY)
+			{
+				glTexImage3D(Target, Mip, GLFormat.InternalFormat, kSizeX, kSizeY, InSizeZ, 0, GLFormat.Format, GLFormat.Type, nullptr);
+			}
+			else if (Target == GL_TEXTURE_CUBE_MAP)
+			{
+				for (GLenum Face = 0; Face < CubeFace_MAX; Face++)
+				{
+					glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + Face, Mip, GLFormat.InternalFormat, kSizeX, kSizeY, 0, GLFormat.Format, GLFormat.Type, nullptr);
+				}
+			}
+			else
+			{
+				glTexImage2D(Target, Mip, GLFormat.InternalFormat, kSizeX, kSizeY, 0, GLFormat.Format, GLFormat.Type, nullptr);
+			}
+		} // end for Mip
+		glTexParameteri(Target, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(Target, GL_TEXTURE_MAX_LEVEL, InMips - 1);
+	}
+
+	return !(Renderer->CheckError(__FILE__, __LINE__));
+}
+
+void FOpenGLTexture::UnInit()
+{
+	if (Resource)
+	{
+		glDeleteTextures(1, &Resource);
+		Renderer->OnTextureDeleted(Resource);
+		Resource = 0;
+	}
+}
+
+void FOpenGLTexture::Update(uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData)
+{
+	const uint32_t kRowBytes = InWidth * GetPixelFormatBytes(PixelFormat);
+	if (kRowBytes == 0 || InHeight == 0)
+	{
+		return;
+	}
+
+	Renderer->BindTextureForUpdate(Target, Resource);
+
+	// a large update goes in bands of rows, the other updates of the frame share the stream buffer.
+	FOpenGLStreamBuffer &Stream = Renderer->GetPixelUnpackBuffer();
+	const uint32_t kBandRows = (std::max)(1u, (std::min)(InHeight, (uint32_t)(OpenGLPixelUnpackBytes / 4) / kRowBytes));
+	const uint8_t *Pixels = reinterpret_cast<const uint8_t*>(InData);
+
+	for (uint32_t Row = 0; Row < InHeight; Row += kBandRows)
+	{
+		const uint32_t kRows = (std::min)(kBandRows, InHeight - Row);
+		const uint32_t kBytes = kRows * kRowBytes;
+
+		uint32_t Offset = 0;
+		void *Memory = Stream.Allocate(kBytes, 16, Offset);
+		if (Memory)
+		{
+			memcpy(Memory, Pixels + Row * kRowBytes, kBytes);
+			Stream.Flush();
+			Renderer->CachedBindBuffer(PixelUnpack_Buffer, Stream.GetBuffer()->NativeResource());
+			SubImage(InMip, InLayer, InX, InY + Row, InWidth, kRows, reinterpret_cast<const GLvoid*>((uintptr_t)Offset));
+		}
+		else
+		{
+			// copied by the driver from the client memory
+			Renderer->CachedBindBuffer(PixelUnpack_Buffer, 0);
+			SubImage(InMip, InLayer, InX, InY + Row, InWidth, kRows, Pixels + Row * kRowBytes);
+		}
+	} // end for Row
+
+	Renderer->CheckError(__FILE__, __LINE__);
+}
+
+void FOpenGLTexture::SubImage(uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const GLvoid *InPixels)
+{
+	FOpenGLPixelFormat GLFormat;
+	TranslatePixelFormat(PixelFormat, GLFormat);
+
+	switch (Target)
+	{
+	case GL_TEXTURE_2D_ARRAY:
+		glTexSubImage3D(Target, InMip, InX, InY, InLayer, InWidth, InHeight, 1, GLFormat.Format, GLFormat.Type, InPixels);
+		break;
+	case GL_TEXTURE_CUBE_MAP:
+		assert(InLayer < CubeFace_MAX);
+		glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + InLayer, InMip, InX, InY, InWidth, InHeight, GLFormat.Format, GLFormat.Type, InPixels);
+		break;
+	default:
+		glTexSubImage2D(Target, InMip, InX, InY, InWidth, InHeight, GLFormat.Format, GLFormat.Type, InPixels);
+		break;
+	}
+}
+
+void FOpenGLTexture::GenerateMips()
+{
+	Renderer->BindTextureForUpdate(Target, Resource);
+	glGenerateMipmap(Target);
+	Renderer->CheckError(__FILE__, __LINE__);
+}
@@ -0,0 +1,94 @@
+//\brief
+//		OpenGL Resource: Texture
+//
+
+#ifndef __JETX_OPENGL_TEXTURE_H__
+#define __JETX_OPENGL_TEXTURE_H__
+
+#include "Renderer/RendererDefs.h"
+#include "Renderer/RHIResource.h"
+#include "PlatformOpenGL.h"
+
+
+/** The size of the stream buffer the texture updates are staged in */
+enum { OpenGLPixelUnpackBytes = 8 * 1024 * 1024 };
+
+// GL formats of a pixel format
+struct FOpenGLPixelFormat
+{
+	GLenum	InternalFormat;
+	GLenum	Format;
+	GLenum	Type;
+};
+
+// FOpenGLTexture
+// the storage is allocated once for all the mips (glTexStorage), the updates are copied to the
+// pixel-unpack stream buffer and read by the GPU from there, the call does not wait for the upload.
+class FOpenGLTexture
+{
+public:
+	FOpenGLTexture(class FOpenGLRenderer *InRenderer, GLenum InTarget, EPixelFormat InFormat)
+		: Renderer(InRenderer)
+		, Target(InTarget)
+		, Resource(0)
+		, PixelFormat(InFormat)
+	{}
+
+	virtual ~FOpenGLTexture();
+
+	// InSizeZ is the layers of an array.
+	bool Initialize(uint32_t InSizeX, uint32_t InSizeY, uint32_t InSizeZ, uint32_t InMips);
+	void UnInit();
+
+	// InLayer is the layer of an array or the face of a cube.
+	void Update(uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData);
+	void GenerateMips();
+
+	GLenum GetTarget() const { return Target; }
+	GLuint NativeResource() const { return Resource; }
+
+	static bool TranslatePixelFormat(EPixelFormat InFormat, FOpenGLPixelFormat &OutFormat);
+protected:
+	void SubImage(uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const GLvoid *InPixels);
+
+public:
+	class FOpenGLRenderer	*Renderer;
+	GLenum					Target;
+	GLuint					Resource;
+	EPixelFormat			PixelFormat;
+};
+
+// 2D Texture
+class FRHIOpenGLTexture2D : public FRHITexture2D, public FOpenGLTexture
+{
+public:
+	FRHIOpenGLTexture2D(class FOpenGLRenderer *InRenderer, uint32_t InSizeX, uint32_t InSizeY, uint32_t InMips, EPixelFormat InFormat)
+		: FRHITexture2D(InSizeX, InSizeY, InMips, InFormat)
+		, FOpenGLTexture(InRenderer, GL_TEXTURE_2D, InFormat)
+	{}
+	virtual ~FRHIOpenGLTexture2D() {}
+};
+
+// 2D Texture Array
+class FRHIOpenGLTexture2DArray : public FRHITexture2DArray, public FOpenGLTexture
+{
+public:
+	FRHIOpenGLTexture2DArray(class FOpenGLRenderer *InRenderer, uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat)
+		: FRHITexture2DArray(InSizeX, InSizeY, InLayers, InMips, InFormat)
+		, FOpenGLTexture(InRenderer, GL_TEXTURE_2D_ARRAY, InFormat)
+	{}
+	virtual ~FRHIOpenGLTexture2DArray() {}
+};
+
+// Cube Texture
+class FRHIOpenGLTextureCube : public FRHITextureCube, public FOpenGLTexture
+{
+public:
+	FRHIOpenGLTextureCube(class FOpenGLRenderer *InRenderer, uint32_t InSize, uint32_t InMips, EPixelFormat InFormat)
+		: FRHITextureCube(InSize, InMips, InFormat)
+		, FOpenGLTexture(InRenderer, GL_TEXTURE_CUBE_MAP, InFormat)
+	{}
+	virtual ~FRHIOpenGLTextureCube() {}
+};
+
+#endif // __JETX_OPENGL_TEXTURE_H__
@@ -0,0 +1,62 @@
+// \brief
+//		OpenGL Uniform Buffer implementation.
+//
+
+#include <cassert>
+#include <cstring>
+#include "OpenGLRenderer.h"
+#include "OpenGLUniformBuffer.h"
+
+
+//////////////////////////////////////////////////////////////////////////
+// Uniform Buffer
+FRHIOpenGLUniformBuffer::FRHIOpenGLUniformBuffer(class FOpenGLRenderer *InRenderer)
+	: FOpenGLBuffer(InRenderer, Uniform_Buffer)
+	, BindBuffer(0)
+	, BindOffset(0)
+	, UpdateFrame(0)
+{
+}
+
+bool FRHIOpenGLUniformBuffer::Initialize(uint32_t InBytes, const void *InData, EBufferAccess InAccess)
+{
+	if (InAccess == BA_Static)
+	{
+		if (!FOpenGLBuffer::Initialize(InBytes, InData, InAccess, BU_Draw))
+		{
+			return false;
+		}
+
+		BindBuffer = Resource;
+		BindOffset = 0;
+		return true;
+	}
+
+	Bytes = InBytes;
+	Access = InAccess;
+	Usage = BU_Draw;
+	return InData ? Update(InData) : true;
+}
+
+bool FRHIOpenGLUniformBuffer::Update(const void *InData)
+{
+	if (!IsVolatile())
+	{
+		FillData(0, Bytes, InData);
+		return true;
+	}
+
+	FOpenGLStreamBuffer &RingBuffer = Renderer->GetUniformRingBuffer();
+	uint32_t Offset = 0;
+	void *Memory = RingBuffer.Allocate(Bytes, Renderer->GetUniformBufferAlignment(), Offset);
+	if (!Memory)
+	{
+		return false;
+	}
+
+	memcpy(Memory, InData, Bytes);
+	BindBuffer = RingBuffer.GetBuffer()->NativeResource();
+	BindOffset = Offset;
+	UpdateFrame = Renderer->GetFrameCounter();
+	return true;
+}
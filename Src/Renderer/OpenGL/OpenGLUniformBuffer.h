@@ -0,0 +1,41 @@
+//\brief
+//		OpenGL Resource: Uniform Buffer
+//
+
+#ifndef __JETX_OPENGL_UNIFORM_BUFFER_H__
+#define __JETX_OPENGL_UNIFORM_BUFFER_H__
+
+#include "Renderer/RendererDefs.h"
+#include "Renderer/RHIResource.h"
+#include "PlatformOpenGL.h"
+#include "OpenGLDataBuffer.h"
+
+
+/** The size of the stream buffer the volatile uniform buffers are allocated from */
+enum { OpenGLUniformRingBytes = 4 * 1024 * 1024 };
+
+// Uniform Buffer
+// a static buffer owns a GL buffer, a volatile one (BA_Dynamic/BA_Stream) lives in the uniform stream buffer.
+class FRHIOpenGLUniformBuffer : public FRHIUniformBuffer, public FOpenGLBuffer
+{
+public:
+	FRHIOpenGLUniformBuffer(class FOpenGLRenderer *InRenderer);
+	virtual ~FRHIOpenGLUniformBuffer() {}
+
+	virtual uint32_t GetBytes() override { return Bytes; }
+
+	bool Initialize(uint32_t InBytes, const void *InData, EBufferAccess InAccess);
+	bool Update(const void *InData);
+
+	bool IsVolatile() const { return Access != BA_Static; }
+
+	// the range to bind: the own buffer, or the stream buffer and the offset of the last update.
+	GLuint	BindBuffer;
+	GLintptr	BindOffset;
+	// the frame the volatile contents were written in.
+	uint32_t	UpdateFrame;
+};
+
+typedef TRefCountPtr<FRHIOpenGLUniformBuffer>	FRHIOpenGLUniformBufferRef;
+
+#endif // __JETX_OPENGL_UNIFORM_BUFFER_H__
@@ -0,0 +1,2053 @@
+// \brief
+//		RHI capture & replay implementation.
+//
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+
+#include "RHICapture.h"
+
+
+// "JXRT"
+static const uint32_t kCaptureMagic = 0x5452584A;
+static const uint32_t kCaptureVersion = 1;
+
+static double GetCaptureSeconds()
+{
+	typedef std::chrono::high_resolution_clock FClock;
+	static const FClock::time_point sStartTime = FClock::now();
+
+	return std::chrono::duration<double>(FClock::now() - sStartTime).count();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FRHICaptureArchive
+
+void FRHICaptureArchive::Write(const void *InData, uint32_t InBytes)
+{
+	if (InBytes > 0)
+	{
+		const uint8_t *Bytes = reinterpret_cast<const uint8_t*>(InData);
+		Data.insert(Data.end(), Bytes, Bytes + InBytes);
+	}
+}
+
+void FRHICaptureArchive::WriteBlob(const void *InData, uint32_t InBytes)
+{
+	Write(InData ? InBytes : 0u);
+	if (InData)
+	{
+		Write(InData, InBytes);
+	}
+}
+
+bool FRHICaptureArchive::Read(void *OutData, uint32_t InBytes)
+{
+	if (Cursor + InBytes > Data.size())
+	{
+		Cursor = Data.size();
+		return false;
+	}
+
+	if (InBytes > 0)
+	{
+		memcpy(OutData, &Data[Cursor], InBytes);
+		Cursor += InBytes;
+	}
+	return true;
+}
+
+const uint8_t* FRHICaptureArchive::ReadBlob(uint32_t &OutBytes)
+{
+	OutBytes = 0;
+	if (!Read(OutBytes) || Cursor + OutBytes > Data.size())
+	{
+		Cursor = Data.size();
+		OutBytes = 0;
+		return nullptr;
+	}
+
+	const uint8_t *Blob = Data.data() + Cursor;
+	Cursor += OutBytes;
+	return Blob;
+}
+
+bool FRHICaptureArchive::SaveToFile(const char *InFileName) const
+{
+	std::ofstream File(InFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!File.is_open())
+	{
+		return false;
+	}
+
+	File.write(reinterpret_cast<const char*>(Data.data()), Data.size());
+	return File.good();
+}
+
+bool FRHICaptureArchive::LoadFromFile(const char *InFileName)
+{
+	std::ifstream File(InFileName, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!File.is_open())
+	{
+		return false;
+	}
+
+	std::streamsize Size = File.tellg();
+	File.seekg(0, std::ios::beg);
+
+	Data.resize((size_t)Size);
+	Cursor = 0;
+	if (Size > 0 && !File.read(reinterpret_cast<char*>(Data.data()), Size))
+	{
+		Data.clear();
+		return false;
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FRHIRecordingGPUProgram
+// the program seen by the application, the uniforms are recorded before forwarding.
+class FRHIRecordingGPUProgram : public FRHIGPUProgram
+{
+public:
+	FRHIRecordingGPUProgram(FRecordingRenderer *InRecorder, const FRHIGPUProgramRef &InProgram)
+		: Recorder(InRecorder)
+		, Program(InProgram)
+	{}
+
+	FRHIGPUProgram* GetProgram() const { return Program.DeRef(); }
+
+	virtual void Dump(class FOutputDevice &OutDevice) override
+	{
+		Program->Dump(OutDevice);
+	}
+
+	virtual bool IsReady() override
+	{
+		return Program->IsReady();
+	}
+
+	virtual bool HasFailed() override
+	{
+		return Program->HasFailed();
+	}
+
+	virtual int32_t GetUniformHandle(const std::string &InName) override
+	{
+		int32_t Handle = Program->GetUniformHandle(InName);
+
+		FRHICaptureArchive &Trace = Recorder->GetArchive();
+		Recorder->WriteCommand(RCC_GetUniformHandle);
+		Trace.Write(Recorder->GetResourceId(this));
+		Trace.Write(Handle);
+		Trace.WriteBlob(InName.c_str(), (uint32_t)InName.length());
+
+		return Handle;
+	}
+
+	virtual bool SetUniform1iv(int32_t InHandle, const int32_t *V, uint32_t InCount) override
+	{
+		RecordUniform(RCU_1iv, InHandle, V, InCount * 1 * sizeof(int32_t), InCount);
+		return Program->SetUniform1iv(InHandle, V, InCount);
+	}
+	virtual bool SetUniform2iv(int32_t InHandle, const int32_t *V, uint32_t InCount) override
+	{
+		RecordUniform(RCU_2iv, InHandle, V, InCount * 2 * sizeof(int32_t), InCount);
+		return Program->SetUniform2iv(InHandle, V, InCount);
+	}
+	virtual bool SetUniform3iv(int32_t InHandle, const int32_t *V, uint32_t InCount) override
+	{
+		RecordUniform(RCU_3iv, InHandle, V, InCount * 3 * sizeof(int32_t), InCount);
+		return Program->SetUniform3iv(InHandle, V, InCount);
+	}
+	virtual bool SetUniform4iv(int32_t InHandle, const int32_t *V, uint32_t InCount) override
+	{
+		RecordUniform(RCU_4iv, InHandle, V, InCount * 4 * sizeof(int32_t), InCount);
+		return Program->SetUniform4iv(InHandle, V, InCount);
+	}
+
+	virtual bool SetUniform1uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount) override
+	{
+		RecordUniform(RCU_1uiv, InHandle, V, InCount * 1 * sizeof(uint32_t), InCount);
+		return Program->SetUniform1uiv(InHandle, V, InCount);
+	}
+	virtual bool SetUniform2uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount) override
+	{
+		RecordUniform(RCU_2uiv, InHandle, V, InCount * 2 * sizeof(uint32_t), InCount);
+		return Program->SetUniform2uiv(InHandle, V, InCount);
+	}
+	virtual bool SetUniform3uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount) override
+	{
+		RecordUniform(RCU_3uiv, InHandle, V, InCount * 3 * sizeof(uint32_t), InCount);
+		return Program->SetUniform3uiv(InHandle, V, InCount);
+	}
+	virtual bool SetUniform4uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount) override
+	{
+		RecordUniform(RCU_4uiv, InHandle, V, InCount * 4 * sizeof(uint32_t), InCount);
+		return Program->SetUniform4uiv(InHandle, V, InCount);
+	}
+
+	virtual bool SetUniform1fv(int32_t InHandle, const float *V, uint32_t InCount) override
+	{
+		RecordUniform(RCU_1fv, InHandle, V, InCount * 1 * sizeof(float), InCount);
+		return Program->SetUniform1fv(InHandle, V, InCount);
+	}
+	virtual bool SetUniform2fv(int32_t InHandle, const float *V, uint32_t InCount) override
+	{
+		RecordUniform(RCU_2fv, InHandle, V, InCount * 2 * sizeof(float), InCount);
+		return Program->SetUniform2fv(InHandle, V, InCount);
+	}
+	virtual bool SetUniform3fv(int32_t InHandle, const float *V, uint32_t InCount) override
+	{
+		RecordUniform(RCU_3fv, InHandle, V, InCount * 3 * sizeof(float), InCount);
+		return Program->SetUniform3fv(InHandle, V, InCount);
+	}
+	virtual bool SetUniform4fv(int32_t InHandle, const float *V, uint32_t InCount) override
+	{
+		RecordUniform(RCU_4fv, InHandle, V, InCount * 4 * sizeof(float), InCount);
+		return Program->SetUniform4fv(InHandle, V, InCount);
+	}
+
+	virtual bool SetUniformMatrix4fv(int32_t InHandle, const float *V, uint32_t InCount) override
+	{
+		RecordUniform(RCU_Matrix4fv, InHandle, V, InCount * 16 * sizeof(float), InCount);
+		return Program->SetUniformMatrix4fv(InHandle, V, InCount);
+	}
+
+	virtual bool SetUniformBufferBinding(const std::string &InBlockName, uint32_t InBindIndex) override
+	{
+		FRHICaptureArchive &Trace = Recorder->GetArchive();
+		Recorder->WriteCommand(RCC_SetUniformBufferBinding);
+		Trace.Write(Recorder->GetResourceId(this));
+		Trace.Write(InBindIndex);
+		Trace.WriteBlob(InBlockName.c_str(), (uint32_t)InBlockName.length());
+
+		return Program->SetUniformBufferBinding(InBlockName, InBindIndex);
+	}
+
+protected:
+	void RecordUniform(ERHICaptureUniformType InType, int32_t InHandle, const void *V, uint32_t InBytes, uint32_t InCount)
+	{
+		FRHICaptureArchive &Trace = Recorder->GetArchive();
+		Recorder->WriteCommand(RCC_SetUniform);
+		Trace.Write(Recorder->GetResourceId(this));
+		Trace.Write(InHandle);
+		Trace.Write((uint8_t)InType);
+		Trace.Write(InCount);
+		Trace.WriteBlob(V, InBytes);
+	}
+
+	FRecordingRenderer	*Recorder;
+	FRHIGPUProgramRef	Program;
+};
+
+static inline FRHIGPUProgram* UnwrapGPUProgram(FRHIGPUProgram *InProgram)
+{
+	FRHIRecordingGPUProgram *Proxy = dynamic_cast<FRHIRecordingGPUProgram*>(InProgram);
+	return Proxy ? Proxy->GetProgram() : InProgram;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FRecordingRenderer
+
+FRecordingRenderer::FRecordingRenderer(FRenderer *InRenderer)
+	: Renderer(InRenderer)
+	, Logger(nullptr)
+	, NextResourceId(1)
+{
+	assert(Renderer != nullptr);
+
+	Trace.Write(kCaptureMagic);
+	Trace.Write(kCaptureVersion);
+}
+
+FRecordingRenderer::~FRecordingRenderer()
+{
+}
+
+uint32_t FRecordingRenderer::GetResourceId(FRHIResource *InResource) const
+{
+	if (!InResource)
+	{
+		return 0;
+	}
+
+	std::unordered_map<FRHIResource*, uint32_t>::const_iterator It = ResourceIds.find(InResource);
+	return It != ResourceIds.end() ? It->second : 0;
+}
+
+uint32_t FRecordingRenderer::RegisterResource(FRHIResource *InResource)
+{
+	if (!InResource)
+	{
+		return 0;
+	}
+
+	// a new address may reuse the one of a released resource
+	uint32_t Id = NextResourceId++;
+	ResourceIds[InResource] = Id;
+	return Id;
+}
+
+FRHIGPUProgramRef FRecordingRenderer::WrapGPUProgram(const FRHIGPUProgramRef &InProgram)
+{
+	if (!InProgram.IsValidRef())
+	{
+		return InProgram;
+	}
+
+	return new FRHIRecordingGPUProgram(this, InProgram);
+}
+
+//Init
+void FRecordingRenderer::Init(FOutputDevice *LogOutputDevice)
+{
+	Logger = LogOutputDevice;
+	Renderer->Init(LogOutputDevice);
+
+	if (Logger)
+	{
+		Logger->Log(Log_Info, "RHI capture is on.");
+	}
+}
+
+void FRecordingRenderer::Shutdown()
+{
+	TransientWrites.clear();
+	TransientVertexBuffer.SafeRelease();
+	TransientIndexBuffers[0].SafeRelease();
+	TransientIndexBuffers[1].SafeRelease();
+
+	Renderer->Shutdown();
+	LockedBuffers.clear();
+}
+
+//Capabilities
+void FRecordingRenderer::DumpCapabilities()
+{
+	Renderer->DumpCapabilities();
+}
+
+//Options
+void FRecordingRenderer::SetProgramCacheDirectory(const char *InDirectory)
+{
+	Renderer->SetProgramCacheDirectory(InDirectory);
+}
+
+void FRecordingRenderer::SetDrawMergingEnabled(bool bEnabled)
+{
+	Renderer->SetDrawMergingEnabled(bEnabled);
+}
+
+//render viewport
+FRHIViewportRef FRecordingRenderer::RHICreateViewport(void* InWindowHandle, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen)
+{
+	FRHIViewportRef Viewport = Renderer->RHICreateViewport(InWindowHandle, SizeX, SizeY, bIsFullscreen);
+
+	WriteCommand(RCC_CreateViewport);
+	Trace.Write(RegisterResource(Viewport.DeRef()));
+	Trace.Write(SizeX);
+	Trace.Write(SizeY);
+	Trace.Write(bIsFullscreen);
+
+	return Viewport;
+}
+
+void FRecordingRenderer::RHIResizeViewport(FRHIViewportRef InViewport, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen)
+{
+	WriteCommand(RCC_ResizeViewport);
+	Trace.Write(GetResourceId(InViewport.DeRef()));
+	Trace.Write(SizeX);
+	Trace.Write(SizeY);
+	Trace.Write(bIsFullscreen);
+
+	Renderer->RHIResizeViewport(InViewport, SizeX, SizeY, bIsFullscreen);
+}
+
+bool FRecordingRenderer::RHIGetAvailableResolutions(FScreenResolutionArray& Resolutions, bool bIgnoreRefreshRate)
+{
+	return Renderer->RHIGetAvailableResolutions(Resolutions, bIgnoreRefreshRate);
+}
+
+void FRecordingRenderer::RHIGetSupportedResolution(uint32_t& Width, uint32_t& Height)
+{
+	Renderer->RHIGetSupportedResolution(Width, Height);
+}
+
+//Resource Creating
+FRHISamplerStateRef FRecordingRenderer::RHICreateSamplerState(const FSamplerStateInitializerRHI &SamplerStateInitializer)
+{
+	FRHISamplerStateRef State = Renderer->RHICreateSamplerState(SamplerStateInitializer);
+
+	WriteCommand(RCC_CreateSamplerState);
+	Trace.Write(RegisterResource(State.DeRef()));
+	Trace.Write(SamplerStateInitializer);
+
+	return State;
+}
+
+FRHIRasterizerStateRef FRecordingRenderer::RHICreateRasterizerState(const FRasterizerStateInitializerRHI &RasterizerStateInitializer)
+{
+	FRHIRasterizerStateRef State = Renderer->RHICreateRasterizerState(RasterizerStateInitializer);
+
+	WriteCommand(RCC_CreateRasterizerState);
+	Trace.Write(RegisterResource(State.DeRef()));
+	Trace.Write(RasterizerStateInitializer);
+
+	return State;
+}
+
+FRHIDepthStencilStateRef FRecordingRenderer::RHICreateDepthStencilState(const FDepthStencilStateInitializerRHI &DepthStencilStateInitializer)
+{
+	FRHIDepthStencilStateRef State = Renderer->RHICreateDepthStencilState(DepthStencilStateInitializer);
+
+	WriteCommand(RCC_CreateDepthStencilState);
+	Trace.Write(RegisterResource(State.DeRef()));
+	Trace.Write(DepthStencilStateInitializer);
+
+	return State;
+}
+
+FRHIBlendStateRef FRecordingRenderer::RHICreateBlendState(const FBlendStateInitializerRHI &BlendStateInitializer)
+{
+	FRHIBlendStateRef State = Renderer->RHICreateBlendState(BlendStateInitializer);
+
+	WriteCommand(RCC_CreateBlendState);
+	Trace.Write(RegisterResource(State.DeRef()));
+	Trace.Write(BlendStateInitializer);
+
+	return State;
+}
+
+FRHIGraphicsPipelineStateRef FRecordingRenderer::RHICreateGraphicsPipelineState(const FGraphicsPipelineStateInitializerRHI &PipelineStateInitializer)
+{
+	FGraphicsPipelineStateInitializerRHI Initializer = PipelineStateInitializer;
+	Initializer.GPUProgram = UnwrapGPUProgram(PipelineStateInitializer.GPUProgram.DeRef());
+	FRHIGraphicsPipelineStateRef State = Renderer->RHICreateGraphicsPipelineState(Initializer);
+
+	WriteCommand(RCC_CreateGraphicsPipelineState);
+	Trace.Write(RegisterResource(State.DeRef()));
+	Trace.Write(GetResourceId(PipelineStateInitializer.RasterizerState.DeRef()));
+	Trace.Write(GetResourceId(PipelineStateInitializer.DepthStencilState.DeRef()));
+	Trace.Write(GetResourceId(PipelineStateInitializer.BlendState.DeRef()));
+	Trace.Write(GetResourceId(PipelineStateInitializer.GPUProgram.DeRef()));
+	Trace.Write(GetResourceId(PipelineStateInitializer.VertexDecl.DeRef()));
+
+	return State;
+}
+
+// data buffers
+FRHIVertexBufferRef FRecordingRenderer::RHICreateVertexBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess, EBufferUsage InUsage)
+{
+	FRHIVertexBufferRef Buffer = Renderer->RHICreateVertexBuffer(InBytes, InData, InAccess, InUsage);
+
+	WriteCommand(RCC_CreateVertexBuffer);
+	Trace.Write(RegisterResource(Buffer.DeRef()));
+	Trace.Write(InBytes);
+	Trace.Write((int32_t)InAccess);
+	Trace.Write((int32_t)InUsage);
+	Trace.WriteBlob(InData, InBytes);
+
+	return Buffer;
+}
+
+FRHIIndexBufferRef FRecordingRenderer::RHICreateIndexBuffer(uint32_t InBytes, const void *InData, uint16_t InStride, EBufferAccess InAccess, EBufferUsage InUsage)
+{
+	FRHIIndexBufferRef Buffer = Renderer->RHICreateIndexBuffer(InBytes, InData, InStride, InAccess, InUsage);
+
+	WriteCommand(RCC_CreateIndexBuffer);
+	Trace.Write(RegisterResource(Buffer.DeRef()));
+	Trace.Write(InBytes);
+	Trace.Write(InStride);
+	Trace.Write((int32_t)InAccess);
+	Trace.Write((int32_t)InUsage);
+	Trace.WriteBlob(InData, InBytes);
+
+	return Buffer;
+}
+
+FRHIIndirectBufferRef FRecordingRenderer::RHICreateIndirectBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess)
+{
+	FRHIIndirectBufferRef Buffer = Renderer->RHICreateIndirectBuffer(InBytes, InData, InAccess);
+
+	WriteCommand(RCC_CreateIndirectBuffer);
+	Trace.Write(RegisterResource(Buffer.DeRef()));
+	Trace.Write(InBytes);
+	Trace.Write((int32_t)InAccess);
+	Trace.WriteBlob(InData, InBytes);
+
+	return Buffer;
+}
+
+void FRecordingRenderer::FillDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, const void *InData)
+{
+	WriteCommand(RCC_FillDataBuffer);
+	Trace.Write(GetResourceId(InBuffer.DeRef()));
+	Trace.Write(InOffset);
+	Trace.WriteBlob(InData, InBytes);
+
+	Renderer->FillDataBuffer(InBuffer, InOffset, InBytes, InData);
+}
+
+void* FRecordingRenderer::LockDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, EBufferLockMode InMode)
+{
+	void *Memory = Renderer->LockDataBuffer(InBuffer, InOffset, InBytes, InMode);
+
+	WriteCommand(RCC_LockDataBuffer);
+	Trace.Write(GetResourceId(InBuffer.DeRef()));
+	Trace.Write(InOffset);
+	Trace.Write(InBytes);
+	Trace.Write((int32_t)InMode);
+
+	if (Memory)
+	{
+		FLockRecord &Record = LockedBuffers[InBuffer.DeRef()];
+		Record.Offset = InOffset;
+		Record.Bytes = InBytes;
+		Record.Mode = InMode;
+		Record.Memory = Memory;
+	}
+
+	return Memory;
+}
+
+void FRecordingRenderer::UnLockDataBuffer(FRHIDataBufferRef InBuffer)
+{
+	// the content written by the application goes with the unlock, or with the explicit flushes.
+	std::unordered_map<FRHIResource*, FLockRecord>::iterator It = LockedBuffers.find(InBuffer.DeRef());
+
+	WriteCommand(RCC_UnLockDataBuffer);
+	Trace.Write(GetResourceId(InBuffer.DeRef()));
+	if (It != LockedBuffers.end() && It->second.Mode != BL_ReadOnly && !(It->second.Mode & BL_FlushExplicit))
+	{
+		Trace.WriteBlob(It->second.Memory, It->second.Bytes);
+	}
+	else
+	{
+		Trace.WriteBlob(nullptr, 0);
+	}
+
+	if (It != LockedBuffers.end())
+	{
+		LockedBuffers.erase(It);
+	}
+
+	Renderer->UnLockDataBuffer(InBuffer);
+}
+
+void FRecordingRenderer::FlushDataBufferRange(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes)
+{
+	std::unordered_map<FRHIResource*, FLockRecord>::iterator It = LockedBuffers.find(InBuffer.DeRef());
+	const bool bInRange = It != LockedBuffers.end() && (uint64_t)InOffset + InBytes <= It->second.Bytes;
+
+	WriteCommand(RCC_FlushDataBufferRange);
+	Trace.Write(GetResourceId(InBuffer.DeRef()));
+	Trace.Write(InOffset);
+	Trace.WriteBlob(bInRange ? reinterpret_cast<const uint8_t*>(It->second.Memory) + InOffset : nullptr, InBytes);
+
+	Renderer->FlushDataBufferRange(InBuffer, InOffset, InBytes);
+}
+
+// uniform buffers
+FRHIUniformBufferRef FRecordingRenderer::RHICreateUniformBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess)
+{
+	FRHIUniformBufferRef Buffer = Renderer->RHICreateUniformBuffer(InBytes, InData, InAccess);
+
+	WriteCommand(RCC_CreateUniformBuffer);
+	Trace.Write(RegisterResource(Buffer.DeRef()));
+	Trace.Write(InBytes);
+	Trace.Write((int32_t)InAccess);
+	Trace.WriteBlob(InData, InData ? InBytes : 0);
+
+	return Buffer;
+}
+
+void FRecordingRenderer::RHIUpdateUniformBuffer(const FRHIUniformBufferRef &InBuffer, const void *InData)
+{
+	WriteCommand(RCC_UpdateUniformBuffer);
+	Trace.Write(GetResourceId(InBuffer.DeRef()));
+	Trace.WriteBlob(InData, (InData && InBuffer.IsValidRef()) ? InBuffer->GetBytes() : 0);
+
+	Renderer->RHIUpdateUniformBuffer(InBuffer, InData);
+}
+
+// textures
+FRHITexture2DRef FRecordingRenderer::RHICreateTexture2D(uint32_t InSizeX, uint32_t InSizeY, uint32_t InMips, EPixelFormat InFormat)
+{
+	FRHITexture2DRef Texture = Renderer->RHICreateTexture2D(InSizeX, InSizeY, InMips, InFormat);
+
+	WriteCommand(RCC_CreateTexture2D);
+	Trace.Write(RegisterResource(Texture.DeRef()));
+	Trace.Write(InSizeX);
+	Trace.Write(InSizeY);
+	Trace.Write(InMips);
+	Trace.Write((int32_t)InFormat);
+
+	return Texture;
+}
+
+FRHITexture2DArrayRef FRecordingRenderer::RHICreateTexture2DArray(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat)
+{
+	FRHITexture2DArrayRef Texture = Renderer->RHICreateTexture2DArray(InSizeX, InSizeY, InLayers, InMips, InFormat);
+
+	WriteCommand(RCC_CreateTexture2DArray);
+	Trace.Write(RegisterResource(Texture.DeRef()));
+	Trace.Write(InSizeX);
+	Trace.Write(InSizeY);
+	Trace.Write(InLayers);
+	Trace.Write(InMips);
+	Trace.Write((int32_t)InFormat);
+
+	return Texture;
+}
+
+FRHITextureCubeRef FRecordingRenderer::RHICreateTextureCube(uint32_t InSize, uint32_t InMips, EPixelFormat InFormat)
+{
+	FRHITextureCubeRef Texture = Renderer->RHICreateTextureCube(InSize, InMips, InFormat);
+
+	WriteCommand(RCC_CreateTextureCube);
+	Trace.Write(RegisterResource(Texture.DeRef()));
+	Trace.Write(InSize);
+	Trace.Write(InMips);
+	Trace.Write((int32_t)InFormat);
+
+	return Texture;
+}
+
+void FRecordingRenderer::RHIUpdateTexture(const FRHITextureRef &InTexture, uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData)
+{
+	const uint32_t kBytes = (InData && InTexture.IsValidRef()) ? InWidth * InHeight * GetPixelFormatBytes(InTexture->GetFormat()) : 0;
+
+	WriteCommand(RCC_UpdateTexture);
+	Trace.Write(GetResourceId(InTexture.DeRef()));
+	Trace.Write(InMip);
+	Trace.Write(InLayer);
+	Trace.Write(InX);
+	Trace.Write(InY);
+	Trace.Write(InWidth);
+	Trace.Write(InHeight);
+	Trace.WriteBlob(InData, kBytes);
+
+	Renderer->RHIUpdateTexture(InTexture, InMip, InLayer, InX, InY, InWidth, InHeight, InData);
+}
+
+void FRecordingRenderer::RHIGenerateMips(const FRHITextureRef &InTexture)
+{
+	WriteCommand(RCC_GenerateMips);
+	Trace.Write(GetResourceId(InTexture.DeRef()));
+
+	Renderer->RHIGenerateMips(InTexture);
+}
+
+// render targets
+FRHIRenderBufferRef FRecordingRenderer::RHICreateRenderBuffer(uint32_t InSizeX, uint32_t InSizeY, EPixelFormat InFormat, uint32_t InSamples)
+{
+	FRHIRenderBufferRef RenderBuffer = Renderer->RHICreateRenderBuffer(InSizeX, InSizeY, InFormat, InSamples);
+
+	WriteCommand(RCC_CreateRenderBuffer);
+	Trace.Write(RegisterResource(RenderBuffer.DeRef()));
+	Trace.Write(InSizeX);
+	Trace.Write(InSizeY);
+	Trace.Write((int32_t)InFormat);
+	Trace.Write(InSamples);
+
+	return RenderBuffer;
+}
+
+FRHIFrameBufferRef FRecordingRenderer::RHICreateFrameBuffer(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget)
+{
+	FRHIFrameBufferRef FrameBuffer = Renderer->RHICreateFrameBuffer(InColorTargets, InColorTargetsNum, InDepthStencilTarget);
+
+	WriteCommand(RCC_CreateFrameBuffer);
+	Trace.Write(RegisterResource(FrameBuffer.DeRef()));
+	Trace.Write(InColorTargetsNum);
+	for (uint32_t k = 0; k < InColorTargetsNum; k++)
+	{
+		WriteRenderTargetView(InColorTargets[k]);
+	}
+	WriteRenderTargetView(InDepthStencilTarget);
+
+	return FrameBuffer;
+}
+
+// queries
+FRHIOcclusionQueryRef FRecordingRenderer::RHICreateOcclusionQuery()
+{
+	FRHIOcclusionQueryRef Query = Renderer->RHICreateOcclusionQuery();
+
+	WriteCommand(RCC_CreateOcclusionQuery);
+	Trace.Write(RegisterResource(Query.DeRef()));
+
+	return Query;
+}
+
+void FRecordingRenderer::WriteRenderTargetView(const FRHIRenderTargetView &InView)
+{
+	FRHIResource *Resource = InView.Texture.IsValidRef() ? (FRHIResource*)InView.Texture.DeRef() : (FRHIResource*)InView.RenderBuffer.DeRef();
+	Trace.Write(GetResourceId(Resource));
+	Trace.Write(InView.MipIndex);
+	Trace.Write(InView.LayerIndex);
+}
+
+// transient geometry
+void* FRecordingRenderer::RHIAllocTransientVertices(uint32_t InBytes, uint32_t InStride, FRHIVertexBufferRef &OutBuffer, uint32_t &OutFirstVertex)
+{
+	void *Memory = Renderer->RHIAllocTransientVertices(InBytes, InStride, OutBuffer, OutFirstVertex);
+	if (!Memory)
+	{
+		return nullptr;
+	}
+
+	if (OutBuffer.DeRef() != TransientVertexBuffer.DeRef())
+	{
+		TransientVertexBuffer = OutBuffer;
+
+		WriteCommand(RCC_CreateVertexBuffer);
+		Trace.Write(RegisterResource(OutBuffer.DeRef()));
+		Trace.Write(OutBuffer->GetBytes());
+		Trace.Write((int32_t)BA_Dynamic);
+		Trace.Write((int32_t)BU_Draw);
+		Trace.WriteBlob(nullptr, 0);
+	}
+
+	FTransientWrite Write;
+	Write.Buffer = OutBuffer.DeRef();
+	Write.Offset = OutFirstVertex * InStride;
+	Write.Bytes = InBytes;
+	Write.Memory = Memory;
+	TransientWrites.push_back(Write);
+
+	return Memory;
+}
+
+void* FRecordingRenderer::RHIAllocTransientIndices(uint32_t InCount, uint16_t InStride, FRHIIndexBufferRef &OutBuffer, uint32_t &OutFirstIndex)
+{
+	void *Memory = Renderer->RHIAllocTransientIndices(InCount, InStride, OutBuffer, OutFirstIndex);
+	if (!Memory)
+	{
+		return nullptr;
+	}
+
+	FRHIIndexBufferRef &Current = TransientIndexBuffers[InStride == sizeof(uint16_t) ? 0 : 1];
+	if (OutBuffer.DeRef() != Current.DeRef())
+	{
+		Current = OutBuffer;
+
+		WriteCommand(RCC_CreateIndexBuffer);
+		Trace.Write(RegisterResource(OutBuffer.DeRef()));
+		Trace.Write(OutBuffer->GetBytes());
+		Trace.Write(InStride);
+		Trace.Write((int32_t)BA_Dynamic);
+		Trace.Write((int32_t)BU_Draw);
+		Trace.WriteBlob(nullptr, 0);
+	}
+
+	FTransientWrite Write;
+	Write.Buffer = OutBuffer.DeRef();
+	Write.Offset = OutFirstIndex * InStride;
+	Write.Bytes = InCount * InStride;
+	Write.Memory = Memory;
+	TransientWrites.push_back(Write);
+
+	return Memory;
+}
+
+void FRecordingRenderer::FlushTransientWrites()
+{
+	// the caller has written the data by now
+	for (size_t k = 0; k < TransientWrites.size(); k++)
+	{
+		const FTransientWrite &Write = TransientWrites[k];
+
+		WriteCommand(RCC_FillDataBuffer);
+		Trace.Write(GetResourceId(Write.Buffer));
+		Trace.Write(Write.Offset);
+		Trace.WriteBlob(Write.Memory, Write.Bytes);
+	} // end for k
+
+	TransientWrites.clear();
+}
+
+// vertex input layout
+FRHIVertexDeclarationRef FRecordingRenderer::RHICreateVertexInputLayout(const FVertexElement *InVertexElements, uint32_t InCount)
+{
+	FRHIVertexDeclarationRef VertexDecl = Renderer->RHICreateVertexInputLayout(InVertexElements, InCount);
+
+	WriteCommand(RCC_CreateVertexInputLayout);
+	Trace.Write(RegisterResource(VertexDecl.DeRef()));
+	Trace.Write(InCount);
+	Trace.Write(InVertexElements, InCount * sizeof(FVertexElement));
+
+	return VertexDecl;
+}
+
+// shader
+FRHIVertexShaderRef FRecordingRenderer::RHICreateVertexShader(const char *InSource, int32_t InLength)
+{
+	FRHIVertexShaderRef Shader = Renderer->RHICreateVertexShader(InSource, InLength);
+
+	WriteCommand(RCC_CreateVertexShader);
+	Trace.Write(RegisterResource(Shader.DeRef()));
+	Trace.WriteBlob(InSource, InSource ? (InLength < 0 ? (uint32_t)strlen(InSource) : (uint32_t)InLength) : 0);
+
+	return Shader;
+}
+
+FRHIPixelShaderRef FRecordingRenderer::RHICreatePixelShader(const char *InSource, int32_t InLength)
+{
+	FRHIPixelShaderRef Shader = Renderer->RHICreatePixelShader(InSource, InLength);
+
+	WriteCommand(RCC_CreatePixelShader);
+	Trace.Write(RegisterResource(Shader.DeRef()));
+	Trace.WriteBlob(InSource, InSource ? (InLength < 0 ? (uint32_t)strlen(InSource) : (uint32_t)InLength) : 0);
+
+	return Shader;
+}
+
+FRHIGPUProgramRef FRecordingRenderer::RHICreateGPUProgram(const FRHIVertexShaderRef &InVShader, const FRHIPixelShaderRef &InPShader)
+{
+	std::vector<FRHIShaderRef> Shaders;
+	Shaders.push_back(InVShader.DeRef());
+	Shaders.push_back(InPShader.DeRef());
+
+	return RHICreateGPUProgram(Shaders);
+}
+
+FRHIGPUProgramRef FRecordingRenderer::RHICreateGPUProgram(const std::vector<FRHIShaderRef> &InShaders)
+{
+	FRHIGPUProgramRef Program = WrapGPUProgram(Renderer->RHICreateGPUProgram(InShaders));
+
+	WriteCommand(RCC_CreateGPUProgram);
+	Trace.Write(RegisterResource(Program.DeRef()));
+	Trace.Write((uint32_t)InShaders.size());
+	for (size_t k = 0; k < InShaders.size(); k++)
+	{
+		Trace.Write(GetResourceId(InShaders[k].DeRef()));
+	} // end for k
+
+	return Program;
+}
+
+//State Setting
+void FRecordingRenderer::RHISetSamplerState(uint32_t InTexIndex, const FRHISamplerStateRef &InSamplerState)
+{
+	WriteCommand(RCC_SetSamplerState);
+	Trace.Write(InTexIndex);
+	Trace.Write(GetResourceId(InSamplerState.DeRef()));
+
+	Renderer->RHISetSamplerState(InTexIndex, InSamplerState);
+}
+
+void FRecordingRenderer::RHISetTexture(uint32_t InTexIndex, const FRHITextureRef &InTexture)
+{
+	WriteCommand(RCC_SetTexture);
+	Trace.Write(InTexIndex);
+	Trace.Write(GetResourceId(InTexture.DeRef()));
+
+	Renderer->RHISetTexture(InTexIndex, InTexture);
+}
+
+void FRecordingRenderer::RHISetRasterizerState(const FRHIRasterizerStateRef &InRasterizerState)
+{
+	WriteCommand(RCC_SetRasterizerState);
+	Trace.Write(GetResourceId(InRasterizerState.DeRef()));
+
+	Renderer->RHISetRasterizerState(InRasterizerState);
+}
+
+void FRecordingRenderer::RHISetDepthStencilState(const FRHIDepthStencilStateRef &InDepthStencilState, int32_t InStencilRef)
+{
+	WriteCommand(RCC_SetDepthStencilState);
+	Trace.Write(GetResourceId(InDepthStencilState.DeRef()));
+	Trace.Write(InStencilRef);
+
+	Renderer->RHISetDepthStencilState(InDepthStencilState, InStencilRef);
+}
+
+void FRecordingRenderer::RHISetBlendState(const FRHIBlendStateRef &InBlendState, const FLinearColor &InBlendColor)
+{
+	WriteCommand(RCC_SetBlendState);
+	Trace.Write(GetResourceId(InBlendState.DeRef()));
+	Trace.Write(InBlendColor);
+
+	Renderer->RHISetBlendState(InBlendState, InBlendColor);
+}
+
+void FRecordingRenderer::RHISetGraphicsPipelineState(const FRHIGraphicsPipelineStateRef &InPipelineState, int32_t InStencilRef, const FLinearColor &InBlendColor)
+{
+	WriteCommand(RCC_SetGraphicsPipelineState);
+	Trace.Write(GetResourceId(InPipelineState.DeRef()));
+	Trace.Write(InStencilRef);
+	Trace.Write(InBlendColor);
+
+	Renderer->RHISetGraphicsPipelineState(InPipelineState, InStencilRef, InBlendColor);
+}
+
+void FRecordingRenderer::RHISetFrameBuffer(const FRHIFrameBufferRef &InFrameBuffer)
+{
+	WriteCommand(RCC_SetFrameBuffer);
+	Trace.Write(GetResourceId(InFrameBuffer.DeRef()));
+
+	Renderer->RHISetFrameBuffer(InFrameBuffer);
+}
+
+void FRecordingRenderer::RHISetViewport(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight, float InMinZ, float InMaxZ)
+{
+	WriteCommand(RCC_SetViewport);
+	Trace.Write(InX);
+	Trace.Write(InY);
+	Trace.Write(InWidth);
+	Trace.Write(InHeight);
+	Trace.Write(InMinZ);
+	Trace.Write(InMaxZ);
+
+	Renderer->RHISetViewport(InX, InY, InWidth, InHeight, InMinZ, InMaxZ);
+}
+
+void FRecordingRenderer::RHISetScissorRect(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight)
+{
+	WriteCommand(RCC_SetScissorRect);
+	Trace.Write(InX);
+	Trace.Write(InY);
+	Trace.Write(InWidth);
+	Trace.Write(InHeight);
+
+	Renderer->RHISetScissorRect(InX, InY, InWidth, InHeight);
+}
+
+void FRecordingRenderer::SetVertexStreamSource(uint32_t InStreamIndex, const FRHIVertexBufferRef &InVertexBuffer)
+{
+	WriteCommand(RCC_SetVertexStreamSource);
+	Trace.Write(InStreamIndex);
+	Trace.Write(GetResourceId(InVertexBuffer.DeRef()));
+
+	Renderer->SetVertexStreamSource(InStreamIndex, InVertexBuffer);
+}
+
+void FRecordingRenderer::SetVertexInputLayout(const FRHIVertexDeclarationRef &InVertexDecl)
+{
+	WriteCommand(RCC_SetVertexInputLayout);
+	Trace.Write(GetResourceId(InVertexDecl.DeRef()));
+
+	Renderer->SetVertexInputLayout(InVertexDecl);
+}
+
+void FRecordingRenderer::SetGPUProgram(const FRHIGPUProgramRef &InProgram)
+{
+	WriteCommand(RCC_SetGPUProgram);
+	Trace.Write(GetResourceId(InProgram.DeRef()));
+
+	Renderer->SetGPUProgram(UnwrapGPUProgram(InProgram.DeRef()));
+}
+
+void FRecordingRenderer::RHISetUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer)
+{
+	WriteCommand(RCC_SetUniformBuffer);
+	Trace.Write(InBindIndex);
+	Trace.Write(GetResourceId(InBuffer.DeRef()));
+
+	Renderer->RHISetUniformBuffer(InBindIndex, InBuffer);
+}
+
+//Draw Commands
+void FRecordingRenderer::RHIBeginDrawingViewport(FRHIViewportRef Viewport)
+{
+	WriteCommand(RCC_BeginDrawingViewport);
+	Trace.Write(GetResourceId(Viewport.DeRef()));
+
+	Renderer->RHIBeginDrawingViewport(Viewport);
+}
+
+void FRecordingRenderer::RHIEndDrawingViewport(FRHIViewportRef Viewport, bool bPresent, bool bLockToVsync)
+{
+	WriteCommand(RCC_EndDrawingViewport);
+	Trace.Write(GetResourceId(Viewport.DeRef()));
+	Trace.Write(bPresent);
+	Trace.Write(bLockToVsync);
+
+	Renderer->RHIEndDrawingViewport(Viewport, bPresent, bLockToVsync);
+}
+
+void FRecordingRenderer::RHIBeginFrame()
+{
+	WriteCommand(RCC_BeginFrame);
+	Renderer->RHIBeginFrame();
+}
+
+void FRecordingRenderer::RHIEndFrame()
+{
+	FlushTransientWrites();
+	WriteCommand(RCC_EndFrame);
+	Renderer->RHIEndFrame();
+}
+
+void FRecordingRenderer::RHIClear(bool bClearColor, const FLinearColor &InColor, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil)
+{
+	WriteCommand(RCC_Clear);
+	Trace.Write(bClearColor);
+	Trace.Write(InColor);
+	Trace.Write(bClearDepth);
+	Trace.Write(InDepth);
+	Trace.Write(bClearStencil);
+	Trace.Write(InStencil);
+
+	Renderer->RHIClear(bClearColor, InColor, bClearDepth, InDepth, bClearStencil, InStencil);
+}
+
+void FRecordingRenderer::RHIClearMRT(bool bClearColor, const FLinearColor *InColors, uint32_t InColorsNum, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil)
+{
+	WriteCommand(RCC_ClearMRT);
+	Trace.Write(bClearColor);
+	Trace.WriteBlob(InColors, InColors ? InColorsNum * sizeof(FLinearColor) : 0);
+	Trace.Write(bClearDepth);
+	Trace.Write(InDepth);
+	Trace.Write(bClearStencil);
+	Trace.Write(InStencil);
+
+	Renderer->RHIClearMRT(bClearColor, InColors, InColorsNum, bClearDepth, InDepth, bClearStencil, InStencil);
+}
+
+void FRecordingRenderer::RHIResolveFrameBuffer(const FRHIFrameBufferRef &InSource, const FRHIFrameBufferRef &InDest)
+{
+	WriteCommand(RCC_ResolveFrameBuffer);
+	Trace.Write(GetResourceId(InSource.DeRef()));
+	Trace.Write(GetResourceId(InDest.DeRef()));
+
+	Renderer->RHIResolveFrameBuffer(InSource, InDest);
+}
+
+// draw primitives
+void FRecordingRenderer::DrawIndexedPrimitive(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount)
+{
+	FlushTransientWrites();
+	WriteCommand(RCC_DrawIndexedPrimitive);
+	Trace.Write(GetResourceId(InIndexBuffer.DeRef()));
+	Trace.Write((int32_t)InMode);
+	Trace.Write(InStart);
+	Trace.Write(InCount);
+
+	Renderer->DrawIndexedPrimitive(InIndexBuffer, InMode, InStart, InCount);
+}
+
+void FRecordingRenderer::DrawIndexedPrimitiveInstanced(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances)
+{
+	FlushTransientWrites();
+	WriteCommand(RCC_DrawIndexedPrimitiveInstanced);
+	Trace.Write(GetResourceId(InIndexBuffer.DeRef()));
+	Trace.Write((int32_t)InMode);
+	Trace.Write(InStart);
+	Trace.Write(InCount);
+	Trace.Write(InInstances);
+
+	Renderer->DrawIndexedPrimitiveInstanced(InIndexBuffer, InMode, InStart, InCount, InInstances);
+}
+
+void FRecordingRenderer::DrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset)
+{
+	FlushTransientWrites();
+	WriteCommand(RCC_DrawIndexedPrimitiveIndirect);
+	Trace.Write(GetResourceId(InIndexBuffer.DeRef()));
+	Trace.Write((int32_t)InMode);
+	Trace.Write(GetResourceId(InArgsBuffer.DeRef()));
+	Trace.Write(InOffset);
+
+	Renderer->DrawIndexedPrimitiveIndirect(InIndexBuffer, InMode, InArgsBuffer, InOffset);
+}
+
+void FRecordingRenderer::MultiDrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t InStride)
+{
+	FlushTransientWrites();
+	WriteCommand(RCC_MultiDrawIndexedPrimitiveIndirect);
+	Trace.Write(GetResourceId(InIndexBuffer.DeRef()));
+	Trace.Write((int32_t)InMode);
+	Trace.Write(GetResourceId(InArgsBuffer.DeRef()));
+	Trace.Write(InOffset);
+	Trace.Write(InDrawsNum);
+	Trace.Write(InStride);
+
+	Renderer->MultiDrawIndexedPrimitiveIndirect(InIndexBuffer, InMode, InArgsBuffer, InOffset, InDrawsNum, InStride);
+}
+
+void FRecordingRenderer::DrawArrayedPrimitive(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount)
+{
+	FlushTransientWrites();
+	WriteCommand(RCC_DrawArrayedPrimitive);
+	Trace.Write((int32_t)InMode);
+	Trace.Write(InStart);
+	Trace.Write(InCount);
+
+	Renderer->DrawArrayedPrimitive(InMode, InStart, InCount);
+}
+
+void FRecordingRenderer::DrawArrayedPrimitiveInstanced(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances)
+{
+	FlushTransientWrites();
+	WriteCommand(RCC_DrawArrayedPrimitiveInstanced);
+	Trace.Write((int32_t)InMode);
+	Trace.Write(InStart);
+	Trace.Write(InCount);
+	Trace.Write(InInstances);
+
+	Renderer->DrawArrayedPrimitiveInstanced(InMode, InStart, InCount, InInstances);
+}
+
+//GPU Profiling
+void FRecordingRenderer::RHIBeginTimerQuery(const char *InName)
+{
+	WriteCommand(RCC_BeginTimerQuery);
+	Trace.WriteBlob(InName, InName ? (uint32_t)strlen(InName) : 0);
+
+	Renderer->RHIBeginTimerQuery(InName);
+}
+
+void FRecordingRenderer::RHIEndTimerQuery()
+{
+	WriteCommand(RCC_EndTimerQuery);
+
+	Renderer->RHIEndTimerQuery();
+}
+
+bool FRecordingRenderer::RHIGetGPUFrameTimings(FGPUFrameTimings &OutTimings)
+{
+	return Renderer->RHIGetGPUFrameTimings(OutTimings);
+}
+
+//Occlusion Queries
+void FRecordingRenderer::RHIBeginOcclusionQuery(const FRHIOcclusionQueryRef &InQuery)
+{
+	WriteCommand(RCC_BeginOcclusionQuery);
+	Trace.Write(GetResourceId(InQuery.DeRef()));
+
+	Renderer->RHIBeginOcclusionQuery(InQuery);
+}
+
+void FRecordingRenderer::RHIEndOcclusionQuery(const FRHIOcclusionQueryRef &InQuery)
+{
+	FlushTransientWrites();
+	WriteCommand(RCC_EndOcclusionQuery);
+	Trace.Write(GetResourceId(InQuery.DeRef()));
+
+	Renderer->RHIEndOcclusionQuery(InQuery);
+}
+
+bool FRecordingRenderer::RHIGetOcclusionQueryResult(const FRHIOcclusionQueryRef &InQuery, uint64_t &OutSamples, bool bWait)
+{
+	return Renderer->RHIGetOcclusionQueryResult(InQuery, OutSamples, bWait);
+}
+
+void FRecordingRenderer::RHIBeginConditionalRender(const FRHIOcclusionQueryRef &InQuery, bool bWait)
+{
+	WriteCommand(RCC_BeginConditionalRender);
+	Trace.Write(GetResourceId(InQuery.DeRef()));
+	Trace.Write(bWait);
+
+	Renderer->RHIBeginConditionalRender(InQuery, bWait);
+}
+
+void FRecordingRenderer::RHIEndConditionalRender()
+{
+	WriteCommand(RCC_EndConditionalRender);
+
+	Renderer->RHIEndConditionalRender();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FRHICaptureReplayer
+
+FRHICaptureReplayer::FRHICaptureReplayer()
+	: Renderer(nullptr)
+	, WindowHandle(nullptr)
+	, Logger(nullptr)
+	, FrameStartTime(0.0)
+{
+}
+
+bool FRHICaptureReplayer::LoadFromFile(const char *InFileName)
+{
+	FRHICaptureArchive InTrace;
+	if (!InTrace.LoadFromFile(InFileName))
+	{
+		return false;
+	}
+
+	return LoadFromArchive(InTrace);
+}
+
+bool FRHICaptureReplayer::LoadFromArchive(const FRHICaptureArchive &InTrace)
+{
+	Trace = InTrace;
+	Trace.Seek(0);
+
+	uint32_t Magic = 0, Version = 0;
+	if (!Trace.Read(Magic) || !Trace.Read(Version) || Magic != kCaptureMagic || Version != kCaptureVersion)
+	{
+		Trace.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void FRHICaptureReplayer::ReplayError(const char *InMessage)
+{
+	if (Logger)
+	{
+		Logger->Log(Log_Error, "RHI replay: %s at offset %u", InMessage, (uint32_t)Trace.Tell());
+	}
+}
+
+void FRHICaptureReplayer::SetResource(uint32_t InId, FRHIResource *InResource)
+{
+	if (InId == 0)
+	{
+		return;
+	}
+
+	if (InId >= Resources.size())
+	{
+		Resources.resize(InId + 1);
+	}
+	Resources[InId] = InResource;
+}
+
+bool FRHICaptureReplayer::ReadRenderTargetView(FRHIRenderTargetView &OutView)
+{
+	uint32_t Id = 0;
+	if (!Trace.Read(Id) || !Trace.Read(OutView.MipIndex) || !Trace.Read(OutView.LayerIndex))
+	{
+		return false;
+	}
+
+	OutView.Texture = GetResource<FRHITexture>(Id);
+	OutView.RenderBuffer = GetResource<FRHIRenderBuffer>(Id);
+	return true;
+}
+
+bool FRHICaptureReplayer::Replay(FRenderer *InRenderer, void *InWindowHandle, uint32_t InLoops, FOutputDevice *InLogger)
+{
+	const size_t kHeaderBytes = sizeof(kCaptureMagic) + sizeof(kCaptureVersion);
+
+	Renderer = InRenderer;
+	WindowHandle = InWindowHandle;
+	Logger = InLogger;
+	FrameTimes.clear();
+	Resources.clear();
+	UniformHandles.clear();
+	LockedMemory.clear();
+
+	if (!Renderer || Trace.Data.size() < kHeaderBytes)
+	{
+		ReplayError("nothing to replay");
+		return false;
+	}
+
+	// the setup commands
+	Trace.Seek(kHeaderBytes);
+	while (!Trace.IsEnd())
+	{
+		if (Trace.Data[Trace.Tell()] == RCC_BeginFrame)
+		{
+			break;
+		}
+
+		uint8_t Command = RCC_None;
+		Trace.Read(Command);
+		if (!ExecuteCommand((ERHICaptureCommand)Command))
+		{
+			return false;
+		}
+	}
+
+	// the frames
+	const size_t FramesStart = Trace.Tell();
+	for (uint32_t Loop = 0; Loop < InLoops; Loop++)
+	{
+		Trace.Seek(FramesStart);
+		while (!Trace.IsEnd())
+		{
+			uint8_t Command = RCC_None;
+			Trace.Read(Command);
+			if (!ExecuteCommand((ERHICaptureCommand)Command))
+			{
+				return false;
+			}
+		}
+	} // end for Loop
+
+	return true;
+}
+
+bool FRHICaptureReplayer::ExecuteCommand(ERHICaptureCommand InCommand)
+{
+	bool bOk = true;
+	uint32_t Id = 0, Bytes = 0;
+
+	switch (InCommand)
+	{
+	case RCC_CreateViewport:
+		{
+			uint32_t SizeX = 0, SizeY = 0;
+			bool bIsFullscreen = false;
+			bOk = Trace.Read(Id) && Trace.Read(SizeX) && Trace.Read(SizeY) && Trace.Read(bIsFullscreen);
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateViewport(WindowHandle, SizeX, SizeY, bIsFullscreen).DeRef());
+			}
+		}
+		break;
+	case RCC_ResizeViewport:
+		{
+			uint32_t SizeX = 0, SizeY = 0;
+			bool bIsFullscreen = false;
+			bOk = Trace.Read(Id) && Trace.Read(SizeX) && Trace.Read(SizeY) && Trace.Read(bIsFullscreen);
+			if (bOk)
+			{
+				Renderer->RHIResizeViewport(GetResource<FRHIViewport>(Id), SizeX, SizeY, bIsFullscreen);
+			}
+		}
+		break;
+	case RCC_CreateSamplerState:
+		{
+			FSamplerStateInitializerRHI Initializer;
+			bOk = Trace.Read(Id) && Trace.Read(Initializer);
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateSamplerState(Initializer).DeRef());
+			}
+		}
+		break;
+	case RCC_CreateRasterizerState:
+		{
+			FRasterizerStateInitializerRHI Initializer;
+			bOk = Trace.Read(Id) && Trace.Read(Initializer);
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateRasterizerState(Initializer).DeRef());
+			}
+		}
+		break;
+	case RCC_CreateDepthStencilState:
+		{
+			FDepthStencilStateInitializerRHI Initializer;
+			bOk = Trace.Read(Id) && Trace.Read(Initializer);
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateDepthStencilState(Initializer).DeRef());
+			}
+		}
+		break;
+	case RCC_CreateBlendState:
+		{
+			FBlendStateInitializerRHI Initializer;
+			bOk = Trace.Read(Id) && Trace.Read(Initializer);
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateBlendState(Initializer).DeRef());
+			}
+		}
+		break;
+	case RCC_CreateVertexBuffer:
+		{
+			int32_t Access = 0, Usage = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Bytes) && Trace.Read(Access) && Trace.Read(Usage);
+			uint32_t DataBytes = 0;
+			const uint8_t *Data = bOk ? Trace.ReadBlob(DataBytes) : nullptr;
+			bOk = Data != nullptr;
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateVertexBuffer(Bytes, DataBytes ? Data : nullptr, (EBufferAccess)Access, (EBufferUsage)Usage).DeRef());
+			}
+		}
+		break;
+	case RCC_CreateIndexBuffer:
+		{
+			uint16_t Stride = 0;
+			int32_t Access = 0, Usage = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Bytes) && Trace.Read(Stride) && Trace.Read(Access) && Trace.Read(Usage);
+			uint32_t DataBytes = 0;
+			const uint8_t *Data = bOk ? Trace.ReadBlob(DataBytes) : nullptr;
+			bOk = Data != nullptr;
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateIndexBuffer(Bytes, DataBytes ? Data : nullptr, Stride, (EBufferAccess)Access, (EBufferUsage)Usage).DeRef());
+			}
+		}
+		break;
+	case RCC_CreateIndirectBuffer:
+		{
+			int32_t Access = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Bytes) && Trace.Read(Access);
+			uint32_t DataBytes = 0;
+			const uint8_t *Data = bOk ? Trace.ReadBlob(DataBytes) : nullptr;
+			bOk = Data != nullptr;
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateIndirectBuffer(Bytes, DataBytes ? Data : nullptr, (EBufferAccess)Access).DeRef());
+			}
+		}
+		break;
+	case RCC_FillDataBuffer:
+		{
+			uint32_t Offset = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Offset);
+			const uint8_t *Data = bOk ? Trace.ReadBlob(Bytes) : nullptr;
+			bOk = Data != nullptr;
+			if (bOk)
+			{
+				Renderer->FillDataBuffer(GetResource<FRHIDataBuffer>(Id), Offset, Bytes, Data);
+			}
+		}
+		break;
+	case RCC_LockDataBuffer:
+		{
+			uint32_t Offset = 0;
+			int32_t Mode = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Offset) && Trace.Read(Bytes) && Trace.Read(Mode);
+			if (bOk)
+			{
+				LockedMemory[Id] = Renderer->LockDataBuffer(GetResource<FRHIDataBuffer>(Id), Offset, Bytes, (EBufferLockMode)Mode);
+			}
+		}
+		break;
+	case RCC_UnLockDataBuffer:
+		{
+			bOk = Trace.Read(Id);
+			const uint8_t *Data = bOk ? Trace.ReadBlob(Bytes) : nullptr;
+			bOk = Data != nullptr;
+			if (bOk)
+			{
+				std::map<uint32_t, void*>::iterator It = LockedMemory.find(Id);
+				if (It != LockedMemory.end())
+				{
+					if (It->second && Bytes > 0)
+					{
+						memcpy(It->second, Data, Bytes);
+					}
+					LockedMemory.erase(It);
+				}
+				Renderer->UnLockDataBuffer(GetResource<FRHIDataBuffer>(Id));
+			}
+		}
+		break;
+	case RCC_CreateVertexInputLayout:
+		{
+			uint32_t Count = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Count);
+			std::vector<FVertexElement> Elements(bOk ? Count : 0);
+			bOk = bOk && Trace.Read(Elements.data(), Count * sizeof(FVertexElement));
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateVertexInputLayout(Elements.data(), Count).DeRef());
+			}
+		}
+		break;
+	case RCC_CreateVertexShader:
+	case RCC_CreatePixelShader:
+		{
+			bOk = Trace.Read(Id);
+			const uint8_t *Source = bOk ? Trace.ReadBlob(Bytes) : nullptr;
+			bOk = Source != nullptr;
+			if (bOk)
+			{
+				const char *Text = reinterpret_cast<const char*>(Source);
+				if (InCommand == RCC_CreateVertexShader)
+				{
+					SetResource(Id, Renderer->RHICreateVertexShader(Text, (int32_t)Bytes).DeRef());
+				}
+				else
+				{
+					SetResource(Id, Renderer->RHICreatePixelShader(Text, (int32_t)Bytes).DeRef());
+				}
+			}
+		}
+		break;
+	case RCC_CreateGPUProgram:
+		{
+			uint32_t Count = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Count);
+
+			std::vector<FRHIShaderRef> Shaders;
+			for (uint32_t k = 0; bOk && k < Count; k++)
+			{
+				uint32_t ShaderId = 0;
+				bOk = Trace.Read(ShaderId);
+				Shaders.push_back(GetResource<FRHIShader>(ShaderId));
+			} // end for k
+
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateGPUProgram(Shaders).DeRef());
+			}
+		}
+		break;
+	case RCC_GetUniformHandle:
+		{
+			int32_t Handle = -1;
+			bOk = Trace.Read(Id) && Trace.Read(Handle);
+			const uint8_t *Name = bOk ? Trace.ReadBlob(Bytes) : nullptr;
+			bOk = Name != nullptr;
+
+			FRHIGPUProgram *Program = GetResource<FRHIGPUProgram>(Id);
+			if (bOk && Program)
+			{
+				UniformHandles[std::make_pair(Id, Handle)] = Program->GetUniformHandle(std::string(reinterpret_cast<const char*>(Name), Bytes));
+			}
+		}
+		break;
+	case RCC_SetUniform:
+		{
+			int32_t Handle = -1;
+			uint8_t Type = 0;
+			uint32_t Count = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Handle) && Trace.Read(Type) && Trace.Read(Count);
+			const uint8_t *Values = bOk ? Trace.ReadBlob(Bytes) : nullptr;
+			bOk = Values != nullptr;
+
+			FRHIGPUProgram *Program = GetResource<FRHIGPUProgram>(Id);
+			if (bOk && Program)
+			{
+				std::map<std::pair<uint32_t, int32_t>, int32_t>::const_iterator It = UniformHandles.find(std::make_pair(Id, Handle));
+				if (It != UniformHandles.end())
+				{
+					Handle = It->second;
+				}
+
+				// copy, the payload is not aligned.
+				std::vector<uint32_t> Aligned((Bytes + 3) / 4);
+				memcpy(Aligned.data(), Values, Bytes);
+				const int32_t *IValues = reinterpret_cast<const int32_t*>(Aligned.data());
+				const uint32_t *UValues = Aligned.data();
+				const float *FValues = reinterpret_cast<const float*>(Aligned.data());
+
+				switch (Type)
+				{
+				case RCU_1iv: Program->SetUniform1iv(Handle, IValues, Count); break;
+				case RCU_2iv: Program->SetUniform2iv(Handle, IValues, Count); break;
+				case RCU_3iv: Program->SetUniform3iv(Handle, IValues, Count); break;
+				case RCU_4iv: Program->SetUniform4iv(Handle, IValues, Count); break;
+				case RCU_1uiv: Program->SetUniform1uiv(Handle, UValues, Count); break;
+				case RCU_2uiv: Program->SetUniform2uiv(Handle, UValues, Count); break;
+				case RCU_3uiv: Program->SetUniform3uiv(Handle, UValues, Count); break;
+				case RCU_4uiv: Program->SetUniform4uiv(Handle, UValues, Count); break;
+				case RCU_1fv: Program->SetUniform1fv(Handle, FValues, Count); break;
+				case RCU_2fv: Program->SetUniform2fv(Handle, FValues, Count); break;
+				case RCU_3fv: Program->SetUniform3fv(Handle, FValues, Count); break;
+				case RCU_4fv: Program->SetUniform4fv(Handle, FValues, Count); break;
+				case RCU_Matrix4fv: Program->SetUniformMatrix4fv(Handle, FValues, Count); break;
+				default:
+					ReplayError("unknown uniform type");
+					return false;
+				}
+			}
+		}
+		break;
+	case RCC_SetSamplerState:
+		{
+			uint32_t TexIndex = 0;
+			bOk = Trace.Read(TexIndex) && Trace.Read(Id);
+			if (bOk)
+			{
+				Renderer->RHISetSamplerState(TexIndex, GetResource<FRHISamplerState>(Id));
+			}
+		}
+		break;
+	case RCC_SetRasterizerState:
+		{
+			bOk = Trace.Read(Id);
+			if (bOk)
+			{
+				Renderer->RHISetRasterizerState(GetResource<FRHIRasterizerState>(Id));
+			}
+		}
+		break;
+	case RCC_SetDepthStencilState:
+		{
+			int32_t StencilRef = 0;
+			bOk = Trace.Read(Id) && Trace.Read(StencilRef);
+			if (bOk)
+			{
+				Renderer->RHISetDepthStencilState(GetResource<FRHIDepthStencilState>(Id), StencilRef);
+			}
+		}
+		break;
+	case RCC_SetBlendState:
+		{
+			FLinearColor BlendColor;
+			bOk = Trace.Read(Id) && Trace.Read(BlendColor);
+			if (bOk)
+			{
+				Renderer->RHISetBlendState(GetResource<FRHIBlendState>(Id), BlendColor);
+			}
+		}
+		break;
+	case RCC_SetViewport:
+		{
+			int32_t X = 0, Y = 0, Width = 0, Height = 0;
+			float MinZ = 0.f, MaxZ = 1.f;
+			bOk = Trace.Read(X) && Trace.Read(Y) && Trace.Read(Width) && Trace.Read(Height) && Trace.Read(MinZ) && Trace.Read(MaxZ);
+			if (bOk)
+			{
+				Renderer->RHISetViewport(X, Y, Width, Height, MinZ, MaxZ);
+			}
+		}
+		break;
+	case RCC_SetScissorRect:
+		{
+			int32_t X = 0, Y = 0, Width = 0, Height = 0;
+			bOk = Trace.Read(X) && Trace.Read(Y) && Trace.Read(Width) && Trace.Read(Height);
+			if (bOk)
+			{
+				Renderer->RHISetScissorRect(X, Y, Width, Height);
+			}
+		}
+		break;
+	case RCC_SetVertexStreamSource:
+		{
+			uint32_t StreamIndex = 0;
+			bOk = Trace.Read(StreamIndex) && Trace.Read(Id);
+			if (bOk)
+			{
+				Renderer->SetVertexStreamSource(StreamIndex, GetResource<FRHIVertexBuffer>(Id));
+			}
+		}
+		break;
+	case RCC_SetVertexInputLayout:
+		{
+			bOk = Trace.Read(Id);
+			if (bOk)
+			{
+				Renderer->SetVertexInputLayout(GetResource<FRHIVertexDeclaration>(Id));
+			}
+		}
+		break;
+	case RCC_SetGPUProgram:
+		{
+			bOk = Trace.Read(Id);
+			if (bOk)
+			{
+				Renderer->SetGPUProgram(GetResource<FRHIGPUProgram>(Id));
+			}
+		}
+		break;
+	case RCC_BeginDrawingViewport:
+		{
+			bOk = Trace.Read(Id);
+			if (bOk)
+			{
+				Renderer->RHIBeginDrawingViewport(GetResource<FRHIViewport>(Id));
+			}
+		}
+		break;
+	case RCC_EndDrawingViewport:
+		{
+			bool bPresent = false, bLockToVsync = false;
+			bOk = Trace.Read(Id) && Trace.Read(bPresent) && Trace.Read(bLockToVsync);
+			if (bOk)
+			{
+				Renderer->RHIEndDrawingViewport(GetResource<FRHIViewport>(Id), bPresent, bLockToVsync);
+			}
+		}
+		break;
+	case RCC_BeginFrame:
+		FrameStartTime = GetCaptureSeconds();
+		Renderer->RHIBeginFrame();
+		break;
+	case RCC_EndFrame:
+		Renderer->RHIEndFrame();
+		FrameTimes.push_back((GetCaptureSeconds() - FrameStartTime) * 1000.0);
+		break;
+	case RCC_Clear:
+		{
+			bool bClearColor = false, bClearDepth = false, bClearStencil = false;
+			FLinearColor Color;
+			float Depth = 1.f;
+			int32_t Stencil = 0;
+			bOk = Trace.Read(bClearColor) && Trace.Read(Color) && Trace.Read(bClearDepth) && Trace.Read(Depth) && Trace.Read(bClearStencil) && Trace.Read(Stencil);
+			if (bOk)
+			{
+				Renderer->RHIClear(bClearColor, Color, bClearDepth, Depth, bClearStencil, Stencil);
+			}
+		}
+		break;
+	case RCC_ClearMRT:
+		{
+			bool bClearColor = false, bClearDepth = false, bClearStencil = false;
+			float Depth = 1.f;
+			int32_t Stencil = 0;
+			bOk = Trace.Read(bClearColor);
+			const uint8_t *ColorsData = bOk ? Trace.ReadBlob(Bytes) : nullptr;
+			bOk = ColorsData != nullptr && Trace.Read(bClearDepth) && Trace.Read(Depth) && Trace.Read(bClearStencil) && Trace.Read(Stencil);
+			if (bOk)
+			{
+				std::vector<FLinearColor> Colors(Bytes / sizeof(FLinearColor));
+				memcpy(Colors.data(), ColorsData, Colors.size() * sizeof(FLinearColor));
+				Renderer->RHIClearMRT(bClearColor, Colors.empty() ? nullptr : Colors.data(), (uint32_t)Colors.size(), bClearDepth, Depth, bClearStencil, Stencil);
+			}
+		}
+		break;
+	case RCC_DrawIndexedPrimitive:
+		{
+			int32_t Mode = 0;
+			uint32_t Start = 0, Count = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Mode) && Trace.Read(Start) && Trace.Read(Count);
+			if (bOk)
+			{
+				Renderer->DrawIndexedPrimitive(GetResource<FRHIIndexBuffer>(Id), (EPrimitiveType)Mode, Start, Count);
+			}
+		}
+		break;
+	case RCC_DrawIndexedPrimitiveInstanced:
+		{
+			int32_t Mode = 0;
+			uint32_t Start = 0, Count = 0, Instances = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Mode) && Trace.Read(Start) && Trace.Read(Count) && Trace.Read(Instances);
+			if (bOk)
+			{
+				Renderer->DrawIndexedPrimitiveInstanced(GetResource<FRHIIndexBuffer>(Id), (EPrimitiveType)Mode, Start, Count, Instances);
+			}
+		}
+		break;
+	case RCC_DrawIndexedPrimitiveIndirect:
+		{
+			int32_t Mode = 0;
+			uint32_t ArgsId = 0, Offset = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Mode) && Trace.Read(ArgsId) && Trace.Read(Offset);
+			if (bOk)
+			{
+				Renderer->DrawIndexedPrimitiveIndirect(GetResource<FRHIIndexBuffer>(Id), (EPrimitiveType)Mode, GetResource<FRHIIndirectBuffer>(ArgsId), Offset);
+			}
+		}
+		break;
+	case RCC_MultiDrawIndexedPrimitiveIndirect:
+		{
+			int32_t Mode = 0;
+			uint32_t ArgsId = 0, Offset = 0, DrawsNum = 0, Stride = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Mode) && Trace.Read(ArgsId) && Trace.Read(Offset) && Trace.Read(DrawsNum) && Trace.Read(Stride);
+			if (bOk)
+			{
+				Renderer->MultiDrawIndexedPrimitiveIndirect(GetResource<FRHIIndexBuffer>(Id), (EPrimitiveType)Mode, GetResource<FRHIIndirectBuffer>(ArgsId), Offset, DrawsNum, Stride);
+			}
+		}
+		break;
+	case RCC_DrawArrayedPrimitive:
+		{
+			int32_t Mode = 0;
+			uint32_t Start = 0, Count = 0;
+			bOk = Trace.Read(Mode) && Trace.Read(Start) && Trace.Read(Count);
+			if (bOk)
+			{
+				Renderer->DrawArrayedPrimitive((EPrimitiveType)Mode, Start, Count);
+			}
+		}
+		break;
+	case RCC_DrawArrayedPrimitiveInstanced:
+		{
+			int32_t Mode = 0;
+			uint32_t Start = 0, Count = 0, Instances = 0;
+			bOk = Trace.Read(Mode) && Trace.Read(Start) && Trace.Read(Count) && Trace.Read(Instances);
+			if (bOk)
+			{
+				Renderer->DrawArrayedPrimitiveInstanced((EPrimitiveType)Mode, Start, Count, Instances);
+			}
+		}
+		break;
+	case RCC_CreateGraphicsPipelineState:
+		{
+			uint32_t RasterizerId = 0, DepthStencilId = 0, BlendId = 0, ProgramId = 0, VertexDeclId = 0;
+			bOk = Trace.Read(Id) && Trace.Read(RasterizerId) && Trace.Read(DepthStencilId) && Trace.Read(BlendId) && Trace.Read(ProgramId) && Trace.Read(VertexDeclId);
+			if (bOk)
+			{
+				FGraphicsPipelineStateInitializerRHI Initializer(
+					GetResource<FRHIRasterizerState>(RasterizerId),
+					GetResource<FRHIDepthStencilState>(DepthStencilId),
+					GetResource<FRHIBlendState>(BlendId),
+					GetResource<FRHIGPUProgram>(ProgramId),
+					GetResource<FRHIVertexDeclaration>(VertexDeclId));
+				SetResource(Id, Renderer->RHICreateGraphicsPipelineState(Initializer).DeRef());
+			}
+		}
+		break;
+	case RCC_SetGraphicsPipelineState:
+		{
+			int32_t StencilRef = 0;
+			FLinearColor BlendColor;
+			bOk = Trace.Read(Id) && Trace.Read(StencilRef) && Trace.Read(BlendColor);
+			if (bOk)
+			{
+				Renderer->RHISetGraphicsPipelineState(GetResource<FRHIGraphicsPipelineState>(Id), StencilRef, BlendColor);
+			}
+		}
+		break;
+	case RCC_CreateUniformBuffer:
+		{
+			int32_t Access = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Bytes) && Trace.Read(Access);
+			uint32_t DataBytes = 0;
+			const uint8_t *Data = bOk ? Trace.ReadBlob(DataBytes) : nullptr;
+			bOk = Data != nullptr;
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateUniformBuffer(Bytes, DataBytes ? Data : nullptr, (EBufferAccess)Access).DeRef());
+			}
+		}
+		break;
+	case RCC_UpdateUniformBuffer:
+		{
+			bOk = Trace.Read(Id);
+			const uint8_t *Data = bOk ? Trace.ReadBlob(Bytes) : nullptr;
+			bOk = Data != nullptr;
+
+			FRHIUniformBuffer *Buffer = GetResource<FRHIUniformBuffer>(Id);
+			if (bOk && Buffer && Bytes == Buffer->GetBytes())
+			{
+				Renderer->RHIUpdateUniformBuffer(Buffer, Data);
+			}
+		}
+		break;
+	case RCC_SetUniformBuffer:
+		{
+			uint32_t BindIndex = 0;
+			bOk = Trace.Read(BindIndex) && Trace.Read(Id);
+			if (bOk)
+			{
+				Renderer->RHISetUniformBuffer(BindIndex, GetResource<FRHIUniformBuffer>(Id));
+			}
+		}
+		break;
+	case RCC_SetUniformBufferBinding:
+		{
+			uint32_t BindIndex = 0;
+			bOk = Trace.Read(Id) && Trace.Read(BindIndex);
+			const uint8_t *Name = bOk ? Trace.ReadBlob(Bytes) : nullptr;
+			bOk = Name != nullptr;
+
+			FRHIGPUProgram *Program = GetResource<FRHIGPUProgram>(Id);
+			if (bOk && Program)
+			{
+				Program->SetUniformBufferBinding(std::string(reinterpret_cast<const char*>(Name), Bytes), BindIndex);
+			}
+		}
+		break;
+	case RCC_FlushDataBufferRange:
+		{
+			uint32_t Offset = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Offset);
+			const uint8_t *Data = bOk ? Trace.ReadBlob(Bytes) : nullptr;
+			bOk = Data != nullptr;
+			if (bOk)
+			{
+				std::map<uint32_t, void*>::iterator It = LockedMemory.find(Id);
+				if (It != LockedMemory.end() && It->second && Bytes > 0)
+				{
+					memcpy(reinterpret_cast<uint8_t*>(It->second) + Offset, Data, Bytes);
+				}
+				Renderer->FlushDataBufferRange(GetResource<FRHIDataBuffer>(Id), Offset, Bytes);
+			}
+		}
+		break;
+	case RCC_CreateTexture2D:
+		{
+			uint32_t SizeX = 0, SizeY = 0, Mips = 0;
+			int32_t Format = 0;
+			bOk = Trace.Read(Id) && Trace.Read(SizeX) && Trace.Read(SizeY) && Trace.Read(Mips) && Trace.Read(Format);
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateTexture2D(SizeX, SizeY, Mips, (EPixelFormat)Format).DeRef());
+			}
+		}
+		break;
+	case RCC_CreateTexture2DArray:
+		{
+			uint32_t SizeX = 0, SizeY = 0, Layers = 0, Mips = 0;
+			int32_t Format = 0;
+			bOk = Trace.Read(Id) && Trace.Read(SizeX) && Trace.Read(SizeY) && Trace.Read(Layers) && Trace.Read(Mips) && Trace.Read(Format);
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateTexture2DArray(SizeX, SizeY, Layers, Mips, (EPixelFormat)Format).DeRef());
+			}
+		}
+		break;
+	case RCC_CreateTextureCube:
+		{
+			uint32_t Size = 0, Mips = 0;
+			int32_t Format = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Size) && Trace.Read(Mips) && Trace.Read(Format);
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateTextureCube(Size, Mips, (EPixelFormat)Format).DeRef());
+			}
+		}
+		break;
+	case RCC_UpdateTexture:
+		{
+			uint32_t Mip = 0, Layer = 0, X = 0, Y = 0, Width = 0, Height = 0;
+			bOk = Trace.Read(Id) && Trace.Read(Mip) && Trace.Read(Layer) && Trace.Read(X) && Trace.Read(Y) && Trace.Read(Width) && Trace.Read(Height);
+			const uint8_t *Data = bOk ? Trace.ReadBlob(Bytes) : nullptr;
+			bOk = Data != nullptr;
+
+			FRHITexture *Texture = GetResource<FRHITexture>(Id);
+			if (bOk && Texture && Bytes > 0 && Bytes == Width * Height * GetPixelFormatBytes(Texture->GetFormat()))
+			{
+				Renderer->RHIUpdateTexture(Texture, Mip, Layer, X, Y, Width, Height, Data);
+			}
+		}
+		break;
+	case RCC_GenerateMips:
+		{
+			bOk = Trace.Read(Id);
+			if (bOk)
+			{
+				Renderer->RHIGenerateMips(GetResource<FRHITexture>(Id));
+			}
+		}
+		break;
+	case RCC_SetTexture:
+		{
+			uint32_t TexIndex = 0;
+			bOk = Trace.Read(TexIndex) && Trace.Read(Id);
+			if (bOk)
+			{
+				Renderer->RHISetTexture(TexIndex, GetResource<FRHITexture>(Id));
+			}
+		}
+		break;
+	case RCC_CreateRenderBuffer:
+		{
+			uint32_t SizeX = 0, SizeY = 0, Samples = 0;
+			int32_t Format = 0;
+			bOk = Trace.Read(Id) && Trace.Read(SizeX) && Trace.Read(SizeY) && Trace.Read(Format) && Trace.Read(Samples);
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateRenderBuffer(SizeX, SizeY, (EPixelFormat)Format, Samples).DeRef());
+			}
+		}
+		break;
+	case RCC_CreateFrameBuffer:
+		{
+			uint32_t ColorTargetsNum = 0;
+			FRHIRenderTargetView ColorTargets[MaxSimultaneousRenderTargets];
+			FRHIRenderTargetView DepthStencilTarget;
+			bOk = Trace.Read(Id) && Trace.Read(ColorTargetsNum) && ColorTargetsNum <= MaxSimultaneousRenderTargets;
+			for (uint32_t k = 0; bOk && k < ColorTargetsNum; k++)
+			{
+				bOk = ReadRenderTargetView(ColorTargets[k]);
+			}
+			bOk = bOk && ReadRenderTargetView(DepthStencilTarget);
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateFrameBuffer(ColorTargets, ColorTargetsNum, DepthStencilTarget).DeRef());
+			}
+		}
+		break;
+	case RCC_SetFrameBuffer:
+		{
+			bOk = Trace.Read(Id);
+			if (bOk)
+			{
+				Renderer->RHISetFrameBuffer(GetResource<FRHIFrameBuffer>(Id));
+			}
+		}
+		break;
+	case RCC_ResolveFrameBuffer:
+		{
+			uint32_t DestId = 0;
+			bOk = Trace.Read(Id) && Trace.Read(DestId);
+			if (bOk)
+			{
+				Renderer->RHIResolveFrameBuffer(GetResource<FRHIFrameBuffer>(Id), GetResource<FRHIFrameBuffer>(DestId));
+			}
+		}
+		break;
+	case RCC_BeginTimerQuery:
+		{
+			const uint8_t *Name = Trace.ReadBlob(Bytes);
+			bOk = Name != nullptr;
+			if (bOk)
+			{
+				Renderer->RHIBeginTimerQuery(std::string(reinterpret_cast<const char*>(Name), Bytes).c_str());
+			}
+		}
+		break;
+	case RCC_EndTimerQuery:
+		Renderer->RHIEndTimerQuery();
+		break;
+	case RCC_CreateOcclusionQuery:
+		{
+			bOk = Trace.Read(Id);
+			if (bOk)
+			{
+				SetResource(Id, Renderer->RHICreateOcclusionQuery().DeRef());
+			}
+		}
+		break;
+	case RCC_BeginOcclusionQuery:
+	case RCC_EndOcclusionQuery:
+		{
+			bOk = Trace.Read(Id);
+			if (bOk)
+			{
+				FRHIOcclusionQueryRef Query = GetResource<FRHIOcclusionQuery>(Id);
+				if (InCommand == RCC_BeginOcclusionQuery)
+				{
+					Renderer->RHIBeginOcclusionQuery(Query);
+				}
+				else
+				{
+					Renderer->RHIEndOcclusionQuery(Query);
+				}
+			}
+		}
+		break;
+	case RCC_BeginConditionalRender:
+		{
+			bool bWait = false;
+			bOk = Trace.Read(Id) && Trace.Read(bWait);
+			if (bOk)
+			{
+				Renderer->RHIBeginConditionalRender(GetResource<FRHIOcclusionQuery>(Id), bWait);
+			}
+		}
+		break;
+	case RCC_EndConditionalRender:
+		Renderer->RHIEndConditionalRender();
+		break;
+	default:
+		ReplayError("unknown command");
+		return false;
+	}
+
+	if (!bOk)
+	{
+		ReplayError("truncated trace");
+	}
+	return bOk;
+}
+
+void FRHICaptureReplayer::DumpTimings(FOutputDevice &OutDevice) const
+{
+	if (FrameTimes.empty())
+	{
+		OutDevice.Log(Log_Info, "RHI replay: no frame replayed.");
+		return;
+	}
+
+	double MinTime = FrameTimes[0], MaxTime = FrameTimes[0], TotalTime = 0.0;
+	for (size_t k = 0; k < FrameTimes.size(); k++)
+	{
+		MinTime = std::min(MinTime, FrameTimes[k]);
+		MaxTime = std::max(MaxTime, FrameTimes[k]);
+		TotalTime += FrameTimes[k];
+	} // end for k
+
+	std::vector<double> Sorted(FrameTimes);
+	std::sort(Sorted.begin(), Sorted.end());
+	double Median = Sorted[Sorted.size() / 2];
+
+	OutDevice.Log(Log_Info, "RHI replay: %u frames, avg %.3f ms, median %.3f ms, min %.3f ms, max %.3f ms",
+		(uint32_t)FrameTimes.size(), TotalTime / FrameTimes.size(), Median, MinTime, MaxTime);
+}
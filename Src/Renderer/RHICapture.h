@@ -0,0 +1,392 @@
+// \brief
+//		RHI capture & replay.
+//		FRecordingRenderer forwards every call to another renderer and serializes it
+//		into a binary trace, FRHICaptureReplayer feeds a trace into any renderer.
+//
+
+#ifndef __JETX_RHI_CAPTURE_H__
+#define __JETX_RHI_CAPTURE_H__
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include "Foundation/JetX.h"
+#include "Foundation/OutputDevice.h"
+#include "Renderer.h"
+
+
+// commands of the trace
+enum ERHICaptureCommand
+{
+	RCC_None,
+
+	// viewport
+	RCC_CreateViewport,
+	RCC_ResizeViewport,
+
+	// resource creating
+	RCC_CreateSamplerState,
+	RCC_CreateRasterizerState,
+	RCC_CreateDepthStencilState,
+	RCC_CreateBlendState,
+	RCC_CreateVertexBuffer,
+	RCC_CreateIndexBuffer,
+	RCC_FillDataBuffer,
+	RCC_LockDataBuffer,
+	RCC_UnLockDataBuffer,
+	RCC_CreateVertexInputLayout,
+	RCC_CreateVertexShader,
+	RCC_CreatePixelShader,
+	RCC_CreateGPUProgram,
+
+	// program parameters
+	RCC_GetUniformHandle,
+	RCC_SetUniform,
+
+	// state setting
+	RCC_SetSamplerState,
+	RCC_SetRasterizerState,
+	RCC_SetDepthStencilState,
+	RCC_SetBlendState,
+	RCC_SetViewport,
+	RCC_SetScissorRect,
+	RCC_SetVertexStreamSource,
+	RCC_SetVertexInputLayout,
+	RCC_SetGPUProgram,
+
+	// draw commands
+	RCC_BeginDrawingViewport,
+	RCC_EndDrawingViewport,
+	RCC_BeginFrame,
+	RCC_EndFrame,
+	RCC_Clear,
+	RCC_ClearMRT,
+	RCC_DrawIndexedPrimitive,
+	RCC_DrawIndexedPrimitiveInstanced,
+	RCC_DrawArrayedPrimitive,
+	RCC_DrawArrayedPrimitiveInstanced,
+
+	// pipeline states
+	RCC_CreateGraphicsPipelineState,
+	RCC_SetGraphicsPipelineState,
+
+	// uniform buffers
+	RCC_CreateUniformBuffer,
+	RCC_UpdateUniformBuffer,
+	RCC_SetUniformBuffer,
+	RCC_SetUniformBufferBinding,
+
+	// data buffers
+	RCC_FlushDataBufferRange,
+
+	// textures
+	RCC_CreateTexture2D,
+	RCC_CreateTexture2DArray,
+	RCC_CreateTextureCube,
+	RCC_UpdateTexture,
+	RCC_GenerateMips,
+	RCC_SetTexture,
+
+	// render targets
+	RCC_CreateRenderBuffer,
+	RCC_CreateFrameBuffer,
+	RCC_SetFrameBuffer,
+	RCC_ResolveFrameBuffer,
+
+	// indirect draws
+	RCC_CreateIndirectBuffer,
+	RCC_DrawIndexedPrimitiveIndirect,
+	RCC_MultiDrawIndexedPrimitiveIndirect,
+
+	// gpu profiling
+	RCC_BeginTimerQuery,
+	RCC_EndTimerQuery,
+
+	// occlusion queries
+	RCC_CreateOcclusionQuery,
+	RCC_BeginOcclusionQuery,
+	RCC_EndOcclusionQuery,
+	RCC_BeginConditionalRender,
+	RCC_EndConditionalRender,
+
+	RCC_Max
+};
+
+// value type of RCC_SetUniform
+enum ERHICaptureUniformType
+{
+	RCU_1iv,
+	RCU_2iv,
+	RCU_3iv,
+	RCU_4iv,
+	RCU_1uiv,
+	RCU_2uiv,
+	RCU_3uiv,
+	RCU_4uiv,
+	RCU_1fv,
+	RCU_2fv,
+	RCU_3fv,
+	RCU_4fv,
+	RCU_Matrix4fv,
+
+	RCU_Max
+};
+
+// binary trace, plain values in native byte order.
+class FRHICaptureArchive
+{
+public:
+	FRHICaptureArchive()
+		: Cursor(0)
+	{}
+
+	void Write(const void *InData, uint32_t InBytes);
+	template<typename T>
+	void Write(const T &InValue) { Write(&InValue, sizeof(T)); }
+	// length-prefixed bytes
+	void WriteBlob(const void *InData, uint32_t InBytes);
+
+	bool Read(void *OutData, uint32_t InBytes);
+	template<typename T>
+	bool Read(T &OutValue) { return Read(&OutValue, sizeof(T)); }
+	// return nullptr if the archive is truncated, the data stays in the archive.
+	const uint8_t* ReadBlob(uint32_t &OutBytes);
+
+	bool IsEnd() const { return Cursor >= Data.size(); }
+	size_t Tell() const { return Cursor; }
+	void Seek(size_t InPosition) { Cursor = InPosition; }
+	void Reset() { Data.clear(); Cursor = 0; }
+
+	bool SaveToFile(const char *InFileName) const;
+	bool LoadFromFile(const char *InFileName);
+
+	std::vector<uint8_t>	Data;
+	size_t					Cursor;
+};
+
+
+//FRecordingRenderer
+// a decorator, the wrapped renderer does the real work. the gpu programs returned
+// are proxies so that the uniform updates are captured too.
+class FRecordingRenderer : public FRenderer
+{
+public:
+	// InRenderer is owned by the caller.
+	FRecordingRenderer(FRenderer *InRenderer);
+	virtual ~FRecordingRenderer();
+
+	FRenderer* GetRenderer() const { return Renderer; }
+
+	// the trace recorded so far, starts with the header.
+	const FRHICaptureArchive& GetTrace() const { return Trace; }
+	bool SaveTrace(const char *InFileName) const { return Trace.SaveToFile(InFileName); }
+
+	//Init
+	virtual void Init(FOutputDevice *LogOutputDevice) override;
+	virtual void Shutdown() override;
+
+	//Capabilities
+	virtual void DumpCapabilities() override;
+
+	//Options, not recorded
+	virtual void SetProgramCacheDirectory(const char *InDirectory) override;
+	virtual void SetDrawMergingEnabled(bool bEnabled) override;
+
+//render viewport
+	virtual FRHIViewportRef RHICreateViewport(void* InWindowHandle, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen) override;
+	virtual void RHIResizeViewport(FRHIViewportRef InViewport, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen) override;
+
+	virtual bool RHIGetAvailableResolutions(FScreenResolutionArray& Resolutions, bool bIgnoreRefreshRate) override;
+	virtual void RHIGetSupportedResolution(uint32_t& Width, uint32_t& Height) override;
+
+//Resource Creating
+	// states
+	virtual FRHISamplerStateRef RHICreateSamplerState(const FSamplerStateInitializerRHI &SamplerStateInitializer) override;
+	virtual FRHIRasterizerStateRef RHICreateRasterizerState(const FRasterizerStateInitializerRHI &RasterizerStateInitializer) override;
+	virtual FRHIDepthStencilStateRef RHICreateDepthStencilState(const FDepthStencilStateInitializerRHI &DepthStencilStateInitializer) override;
+	virtual FRHIBlendStateRef RHICreateBlendState(const FBlendStateInitializerRHI &BlendStateInitializer) override;
+	virtual FRHIGraphicsPipelineStateRef RHICreateGraphicsPipelineState(const FGraphicsPipelineStateInitializerRHI &PipelineStateInitializer) override;
+
+	// data buffers
+	virtual FRHIVertexBufferRef RHICreateVertexBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess, EBufferUsage InUsage) override;
+	virtual FRHIIndexBufferRef RHICreateIndexBuffer(uint32_t InBytes, const void *InData, uint16_t InStride, EBufferAccess InAccess, EBufferUsage InUsage) override;
+	virtual FRHIIndirectBufferRef RHICreateIndirectBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess) override;
+
+	virtual void FillDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, const void *InData) override;
+	virtual void* LockDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, EBufferLockMode InMode) override;
+	virtual void UnLockDataBuffer(FRHIDataBufferRef InBuffer) override;
+	virtual void FlushDataBufferRange(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes) override;
+
+	// uniform buffers
+	virtual FRHIUniformBufferRef RHICreateUniformBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess) override;
+	virtual void RHIUpdateUniformBuffer(const FRHIUniformBufferRef &InBuffer, const void *InData) override;
+
+	// textures
+	virtual FRHITexture2DRef RHICreateTexture2D(uint32_t InSizeX, uint32_t InSizeY, uint32_t InMips, EPixelFormat InFormat) override;
+	virtual FRHITexture2DArrayRef RHICreateTexture2DArray(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat) override;
+	virtual FRHITextureCubeRef RHICreateTextureCube(uint32_t InSize, uint32_t InMips, EPixelFormat InFormat) override;
+	virtual void RHIUpdateTexture(const FRHITextureRef &InTexture, uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData) override;
+	virtual void RHIGenerateMips(const FRHITextureRef &InTexture) override;
+
+	// render targets
+	virtual FRHIRenderBufferRef RHICreateRenderBuffer(uint32_t InSizeX, uint32_t InSizeY, EPixelFormat InFormat, uint32_t InSamples) override;
+	virtual FRHIFrameBufferRef RHICreateFrameBuffer(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget) override;
+
+	// queries
+	virtual FRHIOcclusionQueryRef RHICreateOcclusionQuery() override;
+
+	// transient geometry
+	// the buffers are recorded as dynamic ones, the data written is recorded as fills before the next draw.
+	virtual void* RHIAllocTransientVertices(uint32_t InBytes, uint32_t InStride, FRHIVertexBufferRef &OutBuffer, uint32_t &OutFirstVertex) override;
+	virtual void* RHIAllocTransientIndices(uint32_t InCount, uint16_t InStride, FRHIIndexBufferRef &OutBuffer, uint32_t &OutFirstIndex) override;
+
+	// vertex input layout
+	virtual FRHIVertexDeclarationRef RHICreateVertexInputLayout(const FVertexElement *InVertexElements, uint32_t InCount) override;
+
+	// shader
+	virtual FRHIVertexShaderRef RHICreateVertexShader(const char *InSource, int32_t InLength = -1) override;
+	virtual FRHIPixelShaderRef RHICreatePixelShader(const char *InSource, int32_t InLength = -1) override;
+	virtual FRHIGPUProgramRef RHICreateGPUProgram(const FRHIVertexShaderRef &InVShader, const FRHIPixelShaderRef &InPShader) override;
+	virtual FRHIGPUProgramRef RHICreateGPUProgram(const std::vector<FRHIShaderRef> &InShaders) override;
+
+//State Setting
+	virtual void RHISetSamplerState(uint32_t InTexIndex, const FRHISamplerStateRef &InSamplerState) override;
+	virtual void RHISetTexture(uint32_t InTexIndex, const FRHITextureRef &InTexture) override;
+	virtual void RHISetRasterizerState(const FRHIRasterizerStateRef &InRasterizerState) override;
+	virtual void RHISetDepthStencilState(const FRHIDepthStencilStateRef &InDepthStencilState, int32_t InStencilRef) override;
+	virtual void RHISetBlendState(const FRHIBlendStateRef &InBlendState, const FLinearColor &InBlendColor) override;
+	virtual void RHISetGraphicsPipelineState(const FRHIGraphicsPipelineStateRef &InPipelineState, int32_t InStencilRef, const FLinearColor &InBlendColor) override;
+
+	virtual void RHISetFrameBuffer(const FRHIFrameBufferRef &InFrameBuffer) override;
+	virtual void RHISetViewport(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight, float InMinZ, float InMaxZ) override;
+	virtual void RHISetScissorRect(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight) override;
+
+	virtual void SetVertexStreamSource(uint32_t InStreamIndex, const FRHIVertexBufferRef &InVertexBuffer) override;
+	virtual void SetVertexInputLayout(const FRHIVertexDeclarationRef &InVertexDecl) override;
+	virtual void SetGPUProgram(const FRHIGPUProgramRef &InProgram) override;
+	virtual void RHISetUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer) override;
+
+//Draw Commands
+	virtual void RHIBeginDrawingViewport(FRHIViewportRef Viewport) override;
+	virtual void RHIEndDrawingViewport(FRHIViewportRef Viewport, bool bPresent, bool bLockToVsync) override;
+	virtual void RHIBeginFrame() override;
+	virtual void RHIEndFrame() override;
+
+	virtual void RHIClear(bool bClearColor, const FLinearColor &InColor, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil) override;
+	virtual void RHIClearMRT(bool bClearColor, const FLinearColor *InColors, uint32_t InColorsNum, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil) override;
+	virtual void RHIResolveFrameBuffer(const FRHIFrameBufferRef &InSource, const FRHIFrameBufferRef &InDest) override;
+
+	// draw primitives
+	virtual void DrawIndexedPrimitive(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount) override;
+	virtual void DrawIndexedPrimitiveInstanced(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances) override;
+	virtual void DrawArrayedPrimitive(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount) override;
+	virtual void DrawArrayedPrimitiveInstanced(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances) override;
+	virtual void DrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset) override;
+	virtual void MultiDrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t InStride) override;
+
+//GPU Profiling
+	virtual void RHIBeginTimerQuery(const char *InName) override;
+	virtual void RHIEndTimerQuery() override;
+	// not recorded
+	virtual bool RHIGetGPUFrameTimings(FGPUFrameTimings &OutTimings) override;
+
+//Occlusion Queries
+	virtual void RHIBeginOcclusionQuery(const FRHIOcclusionQueryRef &InQuery) override;
+	virtual void RHIEndOcclusionQuery(const FRHIOcclusionQueryRef &InQuery) override;
+	// not recorded, the draws skipped by the results are not in the trace.
+	virtual bool RHIGetOcclusionQueryResult(const FRHIOcclusionQueryRef &InQuery, uint64_t &OutSamples, bool bWait) override;
+	virtual void RHIBeginConditionalRender(const FRHIOcclusionQueryRef &InQuery, bool bWait) override;
+	virtual void RHIEndConditionalRender() override;
+
+//Helpers
+	// the trace id of a resource, 0 for null or unknown.
+	uint32_t GetResourceId(FRHIResource *InResource) const;
+	void WriteCommand(ERHICaptureCommand InCommand) { Trace.Write((uint8_t)InCommand); }
+
+	FRHICaptureArchive& GetArchive() { return Trace; }
+
+protected:
+	uint32_t RegisterResource(FRHIResource *InResource);
+	FRHIGPUProgramRef WrapGPUProgram(const FRHIGPUProgramRef &InProgram);
+	// the id of the texture or the render buffer, the mip and the layer.
+	void WriteRenderTargetView(const FRHIRenderTargetView &InView);
+	void FlushTransientWrites();
+
+	struct FLockRecord
+	{
+		uint32_t		Offset;
+		uint32_t		Bytes;
+		EBufferLockMode	Mode;
+		void			*Memory;
+	};
+
+	FRenderer			*Renderer;
+	FOutputDevice		*Logger;
+	FRHICaptureArchive	Trace;
+
+	uint32_t			NextResourceId;
+	std::unordered_map<FRHIResource*, uint32_t>	ResourceIds;
+	std::unordered_map<FRHIResource*, FLockRecord>	LockedBuffers;
+
+	// transient allocations not recorded yet
+	struct FTransientWrite
+	{
+		FRHIDataBuffer	*Buffer;
+		uint32_t		Offset;
+		uint32_t		Bytes;
+		const void		*Memory;
+	};
+	std::vector<FTransientWrite>	TransientWrites;
+	// the last transient buffers handed out, kept alive so that their addresses are not reused.
+	FRHIVertexBufferRef		TransientVertexBuffer;
+	FRHIIndexBufferRef		TransientIndexBuffers[2];
+};
+
+
+//FRHICaptureReplayer
+// commands before the first RHIBeginFrame run once, the frames can be looped.
+class FRHICaptureReplayer
+{
+public:
+	FRHICaptureReplayer();
+
+	bool LoadFromFile(const char *InFileName);
+	bool LoadFromArchive(const FRHICaptureArchive &InTrace);
+
+	// replay the trace into InRenderer (already initialized), the viewports are created with InWindowHandle.
+	// the frames are replayed InLoops times.
+	bool Replay(FRenderer *InRenderer, void *InWindowHandle, uint32_t InLoops = 1, FOutputDevice *InLogger = nullptr);
+
+	// CPU time of every replayed frame (RHIBeginFrame to RHIEndFrame), in milliseconds.
+	const std::vector<double>& GetFrameTimes() const { return FrameTimes; }
+	void DumpTimings(FOutputDevice &OutDevice) const;
+
+protected:
+	bool ExecuteCommand(ERHICaptureCommand InCommand);
+	void ReplayError(const char *InMessage);
+
+	template<typename T>
+	T* GetResource(uint32_t InId) const
+	{
+		return InId < Resources.size() ? dynamic_cast<T*>(Resources[InId].DeRef()) : nullptr;
+	}
+	void SetResource(uint32_t InId, FRHIResource *InResource);
+	bool ReadRenderTargetView(FRHIRenderTargetView &OutView);
+
+	FRHICaptureArchive	Trace;
+
+	FRenderer			*Renderer;
+	void				*WindowHandle;
+	FOutputDevice		*Logger;
+
+	std::vector<TRefCountPtr<FRHIResource> >	Resources;
+	// (program id, captured handle) -> handle of the replaying renderer
+	std::map<std::pair<uint32_t, int32_t>, int32_t>	UniformHandles;
+	// buffer id -> memory of the pending lock
+	std::map<uint32_t, void*>	LockedMemory;
+	double				FrameStartTime;
+	std::vector<double>	FrameTimes;
+};
+
+#endif // __JETX_RHI_CAPTURE_H__
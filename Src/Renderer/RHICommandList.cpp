@@ -0,0 +1,778 @@
+// \brief
+//		RHI command list implementation.
+//
+
+#include <cstring>
+#include "RHICommandList.h"
+
+
+//////////////////////////////////////////////////////////////////////////
+// commands
+
+struct FRHICommandFillDataBuffer : public FRHICommandBase
+{
+	FRHICommandFillDataBuffer(FRHIDataBuffer *InBuffer, uint32_t InOffset, uint32_t InBytes, const void *InData)
+		: Buffer(InBuffer), Offset(InOffset), Bytes(InBytes), Data(InData)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->FillDataBuffer(Buffer, Offset, Bytes, Data);
+	}
+
+	FRHIDataBufferRef	Buffer;
+	uint32_t			Offset;
+	uint32_t			Bytes;
+	const void			*Data;
+};
+
+struct FRHICommandUpdateUniformBuffer : public FRHICommandBase
+{
+	FRHICommandUpdateUniformBuffer(FRHIUniformBuffer *InBuffer, const void *InData)
+		: Buffer(InBuffer), Data(InData)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHIUpdateUniformBuffer(Buffer, Data);
+	}
+
+	FRHIUniformBufferRef	Buffer;
+	const void				*Data;
+};
+
+struct FRHICommandUpdateTexture : public FRHICommandBase
+{
+	FRHICommandUpdateTexture(FRHITexture *InTexture, uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData)
+		: Texture(InTexture), Mip(InMip), Layer(InLayer), X(InX), Y(InY), Width(InWidth), Height(InHeight), Data(InData)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHIUpdateTexture(Texture, Mip, Layer, X, Y, Width, Height, Data);
+	}
+
+	FRHITextureRef	Texture;
+	uint32_t		Mip;
+	uint32_t		Layer;
+	uint32_t		X, Y;
+	uint32_t		Width, Height;
+	const void		*Data;
+};
+
+template<typename T>
+struct TRHICommandSetUniform : public FRHICommandBase
+{
+	typedef bool (FRHIGPUProgram::*FSetter)(int32_t, const T*, uint32_t);
+
+	TRHICommandSetUniform(FRHIGPUProgram *InProgram, FSetter InSetter, int32_t InHandle, const T *InValues, uint32_t InCount)
+		: Program(InProgram), Setter(InSetter), Handle(InHandle), Values(InValues), Count(InCount)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		(Program.DeRef()->*Setter)(Handle, Values, Count);
+	}
+
+	FRHIGPUProgramRef	Program;
+	FSetter				Setter;
+	int32_t				Handle;
+	const T				*Values;
+	uint32_t			Count;
+};
+
+struct FRHICommandSetSamplerState : public FRHICommandBase
+{
+	FRHICommandSetSamplerState(uint32_t InTexIndex, FRHISamplerState *InState)
+		: TexIndex(InTexIndex), State(InState)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHISetSamplerState(TexIndex, State);
+	}
+
+	uint32_t			TexIndex;
+	FRHISamplerStateRef	State;
+};
+
+struct FRHICommandSetTexture : public FRHICommandBase
+{
+	FRHICommandSetTexture(uint32_t InTexIndex, FRHITexture *InTexture)
+		: TexIndex(InTexIndex), Texture(InTexture)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHISetTexture(TexIndex, Texture);
+	}
+
+	uint32_t		TexIndex;
+	FRHITextureRef	Texture;
+};
+
+struct FRHICommandSetRasterizerState : public FRHICommandBase
+{
+	FRHICommandSetRasterizerState(FRHIRasterizerState *InState)
+		: State(InState)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHISetRasterizerState(State);
+	}
+
+	FRHIRasterizerStateRef	State;
+};
+
+struct FRHICommandSetDepthStencilState : public FRHICommandBase
+{
+	FRHICommandSetDepthStencilState(FRHIDepthStencilState *InState, int32_t InStencilRef)
+		: State(InState), StencilRef(InStencilRef)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHISetDepthStencilState(State, StencilRef);
+	}
+
+	FRHIDepthStencilStateRef	State;
+	int32_t						StencilRef;
+};
+
+struct FRHICommandSetBlendState : public FRHICommandBase
+{
+	FRHICommandSetBlendState(FRHIBlendState *InState, const FLinearColor &InBlendColor)
+		: State(InState), BlendColor(InBlendColor)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHISetBlendState(State, BlendColor);
+	}
+
+	FRHIBlendStateRef	State;
+	FLinearColor		BlendColor;
+};
+
+struct FRHICommandSetGraphicsPipelineState : public FRHICommandBase
+{
+	FRHICommandSetGraphicsPipelineState(FRHIGraphicsPipelineState *InState, int32_t InStencilRef, const FLinearColor &InBlendColor)
+		: State(InState), StencilRef(InStencilRef), BlendColor(InBlendColor)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHISetGraphicsPipelineState(State, StencilRef, BlendColor);
+	}
+
+	FRHIGraphicsPipelineStateRef	State;
+	int32_t							StencilRef;
+	FLinearColor					BlendColor;
+};
+
+struct FRHICommandSetFrameBuffer : public FRHICommandBase
+{
+	FRHICommandSetFrameBuffer(FRHIFrameBuffer *InFrameBuffer)
+		: FrameBuffer(InFrameBuffer)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHISetFrameBuffer(FrameBuffer);
+	}
+
+	FRHIFrameBufferRef	FrameBuffer;
+};
+
+struct FRHICommandSetViewport : public FRHICommandBase
+{
+	FRHICommandSetViewport(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight, float InMinZ, float InMaxZ)
+		: X(InX), Y(InY), Width(InWidth), Height(InHeight), MinZ(InMinZ), MaxZ(InMaxZ)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHISetViewport(X, Y, Width, Height, MinZ, MaxZ);
+	}
+
+	int32_t		X, Y, Width, Height;
+	float		MinZ, MaxZ;
+};
+
+struct FRHICommandSetScissorRect : public FRHICommandBase
+{
+	FRHICommandSetScissorRect(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight)
+		: X(InX), Y(InY), Width(InWidth), Height(InHeight)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHISetScissorRect(X, Y, Width, Height);
+	}
+
+	int32_t		X, Y, Width, Height;
+};
+
+struct FRHICommandSetVertexStreamSource : public FRHICommandBase
+{
+	FRHICommandSetVertexStreamSource(uint32_t InStreamIndex, FRHIVertexBuffer *InVertexBuffer)
+		: StreamIndex(InStreamIndex), VertexBuffer(InVertexBuffer)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->SetVertexStreamSource(StreamIndex, VertexBuffer);
+	}
+
+	uint32_t			StreamIndex;
+	FRHIVertexBufferRef	VertexBuffer;
+};
+
+struct FRHICommandSetVertexInputLayout : public FRHICommandBase
+{
+	FRHICommandSetVertexInputLayout(FRHIVertexDeclaration *InVertexDecl)
+		: VertexDecl(InVertexDecl)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->SetVertexInputLayout(VertexDecl);
+	}
+
+	FRHIVertexDeclarationRef	VertexDecl;
+};
+
+struct FRHICommandSetGPUProgram : public FRHICommandBase
+{
+	FRHICommandSetGPUProgram(FRHIGPUProgram *InProgram)
+		: Program(InProgram)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->SetGPUProgram(Program);
+	}
+
+	FRHIGPUProgramRef	Program;
+};
+
+struct FRHICommandSetUniformBuffer : public FRHICommandBase
+{
+	FRHICommandSetUniformBuffer(uint32_t InBindIndex, FRHIUniformBuffer *InBuffer)
+		: BindIndex(InBindIndex), Buffer(InBuffer)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHISetUniformBuffer(BindIndex, Buffer);
+	}
+
+	uint32_t				BindIndex;
+	FRHIUniformBufferRef	Buffer;
+};
+
+struct FRHICommandBeginDrawingViewport : public FRHICommandBase
+{
+	FRHICommandBeginDrawingViewport(FRHIViewport *InViewport)
+		: Viewport(InViewport)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHIBeginDrawingViewport(Viewport);
+	}
+
+	FRHIViewportRef	Viewport;
+};
+
+struct FRHICommandEndDrawingViewport : public FRHICommandBase
+{
+	FRHICommandEndDrawingViewport(FRHIViewport *InViewport, bool InPresent, bool InLockToVsync)
+		: Viewport(InViewport), bPresent(InPresent), bLockToVsync(InLockToVsync)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHIEndDrawingViewport(Viewport, bPresent, bLockToVsync);
+	}
+
+	FRHIViewportRef	Viewport;
+	bool			bPresent;
+	bool			bLockToVsync;
+};
+
+struct FRHICommandBeginFrame : public FRHICommandBase
+{
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHIBeginFrame();
+	}
+};
+
+struct FRHICommandEndFrame : public FRHICommandBase
+{
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHIEndFrame();
+	}
+};
+
+struct FRHICommandClear : public FRHICommandBase
+{
+	FRHICommandClear(bool InClearColor, const FLinearColor *InColors, uint32_t InColorsNum, bool InClearDepth, float InDepth, bool InClearStencil, int32_t InStencil, bool InMRT)
+		: bClearColor(InClearColor), Colors(InColors), ColorsNum(InColorsNum)
+		, bClearDepth(InClearDepth), Depth(InDepth), bClearStencil(InClearStencil), Stencil(InStencil), bMRT(InMRT)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		if (bMRT)
+		{
+			InRenderer->RHIClearMRT(bClearColor, Colors, ColorsNum, bClearDepth, Depth, bClearStencil, Stencil);
+		}
+		else
+		{
+			InRenderer->RHIClear(bClearColor, *Colors, bClearDepth, Depth, bClearStencil, Stencil);
+		}
+	}
+
+	bool				bClearColor;
+	const FLinearColor	*Colors;
+	uint32_t			ColorsNum;
+	bool				bClearDepth;
+	float				Depth;
+	bool				bClearStencil;
+	int32_t				Stencil;
+	bool				bMRT;
+};
+
+struct FRHICommandResolveFrameBuffer : public FRHICommandBase
+{
+	FRHICommandResolveFrameBuffer(FRHIFrameBuffer *InSource, FRHIFrameBuffer *InDest)
+		: Source(InSource), Dest(InDest)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		InRenderer->RHIResolveFrameBuffer(Source, Dest);
+	}
+
+	FRHIFrameBufferRef	Source;
+	FRHIFrameBufferRef	Dest;
+};
+
+struct FRHICommandDrawIndexedPrimitive : public FRHICommandBase
+{
+	FRHICommandDrawIndexedPrimitive(FRHIIndexBuffer *InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances, bool InInstanced)
+		: IndexBuffer(InIndexBuffer), Mode(InMode), Start(InStart), Count(InCount), Instances(InInstances), bInstanced(InInstanced)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		if (bInstanced)
+		{
+			InRenderer->DrawIndexedPrimitiveInstanced(IndexBuffer, Mode, Start, Count, Instances);
+		}
+		else
+		{
+			InRenderer->DrawIndexedPrimitive(IndexBuffer, Mode, Start, Count);
+		}
+	}
+
+	FRHIIndexBufferRef	IndexBuffer;
+	EPrimitiveType		Mode;
+	uint32_t			Start;
+	uint32_t			Count;
+	uint32_t			Instances;
+	bool				bInstanced;
+};
+
+struct FRHICommandDrawArrayedPrimitive : public FRHICommandBase
+{
+	FRHICommandDrawArrayedPrimitive(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances, bool InInstanced)
+		: Mode(InMode), Start(InStart), Count(InCount), Instances(InInstances), bInstanced(InInstanced)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		if (bInstanced)
+		{
+			InRenderer->DrawArrayedPrimitiveInstanced(Mode, Start, Count, Instances);
+		}
+		else
+		{
+			InRenderer->DrawArrayedPrimitive(Mode, Start, Count);
+		}
+	}
+
+	EPrimitiveType		Mode;
+	uint32_t			Start;
+	uint32_t			Count;
+	uint32_t			Instances;
+	bool				bInstanced;
+};
+
+struct FRHICommandDrawIndexedPrimitiveIndirect : public FRHICommandBase
+{
+	FRHICommandDrawIndexedPrimitiveIndirect(FRHIIndexBuffer *InIndexBuffer, EPrimitiveType InMode, FRHIIndirectBuffer *InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t InStride, bool InMulti)
+		: IndexBuffer(InIndexBuffer), Mode(InMode), ArgsBuffer(InArgsBuffer), Offset(InOffset), DrawsNum(InDrawsNum), Stride(InStride), bMulti(InMulti)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		if (bMulti)
+		{
+			InRenderer->MultiDrawIndexedPrimitiveIndirect(IndexBuffer, Mode, ArgsBuffer, Offset, DrawsNum, Stride);
+		}
+		else
+		{
+			InRenderer->DrawIndexedPrimitiveIndirect(IndexBuffer, Mode, ArgsBuffer, Offset);
+		}
+	}
+
+	FRHIIndexBufferRef		IndexBuffer;
+	EPrimitiveType			Mode;
+	FRHIIndirectBufferRef	ArgsBuffer;
+	uint32_t				Offset;
+	uint32_t				DrawsNum;
+	uint32_t				Stride;
+	bool					bMulti;
+};
+
+struct FRHICommandTimerQuery : public FRHICommandBase
+{
+	FRHICommandTimerQuery(const char *InName, bool InBegin)
+		: Name(InName), bBegin(InBegin)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		if (bBegin)
+		{
+			InRenderer->RHIBeginTimerQuery(Name);
+		}
+		else
+		{
+			InRenderer->RHIEndTimerQuery();
+		}
+	}
+
+	const char		*Name;		// in the arena
+	bool			bBegin;
+};
+
+struct FRHICommandOcclusionQuery : public FRHICommandBase
+{
+	FRHICommandOcclusionQuery(FRHIOcclusionQuery *InQuery, bool InBegin)
+		: Query(InQuery), bBegin(InBegin)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		if (bBegin)
+		{
+			InRenderer->RHIBeginOcclusionQuery(Query);
+		}
+		else
+		{
+			InRenderer->RHIEndOcclusionQuery(Query);
+		}
+	}
+
+	FRHIOcclusionQueryRef	Query;
+	bool					bBegin;
+};
+
+struct FRHICommandConditionalRender : public FRHICommandBase
+{
+	FRHICommandConditionalRender(FRHIOcclusionQuery *InQuery, bool InWait, bool InBegin)
+		: Query(InQuery), bWait(InWait), bBegin(InBegin)
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		if (bBegin)
+		{
+			InRenderer->RHIBeginConditionalRender(Query, bWait);
+		}
+		else
+		{
+			InRenderer->RHIEndConditionalRender();
+		}
+	}
+
+	FRHIOcclusionQueryRef	Query;
+	bool					bWait;
+	bool					bBegin;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// FRHICommandList
+
+FRHICommandList::FRHICommandList(size_t InChunkBytes)
+	: Arena(InChunkBytes)
+	, Head(nullptr)
+	, Tail(nullptr)
+	, CommandsNum(0)
+{
+}
+
+FRHICommandList::~FRHICommandList()
+{
+	Reset();
+}
+
+void FRHICommandList::Execute(FRenderer *InRenderer)
+{
+	assert(InRenderer != nullptr);
+
+	for (FRHICommandBase *Command = Head; Command; Command = Command->Next)
+	{
+		Command->Execute(InRenderer);
+	}
+
+	Reset();
+}
+
+void FRHICommandList::Reset()
+{
+	DestroyCommands();
+	Arena.Reset();
+}
+
+void FRHICommandList::DestroyCommands()
+{
+	// the commands hold references of the resources
+	FRHICommandBase *Command = Head;
+	while (Command)
+	{
+		FRHICommandBase *Next = Command->Next;
+		Command->~FRHICommandBase();
+		Command = Next;
+	}
+
+	Head = Tail = nullptr;
+	CommandsNum = 0;
+}
+
+void* FRHICommandList::AllocData(const void *InData, size_t InBytes)
+{
+	if (!InData || InBytes == 0)
+	{
+		return nullptr;
+	}
+
+	void *Memory = Arena.Alloc(InBytes, 16);
+	memcpy(Memory, InData, InBytes);
+	return Memory;
+}
+
+//data buffers
+void FRHICommandList::FillDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, const void *InData)
+{
+	AllocCommand<FRHICommandFillDataBuffer>(InBuffer.DeRef(), InOffset, InBytes, AllocData(InData, InBytes));
+}
+
+void FRHICommandList::RHIUpdateUniformBuffer(const FRHIUniformBufferRef &InBuffer, const void *InData)
+{
+	AllocCommand<FRHICommandUpdateUniformBuffer>(InBuffer.DeRef(), AllocData(InData, InBuffer->GetBytes()));
+}
+
+void FRHICommandList::RHIUpdateTexture(const FRHITextureRef &InTexture, uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData)
+{
+	const size_t kBytes = (size_t)InWidth * InHeight * GetPixelFormatBytes(InTexture->GetFormat());
+	AllocCommand<FRHICommandUpdateTexture>(InTexture.DeRef(), InMip, InLayer, InX, InY, InWidth, InHeight, AllocData(InData, kBytes));
+}
+
+//program parameters
+#define RHI_COMMAND_SET_UNIFORM(Name, Type, Components) \
+	void FRHICommandList::Name(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const Type *V, uint32_t InCount) \
+	{ \
+		const Type *Values = reinterpret_cast<const Type*>(AllocData(V, sizeof(Type) * Components * InCount)); \
+		AllocCommand<TRHICommandSetUniform<Type> >(InProgram.DeRef(), &FRHIGPUProgram::Name, InHandle, Values, InCount); \
+	}
+
+RHI_COMMAND_SET_UNIFORM(SetUniform1iv, int32_t, 1)
+RHI_COMMAND_SET_UNIFORM(SetUniform2iv, int32_t, 2)
+RHI_COMMAND_SET_UNIFORM(SetUniform3iv, int32_t, 3)
+RHI_COMMAND_SET_UNIFORM(SetUniform4iv, int32_t, 4)
+RHI_COMMAND_SET_UNIFORM(SetUniform1uiv, uint32_t, 1)
+RHI_COMMAND_SET_UNIFORM(SetUniform2uiv, uint32_t, 2)
+RHI_COMMAND_SET_UNIFORM(SetUniform3uiv, uint32_t, 3)
+RHI_COMMAND_SET_UNIFORM(SetUniform4uiv, uint32_t, 4)
+RHI_COMMAND_SET_UNIFORM(SetUniform1fv, float, 1)
+RHI_COMMAND_SET_UNIFORM(SetUniform2fv, float, 2)
+RHI_COMMAND_SET_UNIFORM(SetUniform3fv, float, 3)
+RHI_COMMAND_SET_UNIFORM(SetUniform4fv, float, 4)
+RHI_COMMAND_SET_UNIFORM(SetUniformMatrix4fv, float, 16)
+
+#undef RHI_COMMAND_SET_UNIFORM
+
+//State Setting
+void FRHICommandList::RHISetSamplerState(uint32_t InTexIndex, const FRHISamplerStateRef &InSamplerState)
+{
+	AllocCommand<FRHICommandSetSamplerState>(InTexIndex, InSamplerState.DeRef());
+}
+
+void FRHICommandList::RHISetTexture(uint32_t InTexIndex, const FRHITextureRef &InTexture)
+{
+	AllocCommand<FRHICommandSetTexture>(InTexIndex, InTexture.DeRef());
+}
+
+void FRHICommandList::RHISetRasterizerState(const FRHIRasterizerStateRef &InRasterizerState)
+{
+	AllocCommand<FRHICommandSetRasterizerState>(InRasterizerState.DeRef());
+}
+
+void FRHICommandList::RHISetDepthStencilState(const FRHIDepthStencilStateRef &InDepthStencilState, int32_t InStencilRef)
+{
+	AllocCommand<FRHICommandSetDepthStencilState>(InDepthStencilState.DeRef(), InStencilRef);
+}
+
+void FRHICommandList::RHISetBlendState(const FRHIBlendStateRef &InBlendState, const FLinearColor &InBlendColor)
+{
+	AllocCommand<FRHICommandSetBlendState>(InBlendState.DeRef(), InBlendColor);
+}
+
+void FRHICommandList::RHISetGraphicsPipelineState(const FRHIGraphicsPipelineStateRef &InPipelineState, int32_t InStencilRef, const FLinearColor &InBlendColor)
+{
+	AllocCommand<FRHICommandSetGraphicsPipelineState>(InPipelineState.DeRef(), InStencilRef, InBlendColor);
+}
+
+void FRHICommandList::RHISetFrameBuffer(const FRHIFrameBufferRef &InFrameBuffer)
+{
+	AllocCommand<FRHICommandSetFrameBuffer>(InFrameBuffer.DeRef());
+}
+
+void FRHICommandList::RHISetViewport(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight, float InMinZ, float InMaxZ)
+{
+	AllocCommand<FRHICommandSetViewport>(InX, InY, InWidth, InHeight, InMinZ, InMaxZ);
+}
+
+void FRHICommandList::RHISetScissorRect(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight)
+{
+	AllocCommand<FRHICommandSetScissorRect>(InX, InY, InWidth, InHeight);
+}
+
+void FRHICommandList::SetVertexStreamSource(uint32_t InStreamIndex, const FRHIVertexBufferRef &InVertexBuffer)
+{
+	AllocCommand<FRHICommandSetVertexStreamSource>(InStreamIndex, InVertexBuffer.DeRef());
+}
+
+void FRHICommandList::SetVertexInputLayout(const FRHIVertexDeclarationRef &InVertexDecl)
+{
+	AllocCommand<FRHICommandSetVertexInputLayout>(InVertexDecl.DeRef());
+}
+
+void FRHICommandList::SetGPUProgram(const FRHIGPUProgramRef &InProgram)
+{
+	AllocCommand<FRHICommandSetGPUProgram>(InProgram.DeRef());
+}
+
+void FRHICommandList::RHISetUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer)
+{
+	AllocCommand<FRHICommandSetUniformBuffer>(InBindIndex, InBuffer.DeRef());
+}
+
+//Draw Commands
+void FRHICommandList::RHIBeginDrawingViewport(FRHIViewportRef Viewport)
+{
+	AllocCommand<FRHICommandBeginDrawingViewport>(Viewport.DeRef());
+}
+
+void FRHICommandList::RHIEndDrawingViewport(FRHIViewportRef Viewport, bool bPresent, bool bLockToVsync)
+{
+	AllocCommand<FRHICommandEndDrawingViewport>(Viewport.DeRef(), bPresent, bLockToVsync);
+}
+
+void FRHICommandList::RHIBeginFrame()
+{
+	AllocCommand<FRHICommandBeginFrame>();
+}
+
+void FRHICommandList::RHIEndFrame()
+{
+	AllocCommand<FRHICommandEndFrame>();
+}
+
+void FRHICommandList::RHIClear(bool bClearColor, const FLinearColor &InColor, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil)
+{
+	const FLinearColor *Color = reinterpret_cast<const FLinearColor*>(AllocData(&InColor, sizeof(FLinearColor)));
+	AllocCommand<FRHICommandClear>(bClearColor, Color, 1u, bClearDepth, InDepth, bClearStencil, InStencil, false);
+}
+
+void FRHICommandList::RHIClearMRT(bool bClearColor, const FLinearColor *InColors, uint32_t InColorsNum, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil)
+{
+	const FLinearColor *Colors = reinterpret_cast<const FLinearColor*>(AllocData(InColors, sizeof(FLinearColor) * InColorsNum));
+	AllocCommand<FRHICommandClear>(bClearColor, Colors, Colors ? InColorsNum : 0u, bClearDepth, InDepth, bClearStencil, InStencil, true);
+}
+
+void FRHICommandList::RHIResolveFrameBuffer(const FRHIFrameBufferRef &InSource, const FRHIFrameBufferRef &InDest)
+{
+	AllocCommand<FRHICommandResolveFrameBuffer>(InSource.DeRef(), InDest.DeRef());
+}
+
+// draw primitives
+void FRHICommandList::DrawIndexedPrimitive(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount)
+{
+	AllocCommand<FRHICommandDrawIndexedPrimitive>(InIndexBuffer.DeRef(), InMode, InStart, InCount, 0u, false);
+}
+
+void FRHICommandList::DrawIndexedPrimitiveInstanced(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances)
+{
+	AllocCommand<FRHICommandDrawIndexedPrimitive>(InIndexBuffer.DeRef(), InMode, InStart, InCount, InInstances, true);
+}
+
+void FRHICommandList::DrawArrayedPrimitive(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount)
+{
+	AllocCommand<FRHICommandDrawArrayedPrimitive>(InMode, InStart, InCount, 0u, false);
+}
+
+void FRHICommandList::DrawArrayedPrimitiveInstanced(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances)
+{
+	AllocCommand<FRHICommandDrawArrayedPrimitive>(InMode, InStart, InCount, InInstances, true);
+}
+
+void FRHICommandList::DrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset)
+{
+	AllocCommand<FRHICommandDrawIndexedPrimitiveIndirect>(InIndexBuffer.DeRef(), InMode, InArgsBuffer.DeRef(), InOffset, 1u, 0u, false);
+}
+
+void FRHICommandList::MultiDrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t InStride)
+{
+	AllocCommand<FRHICommandDrawIndexedPrimitiveIndirect>(InIndexBuffer.DeRef(), InMode, InArgsBuffer.DeRef(), InOffset, InDrawsNum, InStride, true);
+}
+
+//GPU Profiling
+void FRHICommandList::RHIBeginTimerQuery(const char *InName)
+{
+	const char *Name = InName ? reinterpret_cast<const char*>(AllocData(InName, strlen(InName) + 1)) : nullptr;
+	AllocCommand<FRHICommandTimerQuery>(Name, true);
+}
+
+void FRHICommandList::RHIEndTimerQuery()
+{
+	AllocCommand<FRHICommandTimerQuery>(nullptr, false);
+}
+
+//Occlusion Queries
+void FRHICommandList::RHIBeginOcclusionQuery(const FRHIOcclusionQueryRef &InQuery)
+{
+	AllocCommand<FRHICommandOcclusionQuery>(InQuery.DeRef(), true);
+}
+
+void FRHICommandList::RHIEndOcclusionQuery(const FRHIOcclusionQueryRef &InQuery)
+{
+	AllocCommand<FRHICommandOcclusionQuery>(InQuery.DeRef(), false);
+}
+
+void FRHICommandList::RHIBeginConditionalRender(const FRHIOcclusionQueryRef &InQuery, bool bWait)
+{
+	AllocCommand<FRHICommandConditionalRender>(InQuery.DeRef(), bWait, true);
+}
+
+void FRHICommandList::RHIEndConditionalRender()
+{
+	AllocCommand<FRHICommandConditionalRender>(nullptr, false, false);
+}
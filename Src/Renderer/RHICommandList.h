@@ -0,0 +1,190 @@
+// \brief
+//		RHI command list: the renderer calls are recorded into a linear arena on any thread,
+//		then translated by the thread owning the renderer (e.g. the render thread).
+//
+
+#ifndef __JETX_RHI_COMMANDLIST_H__
+#define __JETX_RHI_COMMANDLIST_H__
+
+#include <new>
+#include <utility>
+#include <type_traits>
+#include "Foundation/JetX.h"
+#include "Foundation/MemArena.h"
+#include "Renderer.h"
+
+
+// a recorded command, allocated in the arena of the command list.
+struct FRHICommandBase
+{
+	FRHICommandBase()
+		: Next(nullptr)
+	{}
+	virtual ~FRHICommandBase() {}
+
+	virtual void Execute(FRenderer *InRenderer) = 0;
+
+	FRHICommandBase	*Next;
+};
+
+// FRHICommandList
+// records the state setting and draw calls of FRenderer, the resources are created
+// on the thread of the renderer beforehand. a list is recorded by one thread at a time.
+// the data passed by pointer (buffer contents, uniforms, colors) is copied into the list.
+class FRHICommandList
+{
+public:
+	FRHICommandList(size_t InChunkBytes = 64 * 1024);
+	~FRHICommandList();
+
+	// translate the commands into InRenderer, then reset the list.
+	void Execute(FRenderer *InRenderer);
+	// drop the commands without executing them.
+	void Reset();
+
+	bool IsEmpty() const { return Head == nullptr; }
+	uint32_t GetCommandsNum() const { return CommandsNum; }
+	size_t GetUsedBytes() const { return Arena.GetUsedBytes(); }
+
+//data buffers
+	void FillDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, const void *InData);
+	void RHIUpdateUniformBuffer(const FRHIUniformBufferRef &InBuffer, const void *InData);
+	void RHIUpdateTexture(const FRHITextureRef &InTexture, uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData);
+
+//program parameters
+	void SetUniform1iv(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const int32_t *V, uint32_t InCount);
+	void SetUniform2iv(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const int32_t *V, uint32_t InCount);
+	void SetUniform3iv(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const int32_t *V, uint32_t InCount);
+	void SetUniform4iv(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const int32_t *V, uint32_t InCount);
+
+	void SetUniform1uiv(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const uint32_t *V, uint32_t InCount);
+	void SetUniform2uiv(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const uint32_t *V, uint32_t InCount);
+	void SetUniform3uiv(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const uint32_t *V, uint32_t InCount);
+	void SetUniform4uiv(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const uint32_t *V, uint32_t InCount);
+
+	void SetUniform1fv(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const float *V, uint32_t InCount);
+	void SetUniform2fv(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const float *V, uint32_t InCount);
+	void SetUniform3fv(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const float *V, uint32_t InCount);
+	void SetUniform4fv(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const float *V, uint32_t InCount);
+
+	void SetUniformMatrix4fv(const FRHIGPUProgramRef &InProgram, int32_t InHandle, const float *V, uint32_t InCount);
+
+//State Setting
+	void RHISetSamplerState(uint32_t InTexIndex, const FRHISamplerStateRef &InSamplerState);
+	void RHISetTexture(uint32_t InTexIndex, const FRHITextureRef &InTexture);
+	void RHISetRasterizerState(const FRHIRasterizerStateRef &InRasterizerState);
+	void RHISetDepthStencilState(const FRHIDepthStencilStateRef &InDepthStencilState, int32_t InStencilRef);
+	void RHISetBlendState(const FRHIBlendStateRef &InBlendState, const FLinearColor &InBlendColor);
+	void RHISetGraphicsPipelineState(const FRHIGraphicsPipelineStateRef &InPipelineState, int32_t InStencilRef, const FLinearColor &InBlendColor);
+
+	void RHISetFrameBuffer(const FRHIFrameBufferRef &InFrameBuffer);
+	void RHISetViewport(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight, float InMinZ, float InMaxZ);
+	void RHISetScissorRect(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight);
+
+	void SetVertexStreamSource(uint32_t InStreamIndex, const FRHIVertexBufferRef &InVertexBuffer);
+	void SetVertexInputLayout(const FRHIVertexDeclarationRef &InVertexDecl);
+	void SetGPUProgram(const FRHIGPUProgramRef &InProgram);
+	void RHISetUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer);
+
+//Draw Commands
+	void RHIBeginDrawingViewport(FRHIViewportRef Viewport);
+	void RHIEndDrawingViewport(FRHIViewportRef Viewport, bool bPresent, bool bLockToVsync);
+	void RHIBeginFrame();
+	void RHIEndFrame();
+
+	void RHIClear(bool bClearColor, const FLinearColor &InColor, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil);
+	void RHIClearMRT(bool bClearColor, const FLinearColor *InColors, uint32_t InColorsNum, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil);
+	void RHIResolveFrameBuffer(const FRHIFrameBufferRef &InSource, const FRHIFrameBufferRef &InDest);
+
+	// draw primitives
+	void DrawIndexedPrimitive(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount);
+	void DrawIndexedPrimitiveInstanced(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances);
+	void DrawArrayedPrimitive(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount);
+	void DrawArrayedPrimitiveInstanced(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances);
+	// the arguments are read when the list is executed.
+	void DrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset);
+	void MultiDrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t InStride);
+
+//GPU Profiling
+	void RHIBeginTimerQuery(const char *InName);
+	void RHIEndTimerQuery();
+
+//Occlusion Queries
+	// the results are read from the renderer once the list is executed.
+	void RHIBeginOcclusionQuery(const FRHIOcclusionQueryRef &InQuery);
+	void RHIEndOcclusionQuery(const FRHIOcclusionQueryRef &InQuery);
+	void RHIBeginConditionalRender(const FRHIOcclusionQueryRef &InQuery, bool bWait);
+	void RHIEndConditionalRender();
+
+//Others
+	// run InFunc(FRenderer*) at this point of the list.
+	template<typename TFunc>
+	void EnqueueLambda(TFunc &&InFunc);
+
+	// construct a command in the arena and append it.
+	template<typename TCommand, typename... TArgs>
+	TCommand* AllocCommand(TArgs&&... InArgs);
+
+	// copy InBytes of InData into the arena, the copy lives until the list is reset.
+	void* AllocData(const void *InData, size_t InBytes);
+
+private:
+	FRHICommandList(const FRHICommandList&) = delete;
+	FRHICommandList& operator=(const FRHICommandList&) = delete;
+
+	void DestroyCommands();
+
+	FMemArena			Arena;
+	FRHICommandBase		*Head;
+	FRHICommandBase		*Tail;
+	uint32_t			CommandsNum;
+};
+
+template<typename TFunc>
+struct TRHILambdaCommand : public FRHICommandBase
+{
+	template<typename TArg>
+	TRHILambdaCommand(TArg &&InFunc)
+		: Func(std::forward<TArg>(InFunc))
+	{}
+
+	virtual void Execute(FRenderer *InRenderer) override
+	{
+		Func(InRenderer);
+	}
+
+	TFunc	Func;
+};
+
+template<typename TFunc>
+void FRHICommandList::EnqueueLambda(TFunc &&InFunc)
+{
+	AllocCommand<TRHILambdaCommand<typename std::decay<TFunc>::type> >(std::forward<TFunc>(InFunc));
+}
+
+#pragma push_macro("new")
+#undef new
+
+template<typename TCommand, typename... TArgs>
+TCommand* FRHICommandList::AllocCommand(TArgs&&... InArgs)
+{
+	void *Memory = Arena.Alloc(sizeof(TCommand), alignof(TCommand));
+	TCommand *Command = new(Memory) TCommand(std::forward<TArgs>(InArgs)...);
+
+	if (Tail)
+	{
+		Tail->Next = Command;
+	}
+	else
+	{
+		Head = Command;
+	}
+	Tail = Command;
+	CommandsNum++;
+
+	return Command;
+}
+
+#pragma pop_macro("new")
+
+#endif // __JETX_RHI_COMMANDLIST_H__
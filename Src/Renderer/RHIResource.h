@@ -8,6 +8,8 @@
 #include <string>
 #include "Foundation/JetX.h"
 #include "Foundation/RefCounting.h"
+#include "Foundation/Hash.h"
+#include "RendererDefs.h"
 
 
 // enumeration of the different RHI reference types.
@@ -19,6 +21,7 @@ enum ERHIResourceType
 	RRT_RasterizerState,
 	RRT_DepthStencilState,
 	RRT_BlendState,
+	RRT_GraphicsPipelineState,
 	
 	RRT_VertexDeclaration,  // input assemble layout
 	RRT_VertexShader,
@@ -28,10 +31,12 @@ enum ERHIResourceType
 	RRT_UniformBuffer,
 	RRT_IndexBuffer,
 	RRT_VertexBuffer,
+	RRT_IndirectBuffer,
 
 	RRT_Texture2D,
 	RRT_Texture3D,
 	RRT_TextureCube,
+	RRT_Texture2DArray,
 
 	RRT_FrameBuffer,
 	RRT_RenderBuffer,
@@ -107,6 +112,11 @@ public:
 
 	ERHIResourceType Type() override { return RRT_GpuProgram; }
 
+	// a program created by RHICreateGPUProgramAsync is ready once its link succeeded, the handles &
+	// the uniforms are known from then on. a failed link is never ready.
+	virtual bool IsReady() { return true; }
+	virtual bool HasFailed() { return false; }
+
 	// get uniform parameter handle
 	virtual int32_t GetUniformHandle(const std::string &InName) = 0;
 
@@ -126,6 +136,10 @@ public:
 	virtual bool SetUniform4fv(int32_t InHandle, const float *V, uint32_t InCount) = 0;
 
 	virtual bool SetUniformMatrix4fv(int32_t InHandle, const float *V, uint32_t InCount) = 0;
+
+	// the uniform block InBlockName reads the uniform buffer set at slot InBindIndex.
+	// return false if the program has no such block.
+	virtual bool SetUniformBufferBinding(const std::string &InBlockName, uint32_t InBindIndex) { return false; }
 };
 
 // program input & params
@@ -139,29 +153,73 @@ class FRHIUniformBuffer : public FRHIResource
 {
 public:
 	ERHIResourceType Type() override { return RRT_UniformBuffer; }
+
+	// the size of the contents, every update writes all of them.
+	virtual uint32_t GetBytes() = 0;
 };
 
 // texture resource
 class FRHITexture : public FRHIResource
 {
 public:
+	FRHITexture(uint32_t InSizeX, uint32_t InSizeY, uint32_t InSizeZ, uint32_t InMips, EPixelFormat InFormat)
+		: SizeX(InSizeX)
+		, SizeY(InSizeY)
+		, SizeZ(InSizeZ)
+		, Mips(InMips)
+		, Format(InFormat)
+	{}
 
 	// dynamic cast methods
 	virtual class FRHITexture2D* GetTexture2D() { return nullptr; }
+	virtual class FRHITexture2DArray* GetTexture2DArray() { return nullptr; }
 	virtual class FRHITexture3D* GetTexture3D() { return nullptr; }
 	virtual class FRHITextureCube* GetTextureCube() { return nullptr; }
+
+	uint32_t GetSizeX() const { return SizeX; }
+	uint32_t GetSizeY() const { return SizeY; }
+	// layers of an array, depth of a 3d texture, faces of a cube.
+	uint32_t GetSizeZ() const { return SizeZ; }
+	uint32_t GetNumMips() const { return Mips; }
+	EPixelFormat GetFormat() const { return Format; }
+
+protected:
+	uint32_t		SizeX;
+	uint32_t		SizeY;
+	uint32_t		SizeZ;
+	uint32_t		Mips;
+	EPixelFormat	Format;
 };
 
 class FRHITexture2D : public FRHITexture
 {
 public:
+	FRHITexture2D(uint32_t InSizeX, uint32_t InSizeY, uint32_t InMips, EPixelFormat InFormat)
+		: FRHITexture(InSizeX, InSizeY, 1, InMips, InFormat)
+	{}
+
 	ERHIResourceType Type() override { return RRT_Texture2D; }
 	class FRHITexture2D* GetTexture2D() override { return this; }
 };
 
+class FRHITexture2DArray : public FRHITexture
+{
+public:
+	FRHITexture2DArray(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat)
+		: FRHITexture(InSizeX, InSizeY, InLayers, InMips, InFormat)
+	{}
+
+	ERHIResourceType Type() override { return RRT_Texture2DArray; }
+	class FRHITexture2DArray* GetTexture2DArray() override { return this; }
+};
+
 class FRHITexture3D : public FRHITexture
 {
 public:
+	FRHITexture3D(uint32_t InSizeX, uint32_t InSizeY, uint32_t InSizeZ, uint32_t InMips, EPixelFormat InFormat)
+		: FRHITexture(InSizeX, InSizeY, InSizeZ, InMips, InFormat)
+	{}
+
 	ERHIResourceType Type() override { return RRT_Texture3D; }
 	class FRHITexture3D* GetTexture3D() override { return this; }
 };
@@ -169,12 +227,18 @@ public:
 class FRHITextureCube : public FRHITexture
 {
 public:
+	FRHITextureCube(uint32_t InSize, uint32_t InMips, EPixelFormat InFormat)
+		: FRHITexture(InSize, InSize, CubeFace_MAX, InMips, InFormat)
+	{}
+
 	ERHIResourceType Type() override { return RRT_TextureCube; }
 	class FRHITextureCube* GetTextureCube() override { return this; }
 };
 
 class FRHIDataBuffer : public FRHIResource
 {
+public:
+	virtual uint32_t GetBytes() = 0;
 };
 
 // vertex buffer resource
@@ -191,17 +255,112 @@ public:
 	virtual uint32_t GetIndexCount() = 0;
 };
 
-// frame buffer & render object
-class FRHIFrameBuffer : public FRHIResource
+// packed FDrawIndexedIndirectArgs of the indirect draws
+class FRHIIndirectBuffer : public FRHIDataBuffer
 {
 public:
-	ERHIResourceType Type() override { return RRT_FrameBuffer; }
+	ERHIResourceType Type() override { return RRT_IndirectBuffer; }
 };
 
+// frame buffer & render object
+// a render target which is never sampled, may be multisampled.
 class FRHIRenderBuffer : public FRHIResource
 {
 public:
+	FRHIRenderBuffer(uint32_t InSizeX, uint32_t InSizeY, EPixelFormat InFormat, uint32_t InSamples)
+		: SizeX(InSizeX)
+		, SizeY(InSizeY)
+		, Format(InFormat)
+		, Samples(InSamples)
+	{}
+
 	ERHIResourceType Type() override { return RRT_RenderBuffer; }
+
+	uint32_t GetSizeX() const { return SizeX; }
+	uint32_t GetSizeY() const { return SizeY; }
+	EPixelFormat GetFormat() const { return Format; }
+	uint32_t GetSamples() const { return Samples; }
+
+protected:
+	uint32_t		SizeX;
+	uint32_t		SizeY;
+	EPixelFormat	Format;
+	uint32_t		Samples;
+};
+
+// an attachment of a frame buffer: a mip of a texture or a render buffer.
+// LayerIndex is the layer of an array or the ECubeFace of a cube.
+struct FRHIRenderTargetView
+{
+	FRHIRenderTargetView()
+		: MipIndex(0)
+		, LayerIndex(0)
+	{}
+	FRHIRenderTargetView(FRHITexture *InTexture, uint32_t InMipIndex = 0, uint32_t InLayerIndex = 0)
+		: Texture(InTexture)
+		, MipIndex(InMipIndex)
+		, LayerIndex(InLayerIndex)
+	{}
+	FRHIRenderTargetView(FRHIRenderBuffer *InRenderBuffer)
+		: RenderBuffer(InRenderBuffer)
+		, MipIndex(0)
+		, LayerIndex(0)
+	{}
+
+	bool IsValid() const { return Texture.IsValidRef() || RenderBuffer.IsValidRef(); }
+
+	uint32_t GetSizeX() const { return Texture.IsValidRef() ? GetMipSize(Texture->GetSizeX(), MipIndex) : (RenderBuffer.IsValidRef() ? RenderBuffer->GetSizeX() : 0); }
+	uint32_t GetSizeY() const { return Texture.IsValidRef() ? GetMipSize(Texture->GetSizeY(), MipIndex) : (RenderBuffer.IsValidRef() ? RenderBuffer->GetSizeY() : 0); }
+	EPixelFormat GetFormat() const { return Texture.IsValidRef() ? Texture->GetFormat() : (RenderBuffer.IsValidRef() ? RenderBuffer->GetFormat() : PF_Unknown); }
+	uint32_t GetSamples() const { return RenderBuffer.IsValidRef() ? RenderBuffer->GetSamples() : 1; }
+
+	TRefCountPtr<FRHITexture>		Texture;
+	TRefCountPtr<FRHIRenderBuffer>	RenderBuffer;
+	uint32_t						MipIndex;
+	uint32_t						LayerIndex;
+};
+
+// a set of color targets and a depth-stencil target of the same size, they are kept alive by it.
+class FRHIFrameBuffer : public FRHIResource
+{
+public:
+	FRHIFrameBuffer(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget)
+		: ColorTargetsNum(InColorTargetsNum)
+		, DepthStencilTarget(InDepthStencilTarget)
+	{
+		for (uint32_t k = 0; k < InColorTargetsNum && k < MaxSimultaneousRenderTargets; k++)
+		{
+			ColorTargets[k] = InColorTargets[k];
+		}
+	}
+
+	ERHIResourceType Type() override { return RRT_FrameBuffer; }
+
+	uint32_t GetColorTargetsNum() const { return ColorTargetsNum; }
+	const FRHIRenderTargetView& GetColorTarget(uint32_t InIndex) const { return ColorTargets[InIndex]; }
+	const FRHIRenderTargetView& GetDepthStencilTarget() const { return DepthStencilTarget; }
+
+	uint32_t GetSizeX() const { return ColorTargetsNum > 0 ? ColorTargets[0].GetSizeX() : DepthStencilTarget.GetSizeX(); }
+	uint32_t GetSizeY() const { return ColorTargetsNum > 0 ? ColorTargets[0].GetSizeY() : DepthStencilTarget.GetSizeY(); }
+	uint32_t GetSamples() const { return ColorTargetsNum > 0 ? ColorTargets[0].GetSamples() : DepthStencilTarget.GetSamples(); }
+
+	// true if InTexture is written by the draws into the frame buffer.
+	bool IsAttached(const FRHITexture *InTexture) const
+	{
+		for (uint32_t k = 0; k < ColorTargetsNum; k++)
+		{
+			if (ColorTargets[k].Texture.DeRef() == InTexture)
+			{
+				return true;
+			}
+		}
+		return InTexture && DepthStencilTarget.Texture.DeRef() == InTexture;
+	}
+
+protected:
+	uint32_t				ColorTargetsNum;
+	FRHIRenderTargetView	ColorTargets[MaxSimultaneousRenderTargets];
+	FRHIRenderTargetView	DepthStencilTarget;
 };
 
 // others
@@ -232,12 +391,14 @@ typedef TRefCountPtr<FRHIUniformBuffer> FRHIUniformBufferRef;
 
 typedef TRefCountPtr<FRHITexture> FRHITextureRef;
 typedef TRefCountPtr<FRHITexture2D> FRHITexture2DRef;
+typedef TRefCountPtr<FRHITexture2DArray> FRHITexture2DArrayRef;
 typedef TRefCountPtr<FRHITexture3D> FRHITexture3DRef;
 typedef TRefCountPtr<FRHITextureCube> FRHITextureCubeRef;
 
 typedef TRefCountPtr<FRHIDataBuffer> FRHIDataBufferRef;
 typedef TRefCountPtr<FRHIVertexBuffer> FRHIVertexBufferRef;
 typedef TRefCountPtr<FRHIIndexBuffer> FRHIIndexBufferRef;
+typedef TRefCountPtr<FRHIIndirectBuffer> FRHIIndirectBufferRef;
 typedef TRefCountPtr<FRHIFrameBuffer> FRHIFrameBufferRef;
 typedef TRefCountPtr<FRHIRenderBuffer> FRHIRenderBufferRef;
 
@@ -245,4 +406,69 @@ typedef TRefCountPtr<FRHIOcclusionQuery> FRHIOcclusionQueryRef;
 typedef TRefCountPtr<FRHIViewport> FRHIViewportRef;
 
 
+// pipeline state initializer
+struct FGraphicsPipelineStateInitializerRHI
+{
+	FGraphicsPipelineStateInitializerRHI() {}
+	FGraphicsPipelineStateInitializerRHI(
+		const FRHIRasterizerStateRef &InRasterizerState,
+		const FRHIDepthStencilStateRef &InDepthStencilState,
+		const FRHIBlendStateRef &InBlendState,
+		const FRHIGPUProgramRef &InGPUProgram,
+		const FRHIVertexDeclarationRef &InVertexDecl
+		)
+		: RasterizerState(InRasterizerState)
+		, DepthStencilState(InDepthStencilState)
+		, BlendState(InBlendState)
+		, GPUProgram(InGPUProgram)
+		, VertexDecl(InVertexDecl)
+	{
+	}
+
+	// the states are unique per content (cached by the renderers), the parts are compared by address.
+	bool operator ==(const FGraphicsPipelineStateInitializerRHI &rhs) const
+	{
+		return RasterizerState.DeRef() == rhs.RasterizerState.DeRef()
+			&& DepthStencilState.DeRef() == rhs.DepthStencilState.DeRef()
+			&& BlendState.DeRef() == rhs.BlendState.DeRef()
+			&& GPUProgram.DeRef() == rhs.GPUProgram.DeRef()
+			&& VertexDecl.DeRef() == rhs.VertexDecl.DeRef();
+	}
+
+	friend uint32_t GetTypeHash(const FGraphicsPipelineStateInitializerRHI &InInitializer)
+	{
+		uint32_t Hash = GetTypeHash(InInitializer.RasterizerState.DeRef());
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.DepthStencilState.DeRef()));
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.BlendState.DeRef()));
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.GPUProgram.DeRef()));
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.VertexDecl.DeRef()));
+		return Hash;
+	}
+
+	FRHIRasterizerStateRef		RasterizerState;
+	FRHIDepthStencilStateRef	DepthStencilState;
+	FRHIBlendStateRef			BlendState;
+	FRHIGPUProgramRef			GPUProgram;
+	FRHIVertexDeclarationRef	VertexDecl;
+};
+
+// immutable set of the states of a draw, the renderers may precompute the switches between them.
+class FRHIGraphicsPipelineState : public FRHIResource
+{
+public:
+	FRHIGraphicsPipelineState(const FGraphicsPipelineStateInitializerRHI &InInitializer)
+		: Initializer(InInitializer)
+	{}
+
+	ERHIResourceType Type() override { return RRT_GraphicsPipelineState; }
+
+	const FGraphicsPipelineStateInitializerRHI& GetInitializer() const { return Initializer; }
+
+protected:
+	const FGraphicsPipelineStateInitializerRHI	Initializer;
+};
+
+typedef TRefCountPtr<FRHIGraphicsPipelineState> FRHIGraphicsPipelineStateRef;
+
+
 #endif // __JETX_RHI_RESOURCE_H__
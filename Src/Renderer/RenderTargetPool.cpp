@@ -0,0 +1,147 @@
+// \brief
+//		Render target pool implementation.
+//
+
+#include <cassert>
+#include <algorithm>
+#include "RenderTargetPool.h"
+
+
+// FPooledRenderTarget
+FRHIRenderTargetView FPooledRenderTarget::GetView() const
+{
+	return Texture.IsValidRef() ? FRHIRenderTargetView(Texture.DeRef()) : FRHIRenderTargetView(RenderBuffer.DeRef());
+}
+
+const FRHIFrameBufferRef& FPooledRenderTarget::GetFrameBuffer()
+{
+	if (!FrameBuffer.IsValidRef())
+	{
+		const FRHIRenderTargetView kView = GetView();
+		if (IsDepthPixelFormat(Desc.Format))
+		{
+			FrameBuffer = Renderer->RHICreateFrameBuffer(nullptr, 0, kView);
+		}
+		else
+		{
+			FrameBuffer = Renderer->RHICreateFrameBuffer(&kView, 1, FRHIRenderTargetView());
+		}
+	}
+	return FrameBuffer;
+}
+
+uint64_t FPooledRenderTarget::GetBytes() const
+{
+	return (uint64_t)Desc.SizeX * Desc.SizeY * GetPixelFormatBytes(Desc.Format) * Desc.Samples;
+}
+
+// FRenderTargetPool
+FRenderTargetPool::FRenderTargetPool(FRenderer *InRenderer)
+	: Renderer(InRenderer)
+	, FrameCounter(1)
+	, AllocatedBytes(0)
+	, PeakAllocatedBytes(0)
+	, AllocationsNum(0)
+	, ReusesNum(0)
+	, AliasesNum(0)
+	, ReleasesNum(0)
+{
+	assert(Renderer);
+}
+
+FRenderTargetPool::~FRenderTargetPool()
+{
+	// the targets still held by the passes outlive the pool.
+	Elements.clear();
+}
+
+FPooledRenderTargetRef FRenderTargetPool::FindFreeElement(const FPooledRenderTargetDesc &InDesc, const char *InDebugName)
+{
+	for (size_t Index = 0; Index < Elements.size(); Index++)
+	{
+		FPooledRenderTarget *Element = Elements[Index].DeRef();
+		if (Element->Desc == InDesc && Element->IsFree())
+		{
+			ReusesNum++;
+			if (Element->LastUsedFrame == FrameCounter)
+			{
+				AliasesNum++;
+			}
+			Element->LastUsedFrame = FrameCounter;
+			Element->DebugName = InDebugName ? InDebugName : "";
+			return Element;
+		}
+	} // end for Index
+
+	FPooledRenderTargetRef Element = new FPooledRenderTarget(Renderer, InDesc);
+	if (InDesc.Samples > 1)
+	{
+		Element->RenderBuffer = Renderer->RHICreateRenderBuffer(InDesc.SizeX, InDesc.SizeY, InDesc.Format, InDesc.Samples);
+	}
+	else
+	{
+		Element->Texture = Renderer->RHICreateTexture2D(InDesc.SizeX, InDesc.SizeY, 1, InDesc.Format);
+	}
+	if (!Element->Texture.IsValidRef() && !Element->RenderBuffer.IsValidRef())
+	{
+		return FPooledRenderTargetRef();
+	}
+
+	Element->LastUsedFrame = FrameCounter;
+	Element->DebugName = InDebugName ? InDebugName : "";
+	Elements.push_back(Element);
+
+	AllocationsNum++;
+	AllocatedBytes += Element->GetBytes();
+	PeakAllocatedBytes = (std::max)(PeakAllocatedBytes, AllocatedBytes);
+	return Element;
+}
+
+void FRenderTargetPool::TickPoolElements(uint32_t InUnusedFrames)
+{
+	for (size_t Index = Elements.size(); Index > 0; Index--)
+	{
+		FPooledRenderTarget *Element = Elements[Index - 1].DeRef();
+		if (Element->IsFree() && FrameCounter - Element->LastUsedFrame >= InUnusedFrames)
+		{
+			ReleaseElement(Index - 1);
+		}
+	} // end for Index
+
+	FrameCounter++;
+}
+
+void FRenderTargetPool::FreeUnusedResources()
+{
+	for (size_t Index = Elements.size(); Index > 0; Index--)
+	{
+		if (Elements[Index - 1]->IsFree())
+		{
+			ReleaseElement(Index - 1);
+		}
+	} // end for Index
+}
+
+void FRenderTargetPool::ReleaseElement(size_t InIndex)
+{
+	AllocatedBytes -= Elements[InIndex]->GetBytes();
+	ReleasesNum++;
+
+	// the order does not matter
+	Elements[InIndex] = Elements.back();
+	Elements.pop_back();
+}
+
+void FRenderTargetPool::DumpStats(FOutputDevice &OutDevice)
+{
+	OutDevice.Log(Log_Info, "Render Target Pool: %u targets, %llu KB allocated, peak %llu KB", (uint32_t)Elements.size(),
+		(unsigned long long)(AllocatedBytes / 1024), (unsigned long long)(PeakAllocatedBytes / 1024));
+	OutDevice.Log(Log_Info, "    Allocations: %u, Reuses: %u (Aliased in a frame: %u), Releases: %u", AllocationsNum, ReusesNum, AliasesNum, ReleasesNum);
+	for (size_t Index = 0; Index < Elements.size(); Index++)
+	{
+		FPooledRenderTarget *Element = Elements[Index].DeRef();
+		const FPooledRenderTargetDesc &Desc = Element->Desc;
+		OutDevice.Log(Log_Info, "    %ux%u format %d x%u %s, last used by %s %u frames ago", Desc.SizeX, Desc.SizeY, (int32_t)Desc.Format, Desc.Samples,
+			Element->IsFree() ? "free" : "in use", Element->DebugName, FrameCounter - Element->LastUsedFrame);
+	} // end for Index
+}
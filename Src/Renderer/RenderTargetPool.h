@@ -0,0 +1,122 @@
+// \brief
+//		Render target pool: the targets of the passes are recycled across the frames.
+//
+
+#ifndef __JETX_RENDER_TARGET_POOL_H__
+#define __JETX_RENDER_TARGET_POOL_H__
+
+#include <vector>
+#include "Foundation/JetX.h"
+#include "Foundation/RefCounting.h"
+#include "Foundation/OutputDevice.h"
+#include "Renderer.h"
+
+
+// the key of the pooled targets
+struct FPooledRenderTargetDesc
+{
+	FPooledRenderTargetDesc()
+		: SizeX(0)
+		, SizeY(0)
+		, Format(PF_Unknown)
+		, Samples(1)
+	{}
+
+	FPooledRenderTargetDesc(uint32_t InSizeX, uint32_t InSizeY, EPixelFormat InFormat, uint32_t InSamples = 1)
+		: SizeX(InSizeX)
+		, SizeY(InSizeY)
+		, Format(InFormat)
+		, Samples(InSamples)
+	{}
+
+	bool operator ==(const FPooledRenderTargetDesc &rhs) const
+	{
+		return SizeX == rhs.SizeX && SizeY == rhs.SizeY && Format == rhs.Format && Samples == rhs.Samples;
+	}
+
+	uint32_t		SizeX;
+	uint32_t		SizeY;
+	EPixelFormat	Format;
+	uint32_t		Samples;
+};
+
+// a target of the pool, it is free when the pool holds the only reference.
+class FPooledRenderTarget : public FRefCountedObject
+{
+public:
+	const FPooledRenderTargetDesc& GetDesc() const { return Desc; }
+	// the 2d texture of a single sampled target, the next passes sample it.
+	const FRHITexture2DRef& GetTexture() const { return Texture; }
+	// the render buffer of a multisampled target, resolved into a single sampled one.
+	const FRHIRenderBufferRef& GetRenderBuffer() const { return RenderBuffer; }
+	FRHIRenderTargetView GetView() const;
+	// a frame buffer with this target alone, as the color or the depth-stencil target.
+	const FRHIFrameBufferRef& GetFrameBuffer();
+
+	uint64_t GetBytes() const;
+	// the pass it was handed to the last time
+	const char* GetDebugName() const { return DebugName; }
+
+protected:
+	friend class FRenderTargetPool;
+
+	FPooledRenderTarget(FRenderer *InRenderer, const FPooledRenderTargetDesc &InDesc)
+		: Renderer(InRenderer)
+		, Desc(InDesc)
+		, LastUsedFrame(0)
+		, DebugName("")
+	{}
+
+	bool IsFree() { return RetainCount() == 1; }
+
+	FRenderer					*Renderer;
+	FPooledRenderTargetDesc		Desc;
+	FRHITexture2DRef			Texture;
+	FRHIRenderBufferRef			RenderBuffer;
+	FRHIFrameBufferRef			FrameBuffer;
+	uint32_t					LastUsedFrame;
+	const char					*DebugName;
+};
+
+typedef TRefCountPtr<FPooledRenderTarget> FPooledRenderTargetRef;
+
+// FRenderTargetPool
+// a pass holds its target from FindFreeElement to the last pass reading it. once released, the next
+// request of the same desc in the frame gets it again, so the targets of the passes whose lifetimes
+// do not overlap share the memory, and the next frames find the targets of this one.
+class FRenderTargetPool
+{
+public:
+	FRenderTargetPool(FRenderer *InRenderer);
+	~FRenderTargetPool();
+
+	// return a null ref if the target can't be created.
+	FPooledRenderTargetRef FindFreeElement(const FPooledRenderTargetDesc &InDesc, const char *InDebugName);
+
+	// once per frame, release the free targets which were not used for InUnusedFrames frames.
+	void TickPoolElements(uint32_t InUnusedFrames = 3);
+	// release all the free targets.
+	void FreeUnusedResources();
+
+	uint32_t GetElementsNum() const { return (uint32_t)Elements.size(); }
+	uint64_t GetAllocatedBytes() const { return AllocatedBytes; }
+
+	void DumpStats(FOutputDevice &OutDevice);
+
+protected:
+	void ReleaseElement(size_t InIndex);
+
+	FRenderer		*Renderer;
+	std::vector<FPooledRenderTargetRef>	Elements;
+	uint32_t		FrameCounter;
+
+	// stats
+	uint64_t		AllocatedBytes;
+	uint64_t		PeakAllocatedBytes;
+	uint32_t		AllocationsNum;
+	uint32_t		ReusesNum;		// found in the pool
+	uint32_t		AliasesNum;		// found in the pool after another pass used it in the same frame
+	uint32_t		ReleasesNum;
+};
+
+#endif // __JETX_RENDER_TARGET_POOL_H__
@@ -2,8 +2,11 @@
 //		Base FRenderer
 //
 
+#include <chrono>
 #include "Renderer.h"
 #include "Renderer/OpenGL/OpenGLRenderer.h"
+#include "Renderer/Null/NullRenderer.h"
+#include "Renderer/Software/SoftwareRenderer.h"
 
 
 FRenderer* FRenderer::CreateRender(ERendererType InRenderType)
@@ -13,9 +16,191 @@ FRenderer* FRenderer::CreateRender(ERendererType InRenderType)
 	case RT_OpenGL:
 		return new FOpenGLRenderer();
 		break;
+	case RT_Null:
+		return new FNullRenderer();
+		break;
+	case RT_Software:
+		return new FSoftwareRenderer();
+		break;
 	default:
 		break;
 	}
 
 	return nullptr;
 }
+
+FRHIGraphicsPipelineStateRef FRenderer::RHICreateGraphicsPipelineState(const FGraphicsPipelineStateInitializerRHI &PipelineStateInitializer)
+{
+	return new FRHIGraphicsPipelineState(PipelineStateInitializer);
+}
+
+void FRenderer::RHISetGraphicsPipelineState(const FRHIGraphicsPipelineStateRef &InPipelineState, int32_t InStencilRef, const FLinearColor &InBlendColor)
+{
+	if (!InPipelineState.IsValidRef())
+	{
+		return;
+	}
+
+	const FGraphicsPipelineStateInitializerRHI &Initializer = InPipelineState->GetInitializer();
+	RHISetRasterizerState(Initializer.RasterizerState);
+	RHISetDepthStencilState(Initializer.DepthStencilState, InStencilRef);
+	RHISetBlendState(Initializer.BlendState, InBlendColor);
+	SetVertexInputLayout(Initializer.VertexDecl);
+	SetGPUProgram(Initializer.GPUProgram);
+}
+
+static const char* CheckRenderTargetView(const FRHIRenderTargetView &InView)
+{
+	if (InView.Texture.IsValidRef() && InView.RenderBuffer.IsValidRef())
+	{
+		return "a target is both a texture and a render buffer";
+	}
+	if (InView.Texture.IsValidRef() && (InView.MipIndex >= InView.Texture->GetNumMips() || InView.LayerIndex >= InView.Texture->GetSizeZ()))
+	{
+		return "the mip or the layer of a target is out of the texture";
+	}
+	return nullptr;
+}
+
+const char* FRenderer::CheckFrameBufferTargets(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget)
+{
+	if (InColorTargetsNum > MaxSimultaneousRenderTargets || (InColorTargetsNum > 0 && !InColorTargets))
+	{
+		return "too many color targets";
+	}
+	if (InColorTargetsNum == 0 && !InDepthStencilTarget.IsValid())
+	{
+		return "no target";
+	}
+
+	const FRHIRenderTargetView &First = InColorTargetsNum > 0 ? InColorTargets[0] : InDepthStencilTarget;
+	for (uint32_t k = 0; k <= InColorTargetsNum; k++)
+	{
+		const bool bDepthStencil = k == InColorTargetsNum;
+		const FRHIRenderTargetView &View = bDepthStencil ? InDepthStencilTarget : InColorTargets[k];
+		if (bDepthStencil && !View.IsValid())
+		{
+			break;
+		}
+
+		if (!View.IsValid())
+		{
+			return "a color target is empty";
+		}
+		const char *ViewError = CheckRenderTargetView(View);
+		if (ViewError)
+		{
+			return ViewError;
+		}
+		if (IsDepthPixelFormat(View.GetFormat()) != bDepthStencil)
+		{
+			return bDepthStencil ? "the depth-stencil target has a color format" : "a color target has a depth format";
+		}
+		if (View.GetSizeX() != First.GetSizeX() || View.GetSizeY() != First.GetSizeY() || View.GetSamples() != First.GetSamples())
+		{
+			return "the targets have different sizes or samples";
+		}
+	} // end for k
+
+	return nullptr;
+}
+
+const char* FRenderer::CheckIndirectArgs(FRHIIndirectBuffer *InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t &InOutStride)
+{
+	if (!InArgsBuffer)
+	{
+		return "no arguments buffer";
+	}
+
+	InOutStride = InOutStride ? InOutStride : (uint32_t)sizeof(FDrawIndexedIndirectArgs);
+	if ((InOffset & 3) != 0 || (InOutStride & 3) != 0 || InOutStride < sizeof(FDrawIndexedIndirectArgs))
+	{
+		return "the offset and the stride must be multiples of 4, the stride at least the size of the arguments";
+	}
+	if (InDrawsNum > 0 && (uint64_t)InOffset + (uint64_t)(InDrawsNum - 1) * InOutStride + sizeof(FDrawIndexedIndirectArgs) > InArgsBuffer->GetBytes())
+	{
+		return "the arguments are out of the buffer";
+	}
+
+	return nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// GPU Profiling
+
+void FGPUFrameTimings::Dump(FOutputDevice &OutDevice) const
+{
+	OutDevice.Log(Log_Info, "GPU frame %u:", Frame);
+	for (size_t k = 0; k < Scopes.size(); k++)
+	{
+		const FGPUTimerScope &Scope = Scopes[k];
+		OutDevice.Log(Log_Info, "%*s%s: %.3f ms", (int)(Scope.Depth * 2 + 2), "", Scope.Name.c_str(), Scope.Milliseconds);
+	} // end for k
+}
+
+static double GetTimerMilliseconds()
+{
+	typedef std::chrono::steady_clock FClock;
+	return std::chrono::duration<double, std::milli>(FClock::now().time_since_epoch()).count();
+}
+
+FCPUTimerScopes::FCPUTimerScopes()
+	: bLatestValid(false)
+	, FrameCounter(0)
+{}
+
+void FCPUTimerScopes::BeginScope(const char *InName)
+{
+	FGPUTimerScope Scope;
+	Scope.Name = InName ? InName : "";
+	Scope.Depth = (uint32_t)OpenScopes.size();
+	Scope.Milliseconds = GetTimerMilliseconds();
+
+	OpenScopes.push_back((uint32_t)Recording.Scopes.size());
+	Recording.Scopes.push_back(Scope);
+}
+
+bool FCPUTimerScopes::EndScope()
+{
+	if (OpenScopes.empty())
+	{
+		return false;
+	}
+
+	FGPUTimerScope &Scope = Recording.Scopes[OpenScopes.back()];
+	Scope.Milliseconds = GetTimerMilliseconds() - Scope.Milliseconds;
+	OpenScopes.pop_back();
+	return true;
+}
+
+uint32_t FCPUTimerScopes::EndFrame()
+{
+	const uint32_t kOpenScopes = (uint32_t)OpenScopes.size();
+	while (EndScope())
+	{
+	}
+
+	if (!Recording.Scopes.empty())
+	{
+		Recording.Frame = FrameCounter;
+		Latest.Frame = Recording.Frame;
+		Latest.Scopes.swap(Recording.Scopes);
+		Recording.Scopes.clear();
+		bLatestValid = true;
+	}
+	FrameCounter++;
+
+	return kOpenScopes;
+}
+
+bool FCPUTimerScopes::GetFrameTimings(FGPUFrameTimings &OutTimings)
+{
+	if (!bLatestValid)
+	{
+		return false;
+	}
+
+	OutTimings = Latest;
+	bLatestValid = false;
+	return true;
+}
@@ -12,14 +12,45 @@
 #include "RendererState.h"
 #include "RHIResource.h"
 
+#include <string>
+#include <vector>
+
 
 enum ERendererType
 {
 	RT_None,
 	RT_OpenGL,
+	RT_Null,		// headless, validates and counts the calls
+	RT_Software,	// headless, rasterize on the CPU
 	RT_Max
 };
 
+// a timed scope of a frame, the scopes are in the order they began.
+struct FGPUTimerScope
+{
+	FGPUTimerScope()
+		: Depth(0)
+		, Milliseconds(0.0)
+	{}
+
+	std::string		Name;
+	uint32_t		Depth;			// 0 for a scope out of the others
+	double			Milliseconds;
+};
+
+// the timer scopes of a frame
+struct FGPUFrameTimings
+{
+	FGPUFrameTimings()
+		: Frame(0)
+	{}
+
+	void Dump(FOutputDevice &OutDevice) const;
+
+	uint32_t					Frame;		// the frames ended before it
+	std::vector<FGPUTimerScope>	Scopes;
+};
+
 // FRenderer
 class FRenderer
 {
@@ -36,6 +67,13 @@ public:
 	//Capabilities
 	virtual void DumpCapabilities() = 0;
 
+	//Options, ignored by the backends without them
+	// the linked programs are saved to InDirectory & loaded from it by the next runs, nullptr turns the
+	// cache off. set before the programs are created.
+	virtual void SetProgramCacheDirectory(const char *InDirectory) {}
+	// merge the consecutive draws sharing their states into fewer API calls, off by default.
+	virtual void SetDrawMergingEnabled(bool bEnabled) {}
+
 //render viewport
 	virtual FRHIViewportRef RHICreateViewport(void* InWindowHandle, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen) = 0;
 	virtual void RHIResizeViewport(FRHIViewportRef InViewport, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen) = 0;
@@ -49,41 +87,94 @@ public:
 	virtual FRHIRasterizerStateRef RHICreateRasterizerState(const FRasterizerStateInitializerRHI &RasterizerStateInitializer) = 0;
 	virtual FRHIDepthStencilStateRef RHICreateDepthStencilState(const FDepthStencilStateInitializerRHI &DepthStencilStateInitializer) = 0;
 	virtual FRHIBlendStateRef RHICreateBlendState(const FBlendStateInitializerRHI &BlendStateInitializer) = 0;
+	// the default pipeline state only keeps the parts, setting it sets each of them.
+	virtual FRHIGraphicsPipelineStateRef RHICreateGraphicsPipelineState(const FGraphicsPipelineStateInitializerRHI &PipelineStateInitializer);
 
 	// data buffers
 	virtual FRHIVertexBufferRef RHICreateVertexBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess, EBufferUsage InUsage) = 0;
 	virtual FRHIIndexBufferRef RHICreateIndexBuffer(uint32_t InBytes, const void *InData, uint16_t InStride, EBufferAccess InAccess, EBufferUsage InUsage) = 0;
+	// the arguments of the indirect draws, written like the other data buffers (by the culling jobs e.g.).
+	virtual FRHIIndirectBufferRef RHICreateIndirectBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess) = 0;
 	
 	virtual void FillDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, const void *InData) = 0;
 	virtual void* LockDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, EBufferLockMode InMode) = 0;
 	virtual void UnLockDataBuffer(FRHIDataBufferRef InBuffer) = 0;
+	// a buffer locked with BL_FlushExplicit, InOffset is relative to the start of the locked range.
+	virtual void FlushDataBufferRange(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes) = 0;
+
+	// uniform buffers
+	// BA_Static keeps a buffer of its own. BA_Dynamic & BA_Stream are suballocated from a per-frame
+	// ring at every update, their contents are valid until the end of the frame they were written in.
+	virtual FRHIUniformBufferRef RHICreateUniformBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess) = 0;
+	// InData has the size of the buffer.
+	virtual void RHIUpdateUniformBuffer(const FRHIUniformBufferRef &InBuffer, const void *InData) = 0;
+
+	// transient geometry
+	// memory for InBytes of vertices, written before the draws reading them and valid until the end of the frame.
+	// OutFirstVertex is the index of the first one in OutBuffer: the InStart of an arrayed draw, or the base the
+	// indices are offset with. OutBuffer must not be filled or locked. return nullptr if it can't be allocated.
+	virtual void* RHIAllocTransientVertices(uint32_t InBytes, uint32_t InStride, FRHIVertexBufferRef &OutBuffer, uint32_t &OutFirstVertex) = 0;
+	// InStride must be 2 or 4, OutFirstIndex is the InStart of the indexed draws.
+	virtual void* RHIAllocTransientIndices(uint32_t InCount, uint16_t InStride, FRHIIndexBufferRef &OutBuffer, uint32_t &OutFirstIndex) = 0;
 
 	// vertex input layout
 	virtual FRHIVertexDeclarationRef RHICreateVertexInputLayout(const FVertexElement *InVertexElements, uint32_t InCount) = 0;
 
 	// textures
-	//virtual FRHITexture2DRef RHICreateTexture2D() = 0;
+	// immutable storage of InMips levels, 0 for the full chain. the contents are undefined until updated.
+	virtual FRHITexture2DRef RHICreateTexture2D(uint32_t InSizeX, uint32_t InSizeY, uint32_t InMips, EPixelFormat InFormat) = 0;
+	virtual FRHITexture2DArrayRef RHICreateTexture2DArray(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat) = 0;
+	virtual FRHITextureCubeRef RHICreateTextureCube(uint32_t InSize, uint32_t InMips, EPixelFormat InFormat) = 0;
+	// write a region of mip InMip, InLayer is the layer of an array or the ECubeFace of a cube.
+	// InData is InWidth * InHeight tightly packed pixels of the texture format, it is copied before the return.
+	virtual void RHIUpdateTexture(const FRHITextureRef &InTexture, uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData) = 0;
+	// build the mips below mip 0 from it.
+	virtual void RHIGenerateMips(const FRHITextureRef &InTexture) = 0;
+
+	// render targets
+	// a target which is never sampled, InSamples is 1 if not multisampled.
+	virtual FRHIRenderBufferRef RHICreateRenderBuffer(uint32_t InSizeX, uint32_t InSizeY, EPixelFormat InFormat, uint32_t InSamples) = 0;
+	// the targets are the same size, InDepthStencilTarget may be an empty view.
+	virtual FRHIFrameBufferRef RHICreateFrameBuffer(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget) = 0;
+
+	// queries
+	virtual FRHIOcclusionQueryRef RHICreateOcclusionQuery() = 0;
 
 	// shader
 	virtual FRHIVertexShaderRef RHICreateVertexShader(const char *InSource, int32_t InLength = -1) = 0;
 	virtual FRHIPixelShaderRef RHICreatePixelShader(const char *InSource, int32_t InLength = -1) = 0;
 	virtual FRHIGPUProgramRef RHICreateGPUProgram(const FRHIVertexShaderRef &InVShader, const FRHIPixelShaderRef &InPShader) = 0;
 	virtual FRHIGPUProgramRef RHICreateGPUProgram(const std::vector<FRHIShaderRef> &InShaders) = 0;
+	// return at once, the program compiles & links in the background until it is ready (see FRHIGPUProgram::IsReady).
+	// the draws with it are drawn with InFallback meanwhile, or skipped if there is none ready.
+	virtual FRHIGPUProgramRef RHICreateGPUProgramAsync(const std::vector<FRHIShaderRef> &InShaders, const FRHIGPUProgramRef &InFallback = FRHIGPUProgramRef())
+	{
+		return RHICreateGPUProgram(InShaders);
+	}
 
 //State Setting
 	virtual void RHISetSamplerState(uint32_t InTexIndex, const FRHISamplerStateRef &InSamplerState) = 0;
+	// the texture sampled from unit InTexIndex, the sampler uniform of the program holds the unit.
+	virtual void RHISetTexture(uint32_t InTexIndex, const FRHITextureRef &InTexture) = 0;
 	virtual void RHISetRasterizerState(const FRHIRasterizerStateRef &InRasterizerState) = 0;
 	virtual void RHISetDepthStencilState(const FRHIDepthStencilStateRef &InDepthStencilState, int32_t InStencilRef) = 0;
 	virtual void RHISetBlendState(const FRHIBlendStateRef &InBlendState, const FLinearColor &InBlendColor) = 0;
+	// rasterizer, depth-stencil, blend states, gpu program & vertex input layout at once.
+	virtual void RHISetGraphicsPipelineState(const FRHIGraphicsPipelineStateRef &InPipelineState, int32_t InStencilRef, const FLinearColor &InBlendColor);
 
+	// draw into InFrameBuffer, null for the viewport drawing. the viewport box is kept.
+	virtual void RHISetFrameBuffer(const FRHIFrameBufferRef &InFrameBuffer) = 0;
 	virtual void RHISetViewport(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight, float InMinZ, float InMaxZ) = 0;
 	virtual void RHISetScissorRect(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight) = 0;
 
 	virtual void SetVertexStreamSource(uint32_t InStreamIndex, const FRHIVertexBufferRef &InVertexBuffer) = 0;
 	virtual void SetVertexInputLayout(const FRHIVertexDeclarationRef &InVertexDecl) = 0;
 	virtual void SetGPUProgram(const FRHIGPUProgramRef &InProgram) = 0;
+	// see FRHIGPUProgram::SetUniformBufferBinding
+	virtual void RHISetUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer) = 0;
 
 //Draw Commands
+	// the draws go to the viewport until a frame buffer is set.
 	virtual void RHIBeginDrawingViewport(FRHIViewportRef Viewport) = 0;
 	virtual void RHIEndDrawingViewport(FRHIViewportRef Viewport, bool bPresent, bool bLockToVsync) = 0;
 	virtual void RHIBeginFrame() = 0;
@@ -93,13 +184,90 @@ public:
 	// clear multi-render-targets
 	virtual void RHIClearMRT(bool bClearColor, const FLinearColor *InColors, uint32_t InColorsNum, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil) = 0;
 
+	// copy the color target 0 of InSource into the one of InDest, the samples are resolved. the
+	// depth-stencil targets are copied too if both have one. the sizes and the formats are the same.
+	virtual void RHIResolveFrameBuffer(const FRHIFrameBufferRef &InSource, const FRHIFrameBufferRef &InDest) = 0;
+
 	// draw primitives
 	// InCount: indices number
 	virtual void DrawIndexedPrimitive(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount) = 0;
 	virtual void DrawIndexedPrimitiveInstanced(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances) = 0;
 	virtual void DrawArrayedPrimitive(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount) = 0;
 	virtual void DrawArrayedPrimitiveInstanced(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances) = 0;
+	// a draw of the FDrawIndexedIndirectArgs at InOffset of InArgsBuffer.
+	virtual void DrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset) = 0;
+	// InDrawsNum draws with the same states, the arguments are InStride bytes apart (0: tightly packed).
+	virtual void MultiDrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t InStride) = 0;
+
+//GPU Profiling
+	// a named scope of the GPU time, the scopes nest and end in the frame they began. InName is copied.
+	virtual void RHIBeginTimerQuery(const char *InName) = 0;
+	virtual void RHIEndTimerQuery() = 0;
+	// the scopes of the latest frame whose times are known, the frames are read some frames after they
+	// ended and never waited for. return false if no frame was read since the last call.
+	virtual bool RHIGetGPUFrameTimings(FGPUFrameTimings &OutTimings) = 0;
+
+//Occlusion Queries
+	// count the samples of the draws between the begin & the end which pass the depth & stencil tests,
+	// one query is active at a time. beginning a query again drops its result if it was not read.
+	virtual void RHIBeginOcclusionQuery(const FRHIOcclusionQueryRef &InQuery) = 0;
+	virtual void RHIEndOcclusionQuery(const FRHIOcclusionQueryRef &InQuery) = 0;
+	// the result of the last end of InQuery, return false if it is not known yet (or the query was never
+	// ended). bWait stalls until it is.
+	virtual bool RHIGetOcclusionQueryResult(const FRHIOcclusionQueryRef &InQuery, uint64_t &OutSamples, bool bWait) = 0;
+	// the draws until the end are discarded if the ended InQuery counted no sample. if bWait is false the
+	// result is not waited for: the draws are made when it is not known by the time they run.
+	virtual void RHIBeginConditionalRender(const FRHIOcclusionQueryRef &InQuery, bool bWait) = 0;
+	virtual void RHIEndConditionalRender() = 0;
+
+protected:
+	// return the first reason the targets can't make a frame buffer, nullptr if they can.
+	static const char* CheckFrameBufferTargets(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget);
+	// return the first reason the arguments of the indirect draws can't be read, nullptr if they can.
+	// InOutStride: 0 is replaced by the size of the arguments.
+	static const char* CheckIndirectArgs(FRHIIndirectBuffer *InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t &InOutStride);
+};
+
+// a timer query for the lifetime of the object
+class FRHITimerScope
+{
+public:
+	FRHITimerScope(FRenderer *InRenderer, const char *InName)
+		: Renderer(InRenderer)
+	{
+		Renderer->RHIBeginTimerQuery(InName);
+	}
+	~FRHITimerScope()
+	{
+		Renderer->RHIEndTimerQuery();
+	}
+
+private:
+	FRenderer	*Renderer;
 };
 
+// FCPUTimerScopes
+// the timer scopes of the backends drawing on the CPU, the times are taken at the calls and
+// a frame is read when it ends.
+class FCPUTimerScopes
+{
+public:
+	FCPUTimerScopes();
+
+	void BeginScope(const char *InName);
+	// return false if no scope is open.
+	bool EndScope();
+	// return the scopes left open, they are ended.
+	uint32_t EndFrame();
+	bool GetFrameTimings(FGPUFrameTimings &OutTimings);
+
+private:
+	FGPUFrameTimings		Recording;
+	// the open scopes of Recording, their Milliseconds hold the begin time until they end.
+	std::vector<uint32_t>	OpenScopes;
+	FGPUFrameTimings		Latest;
+	bool					bLatestValid;
+	uint32_t				FrameCounter;
+};
 
 #endif //__JETX_RENDERER_H__
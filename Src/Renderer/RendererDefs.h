@@ -162,6 +162,80 @@ enum ECubeFace
 	CubeFace_MAX
 };
 
+// pixel format of the textures
+enum EPixelFormat
+{
+	PF_Unknown = 0,
+	PF_R8,
+	PF_RG8,
+	PF_RGBA8,
+	PF_SRGB8_A8,
+	PF_R16F,
+	PF_RG16F,
+	PF_RGBA16F,
+	PF_R32F,
+	PF_RG32F,
+	PF_RGBA32F,
+	PF_R11G11B10F,
+	PF_Depth24,
+	PF_Depth24Stencil8,
+	PF_Depth32F,
+
+	PF_Max
+};
+
+// bytes of a pixel, the texture updates are tightly packed.
+inline uint32_t GetPixelFormatBytes(EPixelFormat InFormat)
+{
+	switch (InFormat)
+	{
+	case PF_R8:
+		return 1;
+	case PF_RG8:
+	case PF_R16F:
+		return 2;
+	case PF_RGBA8:
+	case PF_SRGB8_A8:
+	case PF_RG16F:
+	case PF_R32F:
+	case PF_R11G11B10F:
+	case PF_Depth24:
+	case PF_Depth24Stencil8:
+	case PF_Depth32F:
+		return 4;
+	case PF_RGBA16F:
+	case PF_RG32F:
+		return 8;
+	case PF_RGBA32F:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+inline bool IsDepthPixelFormat(EPixelFormat InFormat)
+{
+	return InFormat == PF_Depth24 || InFormat == PF_Depth24Stencil8 || InFormat == PF_Depth32F;
+}
+
+// mips of the full chain down to 1x1
+inline uint32_t GetFullMipsNum(uint32_t InSizeX, uint32_t InSizeY)
+{
+	uint32_t Mips = 1;
+	for (uint32_t Size = InSizeX > InSizeY ? InSizeX : InSizeY; Size > 1; Size >>= 1)
+	{
+		Mips++;
+	}
+	return Mips;
+}
+
+// size of InSize at mip InMip
+inline uint32_t GetMipSize(uint32_t InSize, uint32_t InMip)
+{
+	const uint32_t kSize = InSize >> InMip;
+	return kSize > 0 ? kSize : 1;
+}
+
 enum EClearType
 {
 	CT_None = 0x0,
@@ -194,7 +268,13 @@ enum EBufferLockMode
 {
 	BL_ReadOnly,
 	BL_WriteOnly,
-	BL_ReadWrite
+	BL_ReadWrite,
+	BL_WriteDiscard,		// the previous contents of the whole buffer are dropped, the draws in flight keep them.
+	BL_WriteNoOverwrite,	// the range is not read by the draws in flight, no wait for the GPU (e.g. appending).
+
+	BL_ModeMask = 0x0f,
+	// or'ed with a write mode: only the ranges passed to FlushDataBufferRange are written back.
+	BL_FlushExplicit = 0x10
 };
 
 // primitive type
@@ -211,6 +291,16 @@ enum EPrimitiveType
 	PT_Max
 };
 
+// the arguments of an indexed indirect draw, the same layout as DrawElementsIndirectCommand of OpenGL.
+struct FDrawIndexedIndirectArgs
+{
+	uint32_t	IndexCount;
+	uint32_t	InstanceCount;
+	uint32_t	FirstIndex;
+	int32_t		BaseVertex;
+	uint32_t	BaseInstance;
+};
+
 // linear color rgba
 struct FLinearColor
 {
@@ -309,5 +399,8 @@ enum { MaxVertexStreamSources = 16 };
 /** The number of vertex attributes */
 enum { MaxVertexAttributes = 16 };
 
+/** The number of uniform buffer binding slots */
+enum { MaxUniformBufferBindings = 16 };
+
 
 #endif // __JETX_RENDERER_DEFS_H__
@@ -6,6 +6,7 @@
 #define __JETX_RENDERER_STATES_H__
 
 #include "Foundation/JetX.h"
+#include "Foundation/Hash.h"
 #include "RendererDefs.h"
 
 
@@ -37,14 +38,35 @@ struct FSamplerStateInitializerRHI
 		BorderColor[3] = InBorderA;
 	}
 
-	bool operator <(const FSamplerStateInitializerRHI &rhs) const
+	bool operator ==(const FSamplerStateInitializerRHI &rhs) const
 	{
-		return (Filter < rhs.Filter)
-			|| (AddressS < rhs.AddressS)
-			|| (AddressT < rhs.AddressT)
-			|| (AddressR < rhs.AddressR)
-			|| (MinMipLevel < rhs.MinMipLevel)
-			|| (MaxMipLevel < rhs.MaxMipLevel);
+		return Filter == rhs.Filter
+			&& AddressS == rhs.AddressS
+			&& AddressT == rhs.AddressT
+			&& AddressR == rhs.AddressR
+			&& MinMipLevel == rhs.MinMipLevel
+			&& MaxMipLevel == rhs.MaxMipLevel
+			&& MipBias == rhs.MipBias
+			&& BorderColor[0] == rhs.BorderColor[0]
+			&& BorderColor[1] == rhs.BorderColor[1]
+			&& BorderColor[2] == rhs.BorderColor[2]
+			&& BorderColor[3] == rhs.BorderColor[3];
+	}
+
+	friend uint32_t GetTypeHash(const FSamplerStateInitializerRHI &InInitializer)
+	{
+		uint32_t Hash = GetTypeHash((uint32_t)InInitializer.Filter);
+		Hash = HashCombine(Hash, GetTypeHash((uint32_t)InInitializer.AddressS));
+		Hash = HashCombine(Hash, GetTypeHash((uint32_t)InInitializer.AddressT));
+		Hash = HashCombine(Hash, GetTypeHash((uint32_t)InInitializer.AddressR));
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.MinMipLevel));
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.MaxMipLevel));
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.MipBias));
+		for (uint32_t k = 0; k < 4; k++)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(InInitializer.BorderColor[k]));
+		}
+		return Hash;
 	}
 
 	ESamplerFilter		Filter;
@@ -79,12 +101,25 @@ struct FRasterizerStateInitializerRHI
 	{
 	}
 
-	bool operator <(const FRasterizerStateInitializerRHI &rhs) const
+	bool operator ==(const FRasterizerStateInitializerRHI &rhs) const
 	{
-		return (FillMode < rhs.FillMode)
-			|| (CullMode < rhs.CullMode)
-			|| (DepthOffsetUnits < rhs.DepthOffsetUnits)
-			|| (DepthOffsetFactor < rhs.DepthOffsetFactor);
+		return FillMode == rhs.FillMode
+			&& CullMode == rhs.CullMode
+			&& DepthOffsetFactor == rhs.DepthOffsetFactor
+			&& DepthOffsetUnits == rhs.DepthOffsetUnits
+			&& bAllowMSAA == rhs.bAllowMSAA
+			&& bEnableLineAA == rhs.bEnableLineAA;
+	}
+
+	friend uint32_t GetTypeHash(const FRasterizerStateInitializerRHI &InInitializer)
+	{
+		uint32_t Hash = GetTypeHash((uint32_t)InInitializer.FillMode);
+		Hash = HashCombine(Hash, GetTypeHash((uint32_t)InInitializer.CullMode));
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.DepthOffsetFactor));
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.DepthOffsetUnits));
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.bAllowMSAA));
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.bEnableLineAA));
+		return Hash;
 	}
 
 	ERasterizerFillMode		FillMode;
@@ -129,11 +164,39 @@ struct FDepthStencilStateInitializerRHI
 		, StencilWriteMask(InStencilWriteMask)
 	{}
 
-	bool operator <(const FDepthStencilStateInitializerRHI &rhs) const
+	bool operator ==(const FDepthStencilStateInitializerRHI &rhs) const
+	{
+		return bEnableDepthWrite == rhs.bEnableDepthWrite
+			&& DepthTestFunc == rhs.DepthTestFunc
+			&& bEnableStencilTest == rhs.bEnableStencilTest
+			&& FrontFaceStencilTest == rhs.FrontFaceStencilTest
+			&& FrontFaceStencilFailOp == rhs.FrontFaceStencilFailOp
+			&& FrontFaceDepthFailOp == rhs.FrontFaceDepthFailOp
+			&& FrontFaceDepthPassOp == rhs.FrontFaceDepthPassOp
+			&& BackFaceStencilTest == rhs.BackFaceStencilTest
+			&& BackFaceStencilFailOp == rhs.BackFaceStencilFailOp
+			&& BackFaceDepthFailOp == rhs.BackFaceDepthFailOp
+			&& BackFaceDepthPassOp == rhs.BackFaceDepthPassOp
+			&& StencilReadMask == rhs.StencilReadMask
+			&& StencilWriteMask == rhs.StencilWriteMask;
+	}
+
+	friend uint32_t GetTypeHash(const FDepthStencilStateInitializerRHI &InInitializer)
 	{
-		return (DepthTestFunc < rhs.DepthTestFunc)
-			|| (FrontFaceStencilTest < rhs.FrontFaceStencilTest)
-			|| (BackFaceStencilTest < rhs.BackFaceStencilTest);
+		uint32_t Hash = GetTypeHash(InInitializer.bEnableDepthWrite);
+		Hash = HashCombine(Hash, GetTypeHash((uint32_t)InInitializer.DepthTestFunc));
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.bEnableStencilTest));
+		Hash = HashCombine(Hash, GetTypeHash((uint32_t)InInitializer.FrontFaceStencilTest));
+		Hash = HashCombine(Hash, GetTypeHash((uint32_t)InInitializer.FrontFaceStencilFailOp));
+		Hash = HashCombine(Hash, GetTypeHash((uint32_t)InInitializer.FrontFaceDepthFailOp));
+		Hash = HashCombine(Hash, GetTypeHash((uint32_t)InInitializer.FrontFaceDepthPassOp));
+		Hash = HashCombine(Hash, GetTypeHash((uint32_t)InInitializer.BackFaceStencilTest));
+		Hash = HashCombine(Hash, GetTypeHash((uint32_t)InInitializer.BackFaceStencilFailOp));
+		Hash = HashCombine(Hash, GetTypeHash((uint32_t)InInitializer.BackFaceDepthFailOp));
+		Hash = HashCombine(Hash, GetTypeHash((uint32_t)InInitializer.BackFaceDepthPassOp));
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.StencilReadMask));
+		Hash = HashCombine(Hash, GetTypeHash(InInitializer.StencilWriteMask));
+		return Hash;
 	}
 
 	//depth
@@ -177,6 +240,17 @@ struct FBlendStateInitializerRHI
 			, AlphaDstFactor(BF_Zero)
 			, ColorWriteMask(CW_RGBA)
 		{}
+
+		bool operator ==(const FRenderTargetBlendState &rhs) const
+		{
+			return ColorBlendOp == rhs.ColorBlendOp
+				&& ColorSrcFactor == rhs.ColorSrcFactor
+				&& ColorDstFactor == rhs.ColorDstFactor
+				&& AlphaBlendOp == rhs.AlphaBlendOp
+				&& AlphaSrcFactor == rhs.AlphaSrcFactor
+				&& AlphaDstFactor == rhs.AlphaDstFactor
+				&& ColorWriteMask == rhs.ColorWriteMask;
+		}
 	};
 
 	FBlendStateInitializerRHI() {}
@@ -195,15 +269,42 @@ struct FBlendStateInitializerRHI
 		}
 	}
 
-	bool operator <(const FBlendStateInitializerRHI &rhs) const
+	// the targets after TargetsNum are not used
+	bool operator ==(const FBlendStateInitializerRHI &rhs) const
+	{
+		if (TargetsNum != rhs.TargetsNum)
+		{
+			return false;
+		}
+
+		const uint32_t kTargetsNum = (std::min)(TargetsNum, (uint32_t)MaxSimultaneousRenderTargets);
+		for (uint32_t k = 0; k < kTargetsNum; k++)
+		{
+			if (!(RenderTargetBlendStates[k] == rhs.RenderTargetBlendStates[k]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	friend uint32_t GetTypeHash(const FBlendStateInitializerRHI &InInitializer)
 	{
-		return (RenderTargetBlendStates[0].ColorBlendOp < rhs.RenderTargetBlendStates[0].ColorBlendOp)
-			|| (RenderTargetBlendStates[0].ColorSrcFactor < rhs.RenderTargetBlendStates[0].ColorSrcFactor)
-			|| (RenderTargetBlendStates[0].ColorDstFactor < rhs.RenderTargetBlendStates[0].ColorDstFactor)
-			|| (RenderTargetBlendStates[0].AlphaBlendOp < rhs.RenderTargetBlendStates[0].AlphaBlendOp)
-			|| (RenderTargetBlendStates[0].AlphaSrcFactor < rhs.RenderTargetBlendStates[0].AlphaSrcFactor)
-			|| (RenderTargetBlendStates[0].AlphaDstFactor < rhs.RenderTargetBlendStates[0].AlphaDstFactor)
-			|| TargetsNum < rhs.TargetsNum;
+		uint32_t Hash = GetTypeHash(InInitializer.TargetsNum);
+
+		const uint32_t kTargetsNum = (std::min)(InInitializer.TargetsNum, (uint32_t)MaxSimultaneousRenderTargets);
+		for (uint32_t k = 0; k < kTargetsNum; k++)
+		{
+			const FRenderTargetBlendState &Target = InInitializer.RenderTargetBlendStates[k];
+			Hash = HashCombine(Hash, GetTypeHash((uint32_t)Target.ColorBlendOp));
+			Hash = HashCombine(Hash, GetTypeHash((uint32_t)Target.ColorSrcFactor));
+			Hash = HashCombine(Hash, GetTypeHash((uint32_t)Target.ColorDstFactor));
+			Hash = HashCombine(Hash, GetTypeHash((uint32_t)Target.AlphaBlendOp));
+			Hash = HashCombine(Hash, GetTypeHash((uint32_t)Target.AlphaSrcFactor));
+			Hash = HashCombine(Hash, GetTypeHash((uint32_t)Target.AlphaDstFactor));
+			Hash = HashCombine(Hash, GetTypeHash((uint32_t)Target.ColorWriteMask));
+		}
+		return Hash;
 	}
 
 	FRenderTargetBlendState RenderTargetBlendStates[MaxSimultaneousRenderTargets];
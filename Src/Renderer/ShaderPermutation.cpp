@@ -0,0 +1,268 @@
+// \brief
+//		Shader permutations implementation.
+//
+
+#include <cassert>
+#include <cstdio>
+#include <algorithm>
+#include "ShaderPermutation.h"
+
+
+//////////////////////////////////////////////////////////////////////////
+// FShaderPermutationDomain
+
+uint32_t FShaderPermutationDomain::AddBool(const char *InName, uint32_t InStageMask)
+{
+	return AddDimension(InName, nullptr, 2, InStageMask);
+}
+
+uint32_t FShaderPermutationDomain::AddEnum(const char *InName, const char *const *InValueNames, uint32_t InValuesNum, uint32_t InStageMask)
+{
+	assert(InValueNames);
+	return AddDimension(InName, InValueNames, InValuesNum, InStageMask);
+}
+
+uint32_t FShaderPermutationDomain::AddDimension(const char *InName, const char *const *InValueNames, uint32_t InValuesNum, uint32_t InStageMask)
+{
+	assert(InName && InValuesNum >= 2 && (InStageMask & SSM_All));
+	assert(PermutationsNum * InValuesNum <= MaxShaderPermutations);
+
+	FDimension Dimension;
+	Dimension.Name = InName;
+	Dimension.ValuesNum = InValuesNum;
+	Dimension.Stride = PermutationsNum;
+	Dimension.StageMask = InStageMask;
+	if (InValueNames)
+	{
+		for (uint32_t k = 0; k < InValuesNum; k++)
+		{
+			Dimension.ValueNames.push_back(InValueNames[k]);
+		} // end for k
+	}
+
+	Dimensions.push_back(Dimension);
+	PermutationsNum *= InValuesNum;
+	return (uint32_t)Dimensions.size() - 1;
+}
+
+uint32_t FShaderPermutationDomain::GetValue(uint32_t InPermutationId, uint32_t InDimension) const
+{
+	assert(InPermutationId < PermutationsNum && InDimension < Dimensions.size());
+
+	const FDimension &Dimension = Dimensions[InDimension];
+	return (InPermutationId / Dimension.Stride) % Dimension.ValuesNum;
+}
+
+uint32_t FShaderPermutationDomain::SetValue(uint32_t InPermutationId, uint32_t InDimension, uint32_t InValue) const
+{
+	assert(InDimension < Dimensions.size() && InValue < Dimensions[InDimension].ValuesNum);
+
+	const FDimension &Dimension = Dimensions[InDimension];
+	return InPermutationId - GetValue(InPermutationId, InDimension) * Dimension.Stride + InValue * Dimension.Stride;
+}
+
+uint32_t FShaderPermutationDomain::GetStagePermutation(uint32_t InPermutationId, uint32_t InStageMask) const
+{
+	uint32_t Id = InPermutationId;
+	for (uint32_t k = 0; k < Dimensions.size(); k++)
+	{
+		if ((Dimensions[k].StageMask & InStageMask) == 0)
+		{
+			Id = SetValue(Id, k, 0);
+		}
+	} // end for k
+
+	return Id;
+}
+
+void FShaderPermutationDomain::GenerateDefines(uint32_t InPermutationId, uint32_t InStageMask, std::string &OutDefines) const
+{
+	char Line[256];
+
+	OutDefines.clear();
+	for (uint32_t k = 0; k < Dimensions.size(); k++)
+	{
+		const FDimension &Dimension = Dimensions[k];
+		if ((Dimension.StageMask & InStageMask) == 0)
+		{
+			continue;
+		}
+
+		for (uint32_t v = 0; v < Dimension.ValueNames.size(); v++)
+		{
+			snprintf(Line, sizeof(Line), "#define %s_%s %u\n", Dimension.Name.c_str(), Dimension.ValueNames[v].c_str(), v);
+			OutDefines += Line;
+		} // end for v
+		snprintf(Line, sizeof(Line), "#define %s %u\n", Dimension.Name.c_str(), GetValue(InPermutationId, k));
+		OutDefines += Line;
+	} // end for k
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FShaderPermutationType
+
+FShaderPermutationType::FShaderPermutationType()
+	: Renderer(nullptr)
+{
+}
+
+FShaderPermutationType::~FShaderPermutationType()
+{
+	Release();
+}
+
+void FShaderPermutationType::Init(FRenderer *InRenderer, const char *InName, const FShaderPermutationDomain &InDomain, const std::string &InVertexSource, const std::string &InPixelSource)
+{
+	assert(InRenderer);
+
+	Renderer = InRenderer;
+	Name = InName ? InName : "";
+	Domain = InDomain;
+	VertexSource = InVertexSource;
+	PixelSource = InPixelSource;
+
+	Programs.clear();
+	FailedPrograms.clear();
+	VertexShaders.clear();
+	PixelShaders.clear();
+	Programs.resize(Domain.Num());
+	FailedPrograms.resize(Domain.Num(), false);
+	VertexShaders.resize(Domain.Num());
+	PixelShaders.resize(Domain.Num());
+	Stats = FShaderPermutationStats();
+}
+
+void FShaderPermutationType::Release()
+{
+	Programs.clear();
+	FailedPrograms.clear();
+	VertexShaders.clear();
+	PixelShaders.clear();
+	Renderer = nullptr;
+}
+
+FRHIGPUProgramRef FShaderPermutationType::GetProgram(uint32_t InPermutationId)
+{
+	assert(InPermutationId < Programs.size());
+
+	FRHIGPUProgramRef &Program = Programs[InPermutationId];
+	if (!Program.IsValidRef() && !FailedPrograms[InPermutationId])
+	{
+		Program = CreateProgram(InPermutationId, false, FRHIGPUProgramRef());
+	}
+	else if (Program.IsValidRef() && Program->HasFailed())
+	{
+		// a precached program failed to link in the background
+		Stats.Programs--;
+		Stats.PrecachedPrograms--;
+		SetFailed(InPermutationId);
+	}
+	return Program;
+}
+
+void FShaderPermutationType::Precache(const uint32_t *InPermutationIds, uint32_t InCount, bool bAsync, const FRHIGPUProgramRef &InFallback)
+{
+	for (uint32_t k = 0; k < InCount; k++)
+	{
+		const uint32_t kId = InPermutationIds[k];
+		assert(kId < Programs.size());
+
+		if (!Programs[kId].IsValidRef() && !FailedPrograms[kId])
+		{
+			Programs[kId] = CreateProgram(kId, bAsync, InFallback);
+			Stats.PrecachedPrograms += Programs[kId].IsValidRef() ? 1 : 0;
+		}
+	} // end for k
+}
+
+FRHIGPUProgramRef FShaderPermutationType::CreateProgram(uint32_t InPermutationId, bool bAsync, const FRHIGPUProgramRef &InFallback)
+{
+	assert(Renderer);
+
+	std::vector<FRHIShaderRef> Shaders;
+	Shaders.push_back(GetShader(InPermutationId, SSM_Vertex));
+	Shaders.push_back(GetShader(InPermutationId, SSM_Pixel));
+	if (!Shaders[0].IsValidRef() || !Shaders[1].IsValidRef())
+	{
+		SetFailed(InPermutationId);
+		return FRHIGPUProgramRef();
+	}
+
+	FRHIGPUProgramRef Program = bAsync ? Renderer->RHICreateGPUProgramAsync(Shaders, InFallback) : Renderer->RHICreateGPUProgram(Shaders);
+	if (!Program.IsValidRef() || Program->HasFailed())
+	{
+		SetFailed(InPermutationId);
+		return FRHIGPUProgramRef();
+	}
+
+	Stats.Programs++;
+	return Program;
+}
+
+void FShaderPermutationType::SetFailed(uint32_t InPermutationId)
+{
+	Programs[InPermutationId].SafeRelease();
+	FailedPrograms[InPermutationId] = true;
+	Stats.FailedPrograms++;
+}
+
+FRHIShaderRef FShaderPermutationType::GetShader(uint32_t InPermutationId, uint32_t InStage)
+{
+	const uint32_t kStageId = Domain.GetStagePermutation(InPermutationId, InStage);
+	std::vector<FRHIShaderRef> &Shaders = InStage == SSM_Vertex ? VertexShaders : PixelShaders;
+
+	FRHIShaderRef &Shader = Shaders[kStageId];
+	if (!Shader.IsValidRef())
+	{
+		std::string Defines;
+		Domain.GenerateDefines(kStageId, InStage, Defines);
+		if (InStage == SSM_Vertex)
+		{
+			const std::string Source = ComposeSource(VertexSource, Defines);
+			Shader = Renderer->RHICreateVertexShader(Source.c_str(), (int32_t)Source.size()).DeRef();
+			Stats.VertexShaders++;
+		}
+		else
+		{
+			const std::string Source = ComposeSource(PixelSource, Defines);
+			Shader = Renderer->RHICreatePixelShader(Source.c_str(), (int32_t)Source.size()).DeRef();
+			Stats.PixelShaders++;
+		}
+	}
+	return Shader;
+}
+
+std::string FShaderPermutationType::ComposeSource(const std::string &InSource, const std::string &InDefines) const
+{
+	// the #version directive comes first
+	size_t Insert = 0;
+	const size_t kVersion = InSource.find("#version");
+	if (kVersion != std::string::npos)
+	{
+		const size_t kLineEnd = InSource.find('\n', kVersion);
+		Insert = kLineEnd == std::string::npos ? InSource.size() : kLineEnd + 1;
+	}
+
+	// the errors keep the line numbers of the file
+	char Line[32];
+	const uint32_t kNextLine = (uint32_t)std::count(InSource.begin(), InSource.begin() + Insert, '\n') + 1;
+	snprintf(Line, sizeof(Line), "#line %u\n", kNextLine);
+
+	std::string Source;
+	Source.reserve(InSource.size() + InDefines.size() + 32);
+	Source.append(InSource, 0, Insert);
+	if (Insert > 0 && InSource[Insert - 1] != '\n')
+	{
+		Source += '\n';
+	}
+	Source += InDefines;
+	Source += Line;
+	Source.append(InSource, Insert, std::string::npos);
+	return Source;
+}
+
+void FShaderPermutationType::DumpStats(FOutputDevice &OutDevice) const
+{
+	OutDevice.Log(Log_Info, "Shader permutations of %s: %u dimensions, %u permutations, %u programs (%u precached, %u failed), %u vertex shaders, %u pixel shaders",
+		Name.c_str(), Domain.GetDimensionsNum(), Domain.Num(), Stats.Programs, Stats.PrecachedPrograms, Stats.FailedPrograms, Stats.VertexShaders, Stats.PixelShaders);
+}
@@ -0,0 +1,138 @@
+// \brief
+//		Shader permutations: a shader type declares boolean & enum dimensions, each permutation is
+//		compiled from the same sources with the #define of its values, so a mesh runs the features
+//		it needs only instead of branching on uniforms.
+//
+
+#ifndef __JETX_SHADER_PERMUTATION_H__
+#define __JETX_SHADER_PERMUTATION_H__
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include "Foundation/JetX.h"
+#include "Foundation/OutputDevice.h"
+#include "Renderer.h"
+
+
+/** The permutations of a shader type at most */
+enum { MaxShaderPermutations = 4096 };
+
+// the shaders whose sources a dimension changes
+enum EShaderStageMask
+{
+	SSM_Vertex = 1,
+	SSM_Pixel = 2,
+	SSM_All = SSM_Vertex | SSM_Pixel
+};
+
+// FShaderPermutationDomain
+// the dimensions of a shader type. a permutation id packs the values of all the dimensions in mixed
+// radix, the first dimension varying the fastest: the ids are [0, Num()).
+//
+//	Domain.AddBool("SKINNED", SSM_Vertex);
+//	Domain.AddEnum("FOG", FogModeNames, 3, SSM_Pixel);	// #define FOG 2, #define FOG_EXP 2 ...
+//	uint32_t Id = Domain.SetValue(Domain.SetValue(0, kSkinned, 1), kFog, FogExp);
+class FShaderPermutationDomain
+{
+public:
+	FShaderPermutationDomain()
+		: PermutationsNum(1)
+	{}
+
+	// return the index of the dimension, the values are 0 & 1.
+	uint32_t AddBool(const char *InName, uint32_t InStageMask = SSM_All);
+	// the values are [0, InValuesNum), each one defined as InName_InValueNames[k] too.
+	uint32_t AddEnum(const char *InName, const char *const *InValueNames, uint32_t InValuesNum, uint32_t InStageMask = SSM_All);
+
+	uint32_t Num() const { return PermutationsNum; }
+	uint32_t GetDimensionsNum() const { return (uint32_t)Dimensions.size(); }
+
+	uint32_t GetValue(uint32_t InPermutationId, uint32_t InDimension) const;
+	// return InPermutationId with InValue for InDimension.
+	uint32_t SetValue(uint32_t InPermutationId, uint32_t InDimension, uint32_t InValue) const;
+	// the values of the dimensions not read by the stages of InStageMask are cleared: the permutations
+	// sharing the result share the shader of these stages.
+	uint32_t GetStagePermutation(uint32_t InPermutationId, uint32_t InStageMask) const;
+
+	// the #define lines of the permutation for the stages of InStageMask.
+	void GenerateDefines(uint32_t InPermutationId, uint32_t InStageMask, std::string &OutDefines) const;
+
+protected:
+	struct FDimension
+	{
+		std::string					Name;
+		std::vector<std::string>	ValueNames;		// empty for a bool
+		uint32_t					ValuesNum;
+		uint32_t					Stride;
+		uint32_t					StageMask;
+	};
+
+	uint32_t AddDimension(const char *InName, const char *const *InValueNames, uint32_t InValuesNum, uint32_t InStageMask);
+
+	std::vector<FDimension>		Dimensions;
+	uint32_t					PermutationsNum;
+};
+
+// the shaders compiled for a shader type
+struct FShaderPermutationStats
+{
+	FShaderPermutationStats()
+	{
+		::memset(this, 0, sizeof(*this));
+	}
+
+	uint32_t	Programs;			// permutations linked
+	uint32_t	VertexShaders;		// compiled, shared by the permutations differing in the pixel dimensions
+	uint32_t	PixelShaders;
+	uint32_t	PrecachedPrograms;
+	uint32_t	FailedPrograms;
+};
+
+// FShaderPermutationType
+// the permutations of a vertex & pixel shader pair, created the first time they are asked for or
+// precached. the defines are inserted after the #version line of the sources.
+class FShaderPermutationType
+{
+public:
+	FShaderPermutationType();
+	~FShaderPermutationType();
+
+	// InDomain is complete, InName names the type in the logs.
+	void Init(FRenderer *InRenderer, const char *InName, const FShaderPermutationDomain &InDomain, const std::string &InVertexSource, const std::string &InPixelSource);
+	void Release();
+
+	const FShaderPermutationDomain& GetDomain() const { return Domain; }
+
+	// the program of the permutation, linked at the first call unless it was precached. a permutation
+	// that failed to compile or link (in the background too) is not tried again, its ref is null.
+	FRHIGPUProgramRef GetProgram(uint32_t InPermutationId);
+	// create the programs of the permutations ahead of their draws, by RHICreateGPUProgramAsync if
+	// bAsync: their draws use InFallback until they are ready.
+	void Precache(const uint32_t *InPermutationIds, uint32_t InCount, bool bAsync, const FRHIGPUProgramRef &InFallback = FRHIGPUProgramRef());
+
+	const FShaderPermutationStats& GetStats() const { return Stats; }
+	void DumpStats(FOutputDevice &OutDevice) const;
+
+protected:
+	FRHIGPUProgramRef CreateProgram(uint32_t InPermutationId, bool bAsync, const FRHIGPUProgramRef &InFallback);
+	void SetFailed(uint32_t InPermutationId);
+	FRHIShaderRef GetShader(uint32_t InPermutationId, uint32_t InStage);
+	std::string ComposeSource(const std::string &InSource, const std::string &InDefines) const;
+
+	FRenderer					*Renderer;
+	std::string					Name;
+	FShaderPermutationDomain	Domain;
+	std::string					VertexSource;
+	std::string					PixelSource;
+
+	// by the permutation id, the shaders by the stage permutation id.
+	std::vector<FRHIGPUProgramRef>	Programs;
+	std::vector<bool>				FailedPrograms;
+	std::vector<FRHIShaderRef>		VertexShaders;
+	std::vector<FRHIShaderRef>		PixelShaders;
+
+	FShaderPermutationStats		Stats;
+};
+
+#endif // __JETX_SHADER_PERMUTATION_H__
@@ -0,0 +1,1078 @@
+//\brief
+//		Software Rasterizer Implementation.
+//
+
+#include <cassert>
+#include <cmath>
+#include "SoftwareRasterizer.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFTWARE_RASTER_SSE2	1
+#include <emmintrin.h>
+#else
+#define SOFTWARE_RASTER_SSE2	0
+#endif
+
+
+// flush when this many primitives are binned
+static const uint32_t kMaxBinnedPrimitives = 65536;
+// clip polygon: 3 vertices + 1 per clip plane
+static const uint32_t kMaxClipVertices = 8;
+
+//////////////////////////////////////////////////////////////////////////
+// Helpers
+static inline bool CompareValue(ECompareFunction InFunc, float InValue, float InRef)
+{
+	switch (InFunc)
+	{
+	case CF_Less:			return InValue < InRef;
+	case CF_LessEqual:		return InValue <= InRef;
+	case CF_Greater:		return InValue > InRef;
+	case CF_GreaterEqual:	return InValue >= InRef;
+	case CF_Equal:			return InValue == InRef;
+	case CF_NotEqual:		return InValue != InRef;
+	case CF_Never:			return false;
+	case CF_Always:
+	default:
+		return true;
+	}
+}
+
+static inline bool CompareStencil(ECompareFunction InFunc, uint32_t InRef, uint32_t InValue)
+{
+	// same as glStencilFunc: (ref & mask) func (stencil & mask)
+	switch (InFunc)
+	{
+	case CF_Less:			return InRef < InValue;
+	case CF_LessEqual:		return InRef <= InValue;
+	case CF_Greater:		return InRef > InValue;
+	case CF_GreaterEqual:	return InRef >= InValue;
+	case CF_Equal:			return InRef == InValue;
+	case CF_NotEqual:		return InRef != InValue;
+	case CF_Never:			return false;
+	case CF_Always:
+	default:
+		return true;
+	}
+}
+
+static inline uint8_t ApplyStencilOp(EStencilOp InOp, uint8_t InValue, uint8_t InRef)
+{
+	switch (InOp)
+	{
+	case SO_Zero:			return 0;
+	case SO_Replace:		return InRef;
+	case SO_Increment:		return InValue < 0xFF ? InValue + 1 : 0xFF;
+	case SO_Decrement:		return InValue > 0 ? InValue - 1 : 0;
+	case SO_IncrementWrap:	return (uint8_t)(InValue + 1);
+	case SO_DecrementWrap:	return (uint8_t)(InValue - 1);
+	case SO_Invert:			return (uint8_t)~InValue;
+	case SO_Keep:
+	default:
+		return InValue;
+	}
+}
+
+// the 4 factors of EBlendFactor
+static inline void GetBlendFactor(EBlendFactor InFactor, const FLinearColor &InSrc, const FLinearColor &InDst, const FLinearColor &InConstant, float OutFactor[4])
+{
+	for (uint32_t k = 0; k < 4; k++)
+	{
+		float Value = 0.f;
+		switch (InFactor)
+		{
+		case BF_Zero:						Value = 0.f; break;
+		case BF_One:						Value = 1.f; break;
+		case BF_SourceColor:				Value = InSrc.RGBA[k]; break;
+		case BF_InverseSourceColor:			Value = 1.f - InSrc.RGBA[k]; break;
+		case BF_SourceAlpha:				Value = InSrc.A; break;
+		case BF_InverseSourceAlpha:			Value = 1.f - InSrc.A; break;
+		case BF_DestAlpha:					Value = InDst.A; break;
+		case BF_InverseDestAlpha:			Value = 1.f - InDst.A; break;
+		case BF_DestColor:					Value = InDst.RGBA[k]; break;
+		case BF_InverseDestColor:			Value = 1.f - InDst.RGBA[k]; break;
+		case BF_ConstantBlendFactor:		Value = InConstant.RGBA[k]; break;
+		case BF_InverseConstantBlendFactor:	Value = 1.f - InConstant.RGBA[k]; break;
+		default:
+			break;
+		}
+		OutFactor[k] = Value;
+	}
+}
+
+static inline float ApplyBlendOp(EBlendOperation InOp, float InSrc, float InSrcFactor, float InDst, float InDstFactor)
+{
+	switch (InOp)
+	{
+	case BO_Subtract:			return InSrc * InSrcFactor - InDst * InDstFactor;
+	case BO_ReverseSubstract:	return InDst * InDstFactor - InSrc * InSrcFactor;
+	case BO_Min:				return (std::min)(InSrc, InDst);
+	case BO_Max:				return (std::max)(InSrc, InDst);
+	case BO_Add:
+	default:
+		return InSrc * InSrcFactor + InDst * InDstFactor;
+	}
+}
+
+#if SOFTWARE_RASTER_SSE2
+static inline __m128 CompareDepth4(ECompareFunction InFunc, __m128 InValue, __m128 InRef)
+{
+	switch (InFunc)
+	{
+	case CF_Less:			return _mm_cmplt_ps(InValue, InRef);
+	case CF_LessEqual:		return _mm_cmple_ps(InValue, InRef);
+	case CF_Greater:		return _mm_cmpgt_ps(InValue, InRef);
+	case CF_GreaterEqual:	return _mm_cmpge_ps(InValue, InRef);
+	case CF_Equal:			return _mm_cmpeq_ps(InValue, InRef);
+	case CF_NotEqual:		return _mm_cmpneq_ps(InValue, InRef);
+	case CF_Never:			return _mm_setzero_ps();
+	case CF_Always:
+	default:
+		return _mm_castsi128_ps(_mm_set1_epi32(-1));
+	}
+}
+#endif
+
+// clip planes of the clip space: z >= -w, z <= w, w >= epsilon
+enum { ClipPlanesNum = 3 };
+static const float kClipEpsilon = 1e-6f;
+
+static inline float ClipDistance(const FSoftwareVertexOutput &InVertex, uint32_t InPlane)
+{
+	const float *P = InVertex.Position;
+	switch (InPlane)
+	{
+	case 0:		return P[2] + P[3];
+	case 1:		return P[3] - P[2];
+	default:	return P[3] - kClipEpsilon;
+	}
+}
+
+// outcodes: bits 0-2 are the clip planes, bits 3-6 are x/y outside (guard band only)
+static inline uint32_t ClipCode(const FSoftwareVertexOutput &InVertex)
+{
+	const float *P = InVertex.Position;
+	uint32_t Code = 0;
+	for (uint32_t Plane = 0; Plane < ClipPlanesNum; Plane++)
+	{
+		Code |= ClipDistance(InVertex, Plane) < 0.f ? (1u << Plane) : 0;
+	}
+	Code |= P[0] < -P[3] ? 0x08 : 0;
+	Code |= P[0] > P[3] ? 0x10 : 0;
+	Code |= P[1] < -P[3] ? 0x20 : 0;
+	Code |= P[1] > P[3] ? 0x40 : 0;
+	return Code;
+}
+
+static inline void LerpVertex(const FSoftwareVertexOutput &A, const FSoftwareVertexOutput &B, float t, uint32_t InVaryingsNum, FSoftwareVertexOutput &OutVertex)
+{
+	for (uint32_t k = 0; k < 4; k++)
+	{
+		OutVertex.Position[k] = A.Position[k] + (B.Position[k] - A.Position[k]) * t;
+	}
+	for (uint32_t k = 0; k < InVaryingsNum; k++)
+	{
+		OutVertex.Varyings[k] = A.Varyings[k] + (B.Varyings[k] - A.Varyings[k]) * t;
+	}
+}
+
+// Sutherland-Hodgman against the clip planes, return the new vertices count.
+static uint32_t ClipPolygon(FSoftwareVertexOutput *InOutPolygon, uint32_t InCount, uint32_t InVaryingsNum)
+{
+	FSoftwareVertexOutput Temp[kMaxClipVertices];
+	FSoftwareVertexOutput *Src = InOutPolygon, *Dst = Temp;
+
+	for (uint32_t Plane = 0; Plane < ClipPlanesNum && InCount >= 3; Plane++)
+	{
+		uint32_t OutCount = 0;
+		for (uint32_t k = 0; k < InCount; k++)
+		{
+			const FSoftwareVertexOutput &A = Src[k];
+			const FSoftwareVertexOutput &B = Src[(k + 1) % InCount];
+			const float DA = ClipDistance(A, Plane);
+			const float DB = ClipDistance(B, Plane);
+
+			if (DA >= 0.f)
+			{
+				Dst[OutCount++] = A;
+			}
+			if ((DA >= 0.f) != (DB >= 0.f))
+			{
+				LerpVertex(A, B, DA / (DA - DB), InVaryingsNum, Dst[OutCount++]);
+			}
+		} // end for k
+
+		std::swap(Src, Dst);
+		InCount = OutCount;
+	} // end for Plane
+
+	if (Src != InOutPolygon)
+	{
+		for (uint32_t k = 0; k < InCount; k++)
+		{
+			InOutPolygon[k] = Src[k];
+		}
+	}
+	return InCount;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Rasterizer
+FSoftwareRasterizer::FSoftwareRasterizer()
+	: JobSystem(nullptr)
+	, Target(nullptr)
+	, TilesX(0)
+	, TilesY(0)
+	, bInDraw(false)
+{
+}
+
+FSoftwareRasterizer::~FSoftwareRasterizer()
+{
+	Shutdown();
+}
+
+void FSoftwareRasterizer::Init(uint32_t InThreadsNum)
+{
+	// the workers are shared with the engine, the first user decides their number.
+	JobSystem = FJobSystem::SharedInstance();
+	if (!JobSystem->IsRunning())
+	{
+		JobSystem->Start(InThreadsNum);
+	}
+}
+
+void FSoftwareRasterizer::Shutdown()
+{
+	Flush();
+	Target = nullptr;
+}
+
+void FSoftwareRasterizer::SetRenderTarget(FRHISoftwareViewport *InTarget)
+{
+	if (Target == InTarget && (!Target || (TilesX == Target->Pitch / SoftwareTileSize && TilesY == Target->Rows / SoftwareTileSize)))
+	{
+		return;
+	}
+
+	Flush();
+
+	Target = InTarget;
+	TilesX = Target ? Target->Pitch / SoftwareTileSize : 0;
+	TilesY = Target ? Target->Rows / SoftwareTileSize : 0;
+	Bins.resize(TilesX * TilesY);
+}
+
+void FSoftwareRasterizer::Clear(bool bClearColor, const FLinearColor &InColor, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil)
+{
+	if (!Target || (!bClearColor && !bClearDepth && !bClearStencil))
+	{
+		return;
+	}
+
+	FClearRecord Record;
+	Record.bClearColor = bClearColor;
+	Record.Color = PackColor(InColor);
+	Record.bClearDepth = bClearDepth;
+	Record.Depth = InDepth < 0.f ? 0.f : (InDepth > 1.f ? 1.f : InDepth);
+	Record.bClearStencil = bClearStencil;
+	Record.Stencil = (uint8_t)InStencil;
+
+	const uint32_t kCommand = ((uint32_t)Clears.size() << 1) | 1;
+	Clears.push_back(Record);
+	for (size_t Tile = 0; Tile < Bins.size(); Tile++)
+	{
+		Bins[Tile].push_back(kCommand);
+	}
+}
+
+void FSoftwareRasterizer::BeginDraw(const FSoftwareDrawState &InState)
+{
+	FDrawRecord Draw;
+	Draw.State = InState;
+
+	const int32_t kSizeX = Target ? (int32_t)Target->SizeX : 0;
+	const int32_t kSizeY = Target ? (int32_t)Target->SizeY : 0;
+	Draw.ClipMinX = (std::max)(InState.ViewportX, 0);
+	Draw.ClipMinY = (std::max)(InState.ViewportY, 0);
+	Draw.ClipMaxX = (std::min)(InState.ViewportX + InState.ViewportWidth, kSizeX) - 1;
+	Draw.ClipMaxY = (std::min)(InState.ViewportY + InState.ViewportHeight, kSizeY) - 1;
+
+	// front faces are counter-clockwise, CM_CW culls the back faces (same as the OpenGL renderer)
+	Draw.bCullFront = InState.RasterizerState.CullMode == CM_CCW;
+	Draw.bCullBack = InState.RasterizerState.CullMode == CM_CW;
+
+	const FDepthStencilStateInitializerRHI &DepthStencil = InState.DepthStencilState;
+	Draw.bDepthTest = DepthStencil.DepthTestFunc != CF_Always || DepthStencil.bEnableDepthWrite;
+	Draw.bDepthWrite = DepthStencil.bEnableDepthWrite;
+	Draw.bStencilTest = DepthStencil.bEnableStencilTest;
+
+	const FBlendStateInitializerRHI::FRenderTargetBlendState &Blend = InState.BlendState;
+	Draw.bBlend = Blend.ColorBlendOp != BO_Add || Blend.ColorSrcFactor != BF_One || Blend.ColorDstFactor != BF_Zero
+		|| Blend.AlphaBlendOp != BO_Add || Blend.AlphaSrcFactor != BF_One || Blend.AlphaDstFactor != BF_Zero;
+	Draw.ColorWriteMask = ((Blend.ColorWriteMask & CW_RED) ? 0x000000FF : 0)
+		| ((Blend.ColorWriteMask & CW_GREEN) ? 0x0000FF00 : 0)
+		| ((Blend.ColorWriteMask & CW_BLUE) ? 0x00FF0000 : 0)
+		| ((Blend.ColorWriteMask & CW_ALPHA) ? 0xFF000000 : 0);
+
+	if (!Draw.State.Uniforms.IsValidRef())
+	{
+		Draw.State.Uniforms = new FSoftwareUniformBlock();
+	}
+	Draw.State.VaryingsNum = (std::min)(Draw.State.VaryingsNum, (uint32_t)MaxSoftwareVaryings);
+
+	Draws.push_back(Draw);
+	bInDraw = true;
+}
+
+void FSoftwareRasterizer::SubmitTriangle(const FSoftwareVertexOutput &V0, const FSoftwareVertexOutput &V1, const FSoftwareVertexOutput &V2)
+{
+	assert(bInDraw);
+	const FDrawRecord &Draw = Draws.back();
+	if (!Target || Draw.ClipMinX > Draw.ClipMaxX || Draw.ClipMinY > Draw.ClipMaxY)
+	{
+		return;
+	}
+
+	const uint32_t Code0 = ClipCode(V0), Code1 = ClipCode(V1), Code2 = ClipCode(V2);
+	if (Code0 & Code1 & Code2)
+	{
+		// all outside of one plane
+		return;
+	}
+
+	FSoftwareVertexOutput Polygon[kMaxClipVertices];
+	Polygon[0] = V0;
+	Polygon[1] = V1;
+	Polygon[2] = V2;
+
+	uint32_t Count = 3;
+	if ((Code0 | Code1 | Code2) & ((1u << ClipPlanesNum) - 1))
+	{
+		Count = ClipPolygon(Polygon, Count, Draw.State.VaryingsNum);
+		if (Count < 3)
+		{
+			return;
+		}
+	}
+
+	const uint32_t kBase = (uint32_t)Vertices.size();
+	for (uint32_t k = 0; k < Count; k++)
+	{
+		Vertices.push_back(ToRasterVertex(Polygon[k], Draw));
+	}
+	for (uint32_t k = 1; k + 1 < Count; k++)
+	{
+		SetupTriangle(kBase, kBase + k, kBase + k + 1);
+	}
+
+	FlushIfFull();
+}
+
+void FSoftwareRasterizer::SubmitLine(const FSoftwareVertexOutput &V0, const FSoftwareVertexOutput &V1)
+{
+	assert(bInDraw);
+	const FDrawRecord &Draw = Draws.back();
+	if (!Target || Draw.ClipMinX > Draw.ClipMaxX || Draw.ClipMinY > Draw.ClipMaxY)
+	{
+		return;
+	}
+
+	const uint32_t Code0 = ClipCode(V0), Code1 = ClipCode(V1);
+	if (Code0 & Code1)
+	{
+		return;
+	}
+
+	// parametric clipping
+	float t0 = 0.f, t1 = 1.f;
+	for (uint32_t Plane = 0; Plane < ClipPlanesNum; Plane++)
+	{
+		const float D0 = ClipDistance(V0, Plane);
+		const float D1 = ClipDistance(V1, Plane);
+		if (D0 < 0.f && D1 < 0.f)
+		{
+			return;
+		}
+		if (D0 < 0.f)
+		{
+			t0 = (std::max)(t0, D0 / (D0 - D1));
+		}
+		else if (D1 < 0.f)
+		{
+			t1 = (std::min)(t1, D0 / (D0 - D1));
+		}
+	}
+	if (t0 > t1)
+	{
+		return;
+	}
+
+	FSoftwareVertexOutput A, B;
+	LerpVertex(V0, V1, t0, Draw.State.VaryingsNum, A);
+	LerpVertex(V0, V1, t1, Draw.State.VaryingsNum, B);
+
+	const uint32_t kBase = (uint32_t)Vertices.size();
+	Vertices.push_back(ToRasterVertex(A, Draw));
+	Vertices.push_back(ToRasterVertex(B, Draw));
+	AddLine(kBase, kBase + 1, true);
+
+	FlushIfFull();
+}
+
+void FSoftwareRasterizer::SubmitPoint(const FSoftwareVertexOutput &V0)
+{
+	assert(bInDraw);
+	const FDrawRecord &Draw = Draws.back();
+	if (!Target || ClipCode(V0) != 0)
+	{
+		return;
+	}
+
+	const uint32_t kBase = (uint32_t)Vertices.size();
+	Vertices.push_back(ToRasterVertex(V0, Draw));
+	AddPoint(kBase, true);
+
+	FlushIfFull();
+}
+
+void FSoftwareRasterizer::Flush()
+{
+	if (!Target || (Primitives.empty() && Clears.empty()))
+	{
+		return;
+	}
+
+	ActiveTiles.clear();
+	for (uint32_t Tile = 0; Tile < (uint32_t)Bins.size(); Tile++)
+	{
+		if (!Bins[Tile].empty())
+		{
+			ActiveTiles.push_back(Tile);
+		}
+	}
+
+	JobSystem->ParallelFor((uint32_t)ActiveTiles.size(), 1, [this](uint32_t InIndex) {
+		RasterizeTile(ActiveTiles[InIndex]);
+	});
+
+	for (size_t Tile = 0; Tile < Bins.size(); Tile++)
+	{
+		Bins[Tile].clear();
+	}
+	Vertices.clear();
+	Primitives.clear();
+	Clears.clear();
+
+	// the draw in progress continues after the flush
+	if (bInDraw && !Draws.empty())
+	{
+		FDrawRecord Current = Draws.back();
+		Draws.clear();
+		Draws.push_back(Current);
+	}
+	else
+	{
+		Draws.clear();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Setup
+FSoftwareRasterizer::FRasterVertex FSoftwareRasterizer::ToRasterVertex(const FSoftwareVertexOutput &InVertex, const FDrawRecord &InDraw) const
+{
+	const FSoftwareDrawState &State = InDraw.State;
+	const float InvW = 1.f / InVertex.Position[3];
+
+	FRasterVertex Vertex;
+	Vertex.X = State.ViewportX + (InVertex.Position[0] * InvW * 0.5f + 0.5f) * State.ViewportWidth;
+	Vertex.Y = State.ViewportY + (InVertex.Position[1] * InvW * 0.5f + 0.5f) * State.ViewportHeight;
+	Vertex.Z = State.MinZ + (InVertex.Position[2] * InvW * 0.5f + 0.5f) * (State.MaxZ - State.MinZ);
+	Vertex.InvW = InvW;
+	for (uint32_t k = 0; k < State.VaryingsNum; k++)
+	{
+		Vertex.Varyings[k] = InVertex.Varyings[k] * InvW;
+	}
+	return Vertex;
+}
+
+void FSoftwareRasterizer::SetupTriangle(uint32_t I0, uint32_t I1, uint32_t I2)
+{
+	const uint32_t kDrawIndex = (uint32_t)Draws.size() - 1;
+	const FDrawRecord &Draw = Draws[kDrawIndex];
+
+	const FRasterVertex *P0 = &Vertices[I0], *P1 = &Vertices[I1], *P2 = &Vertices[I2];
+	float Area = (P1->X - P0->X) * (P2->Y - P0->Y) - (P2->X - P0->X) * (P1->Y - P0->Y);
+	if (!(Area != 0.f) || !std::isfinite(Area))
+	{
+		return;
+	}
+
+	const bool bFrontFacing = Area > 0.f;
+	if ((bFrontFacing && Draw.bCullFront) || (!bFrontFacing && Draw.bCullBack))
+	{
+		return;
+	}
+
+	switch (Draw.State.RasterizerState.FillMode)
+	{
+	case FM_Wireframe:
+		AddLine(I0, I1, bFrontFacing);
+		AddLine(I1, I2, bFrontFacing);
+		AddLine(I2, I0, bFrontFacing);
+		return;
+	case FM_Point:
+		AddPoint(I0, bFrontFacing);
+		AddPoint(I1, bFrontFacing);
+		AddPoint(I2, bFrontFacing);
+		return;
+	default:
+		break;
+	}
+
+	// keep the edges counter-clockwise
+	if (!bFrontFacing)
+	{
+		std::swap(I1, I2);
+		std::swap(P1, P2);
+		Area = -Area;
+	}
+
+	FRasterPrimitive Prim;
+	Prim.Kind = PK_Triangle;
+	Prim.DrawIndex = kDrawIndex;
+	Prim.V[0] = I0;
+	Prim.V[1] = I1;
+	Prim.V[2] = I2;
+	Prim.bFrontFacing = bFrontFacing;
+	Prim.InvArea = 1.f / Area;
+
+	const FRasterVertex *P[3] = { P0, P1, P2 };
+	for (uint32_t k = 0; k < 3; k++)
+	{
+		const FRasterVertex *A = P[(k + 1) % 3];
+		const FRasterVertex *B = P[(k + 2) % 3];
+		Prim.EdgeA[k] = A->Y - B->Y;
+		Prim.EdgeB[k] = B->X - A->X;
+		Prim.EdgeC[k] = -(Prim.EdgeA[k] * A->X + Prim.EdgeB[k] * A->Y);
+		Prim.EdgeTie[k] = Prim.EdgeA[k] > 0.f || (Prim.EdgeA[k] == 0.f && Prim.EdgeB[k] < 0.f);
+	}
+
+	const float kMinX = (std::min)((std::min)(P0->X, P1->X), P2->X);
+	const float kMinY = (std::min)((std::min)(P0->Y, P1->Y), P2->Y);
+	const float kMaxX = (std::max)((std::max)(P0->X, P1->X), P2->X);
+	const float kMaxY = (std::max)((std::max)(P0->Y, P1->Y), P2->Y);
+	Prim.MinX = (std::max)(Draw.ClipMinX, (int32_t)(std::max)(std::floor(kMinX), (float)Draw.ClipMinX));
+	Prim.MinY = (std::max)(Draw.ClipMinY, (int32_t)(std::max)(std::floor(kMinY), (float)Draw.ClipMinY));
+	Prim.MaxX = (std::min)(Draw.ClipMaxX, (int32_t)(std::min)(std::floor(kMaxX), (float)Draw.ClipMaxX));
+	Prim.MaxY = (std::min)(Draw.ClipMaxY, (int32_t)(std::min)(std::floor(kMaxY), (float)Draw.ClipMaxY));
+	if (Prim.MinX > Prim.MaxX || Prim.MinY > Prim.MaxY)
+	{
+		return;
+	}
+
+	// polygon offset, the units are of a 24 bits depth buffer
+	Prim.DepthOffset = 0.f;
+	const FRasterizerStateInitializerRHI &Rasterizer = Draw.State.RasterizerState;
+	if (Rasterizer.DepthOffsetFactor != 0.f || Rasterizer.DepthOffsetUnits != 0.f)
+	{
+		const float kDzDx = (Prim.EdgeA[0] * P0->Z + Prim.EdgeA[1] * P1->Z + Prim.EdgeA[2] * P2->Z) * Prim.InvArea;
+		const float kDzDy = (Prim.EdgeB[0] * P0->Z + Prim.EdgeB[1] * P1->Z + Prim.EdgeB[2] * P2->Z) * Prim.InvArea;
+		Prim.DepthOffset = Rasterizer.DepthOffsetFactor * (std::max)(std::fabs(kDzDx), std::fabs(kDzDy))
+			+ Rasterizer.DepthOffsetUnits * (1.f / 16777216.f);
+	}
+
+	Primitives.push_back(Prim);
+	BinPrimitive((uint32_t)Primitives.size() - 1);
+}
+
+void FSoftwareRasterizer::AddLine(uint32_t I0, uint32_t I1, bool bFrontFacing)
+{
+	const uint32_t kDrawIndex = (uint32_t)Draws.size() - 1;
+	const FDrawRecord &Draw = Draws[kDrawIndex];
+	const FRasterVertex &P0 = Vertices[I0], &P1 = Vertices[I1];
+
+	FRasterPrimitive Prim;
+	Prim.Kind = PK_Line;
+	Prim.DrawIndex = kDrawIndex;
+	Prim.V[0] = I0;
+	Prim.V[1] = I1;
+	Prim.V[2] = I0;
+	Prim.bFrontFacing = bFrontFacing;
+	Prim.DepthOffset = 0.f;
+	Prim.MinX = (std::max)(Draw.ClipMinX, (int32_t)(std::max)(std::floor((std::min)(P0.X, P1.X)), (float)Draw.ClipMinX));
+	Prim.MinY = (std::max)(Draw.ClipMinY, (int32_t)(std::max)(std::floor((std::min)(P0.Y, P1.Y)), (float)Draw.ClipMinY));
+	Prim.MaxX = (std::min)(Draw.ClipMaxX, (int32_t)(std::min)(std::floor((std::max)(P0.X, P1.X)), (float)Draw.ClipMaxX));
+	Prim.MaxY = (std::min)(Draw.ClipMaxY, (int32_t)(std::min)(std::floor((std::max)(P0.Y, P1.Y)), (float)Draw.ClipMaxY));
+	if (Prim.MinX > Prim.MaxX || Prim.MinY > Prim.MaxY)
+	{
+		return;
+	}
+
+	Primitives.push_back(Prim);
+	BinPrimitive((uint32_t)Primitives.size() - 1);
+}
+
+void FSoftwareRasterizer::AddPoint(uint32_t I0, bool bFrontFacing)
+{
+	const uint32_t kDrawIndex = (uint32_t)Draws.size() - 1;
+	const FDrawRecord &Draw = Draws[kDrawIndex];
+	const FRasterVertex &P0 = Vertices[I0];
+
+	FRasterPrimitive Prim;
+	Prim.Kind = PK_Point;
+	Prim.DrawIndex = kDrawIndex;
+	Prim.V[0] = Prim.V[1] = Prim.V[2] = I0;
+	Prim.bFrontFacing = bFrontFacing;
+	Prim.DepthOffset = 0.f;
+	if (!(P0.X >= Draw.ClipMinX && P0.X < Draw.ClipMaxX + 1 && P0.Y >= Draw.ClipMinY && P0.Y < Draw.ClipMaxY + 1))
+	{
+		return;
+	}
+	Prim.MinX = Prim.MaxX = (int32_t)P0.X;
+	Prim.MinY = Prim.MaxY = (int32_t)P0.Y;
+
+	Primitives.push_back(Prim);
+	BinPrimitive((uint32_t)Primitives.size() - 1);
+}
+
+void FSoftwareRasterizer::BinPrimitive(uint32_t InPrimitiveIndex)
+{
+	const FRasterPrimitive &Prim = Primitives[InPrimitiveIndex];
+	const uint32_t kCommand = InPrimitiveIndex << 1;
+
+	const int32_t kTileMinX = Prim.MinX / SoftwareTileSize, kTileMaxX = Prim.MaxX / SoftwareTileSize;
+	const int32_t kTileMinY = Prim.MinY / SoftwareTileSize, kTileMaxY = Prim.MaxY / SoftwareTileSize;
+	for (int32_t ty = kTileMinY; ty <= kTileMaxY; ty++)
+	{
+		for (int32_t tx = kTileMinX; tx <= kTileMaxX; tx++)
+		{
+			if (Prim.Kind == PK_Triangle && (kTileMinX != kTileMaxX || kTileMinY != kTileMaxY))
+			{
+				// reject the tile if it is fully outside of an edge, test the corner most inside.
+				const float kX0 = (float)(tx * SoftwareTileSize), kX1 = kX0 + SoftwareTileSize;
+				const float kY0 = (float)(ty * SoftwareTileSize), kY1 = kY0 + SoftwareTileSize;
+				bool bOutside = false;
+				for (uint32_t k = 0; k < 3 && !bOutside; k++)
+				{
+					const float x = Prim.EdgeA[k] > 0.f ? kX1 : kX0;
+					const float y = Prim.EdgeB[k] > 0.f ? kY1 : kY0;
+					bOutside = Prim.EdgeA[k] * x + Prim.EdgeB[k] * y + Prim.EdgeC[k] < 0.f;
+				}
+				if (bOutside)
+				{
+					continue;
+				}
+			}
+
+			Bins[ty * TilesX + tx].push_back(kCommand);
+		}
+	}
+}
+
+void FSoftwareRasterizer::FlushIfFull()
+{
+	if (Primitives.size() >= kMaxBinnedPrimitives)
+	{
+		Flush();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Tiles
+void FSoftwareRasterizer::RasterizeTile(uint32_t InTileIndex)
+{
+	FTileRect Rect;
+	Rect.MinX = (InTileIndex % TilesX) * SoftwareTileSize;
+	Rect.MinY = (InTileIndex / TilesX) * SoftwareTileSize;
+	Rect.MaxX = Rect.MinX + SoftwareTileSize - 1;
+	Rect.MaxY = Rect.MinY + SoftwareTileSize - 1;
+
+	const FTileBin &Bin = Bins[InTileIndex];
+	for (size_t k = 0; k < Bin.size(); k++)
+	{
+		const uint32_t kCommand = Bin[k];
+		if (kCommand & 1)
+		{
+			ClearTile(Clears[kCommand >> 1], Rect);
+			continue;
+		}
+
+		const FRasterPrimitive &Prim = Primitives[kCommand >> 1];
+		const FDrawRecord &Draw = Draws[Prim.DrawIndex];
+		uint32_t Samples = 0;
+		switch (Prim.Kind)
+		{
+		case PK_Triangle:
+			Samples = RasterizeTriangle(Prim, Draw, Rect);
+			break;
+		case PK_Line:
+			Samples = RasterizeLine(Prim, Draw, Rect);
+			break;
+		case PK_Point:
+			Samples = RasterizePoint(Prim, Draw, Rect);
+			break;
+		default:
+			break;
+		}
+		if (Samples && Draw.State.SamplesPassed)
+		{
+			Draw.State.SamplesPassed->fetch_add(Samples, std::memory_order_relaxed);
+		}
+	} // end for k
+}
+
+void FSoftwareRasterizer::ClearTile(const FClearRecord &InClear, const FTileRect &InRect)
+{
+	for (int32_t y = InRect.MinY; y <= InRect.MaxY; y++)
+	{
+		const size_t kRow = (size_t)y * Target->Pitch + InRect.MinX;
+		if (InClear.bClearColor)
+		{
+			std::fill_n(&Target->ColorBuffer[kRow], SoftwareTileSize, InClear.Color);
+		}
+		if (InClear.bClearDepth)
+		{
+			std::fill_n(&Target->DepthBuffer[kRow], SoftwareTileSize, InClear.Depth);
+		}
+		if (InClear.bClearStencil)
+		{
+			std::fill_n(&Target->StencilBuffer[kRow], SoftwareTileSize, InClear.Stencil);
+		}
+	}
+}
+
+uint32_t FSoftwareRasterizer::RasterizeTriangle(const FRasterPrimitive &InPrim, const FDrawRecord &InDraw, const FTileRect &InRect)
+{
+	const int32_t kMinX = (std::max)(InPrim.MinX, InRect.MinX);
+	const int32_t kMinY = (std::max)(InPrim.MinY, InRect.MinY);
+	const int32_t kMaxX = (std::min)(InPrim.MaxX, InRect.MaxX);
+	const int32_t kMaxY = (std::min)(InPrim.MaxY, InRect.MaxY);
+	if (kMinX > kMaxX || kMinY > kMaxY)
+	{
+		return 0;
+	}
+
+	const float kZ0 = Vertices[InPrim.V[0]].Z;
+	const float kZ1 = Vertices[InPrim.V[1]].Z;
+	const float kZ2 = Vertices[InPrim.V[2]].Z;
+	// without stencil the depth test has no side effect, it can be done before the pixel shader.
+	const bool bEarlyDepth = InDraw.bDepthTest && !InDraw.bStencilTest;
+	const ECompareFunction kDepthFunc = InDraw.State.DepthStencilState.DepthTestFunc;
+	uint32_t Samples = 0;
+
+#if SOFTWARE_RASTER_SSE2
+	// 4 pixels a step, the row is 16 bytes aligned as the tiles are.
+	const __m128 kLaneOffset = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+	const __m128i kLaneIndex = _mm_set_epi32(3, 2, 1, 0);
+	const __m128i kMinXi = _mm_set1_epi32(kMinX - 1);
+	const __m128i kMaxXi = _mm_set1_epi32(kMaxX + 1);
+	const __m128 kZero = _mm_setzero_ps();
+	const __m128 kOne = _mm_set1_ps(1.f);
+
+	__m128 A[3], B[3], C[3], Tie[3];
+	for (uint32_t k = 0; k < 3; k++)
+	{
+		A[k] = _mm_set1_ps(InPrim.EdgeA[k]);
+		B[k] = _mm_set1_ps(InPrim.EdgeB[k]);
+		C[k] = _mm_set1_ps(InPrim.EdgeC[k]);
+		Tie[k] = _mm_castsi128_ps(_mm_set1_epi32(InPrim.EdgeTie[k] ? -1 : 0));
+	}
+	const __m128 kInvArea = _mm_set1_ps(InPrim.InvArea);
+	const __m128 kVZ0 = _mm_set1_ps(kZ0), kVZ1 = _mm_set1_ps(kZ1), kVZ2 = _mm_set1_ps(kZ2);
+	const __m128 kOffset = _mm_set1_ps(InPrim.DepthOffset);
+
+	alignas(16) float LaneZ[4], LaneB0[4], LaneB1[4], LaneB2[4];
+	const int32_t kStartX = kMinX & ~3;
+
+	for (int32_t y = kMinY; y <= kMaxY; y++)
+	{
+		const __m128 py = _mm_set1_ps(y + 0.5f);
+		__m128 RowE[3];
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			RowE[k] = _mm_add_ps(_mm_mul_ps(B[k], py), C[k]);
+		}
+
+		for (int32_t x = kStartX; x <= kMaxX; x += 4)
+		{
+			const __m128 px = _mm_add_ps(_mm_set1_ps((float)x), kLaneOffset);
+			const __m128i xi = _mm_add_epi32(_mm_set1_epi32(x), kLaneIndex);
+
+			__m128 E[3];
+			__m128 Mask = _mm_castsi128_ps(_mm_and_si128(_mm_cmpgt_epi32(xi, kMinXi), _mm_cmplt_epi32(xi, kMaxXi)));
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				E[k] = _mm_add_ps(_mm_mul_ps(A[k], px), RowE[k]);
+				const __m128 Inside = _mm_or_ps(_mm_cmpgt_ps(E[k], kZero), _mm_and_ps(_mm_cmpeq_ps(E[k], kZero), Tie[k]));
+				Mask = _mm_and_ps(Mask, Inside);
+			}
+
+			int32_t Bits = _mm_movemask_ps(Mask);
+			if (!Bits)
+			{
+				continue;
+			}
+
+			const __m128 b0 = _mm_mul_ps(E[0], kInvArea);
+			const __m128 b1 = _mm_mul_ps(E[1], kInvArea);
+			const __m128 b2 = _mm_mul_ps(E[2], kInvArea);
+			__m128 Z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b0, kVZ0), _mm_mul_ps(b1, kVZ1)), _mm_add_ps(_mm_mul_ps(b2, kVZ2), kOffset));
+			Z = _mm_min_ps(_mm_max_ps(Z, kZero), kOne);
+
+			if (bEarlyDepth)
+			{
+				const __m128 Depth = _mm_loadu_ps(&Target->DepthBuffer[(size_t)y * Target->Pitch + x]);
+				Bits &= _mm_movemask_ps(CompareDepth4(kDepthFunc, Z, Depth));
+				if (!Bits)
+				{
+					continue;
+				}
+			}
+
+			_mm_store_ps(LaneZ, Z);
+			_mm_store_ps(LaneB0, b0);
+			_mm_store_ps(LaneB1, b1);
+			_mm_store_ps(LaneB2, b2);
+			for (int32_t Lane = 0; Lane < 4; Lane++)
+			{
+				if (Bits & (1 << Lane))
+				{
+					Samples += ShadeFragment(InDraw, InPrim, x + Lane, y, LaneZ[Lane], LaneB0[Lane], LaneB1[Lane], LaneB2[Lane], bEarlyDepth) ? 1 : 0;
+				}
+			}
+		} // end for x
+	} // end for y
+#else
+	for (int32_t y = kMinY; y <= kMaxY; y++)
+	{
+		const float py = y + 0.5f;
+		for (int32_t x = kMinX; x <= kMaxX; x++)
+		{
+			const float px = x + 0.5f;
+
+			float E[3];
+			bool bInside = true;
+			for (uint32_t k = 0; k < 3 && bInside; k++)
+			{
+				E[k] = InPrim.EdgeA[k] * px + InPrim.EdgeB[k] * py + InPrim.EdgeC[k];
+				bInside = E[k] > 0.f || (E[k] == 0.f && InPrim.EdgeTie[k]);
+			}
+			if (!bInside)
+			{
+				continue;
+			}
+
+			const float b0 = E[0] * InPrim.InvArea, b1 = E[1] * InPrim.InvArea, b2 = E[2] * InPrim.InvArea;
+			float z = b0 * kZ0 + b1 * kZ1 + b2 * kZ2 + InPrim.DepthOffset;
+			z = z < 0.f ? 0.f : (z > 1.f ? 1.f : z);
+
+			if (bEarlyDepth && !CompareValue(kDepthFunc, z, Target->DepthBuffer[(size_t)y * Target->Pitch + x]))
+			{
+				continue;
+			}
+
+			Samples += ShadeFragment(InDraw, InPrim, x, y, z, b0, b1, b2, bEarlyDepth) ? 1 : 0;
+		} // end for x
+	} // end for y
+#endif
+	return Samples;
+}
+
+uint32_t FSoftwareRasterizer::RasterizeLine(const FRasterPrimitive &InPrim, const FDrawRecord &InDraw, const FTileRect &InRect)
+{
+	const int32_t kMinX = (std::max)(InPrim.MinX, InRect.MinX);
+	const int32_t kMinY = (std::max)(InPrim.MinY, InRect.MinY);
+	const int32_t kMaxX = (std::min)(InPrim.MaxX, InRect.MaxX);
+	const int32_t kMaxY = (std::min)(InPrim.MaxY, InRect.MaxY);
+	if (kMinX > kMaxX || kMinY > kMaxY)
+	{
+		return 0;
+	}
+
+	const FRasterVertex &P0 = Vertices[InPrim.V[0]];
+	const FRasterVertex &P1 = Vertices[InPrim.V[1]];
+	const float kDx = P1.X - P0.X, kDy = P1.Y - P0.Y;
+	const int32_t kSteps = (std::max)(1, (int32_t)std::ceil((std::max)(std::fabs(kDx), std::fabs(kDy))));
+
+	// only walk the part of the line inside this tile
+	float t0 = 0.f, t1 = 1.f;
+	const float kLow[2] = { (float)kMinX, (float)kMinY };
+	const float kHigh[2] = { (float)(kMaxX + 1), (float)(kMaxY + 1) };
+	const float kStart[2] = { P0.X, P0.Y };
+	const float kDelta[2] = { kDx, kDy };
+	for (uint32_t Axis = 0; Axis < 2; Axis++)
+	{
+		if (kDelta[Axis] != 0.f)
+		{
+			float ta = (kLow[Axis] - kStart[Axis]) / kDelta[Axis];
+			float tb = (kHigh[Axis] - kStart[Axis]) / kDelta[Axis];
+			if (ta > tb)
+			{
+				std::swap(ta, tb);
+			}
+			t0 = (std::max)(t0, ta);
+			t1 = (std::min)(t1, tb);
+		}
+	}
+	if (t0 > t1)
+	{
+		return 0;
+	}
+
+	const int32_t kFirst = (std::max)(0, (int32_t)std::floor(t0 * kSteps));
+	const int32_t kLast = (std::min)(kSteps, (int32_t)std::ceil(t1 * kSteps));
+	uint32_t Samples = 0;
+	for (int32_t Step = kFirst; Step <= kLast; Step++)
+	{
+		const float t = (float)Step / kSteps;
+		const int32_t x = (int32_t)std::floor(P0.X + kDx * t);
+		const int32_t y = (int32_t)std::floor(P0.Y + kDy * t);
+		if (x < kMinX || x > kMaxX || y < kMinY || y > kMaxY)
+		{
+			continue;
+		}
+
+		const float z = P0.Z + (P1.Z - P0.Z) * t;
+		Samples += ShadeFragment(InDraw, InPrim, x, y, z, 1.f - t, t, 0.f, false) ? 1 : 0;
+	}
+	return Samples;
+}
+
+uint32_t FSoftwareRasterizer::RasterizePoint(const FRasterPrimitive &InPrim, const FDrawRecord &InDraw, const FTileRect &InRect)
+{
+	if (InPrim.MinX < InRect.MinX || InPrim.MinX > InRect.MaxX || InPrim.MinY < InRect.MinY || InPrim.MinY > InRect.MaxY)
+	{
+		return 0;
+	}
+
+	return ShadeFragment(InDraw, InPrim, InPrim.MinX, InPrim.MinY, Vertices[InPrim.V[0]].Z, 1.f, 0.f, 0.f, false) ? 1 : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Pixels
+bool FSoftwareRasterizer::ShadeFragment(const FDrawRecord &InDraw, const FRasterPrimitive &InPrim, int32_t x, int32_t y, float z, float b0, float b1, float b2, bool bDepthTested)
+{
+	const size_t kPixel = (size_t)y * Target->Pitch + x;
+	const FSoftwareDrawState &State = InDraw.State;
+	const FRasterVertex &V0 = Vertices[InPrim.V[0]];
+	const FRasterVertex &V1 = Vertices[InPrim.V[1]];
+	const FRasterVertex &V2 = Vertices[InPrim.V[2]];
+
+	// perspective-correct varyings
+	FSoftwarePixelInput Pixel;
+	const float InvW = b0 * V0.InvW + b1 * V1.InvW + b2 * V2.InvW;
+	const float W = InvW != 0.f ? 1.f / InvW : 0.f;
+	for (uint32_t k = 0; k < State.VaryingsNum; k++)
+	{
+		Pixel.Varyings[k] = (b0 * V0.Varyings[k] + b1 * V1.Varyings[k] + b2 * V2.Varyings[k]) * W;
+	}
+	Pixel.FragCoord[0] = x + 0.5f;
+	Pixel.FragCoord[1] = y + 0.5f;
+	Pixel.FragCoord[2] = z;
+	Pixel.FragCoord[3] = InvW;
+	Pixel.bFrontFacing = InPrim.bFrontFacing;
+
+	FLinearColor Color;
+	if (!State.PixelShader(*State.Uniforms, Pixel, Color))
+	{
+		return false;
+	}
+
+	if (InDraw.bStencilTest)
+	{
+		if (!StencilDepthTest(InDraw, InPrim.bFrontFacing, kPixel, z))
+		{
+			return false;
+		}
+	}
+	else if (InDraw.bDepthTest)
+	{
+		float &Depth = Target->DepthBuffer[kPixel];
+		if (!bDepthTested && !CompareValue(State.DepthStencilState.DepthTestFunc, z, Depth))
+		{
+			return false;
+		}
+		if (InDraw.bDepthWrite)
+		{
+			Depth = z;
+		}
+	}
+
+	WriteColor(InDraw, kPixel, Color);
+	return true;
+}
+
+bool FSoftwareRasterizer::StencilDepthTest(const FDrawRecord &InDraw, bool bFrontFacing, size_t InPixel, float z)
+{
+	const FDepthStencilStateInitializerRHI &DepthStencil = InDraw.State.DepthStencilState;
+	const ECompareFunction kStencilFunc = bFrontFacing ? DepthStencil.FrontFaceStencilTest : DepthStencil.BackFaceStencilTest;
+	const EStencilOp kStencilFailOp = bFrontFacing ? DepthStencil.FrontFaceStencilFailOp : DepthStencil.BackFaceStencilFailOp;
+	const EStencilOp kDepthFailOp = bFrontFacing ? DepthStencil.FrontFaceDepthFailOp : DepthStencil.BackFaceDepthFailOp;
+	const EStencilOp kDepthPassOp = bFrontFacing ? DepthStencil.FrontFaceDepthPassOp : DepthStencil.BackFaceDepthPassOp;
+	const uint8_t kReadMask = (uint8_t)DepthStencil.StencilReadMask;
+	const uint8_t kWriteMask = (uint8_t)DepthStencil.StencilWriteMask;
+	const uint8_t kRef = (uint8_t)InDraw.State.StencilRef;
+
+	uint8_t &Stencil = Target->StencilBuffer[InPixel];
+	float &Depth = Target->DepthBuffer[InPixel];
+
+	EStencilOp Op = kDepthPassOp;
+	bool bPassed = false;
+	if (!CompareStencil(kStencilFunc, kRef & kReadMask, Stencil & kReadMask))
+	{
+		Op = kStencilFailOp;
+	}
+	else if (InDraw.bDepthTest && !CompareValue(DepthStencil.DepthTestFunc, z, Depth))
+	{
+		Op = kDepthFailOp;
+	}
+	else
+	{
+		bPassed = true;
+		if (InDraw.bDepthWrite)
+		{
+			Depth = z;
+		}
+	}
+
+	const uint8_t kNewStencil = ApplyStencilOp(Op, Stencil, kRef);
+	Stencil = (Stencil & ~kWriteMask) | (kNewStencil & kWriteMask);
+	return bPassed;
+}
+
+void FSoftwareRasterizer::WriteColor(const FDrawRecord &InDraw, size_t InPixel, const FLinearColor &InColor)
+{
+	uint32_t &Dest = Target->ColorBuffer[InPixel];
+	if (InDraw.ColorWriteMask == 0)
+	{
+		return;
+	}
+
+	uint32_t Packed;
+	if (!InDraw.bBlend)
+	{
+		Packed = PackColor(InColor);
+	}
+	else
+	{
+		const FBlendStateInitializerRHI::FRenderTargetBlendState &Blend = InDraw.State.BlendState;
+		const FLinearColor DstColor = UnpackColor(Dest);
+
+		float ColorSrcFactor[4], ColorDstFactor[4], AlphaSrcFactor[4], AlphaDstFactor[4];
+		GetBlendFactor(Blend.ColorSrcFactor, InColor, DstColor, InDraw.State.BlendColor, ColorSrcFactor);
+		GetBlendFactor(Blend.ColorDstFactor, InColor, DstColor, InDraw.State.BlendColor, ColorDstFactor);
+		GetBlendFactor(Blend.AlphaSrcFactor, InColor, DstColor, InDraw.State.BlendColor, AlphaSrcFactor);
+		GetBlendFactor(Blend.AlphaDstFactor, InColor, DstColor, InDraw.State.BlendColor, AlphaDstFactor);
+
+		FLinearColor Result;
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			Result.RGBA[k] = ApplyBlendOp(Blend.ColorBlendOp, InColor.RGBA[k], ColorSrcFactor[k], DstColor.RGBA[k], ColorDstFactor[k]);
+		}
+		Result.A = ApplyBlendOp(Blend.AlphaBlendOp, InColor.A, AlphaSrcFactor[3], DstColor.A, AlphaDstFactor[3]);
+		Packed = PackColor(Result);
+	}
+
+	Dest = (Dest & ~InDraw.ColorWriteMask) | (Packed & InDraw.ColorWriteMask);
+}
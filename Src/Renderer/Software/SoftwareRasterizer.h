@@ -0,0 +1,173 @@
+//\brief
+//		Software Rasterizer: tile binning and parallel tile shading.
+//
+
+#ifndef __JETX_SOFTWARE_RASTERIZER_H__
+#define __JETX_SOFTWARE_RASTERIZER_H__
+
+#include <vector>
+#include <atomic>
+#include "Foundation/JetX.h"
+#include "Foundation/JobSystem.h"
+#include "Renderer/RendererDefs.h"
+#include "Renderer/RendererState.h"
+#include "SoftwareResource.h"
+#include "SoftwareShader.h"
+
+
+// pipeline states of a draw
+struct FSoftwareDrawState
+{
+	FRasterizerStateInitializerRHI		RasterizerState;
+	FDepthStencilStateInitializerRHI	DepthStencilState;
+	int32_t								StencilRef;
+	FBlendStateInitializerRHI::FRenderTargetBlendState	BlendState;
+	FLinearColor						BlendColor;
+
+	int32_t		ViewportX;
+	int32_t		ViewportY;
+	int32_t		ViewportWidth;
+	int32_t		ViewportHeight;
+	float		MinZ;
+	float		MaxZ;
+
+	FSoftwarePixelShaderFunc	PixelShader;
+	FSoftwareUniformBlockRef	Uniforms;
+	uint32_t					VaryingsNum;
+
+	// the samples passing the tests are added to it, null if no occlusion query is active.
+	std::atomic<uint64_t>		*SamplesPassed;
+};
+
+// FSoftwareRasterizer
+// primitives are clipped, set up and binned into tiles on the calling thread,
+// Flush() shades the tiles in parallel. the order of the primitives is kept in every tile.
+class FSoftwareRasterizer
+{
+public:
+	FSoftwareRasterizer();
+	~FSoftwareRasterizer();
+
+	// InThreadsNum: worker threads besides the calling one, if the shared job system is not running yet.
+	void Init(uint32_t InThreadsNum);
+	void Shutdown();
+
+	FJobSystem* GetJobSystem() const { return JobSystem; }
+
+	// flush the pending work of the previous target.
+	void SetRenderTarget(FRHISoftwareViewport *InTarget);
+	FRHISoftwareViewport* GetRenderTarget() const { return Target; }
+
+	// clear the whole target as glClear without scissor.
+	void Clear(bool bClearColor, const FLinearColor &InColor, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil);
+
+	// the next primitives use the states of InState.
+	void BeginDraw(const FSoftwareDrawState &InState);
+	void SubmitTriangle(const FSoftwareVertexOutput &V0, const FSoftwareVertexOutput &V1, const FSoftwareVertexOutput &V2);
+	void SubmitLine(const FSoftwareVertexOutput &V0, const FSoftwareVertexOutput &V1);
+	void SubmitPoint(const FSoftwareVertexOutput &V0);
+
+	// shade all the binned work into the target.
+	void Flush();
+
+protected:
+	// screen space vertex, the varyings are pre-multiplied by InvW.
+	struct FRasterVertex
+	{
+		float	X, Y, Z, InvW;
+		float	Varyings[MaxSoftwareVaryings];
+	};
+
+	enum EPrimitiveKind
+	{
+		PK_Triangle,
+		PK_Line,
+		PK_Point
+	};
+
+	struct FRasterPrimitive
+	{
+		uint32_t	Kind;
+		uint32_t	DrawIndex;
+		uint32_t	V[3];
+		bool		bFrontFacing;
+		int32_t		MinX, MinY, MaxX, MaxY;	// inclusive pixels
+
+		// triangles: edge i is opposite to V[i], E = A*x + B*y + C, inside when positive.
+		float		EdgeA[3];
+		float		EdgeB[3];
+		float		EdgeC[3];
+		bool		EdgeTie[3];	// the edge owns the pixels exactly on it (top-left rule)
+		float		InvArea;
+		float		DepthOffset;
+	};
+
+	struct FDrawRecord
+	{
+		FSoftwareDrawState	State;
+
+		int32_t		ClipMinX, ClipMinY, ClipMaxX, ClipMaxY;
+		bool		bCullFront;
+		bool		bCullBack;
+		bool		bDepthTest;
+		bool		bDepthWrite;
+		bool		bStencilTest;
+		bool		bBlend;
+		uint32_t	ColorWriteMask;		// mask of the packed RGBA8 color
+	};
+
+	struct FClearRecord
+	{
+		bool		bClearColor;
+		uint32_t	Color;
+		bool		bClearDepth;
+		float		Depth;
+		bool		bClearStencil;
+		uint8_t		Stencil;
+	};
+
+	struct FTileRect
+	{
+		int32_t		MinX, MinY, MaxX, MaxY;	// inclusive
+	};
+
+	// a tile command is (Index << 1) | IsClear
+	typedef std::vector<uint32_t>	FTileBin;
+
+	// setup
+	FRasterVertex ToRasterVertex(const FSoftwareVertexOutput &InVertex, const FDrawRecord &InDraw) const;
+	void SetupTriangle(uint32_t I0, uint32_t I1, uint32_t I2);
+	void AddLine(uint32_t I0, uint32_t I1, bool bFrontFacing);
+	void AddPoint(uint32_t I0, bool bFrontFacing);
+	void BinPrimitive(uint32_t InPrimitiveIndex);
+	void FlushIfFull();
+
+	// tiles
+	void RasterizeTile(uint32_t InTileIndex);
+	void ClearTile(const FClearRecord &InClear, const FTileRect &InRect);
+	// return the samples which passed the tests
+	uint32_t RasterizeTriangle(const FRasterPrimitive &InPrim, const FDrawRecord &InDraw, const FTileRect &InRect);
+	uint32_t RasterizeLine(const FRasterPrimitive &InPrim, const FDrawRecord &InDraw, const FTileRect &InRect);
+	uint32_t RasterizePoint(const FRasterPrimitive &InPrim, const FDrawRecord &InDraw, const FTileRect &InRect);
+
+	// per-pixel: pixel shader, depth-stencil and blending
+	// return false if the fragment is discarded or fails the tests.
+	bool ShadeFragment(const FDrawRecord &InDraw, const FRasterPrimitive &InPrim, int32_t x, int32_t y, float z, float b0, float b1, float b2, bool bDepthTested);
+	bool StencilDepthTest(const FDrawRecord &InDraw, bool bFrontFacing, size_t InPixel, float z);
+	void WriteColor(const FDrawRecord &InDraw, size_t InPixel, const FLinearColor &InColor);
+
+	FJobSystem					*JobSystem;
+	FRHISoftwareViewport		*Target;
+	uint32_t					TilesX;
+	uint32_t					TilesY;
+
+	std::vector<FRasterVertex>		Vertices;
+	std::vector<FRasterPrimitive>	Primitives;
+	std::vector<FDrawRecord>		Draws;
+	std::vector<FClearRecord>		Clears;
+	std::vector<FTileBin>			Bins;
+	std::vector<uint32_t>			ActiveTiles;
+	bool							bInDraw;
+};
+
+#endif // __JETX_SOFTWARE_RASTERIZER_H__
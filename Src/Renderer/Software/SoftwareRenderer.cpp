@@ -0,0 +1,1114 @@
+// \brief
+//		Software Renderer implementation.
+//
+
+#include <cassert>
+#include <thread>
+#include <algorithm>
+#include "SoftwareRenderer.h"
+
+
+// the vertex shader runs in parallel for the draws with more vertices
+static const uint32_t kParallelVerticesBatch = 256;
+
+// expand a vertex element to float4, same conversions as the OpenGL vertex declaration.
+static void FetchVertexElement(EVertexElementType InType, const uint8_t *InSrc, float *OutValue)
+{
+	OutValue[0] = OutValue[1] = OutValue[2] = 0.f;
+	OutValue[3] = 1.f;
+
+	switch (InType)
+	{
+	case VET_Float1:
+	case VET_Float2:
+	case VET_Float3:
+	case VET_Float4:
+		::memcpy(OutValue, InSrc, sizeof(float) * (InType - VET_Float1 + 1));
+		break;
+	case VET_PackedNormal:
+	case VET_UByte4N:
+	case VET_Color:
+		for (uint32_t k = 0; k < 4; k++) { OutValue[k] = InSrc[k] * (1.f / 255.f); }
+		break;
+	case VET_UByte4:
+		for (uint32_t k = 0; k < 4; k++) { OutValue[k] = (float)InSrc[k]; }
+		break;
+	case VET_Short2:
+	case VET_Short4:
+	{
+		int16_t Values[4];
+		const uint32_t kCount = InType == VET_Short2 ? 2 : 4;
+		::memcpy(Values, InSrc, sizeof(int16_t) * kCount);
+		for (uint32_t k = 0; k < kCount; k++) { OutValue[k] = (float)Values[k]; }
+		break;
+	}
+	case VET_Short2N:
+	case VET_Short4N:
+	{
+		int16_t Values[4];
+		const uint32_t kCount = InType == VET_Short2N ? 2 : 4;
+		::memcpy(Values, InSrc, sizeof(int16_t) * kCount);
+		for (uint32_t k = 0; k < kCount; k++) { OutValue[k] = (std::max)(Values[k] * (1.f / 32767.f), -1.f); }
+		break;
+	}
+	case VET_Half2:
+	case VET_Half4:
+	{
+		uint16_t Values[4];
+		const uint32_t kCount = InType == VET_Half2 ? 2 : 4;
+		::memcpy(Values, InSrc, sizeof(uint16_t) * kCount);
+		for (uint32_t k = 0; k < kCount; k++) { OutValue[k] = HalfToFloat(Values[k]); }
+		break;
+	}
+	case VET_UShort2:
+	case VET_UShort4:
+	case VET_UShort2N:
+	case VET_UShort4N:
+	{
+		uint16_t Values[4];
+		const uint32_t kCount = (InType == VET_UShort2 || InType == VET_UShort2N) ? 2 : 4;
+		const float kScale = (InType == VET_UShort2N || InType == VET_UShort4N) ? (1.f / 65535.f) : 1.f;
+		::memcpy(Values, InSrc, sizeof(uint16_t) * kCount);
+		for (uint32_t k = 0; k < kCount; k++) { OutValue[k] = Values[k] * kScale; }
+		break;
+	}
+	case VET_URGB10A2N:
+	{
+		uint32_t Packed;
+		::memcpy(&Packed, InSrc, sizeof(Packed));
+		OutValue[0] = (Packed & 0x3FF) * (1.f / 1023.f);
+		OutValue[1] = ((Packed >> 10) & 0x3FF) * (1.f / 1023.f);
+		OutValue[2] = ((Packed >> 20) & 0x3FF) * (1.f / 1023.f);
+		OutValue[3] = (Packed >> 30) * (1.f / 3.f);
+		break;
+	}
+	case VET_Int1:
+	case VET_Int2:
+	case VET_Int3:
+	case VET_Int4:
+	{
+		int32_t Values[4];
+		const uint32_t kCount = InType - VET_Int1 + 1;
+		::memcpy(Values, InSrc, sizeof(int32_t) * kCount);
+		for (uint32_t k = 0; k < kCount; k++) { OutValue[k] = (float)Values[k]; }
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+static uint32_t GetVertexElementBytes(EVertexElementType InType)
+{
+	switch (InType)
+	{
+	case VET_Float1:		return 4;
+	case VET_Float2:		return 8;
+	case VET_Float3:		return 12;
+	case VET_Float4:		return 16;
+	case VET_Short4:
+	case VET_Half4:
+	case VET_Short4N:
+	case VET_UShort4:
+	case VET_UShort4N:
+	case VET_Int2:			return 8;
+	case VET_Int3:			return 12;
+	case VET_Int4:			return 16;
+	case VET_None:
+	case VET_MAX:			return 0;
+	default:
+		return 4;
+	}
+}
+
+FSoftwareRenderer::FSoftwareRenderer(uint32_t InWorkerThreads)
+	: Logger(nullptr)
+	, WorkerThreads(InWorkerThreads)
+	, TransientVertexHead(0)
+	, bInConditionalRender(false)
+	, bConditionalDiscard(false)
+{
+	TransientIndexHeads[0] = TransientIndexHeads[1] = 0;
+	if (WorkerThreads == ~0u)
+	{
+		const uint32_t kCores = std::thread::hardware_concurrency();
+		WorkerThreads = kCores > 1 ? kCores - 1 : 0;
+	}
+}
+
+FSoftwareRenderer::~FSoftwareRenderer()
+{
+	Rasterizer.Shutdown();
+}
+
+//Init
+void FSoftwareRenderer::Init(FOutputDevice *LogOutputDevice)
+{
+	Logger = LogOutputDevice;
+	Rasterizer.Init(WorkerThreads);
+
+	RenderContext.ViewportBox.x = RenderContext.ViewportBox.y = 0;
+	RenderContext.ViewportBox.width = RenderContext.ViewportBox.height = 0;
+	RenderContext.ViewportBox.zMin = 0.f;
+	RenderContext.ViewportBox.zMax = 1.f;
+
+	// same defaults as the OpenGL renderer
+	RHISetRasterizerState(RHICreateRasterizerState(FRasterizerStateInitializerRHI(FM_Solid)));
+	RHISetDepthStencilState(RHICreateDepthStencilState(FDepthStencilStateInitializerRHI(true)), 0);
+
+	FBlendStateInitializerRHI::FRenderTargetBlendState TargetBlend;
+	RHISetBlendState(RHICreateBlendState(FBlendStateInitializerRHI(TargetBlend)), FLinearColor(0.f, 0.f, 0.f, 0.f));
+
+	FRHISamplerStateRef SamplerState = RHICreateSamplerState(FSamplerStateInitializerRHI(SF_Bilinear));
+	for (uint32_t k = 0; k < MaxTextureUnits; k++)
+	{
+		RHISetSamplerState(k, SamplerState);
+	} // end for k
+}
+
+void FSoftwareRenderer::Shutdown()
+{
+	Rasterizer.Shutdown();
+
+	RenderContext = FRenderContext();
+	ViewportDrawing.SafeRelease();
+	TransformedVertices.clear();
+
+	TransientVertexBuffer.SafeRelease();
+	TransientIndexBuffers[0].SafeRelease();
+	TransientIndexBuffers[1].SafeRelease();
+	ActiveOcclusionQuery.SafeRelease();
+	bInConditionalRender = bConditionalDiscard = false;
+}
+
+//Capabilities
+void FSoftwareRenderer::DumpCapabilities()
+{
+	if (Logger)
+	{
+		Logger->Log(Log_Info, "Software Renderer Capabilities:");
+		Logger->Log(Log_Info, "Threads: %u", Rasterizer.GetJobSystem()->GetConcurrency());
+		Logger->Log(Log_Info, "TileSize: %d", SoftwareTileSize);
+		Logger->Log(Log_Info, "MaxVaryings: %d", MaxSoftwareVaryings);
+		Logger->Log(Log_Info, "MaxVertexStreamSources: %d", MaxVertexStreamSources);
+		Logger->Log(Log_Info, "MaxVertexAttributes: %d", MaxVertexAttributes);
+	}
+}
+
+//render viewport
+FRHIViewportRef FSoftwareRenderer::RHICreateViewport(void* InWindowHandle, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen)
+{
+	return new FRHISoftwareViewport(InWindowHandle, SizeX, SizeY, bIsFullscreen);
+}
+
+void FSoftwareRenderer::RHIResizeViewport(FRHIViewportRef InViewport, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen)
+{
+	FRHISoftwareViewport *Viewport = dynamic_cast<FRHISoftwareViewport*>(InViewport.DeRef());
+	if (!Viewport)
+	{
+		return;
+	}
+
+	if (Viewport == Rasterizer.GetRenderTarget())
+	{
+		Rasterizer.Flush();
+		Viewport->Resize(SizeX, SizeY, bIsFullscreen);
+		Rasterizer.SetRenderTarget(Viewport);
+	}
+	else
+	{
+		Viewport->Resize(SizeX, SizeY, bIsFullscreen);
+	}
+}
+
+bool FSoftwareRenderer::RHIGetAvailableResolutions(FScreenResolutionArray& Resolutions, bool bIgnoreRefreshRate)
+{
+	FScreenResolution Resolution;
+	Resolution.Width = 1920;
+	Resolution.Height = 1080;
+	Resolution.RefreshRate = bIgnoreRefreshRate ? 0 : 60;
+
+	Resolutions.clear();
+	Resolutions.push_back(Resolution);
+	return true;
+}
+
+void FSoftwareRenderer::RHIGetSupportedResolution(uint32_t& Width, uint32_t& Height)
+{
+	// any resolution is fine
+}
+
+//Resource Creating
+FRHISamplerStateRef FSoftwareRenderer::RHICreateSamplerState(const FSamplerStateInitializerRHI &SamplerStateInitializer)
+{
+	return new FRHISoftwareSamplerState(SamplerStateInitializer);
+}
+
+FRHIRasterizerStateRef FSoftwareRenderer::RHICreateRasterizerState(const FRasterizerStateInitializerRHI &RasterizerStateInitializer)
+{
+	return new FRHISoftwareRasterizerState(RasterizerStateInitializer);
+}
+
+FRHIDepthStencilStateRef FSoftwareRenderer::RHICreateDepthStencilState(const FDepthStencilStateInitializerRHI &DepthStencilStateInitializer)
+{
+	return new FRHISoftwareDepthStencilState(DepthStencilStateInitializer);
+}
+
+FRHIBlendStateRef FSoftwareRenderer::RHICreateBlendState(const FBlendStateInitializerRHI &BlendStateInitializer)
+{
+	return new FRHISoftwareBlendState(BlendStateInitializer);
+}
+
+// data buffers
+FRHIVertexBufferRef FSoftwareRenderer::RHICreateVertexBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess, EBufferUsage InUsage)
+{
+	FRHISoftwareVertexBuffer *VBuffer = new FRHISoftwareVertexBuffer();
+	if (VBuffer->Initialize(InBytes, InData))
+	{
+		return VBuffer;
+	}
+
+	delete VBuffer;
+	return FRHIVertexBufferRef();
+}
+
+FRHIIndexBufferRef FSoftwareRenderer::RHICreateIndexBuffer(uint32_t InBytes, const void *InData, uint16_t InStride, EBufferAccess InAccess, EBufferUsage InUsage)
+{
+	FRHISoftwareIndexBuffer *IBuffer = new FRHISoftwareIndexBuffer();
+	if (IBuffer->Initialize(InBytes, InData, InStride))
+	{
+		return IBuffer;
+	}
+
+	delete IBuffer;
+	return FRHIIndexBufferRef();
+}
+
+FRHIIndirectBufferRef FSoftwareRenderer::RHICreateIndirectBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess)
+{
+	FRHISoftwareIndirectBuffer *ArgsBuffer = new FRHISoftwareIndirectBuffer();
+	if (ArgsBuffer->Initialize(InBytes, InData))
+	{
+		return ArgsBuffer;
+	}
+
+	delete ArgsBuffer;
+	return FRHIIndirectBufferRef();
+}
+
+// the vertices are transformed when the draw is issued, so the buffers can be
+// modified at any time without waiting for the rasterizer.
+void FSoftwareRenderer::FillDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, const void *InData)
+{
+	FSoftwareBuffer *SoftwareBuffer = dynamic_cast<FSoftwareBuffer*>(InBuffer.DeRef());
+	if (SoftwareBuffer)
+	{
+		SoftwareBuffer->FillData(InOffset, InBytes, InData);
+	}
+}
+
+void* FSoftwareRenderer::LockDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, EBufferLockMode InMode)
+{
+	FSoftwareBuffer *SoftwareBuffer = dynamic_cast<FSoftwareBuffer*>(InBuffer.DeRef());
+	return SoftwareBuffer ? SoftwareBuffer->Lock(InOffset, InBytes, InMode) : nullptr;
+}
+
+void FSoftwareRenderer::UnLockDataBuffer(FRHIDataBufferRef InBuffer)
+{
+	FSoftwareBuffer *SoftwareBuffer = dynamic_cast<FSoftwareBuffer*>(InBuffer.DeRef());
+	if (SoftwareBuffer)
+	{
+		SoftwareBuffer->UnLock();
+	}
+}
+
+void FSoftwareRenderer::FlushDataBufferRange(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes)
+{
+	// the locked memory is the buffer itself, the draws are done by the time it is locked again.
+}
+
+// uniform buffers, all of them live in system memory whatever the access.
+FRHIUniformBufferRef FSoftwareRenderer::RHICreateUniformBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess)
+{
+	FRHISoftwareUniformBuffer *UBuffer = new FRHISoftwareUniformBuffer();
+	if (UBuffer->Initialize(InBytes, InData))
+	{
+		return UBuffer;
+	}
+
+	delete UBuffer;
+	return FRHIUniformBufferRef();
+}
+
+void FSoftwareRenderer::RHIUpdateUniformBuffer(const FRHIUniformBufferRef &InBuffer, const void *InData)
+{
+	FRHISoftwareUniformBuffer *SoftwareBuffer = dynamic_cast<FRHISoftwareUniformBuffer*>(InBuffer.DeRef());
+	if (SoftwareBuffer && InData)
+	{
+		SoftwareBuffer->Update(InData);
+	}
+}
+
+// textures, the texels are kept as linear float4 whatever the format.
+bool FSoftwareRenderer::ValidateTextureDesc(const char *InKind, uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat)
+{
+	if (InSizeX == 0 || InSizeY == 0 || InLayers == 0 || InMips > GetFullMipsNum(InSizeX, InSizeY) || GetPixelFormatBytes(InFormat) == 0)
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "failed to create a %s of %ux%ux%u, %u mips, format %d", InKind, InSizeX, InSizeY, InLayers, InMips, (int32_t)InFormat);
+		}
+		return false;
+	}
+	return true;
+}
+
+FRHITexture2DRef FSoftwareRenderer::RHICreateTexture2D(uint32_t InSizeX, uint32_t InSizeY, uint32_t InMips, EPixelFormat InFormat)
+{
+	const uint32_t kMips = InMips > 0 ? InMips : GetFullMipsNum(InSizeX, InSizeY);
+	if (!ValidateTextureDesc("texture2d", InSizeX, InSizeY, 1, kMips, InFormat))
+	{
+		return FRHITexture2DRef();
+	}
+	return new FRHISoftwareTexture2D(InSizeX, InSizeY, kMips, InFormat);
+}
+
+FRHITexture2DArrayRef FSoftwareRenderer::RHICreateTexture2DArray(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat)
+{
+	const uint32_t kMips = InMips > 0 ? InMips : GetFullMipsNum(InSizeX, InSizeY);
+	if (!ValidateTextureDesc("texture2d array", InSizeX, InSizeY, InLayers, kMips, InFormat))
+	{
+		return FRHITexture2DArrayRef();
+	}
+	return new FRHISoftwareTexture2DArray(InSizeX, InSizeY, InLayers, kMips, InFormat);
+}
+
+FRHITextureCubeRef FSoftwareRenderer::RHICreateTextureCube(uint32_t InSize, uint32_t InMips, EPixelFormat InFormat)
+{
+	const uint32_t kMips = InMips > 0 ? InMips : GetFullMipsNum(InSize, InSize);
+	if (!ValidateTextureDesc("texture cube", InSize, InSize, CubeFace_MAX, kMips, InFormat))
+	{
+		return FRHITextureCubeRef();
+	}
+	return new FRHISoftwareTextureCube(InSize, kMips, InFormat);
+}
+
+void FSoftwareRenderer::RHIUpdateTexture(const FRHITextureRef &InTexture, uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData)
+{
+	FSoftwareTexture *SoftwareTexture = dynamic_cast<FSoftwareTexture*>(InTexture.DeRef());
+	if (!SoftwareTexture || !InData)
+	{
+		return;
+	}
+	if (InMip >= InTexture->GetNumMips() || InLayer >= InTexture->GetSizeZ()
+		|| InX + InWidth > GetMipSize(InTexture->GetSizeX(), InMip) || InY + InHeight > GetMipSize(InTexture->GetSizeY(), InMip))
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "texture update (%u,%u %ux%u) of mip %u layer %u is out of the texture", InX, InY, InWidth, InHeight, InMip, InLayer);
+		}
+		return;
+	}
+
+	// the draws queued in the rasterizer keep the contents they were issued with.
+	SoftwareTexture->Update(InMip, InLayer, InX, InY, InWidth, InHeight, InData);
+}
+
+void FSoftwareRenderer::RHIGenerateMips(const FRHITextureRef &InTexture)
+{
+	FSoftwareTexture *SoftwareTexture = dynamic_cast<FSoftwareTexture*>(InTexture.DeRef());
+	if (SoftwareTexture)
+	{
+		SoftwareTexture->GenerateMips();
+	}
+}
+
+// render targets
+FRHIRenderBufferRef FSoftwareRenderer::RHICreateRenderBuffer(uint32_t InSizeX, uint32_t InSizeY, EPixelFormat InFormat, uint32_t InSamples)
+{
+	if (InSamples == 0 || !ValidateTextureDesc("render buffer", InSizeX, InSizeY, 1, 1, InFormat))
+	{
+		return FRHIRenderBufferRef();
+	}
+	return new FRHISoftwareRenderBuffer(InSizeX, InSizeY, InFormat, InSamples);
+}
+
+FRHIFrameBufferRef FSoftwareRenderer::RHICreateFrameBuffer(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget)
+{
+	const char *Error = CheckFrameBufferTargets(InColorTargets, InColorTargetsNum, InDepthStencilTarget);
+	if (!Error && InColorTargetsNum > 1)
+	{
+		Error = "only one color target is rasterized";
+	}
+	if (Error)
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "failed to create a frame buffer: %s", Error);
+		}
+		return FRHIFrameBufferRef();
+	}
+	return new FRHISoftwareFrameBuffer(InColorTargets, InColorTargetsNum, InDepthStencilTarget);
+}
+
+// queries
+FRHIOcclusionQueryRef FSoftwareRenderer::RHICreateOcclusionQuery()
+{
+	return new FRHISoftwareOcclusionQuery();
+}
+
+// transient geometry
+void* FSoftwareRenderer::RHIAllocTransientVertices(uint32_t InBytes, uint32_t InStride, FRHIVertexBufferRef &OutBuffer, uint32_t &OutFirstVertex)
+{
+	if (InStride == 0 || InBytes == 0)
+	{
+		return nullptr;
+	}
+
+	uint32_t Offset = (TransientVertexHead + InStride - 1) / InStride * InStride;
+	if (!TransientVertexBuffer.IsValidRef() || Offset + InBytes > TransientVertexBuffer->GetBytes())
+	{
+		TransientVertexBuffer = new FRHISoftwareVertexBuffer();
+		TransientVertexBuffer->Initialize(std::max<uint32_t>(InBytes, SoftwareTransientVertexBytes), nullptr);
+		Offset = 0;
+	}
+	TransientVertexHead = Offset + InBytes;
+
+	OutBuffer = TransientVertexBuffer.DeRef();
+	OutFirstVertex = Offset / InStride;
+	return TransientVertexBuffer->GetMutableData() + Offset;
+}
+
+void* FSoftwareRenderer::RHIAllocTransientIndices(uint32_t InCount, uint16_t InStride, FRHIIndexBufferRef &OutBuffer, uint32_t &OutFirstIndex)
+{
+	const uint32_t kBytes = InCount * InStride;
+	if ((InStride != sizeof(uint16_t) && InStride != sizeof(uint32_t)) || kBytes == 0)
+	{
+		return nullptr;
+	}
+
+	const uint32_t kStream = InStride == sizeof(uint16_t) ? 0 : 1;
+	FRHISoftwareIndexBufferRef &IndexBuffer = TransientIndexBuffers[kStream];
+	uint32_t Offset = (TransientIndexHeads[kStream] + InStride - 1) / InStride * InStride;
+	if (!IndexBuffer.IsValidRef() || Offset + kBytes > IndexBuffer->GetBytes())
+	{
+		IndexBuffer = new FRHISoftwareIndexBuffer();
+		IndexBuffer->Initialize(std::max<uint32_t>(kBytes, SoftwareTransientIndexBytes), nullptr, InStride);
+		Offset = 0;
+	}
+	TransientIndexHeads[kStream] = Offset + kBytes;
+
+	OutBuffer = IndexBuffer.DeRef();
+	OutFirstIndex = Offset / InStride;
+	return IndexBuffer->GetMutableData() + Offset;
+}
+
+// vertex input layout
+FRHIVertexDeclarationRef FSoftwareRenderer::RHICreateVertexInputLayout(const FVertexElement *InVertexElements, uint32_t InCount)
+{
+	for (uint32_t Index = 0; Index < InCount; Index++)
+	{
+		const FVertexElement &Element = InVertexElements[Index];
+		if (Element.StreamIndex >= MaxVertexStreamSources || Element.AttributeIndex >= MaxVertexAttributes || GetVertexElementBytes(Element.DataType) == 0)
+		{
+			if (Logger)
+			{
+				Logger->Log(Log_Error, "Software Renderer: invalid vertex element %u.", Index);
+			}
+			return FRHIVertexDeclarationRef();
+		}
+	}
+
+	return new FRHISoftwareVertexDeclaration(InVertexElements, InCount);
+}
+
+// shader
+FRHIVertexShaderRef FSoftwareRenderer::RHICreateVertexShader(const char *InSource, int32_t InLength)
+{
+	return new FRHISoftwareVertexShader(InSource, InLength);
+}
+
+FRHIPixelShaderRef FSoftwareRenderer::RHICreatePixelShader(const char *InSource, int32_t InLength)
+{
+	return new FRHISoftwarePixelShader(InSource, InLength);
+}
+
+FRHIGPUProgramRef FSoftwareRenderer::RHICreateGPUProgram(const FRHIVertexShaderRef &InVShader, const FRHIPixelShaderRef &InPShader)
+{
+	std::vector<FRHIShaderRef> Shaders;
+	Shaders.push_back(InVShader.DeRef());
+	Shaders.push_back(InPShader.DeRef());
+
+	return RHICreateGPUProgram(Shaders);
+}
+
+FRHIGPUProgramRef FSoftwareRenderer::RHICreateGPUProgram(const std::vector<FRHIShaderRef> &InShaders)
+{
+	// GLSL can't run here, the program is pass-through until the C++ shaders are installed.
+	FRHISoftwareGPUProgram *GPUProgram = new FRHISoftwareGPUProgram();
+	for (size_t Index = 0; Index < InShaders.size(); Index++)
+	{
+		GPUProgram->AddShader(InShaders[Index]);
+	}
+
+	return GPUProgram;
+}
+
+FRHIGPUProgramRef FSoftwareRenderer::RHICreateSoftwareGPUProgram(FSoftwareVertexShaderFunc InVertexShader, FSoftwarePixelShaderFunc InPixelShader, uint32_t InVaryingsNum)
+{
+	if (!InVertexShader || !InPixelShader)
+	{
+		return FRHIGPUProgramRef();
+	}
+
+	FRHISoftwareGPUProgram *GPUProgram = new FRHISoftwareGPUProgram();
+	GPUProgram->SetShaderFunctions(InVertexShader, InPixelShader, InVaryingsNum);
+	return GPUProgram;
+}
+
+//State Setting
+void FSoftwareRenderer::RHISetSamplerState(uint32_t InTexIndex, const FRHISamplerStateRef &InSamplerState)
+{
+	if (InTexIndex < MaxTextureUnits && InSamplerState.IsValidRef())
+	{
+		RenderContext.TextureSamplers[InTexIndex] = dynamic_cast<FRHISoftwareSamplerState*>(InSamplerState.DeRef());
+	}
+}
+
+void FSoftwareRenderer::RHISetTexture(uint32_t InTexIndex, const FRHITextureRef &InTexture)
+{
+	if (InTexIndex < MaxTextureUnits)
+	{
+		RenderContext.Textures[InTexIndex] = InTexture;
+	}
+}
+
+void FSoftwareRenderer::RHISetRasterizerState(const FRHIRasterizerStateRef &InRasterizerState)
+{
+	if (InRasterizerState.IsValidRef())
+	{
+		RenderContext.RasterizerState = dynamic_cast<FRHISoftwareRasterizerState*>(InRasterizerState.DeRef());
+	}
+}
+
+void FSoftwareRenderer::RHISetDepthStencilState(const FRHIDepthStencilStateRef &InDepthStencilState, int32_t InStencilRef)
+{
+	if (InDepthStencilState.IsValidRef())
+	{
+		RenderContext.DepthStencilState = dynamic_cast<FRHISoftwareDepthStencilState*>(InDepthStencilState.DeRef());
+	}
+	RenderContext.StencilRef = InStencilRef;
+}
+
+void FSoftwareRenderer::RHISetBlendState(const FRHIBlendStateRef &InBlendState, const FLinearColor &InBlendColor)
+{
+	if (InBlendState.IsValidRef())
+	{
+		RenderContext.BlendState = dynamic_cast<FRHISoftwareBlendState*>(InBlendState.DeRef());
+	}
+	RenderContext.BlendColor = InBlendColor;
+}
+
+void FSoftwareRenderer::RHISetFrameBuffer(const FRHIFrameBufferRef &InFrameBuffer)
+{
+	FRHISoftwareFrameBuffer *FrameBuffer = dynamic_cast<FRHISoftwareFrameBuffer*>(InFrameBuffer.DeRef());
+	if (FrameBuffer == RenderContext.FrameBuffer.DeRef())
+	{
+		return;
+	}
+
+	StoreFrameBuffer();
+	RenderContext.FrameBuffer = FrameBuffer;
+	if (FrameBuffer)
+	{
+		FrameBuffer->LoadSurface();
+		Rasterizer.SetRenderTarget(FrameBuffer->GetSurface());
+	}
+	else
+	{
+		Rasterizer.SetRenderTarget(ViewportDrawing);
+	}
+}
+
+void FSoftwareRenderer::RHISetViewport(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight, float InMinZ, float InMaxZ)
+{
+	RenderContext.ViewportBox.x = InX;
+	RenderContext.ViewportBox.y = InY;
+	RenderContext.ViewportBox.width = InWidth;
+	RenderContext.ViewportBox.height = InHeight;
+	RenderContext.ViewportBox.zMin = InMinZ;
+	RenderContext.ViewportBox.zMax = InMaxZ;
+}
+
+void FSoftwareRenderer::RHISetScissorRect(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight)
+{
+	// the scissor test is never enabled by the OpenGL renderer either.
+}
+
+void FSoftwareRenderer::SetVertexStreamSource(uint32_t InStreamIndex, const FRHIVertexBufferRef &InVertexBuffer)
+{
+	if (InStreamIndex < MaxVertexStreamSources)
+	{
+		RenderContext.VertexStreams[InStreamIndex] = dynamic_cast<FRHISoftwareVertexBuffer*>(InVertexBuffer.DeRef());
+	}
+}
+
+void FSoftwareRenderer::SetVertexInputLayout(const FRHIVertexDeclarationRef &InVertexDecl)
+{
+	RenderContext.VertexDecl = dynamic_cast<FRHISoftwareVertexDeclaration*>(InVertexDecl.DeRef());
+}
+
+void FSoftwareRenderer::SetGPUProgram(const FRHIGPUProgramRef &InProgram)
+{
+	RenderContext.GPUProgram = dynamic_cast<FRHISoftwareGPUProgram*>(InProgram.DeRef());
+}
+
+void FSoftwareRenderer::RHISetUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer)
+{
+	if (InBindIndex < MaxUniformBufferBindings)
+	{
+		RenderContext.UniformBuffers[InBindIndex] = dynamic_cast<FRHISoftwareUniformBuffer*>(InBuffer.DeRef());
+	}
+}
+
+//Draw Commands
+void FSoftwareRenderer::RHIBeginDrawingViewport(FRHIViewportRef Viewport)
+{
+	RHISetFrameBuffer(FRHIFrameBufferRef());
+	ViewportDrawing = dynamic_cast<FRHISoftwareViewport*>(Viewport.DeRef());
+	Rasterizer.SetRenderTarget(ViewportDrawing);
+}
+
+void FSoftwareRenderer::RHIEndDrawingViewport(FRHIViewportRef Viewport, bool bPresent, bool bLockToVsync)
+{
+	// nothing to present, the pixels are read back with ReadViewportPixels.
+	Rasterizer.Flush();
+	StoreFrameBuffer();
+	ViewportDrawing.SafeRelease();
+}
+
+void FSoftwareRenderer::RHIBeginFrame()
+{
+}
+
+void FSoftwareRenderer::RHIEndFrame()
+{
+	Rasterizer.Flush();
+	StoreFrameBuffer();
+	const uint32_t kOpenScopes = TimerScopes.EndFrame();
+	if (kOpenScopes > 0 && Logger)
+	{
+		Logger->Log(Log_Warning, "%u timer scopes are still open at the end of the frame", kOpenScopes);
+	}
+
+	TransientVertexHead = 0;
+	TransientIndexHeads[0] = TransientIndexHeads[1] = 0;
+}
+
+void FSoftwareRenderer::RHIClear(bool bClearColor, const FLinearColor &InColor, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil)
+{
+	Rasterizer.Clear(bClearColor, InColor, bClearDepth, InDepth, bClearStencil, InStencil);
+}
+
+void FSoftwareRenderer::RHIClearMRT(bool bClearColor, const FLinearColor *InColors, uint32_t InColorsNum, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil)
+{
+	// only the first color buffer is rasterized
+	const bool bHasColor = bClearColor && InColors && InColorsNum > 0;
+	Rasterizer.Clear(bHasColor, bHasColor ? InColors[0] : FLinearColor(0.f, 0.f, 0.f, 0.f), bClearDepth, InDepth, bClearStencil, InStencil);
+}
+
+void FSoftwareRenderer::RHIResolveFrameBuffer(const FRHIFrameBufferRef &InSource, const FRHIFrameBufferRef &InDest)
+{
+	FRHISoftwareFrameBuffer *Source = dynamic_cast<FRHISoftwareFrameBuffer*>(InSource.DeRef());
+	FRHISoftwareFrameBuffer *Dest = dynamic_cast<FRHISoftwareFrameBuffer*>(InDest.DeRef());
+	if (!Source || !Dest || Source == Dest || Source->GetSizeX() != Dest->GetSizeX() || Source->GetSizeY() != Dest->GetSizeY())
+	{
+		return;
+	}
+
+	// the samples are not kept apart, the resolve is a copy of the targets.
+	StoreFrameBuffer();
+	if (Source->GetColorTargetsNum() > 0 && Dest->GetColorTargetsNum() > 0)
+	{
+		*FRHISoftwareFrameBuffer::GetTargetTexels(Dest->GetColorTarget(0)) = *FRHISoftwareFrameBuffer::GetTargetTexels(Source->GetColorTarget(0));
+	}
+	if (Source->GetDepthStencilTarget().IsValid() && Dest->GetDepthStencilTarget().IsValid())
+	{
+		*FRHISoftwareFrameBuffer::GetTargetTexels(Dest->GetDepthStencilTarget()) = *FRHISoftwareFrameBuffer::GetTargetTexels(Source->GetDepthStencilTarget());
+	}
+	if (Dest == RenderContext.FrameBuffer.DeRef())
+	{
+		Dest->LoadSurface();
+	}
+}
+
+void FSoftwareRenderer::DrawIndexedPrimitive(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount)
+{
+	DrawIndexedPrimitiveInstanced(InIndexBuffer, InMode, InStart, InCount, 1);
+}
+
+void FSoftwareRenderer::DrawIndexedPrimitiveInstanced(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances)
+{
+	FRHISoftwareIndexBuffer *IndexBuffer = dynamic_cast<FRHISoftwareIndexBuffer*>(InIndexBuffer.DeRef());
+	if (!IndexBuffer || (uint64_t)InStart + InCount > IndexBuffer->GetIndexCount())
+	{
+		return;
+	}
+
+	DrawPrimitives(IndexBuffer, InMode, InStart, InCount, InInstances);
+}
+
+void FSoftwareRenderer::DrawArrayedPrimitive(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount)
+{
+	DrawArrayedPrimitiveInstanced(InMode, InStart, InCount, 1);
+}
+
+void FSoftwareRenderer::DrawArrayedPrimitiveInstanced(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances)
+{
+	DrawPrimitives(nullptr, InMode, InStart, InCount, InInstances);
+}
+
+void FSoftwareRenderer::DrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset)
+{
+	MultiDrawIndexedPrimitiveIndirect(InIndexBuffer, InMode, InArgsBuffer, InOffset, 1, 0);
+}
+
+void FSoftwareRenderer::MultiDrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t InStride)
+{
+	FRHISoftwareIndexBuffer *IndexBuffer = dynamic_cast<FRHISoftwareIndexBuffer*>(InIndexBuffer.DeRef());
+	FRHISoftwareIndirectBuffer *ArgsBuffer = dynamic_cast<FRHISoftwareIndirectBuffer*>(InArgsBuffer.DeRef());
+	uint32_t Stride = InStride;
+	if (!IndexBuffer || CheckIndirectArgs(ArgsBuffer, InOffset, InDrawsNum, Stride))
+	{
+		return;
+	}
+
+	// the arguments are read now, as the vertices
+	const uint8_t *Args = ArgsBuffer->GetData() + InOffset;
+	for (uint32_t k = 0; k < InDrawsNum; k++, Args += Stride)
+	{
+		FDrawIndexedIndirectArgs DrawArgs;
+		::memcpy(&DrawArgs, Args, sizeof(DrawArgs));
+		if ((uint64_t)DrawArgs.FirstIndex + DrawArgs.IndexCount <= IndexBuffer->GetIndexCount())
+		{
+			DrawPrimitives(IndexBuffer, InMode, DrawArgs.FirstIndex, DrawArgs.IndexCount, DrawArgs.InstanceCount, DrawArgs.BaseVertex, DrawArgs.BaseInstance);
+		}
+	} // end for k
+}
+
+//GPU Profiling
+void FSoftwareRenderer::RHIBeginTimerQuery(const char *InName)
+{
+	Rasterizer.Flush();
+	TimerScopes.BeginScope(InName);
+}
+
+void FSoftwareRenderer::RHIEndTimerQuery()
+{
+	Rasterizer.Flush();
+	if (!TimerScopes.EndScope() && Logger)
+	{
+		Logger->Log(Log_Warning, "end of a timer scope which was not begun");
+	}
+}
+
+bool FSoftwareRenderer::RHIGetGPUFrameTimings(FGPUFrameTimings &OutTimings)
+{
+	return TimerScopes.GetFrameTimings(OutTimings);
+}
+
+//Occlusion Queries
+void FSoftwareRenderer::RHIBeginOcclusionQuery(const FRHIOcclusionQueryRef &InQuery)
+{
+	FRHISoftwareOcclusionQuery *Query = dynamic_cast<FRHISoftwareOcclusionQuery*>(InQuery.DeRef());
+	if (!Query || ActiveOcclusionQuery.IsValidRef())
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, Query ? "begin an occlusion query while another one is active" : "begin an invalid occlusion query");
+		}
+		return;
+	}
+
+	Query->SamplesPassed.store(0);
+	Query->bEnded = false;
+	ActiveOcclusionQuery = Query;
+}
+
+void FSoftwareRenderer::RHIEndOcclusionQuery(const FRHIOcclusionQueryRef &InQuery)
+{
+	if (!InQuery.IsValidRef() || ActiveOcclusionQuery.DeRef() != InQuery.DeRef())
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "end an occlusion query which is not active");
+		}
+		return;
+	}
+
+	Rasterizer.Flush();
+	ActiveOcclusionQuery->bEnded = true;
+	ActiveOcclusionQuery.SafeRelease();
+}
+
+bool FSoftwareRenderer::RHIGetOcclusionQueryResult(const FRHIOcclusionQueryRef &InQuery, uint64_t &OutSamples, bool bWait)
+{
+	FRHISoftwareOcclusionQuery *Query = dynamic_cast<FRHISoftwareOcclusionQuery*>(InQuery.DeRef());
+	if (!Query || !Query->bEnded)
+	{
+		return false;
+	}
+
+	OutSamples = Query->SamplesPassed.load();
+	return true;
+}
+
+void FSoftwareRenderer::RHIBeginConditionalRender(const FRHIOcclusionQueryRef &InQuery, bool bWait)
+{
+	FRHISoftwareOcclusionQuery *Query = dynamic_cast<FRHISoftwareOcclusionQuery*>(InQuery.DeRef());
+	if (!Query || !Query->bEnded || bInConditionalRender)
+	{
+		if (Logger)
+		{
+			Logger->Log(Log_Error, "conditional render on an occlusion query which is not ended, or inside another one");
+		}
+		return;
+	}
+
+	bInConditionalRender = true;
+	bConditionalDiscard = Query->SamplesPassed.load() == 0;
+}
+
+void FSoftwareRenderer::RHIEndConditionalRender()
+{
+	bInConditionalRender = false;
+	bConditionalDiscard = false;
+}
+
+//Read Back
+bool FSoftwareRenderer::ReadViewportPixels(FRHIViewportRef InViewport, std::vector<uint8_t> &OutPixels)
+{
+	FRHISoftwareViewport *Viewport = dynamic_cast<FRHISoftwareViewport*>(InViewport.DeRef());
+	if (!Viewport)
+	{
+		return false;
+	}
+
+	if (Viewport == Rasterizer.GetRenderTarget())
+	{
+		Rasterizer.Flush();
+	}
+	Viewport->ReadPixels(OutPixels);
+	return true;
+}
+
+void FSoftwareRenderer::StoreFrameBuffer()
+{
+	if (RenderContext.FrameBuffer.IsValidRef())
+	{
+		Rasterizer.Flush();
+		RenderContext.FrameBuffer->StoreSurface();
+	}
+}
+
+//Helpers
+void FSoftwareRenderer::DrawPrimitives(FRHISoftwareIndexBuffer *InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances, int32_t InBaseVertex, uint32_t InBaseInstance)
+{
+	FRHISoftwareGPUProgram *Program = RenderContext.GPUProgram;
+	FRHISoftwareViewport *Target = Rasterizer.GetRenderTarget();
+	if (!Target || !Program || !RenderContext.VertexDecl || InCount == 0 || InInstances == 0 || InMode >= PT_Max || bConditionalDiscard)
+	{
+		return;
+	}
+
+	// the range of the vertices referenced by the draw
+	uint32_t FirstVertex = InStart, LastVertex = InStart + InCount - 1;
+	if (InIndexBuffer)
+	{
+		FirstVertex = ~0u;
+		LastVertex = 0;
+		for (uint32_t k = 0; k < InCount; k++)
+		{
+			const uint32_t kIndex = InIndexBuffer->GetIndex(InStart + k) + InBaseVertex;
+			FirstVertex = (std::min)(FirstVertex, kIndex);
+			LastVertex = (std::max)(LastVertex, kIndex);
+		}
+	}
+
+	FSoftwareDrawState State;
+	State.RasterizerState = RenderContext.RasterizerState->Initializer;
+	State.DepthStencilState = RenderContext.DepthStencilState->Initializer;
+	State.StencilRef = RenderContext.StencilRef;
+	State.BlendState = RenderContext.BlendState->Initializer.RenderTargetBlendStates[0];
+	State.BlendColor = RenderContext.BlendColor;
+
+	const FViewportBox &Box = RenderContext.ViewportBox;
+	const bool bFullViewport = Box.width <= 0 || Box.height <= 0;
+	State.ViewportX = bFullViewport ? 0 : Box.x;
+	State.ViewportY = bFullViewport ? 0 : Box.y;
+	State.ViewportWidth = bFullViewport ? (int32_t)Target->SizeX : Box.width;
+	State.ViewportHeight = bFullViewport ? (int32_t)Target->SizeY : Box.height;
+	State.MinZ = Box.zMin;
+	State.MaxZ = Box.zMax;
+
+	FSoftwareUniformBufferDataRef UniformBuffers[MaxUniformBufferBindings];
+	for (uint32_t k = 0; k < MaxUniformBufferBindings; k++)
+	{
+		if (RenderContext.UniformBuffers[k].IsValidRef())
+		{
+			UniformBuffers[k] = RenderContext.UniformBuffers[k]->GetContents();
+		}
+	}
+
+	FSoftwareTextureDataRef Textures[MaxTextureUnits];
+	FSamplerStateInitializerRHI Samplers[MaxTextureUnits];
+	for (uint32_t k = 0; k < MaxTextureUnits; k++)
+	{
+		FSoftwareTexture *SoftwareTexture = dynamic_cast<FSoftwareTexture*>(RenderContext.Textures[k].DeRef());
+		if (SoftwareTexture)
+		{
+			Textures[k] = SoftwareTexture->GetContents();
+		}
+		Samplers[k] = RenderContext.TextureSamplers[k].IsValidRef() ? RenderContext.TextureSamplers[k]->Initializer : FSamplerStateInitializerRHI(SF_Point);
+	}
+
+	State.PixelShader = Program->GetPixelShader();
+	State.Uniforms = Program->GetUniformSnapshot(UniformBuffers, Textures, Samplers);
+	State.VaryingsNum = Program->GetVaryingsNum();
+	State.SamplesPassed = ActiveOcclusionQuery.IsValidRef() ? &ActiveOcclusionQuery->SamplesPassed : nullptr;
+
+	Rasterizer.BeginDraw(State);
+
+	const uint32_t kVerticesNum = LastVertex - FirstVertex + 1;
+	TransformedVertices.resize(kVerticesNum);
+	for (uint32_t Instance = 0; Instance < InInstances; Instance++)
+	{
+		TransformVertices(*State.Uniforms, FirstVertex, kVerticesNum, Instance, InBaseInstance);
+		SubmitPrimitives(InIndexBuffer, InMode, InStart, InCount, FirstVertex, InBaseVertex);
+	}
+}
+
+void FSoftwareRenderer::TransformVertices(const FSoftwareUniformBlock &InUniforms, uint32_t InFirstVertex, uint32_t InCount, uint32_t InInstance, uint32_t InBaseInstance)
+{
+	// resolve the vertex streams once
+	struct FFetchElement
+	{
+		const uint8_t		*Data;
+		uint32_t			Bytes;
+		uint32_t			ElementBytes;
+		const FVertexElement	*Element;
+	};
+
+	const FVertexElementsList &Elements = RenderContext.VertexDecl->VertexElements;
+	std::vector<FFetchElement> FetchElements;
+	FetchElements.reserve(Elements.size());
+	for (size_t Index = 0; Index < Elements.size(); Index++)
+	{
+		FRHISoftwareVertexBuffer *Stream = RenderContext.VertexStreams[Elements[Index].StreamIndex];
+		if (Stream)
+		{
+			FFetchElement Fetch;
+			Fetch.Data = Stream->GetData();
+			Fetch.Bytes = Stream->GetBytes();
+			Fetch.ElementBytes = GetVertexElementBytes(Elements[Index].DataType);
+			Fetch.Element = &Elements[Index];
+			FetchElements.push_back(Fetch);
+		}
+	}
+
+	FRHISoftwareGPUProgram *Program = RenderContext.GPUProgram;
+	const FSoftwareVertexShaderFunc VertexShader = Program->GetVertexShader();
+
+	auto TransformRange = [&](uint32_t InBegin, uint32_t InEnd) {
+		FSoftwareVertexInput Input;
+		for (uint32_t k = 0; k < MaxVertexAttributes; k++)
+		{
+			Input.Attributes[k][0] = Input.Attributes[k][1] = Input.Attributes[k][2] = 0.f;
+			Input.Attributes[k][3] = 1.f;
+		}
+		Input.InstanceID = InInstance;
+
+		for (uint32_t Index = InBegin; Index < InEnd; Index++)
+		{
+			Input.VertexID = InFirstVertex + Index;
+			for (size_t e = 0; e < FetchElements.size(); e++)
+			{
+				const FFetchElement &Fetch = FetchElements[e];
+				const FVertexElement &Element = *Fetch.Element;
+				const uint32_t kElementIndex = Element.Divisor ? InBaseInstance + InInstance / Element.Divisor : Input.VertexID;
+				const uint64_t kOffset = (uint64_t)kElementIndex * Element.Stride + Element.Offset;
+				if (kOffset + Fetch.ElementBytes <= Fetch.Bytes)
+				{
+					FetchVertexElement(Element.DataType, Fetch.Data + kOffset, Input.Attributes[Element.AttributeIndex]);
+				}
+			}
+
+			VertexShader(InUniforms, Input, TransformedVertices[Index]);
+		}
+	};
+
+	Rasterizer.GetJobSystem()->ParallelForRange(InCount, kParallelVerticesBatch, TransformRange);
+}
+
+void FSoftwareRenderer::SubmitPrimitives(FRHISoftwareIndexBuffer *InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InFirstVertex, int32_t InBaseVertex)
+{
+	auto Vertex = [&](uint32_t InIndex) -> const FSoftwareVertexOutput& {
+		const uint32_t kVertex = InIndexBuffer ? InIndexBuffer->GetIndex(InStart + InIndex) + InBaseVertex : InStart + InIndex;
+		return TransformedVertices[kVertex - InFirstVertex];
+	};
+
+	switch (InMode)
+	{
+	case PT_Points:
+		for (uint32_t k = 0; k < InCount; k++)
+		{
+			Rasterizer.SubmitPoint(Vertex(k));
+		}
+		break;
+	case PT_Lines:
+		for (uint32_t k = 0; k + 1 < InCount; k += 2)
+		{
+			Rasterizer.SubmitLine(Vertex(k), Vertex(k + 1));
+		}
+		break;
+	case PT_LineStrips:
+	case PT_LineLoops:
+		for (uint32_t k = 0; k + 1 < InCount; k++)
+		{
+			Rasterizer.SubmitLine(Vertex(k), Vertex(k + 1));
+		}
+		if (InMode == PT_LineLoops && InCount > 2)
+		{
+			Rasterizer.SubmitLine(Vertex(InCount - 1), Vertex(0));
+		}
+		break;
+	case PT_Triangles:
+		for (uint32_t k = 0; k + 2 < InCount; k += 3)
+		{
+			Rasterizer.SubmitTriangle(Vertex(k), Vertex(k + 1), Vertex(k + 2));
+		}
+		break;
+	case PT_TriangleStrips:
+		for (uint32_t k = 0; k + 2 < InCount; k++)
+		{
+			// keep the winding of the odd triangles
+			if (k & 1)
+			{
+				Rasterizer.SubmitTriangle(Vertex(k + 1), Vertex(k), Vertex(k + 2));
+			}
+			else
+			{
+				Rasterizer.SubmitTriangle(Vertex(k), Vertex(k + 1), Vertex(k + 2));
+			}
+		}
+		break;
+	case PT_TriangleFans:
+		for (uint32_t k = 1; k + 1 < InCount; k++)
+		{
+			Rasterizer.SubmitTriangle(Vertex(0), Vertex(k), Vertex(k + 1));
+		}
+		break;
+	default:
+		break;
+	}
+}
@@ -0,0 +1,211 @@
+// \brief
+//		Software renderer: rasterize on the CPU, no window or GPU needed.
+//		GLSL is not compiled, the programs run C++ shader callbacks (see SoftwareShader.h).
+//
+
+#ifndef __JETX_SOFTWARE_RENDERER_H__
+#define __JETX_SOFTWARE_RENDERER_H__
+
+#include <vector>
+#include "Renderer/Renderer.h"
+#include "SoftwareResource.h"
+#include "SoftwareShader.h"
+#include "SoftwareRasterizer.h"
+
+
+/** The default sizes of the per-frame transient geometry buffers */
+enum { SoftwareTransientVertexBytes = 1024 * 1024 };
+enum { SoftwareTransientIndexBytes = 256 * 1024 };
+
+//FSoftwareRenderer
+class FSoftwareRenderer : public FRenderer
+{
+public:
+	// InWorkerThreads: threads besides the calling one, ~0 to use all the cores.
+	FSoftwareRenderer(uint32_t InWorkerThreads = ~0u);
+	virtual ~FSoftwareRenderer();
+
+	//Init
+	virtual void Init(FOutputDevice *LogOutputDevice) override;
+	virtual void Shutdown() override;
+
+	//Capabilities
+	virtual void DumpCapabilities() override;
+
+//render viewport
+	virtual FRHIViewportRef RHICreateViewport(void* InWindowHandle, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen) override;
+	virtual void RHIResizeViewport(FRHIViewportRef InViewport, uint32_t SizeX, uint32_t SizeY, bool bIsFullscreen) override;
+
+	virtual bool RHIGetAvailableResolutions(FScreenResolutionArray& Resolutions, bool bIgnoreRefreshRate) override;
+	virtual void RHIGetSupportedResolution(uint32_t& Width, uint32_t& Height) override;
+
+//Resource Creating
+	// states
+	virtual FRHISamplerStateRef RHICreateSamplerState(const FSamplerStateInitializerRHI &SamplerStateInitializer) override;
+	virtual FRHIRasterizerStateRef RHICreateRasterizerState(const FRasterizerStateInitializerRHI &RasterizerStateInitializer) override;
+	virtual FRHIDepthStencilStateRef RHICreateDepthStencilState(const FDepthStencilStateInitializerRHI &DepthStencilStateInitializer) override;
+	virtual FRHIBlendStateRef RHICreateBlendState(const FBlendStateInitializerRHI &BlendStateInitializer) override;
+
+	// data buffers
+	virtual FRHIVertexBufferRef RHICreateVertexBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess, EBufferUsage InUsage) override;
+	virtual FRHIIndexBufferRef RHICreateIndexBuffer(uint32_t InBytes, const void *InData, uint16_t InStride, EBufferAccess InAccess, EBufferUsage InUsage) override;
+	virtual FRHIIndirectBufferRef RHICreateIndirectBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess) override;
+
+	virtual void FillDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, const void *InData) override;
+	virtual void* LockDataBuffer(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes, EBufferLockMode InMode) override;
+	virtual void UnLockDataBuffer(FRHIDataBufferRef InBuffer) override;
+	virtual void FlushDataBufferRange(FRHIDataBufferRef InBuffer, uint32_t InOffset, uint32_t InBytes) override;
+
+	// uniform buffers
+	virtual FRHIUniformBufferRef RHICreateUniformBuffer(uint32_t InBytes, const void *InData, EBufferAccess InAccess) override;
+	virtual void RHIUpdateUniformBuffer(const FRHIUniformBufferRef &InBuffer, const void *InData) override;
+
+	// textures
+	virtual FRHITexture2DRef RHICreateTexture2D(uint32_t InSizeX, uint32_t InSizeY, uint32_t InMips, EPixelFormat InFormat) override;
+	virtual FRHITexture2DArrayRef RHICreateTexture2DArray(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat) override;
+	virtual FRHITextureCubeRef RHICreateTextureCube(uint32_t InSize, uint32_t InMips, EPixelFormat InFormat) override;
+	virtual void RHIUpdateTexture(const FRHITextureRef &InTexture, uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData) override;
+	virtual void RHIGenerateMips(const FRHITextureRef &InTexture) override;
+
+	// transient geometry
+	virtual void* RHIAllocTransientVertices(uint32_t InBytes, uint32_t InStride, FRHIVertexBufferRef &OutBuffer, uint32_t &OutFirstVertex) override;
+	virtual void* RHIAllocTransientIndices(uint32_t InCount, uint16_t InStride, FRHIIndexBufferRef &OutBuffer, uint32_t &OutFirstIndex) override;
+
+	// render targets, rasterized single sampled into a single color target.
+	virtual FRHIRenderBufferRef RHICreateRenderBuffer(uint32_t InSizeX, uint32_t InSizeY, EPixelFormat InFormat, uint32_t InSamples) override;
+	virtual FRHIFrameBufferRef RHICreateFrameBuffer(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget) override;
+
+	// queries
+	virtual FRHIOcclusionQueryRef RHICreateOcclusionQuery() override;
+
+	// vertex input layout
+	virtual FRHIVertexDeclarationRef RHICreateVertexInputLayout(const FVertexElement *InVertexElements, uint32_t InCount) override;
+
+	// shader
+	virtual FRHIVertexShaderRef RHICreateVertexShader(const char *InSource, int32_t InLength = -1) override;
+	virtual FRHIPixelShaderRef RHICreatePixelShader(const char *InSource, int32_t InLength = -1) override;
+	virtual FRHIGPUProgramRef RHICreateGPUProgram(const FRHIVertexShaderRef &InVShader, const FRHIPixelShaderRef &InPShader) override;
+	virtual FRHIGPUProgramRef RHICreateGPUProgram(const std::vector<FRHIShaderRef> &InShaders) override;
+
+	// a program running the C++ shaders, InVaryingsNum floats are passed from the vertex to the pixel shader.
+	FRHIGPUProgramRef RHICreateSoftwareGPUProgram(FSoftwareVertexShaderFunc InVertexShader, FSoftwarePixelShaderFunc InPixelShader, uint32_t InVaryingsNum);
+
+//State Setting
+	virtual void RHISetSamplerState(uint32_t InTexIndex, const FRHISamplerStateRef &InSamplerState) override;
+	virtual void RHISetTexture(uint32_t InTexIndex, const FRHITextureRef &InTexture) override;
+	virtual void RHISetRasterizerState(const FRHIRasterizerStateRef &InRasterizerState) override;
+	virtual void RHISetDepthStencilState(const FRHIDepthStencilStateRef &InDepthStencilState, int32_t InStencilRef) override;
+	virtual void RHISetBlendState(const FRHIBlendStateRef &InBlendState, const FLinearColor &InBlendColor) override;
+
+	virtual void RHISetFrameBuffer(const FRHIFrameBufferRef &InFrameBuffer) override;
+	virtual void RHISetViewport(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight, float InMinZ, float InMaxZ) override;
+	virtual void RHISetScissorRect(int32_t InX, int32_t InY, int32_t InWidth, int32_t InHeight) override;
+
+	virtual void SetVertexStreamSource(uint32_t InStreamIndex, const FRHIVertexBufferRef &InVertexBuffer) override;
+	virtual void SetVertexInputLayout(const FRHIVertexDeclarationRef &InVertexDecl) override;
+	virtual void SetGPUProgram(const FRHIGPUProgramRef &InProgram) override;
+	virtual void RHISetUniformBuffer(uint32_t InBindIndex, const FRHIUniformBufferRef &InBuffer) override;
+
+//Draw Commands
+	virtual void RHIBeginDrawingViewport(FRHIViewportRef Viewport) override;
+	virtual void RHIEndDrawingViewport(FRHIViewportRef Viewport, bool bPresent, bool bLockToVsync) override;
+	virtual void RHIBeginFrame() override;
+	virtual void RHIEndFrame() override;
+
+	virtual void RHIClear(bool bClearColor, const FLinearColor &InColor, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil) override;
+	virtual void RHIClearMRT(bool bClearColor, const FLinearColor *InColors, uint32_t InColorsNum, bool bClearDepth, float InDepth, bool bClearStencil, int32_t InStencil) override;
+
+	virtual void RHIResolveFrameBuffer(const FRHIFrameBufferRef &InSource, const FRHIFrameBufferRef &InDest) override;
+
+	// draw primitives
+	virtual void DrawIndexedPrimitive(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount) override;
+	virtual void DrawIndexedPrimitiveInstanced(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances) override;
+	virtual void DrawArrayedPrimitive(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount) override;
+	virtual void DrawArrayedPrimitiveInstanced(EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances) override;
+	virtual void DrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset) override;
+	virtual void MultiDrawIndexedPrimitiveIndirect(const FRHIIndexBufferRef &InIndexBuffer, EPrimitiveType InMode, const FRHIIndirectBufferRef &InArgsBuffer, uint32_t InOffset, uint32_t InDrawsNum, uint32_t InStride) override;
+
+//GPU Profiling
+	// the rasterizer is flushed at the bounds of the scopes, the times are the ones of the CPU.
+	virtual void RHIBeginTimerQuery(const char *InName) override;
+	virtual void RHIEndTimerQuery() override;
+	virtual bool RHIGetGPUFrameTimings(FGPUFrameTimings &OutTimings) override;
+
+//Occlusion Queries
+	// the rasterizer is flushed at the end of a query, the results are known at once and the
+	// conditional draws are skipped before their vertices are transformed.
+	virtual void RHIBeginOcclusionQuery(const FRHIOcclusionQueryRef &InQuery) override;
+	virtual void RHIEndOcclusionQuery(const FRHIOcclusionQueryRef &InQuery) override;
+	virtual bool RHIGetOcclusionQueryResult(const FRHIOcclusionQueryRef &InQuery, uint64_t &OutSamples, bool bWait) override;
+	virtual void RHIBeginConditionalRender(const FRHIOcclusionQueryRef &InQuery, bool bWait) override;
+	virtual void RHIEndConditionalRender() override;
+
+//Read Back
+	// finish the pending work and copy the viewport as RGBA8, rows are top-down.
+	bool ReadViewportPixels(FRHIViewportRef InViewport, std::vector<uint8_t> &OutPixels);
+
+protected:
+	// InBaseVertex is added to the indices, InBaseInstance to the instance of the per-instance elements.
+	void DrawPrimitives(FRHISoftwareIndexBuffer *InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InInstances, int32_t InBaseVertex = 0, uint32_t InBaseInstance = 0);
+	void TransformVertices(const FSoftwareUniformBlock &InUniforms, uint32_t InFirstVertex, uint32_t InCount, uint32_t InInstance, uint32_t InBaseInstance);
+	void SubmitPrimitives(FRHISoftwareIndexBuffer *InIndexBuffer, EPrimitiveType InMode, uint32_t InStart, uint32_t InCount, uint32_t InFirstVertex, int32_t InBaseVertex);
+	// finish the draws into the frame buffer and store them into its targets.
+	void StoreFrameBuffer();
+	bool ValidateTextureDesc(const char *InKind, uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat);
+
+protected:
+	struct FViewportBox
+	{
+		int32_t x, y, width, height;
+		float zMin, zMax;
+	};
+
+	// Render Context
+	struct FRenderContext
+	{
+		FViewportBox					ViewportBox;
+		FRHISoftwareFrameBufferRef		FrameBuffer;
+
+		FRHISoftwareRasterizerStateRef	RasterizerState;
+		FRHISoftwareSamplerStateRef		TextureSamplers[MaxTextureUnits];
+		FRHITextureRef					Textures[MaxTextureUnits];
+		FRHISoftwareDepthStencilStateRef	DepthStencilState;
+		int32_t							StencilRef;
+		FRHISoftwareBlendStateRef		BlendState;
+		FLinearColor					BlendColor;
+
+		FRHISoftwareVertexDeclarationRef	VertexDecl;
+		FRHISoftwareVertexBufferRef		VertexStreams[MaxVertexStreamSources];
+
+		FRHISoftwareGPUProgramRef		GPUProgram;
+		FRHISoftwareUniformBufferRef	UniformBuffers[MaxUniformBufferBindings];
+	};
+
+	FOutputDevice			*Logger;
+	uint32_t				WorkerThreads;
+
+	FSoftwareRasterizer		Rasterizer;
+	FRHISoftwareViewportRef	ViewportDrawing;
+	FRenderContext			RenderContext;
+
+	// transformed vertices of the current draw
+	std::vector<FSoftwareVertexOutput>	TransformedVertices;
+
+	// transient geometry, rewound at every frame. the draws read it at once, a full buffer is
+	// replaced by a new one (kept alive by the buffers handed out).
+	FRHISoftwareVertexBufferRef		TransientVertexBuffer;
+	uint32_t						TransientVertexHead;
+	// 16 & 32 bits indices
+	FRHISoftwareIndexBufferRef		TransientIndexBuffers[2];
+	uint32_t						TransientIndexHeads[2];
+
+	FCPUTimerScopes					TimerScopes;
+
+	// occlusion queries
+	FRHISoftwareOcclusionQueryRef	ActiveOcclusionQuery;
+	bool							bInConditionalRender;
+	// the draws of the conditional render are discarded
+	bool							bConditionalDiscard;
+};
+
+#endif //__JETX_SOFTWARE_RENDERER_H__
@@ -0,0 +1,350 @@
+// \brief
+//		Software RHI resources implementation.
+//
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include "SoftwareResource.h"
+
+
+//////////////////////////////////////////////////////////////////////////
+// Data Buffer
+bool FSoftwareBuffer::Initialize(uint32_t InBytes, const void *InData)
+{
+	if (InBytes == 0)
+	{
+		return false;
+	}
+
+	Memory.resize(InBytes);
+	if (InData)
+	{
+		::memcpy(&Memory[0], InData, InBytes);
+	}
+
+	return true;
+}
+
+bool FSoftwareBuffer::FillData(uint32_t InOffset, uint32_t InBytes, const void *InData)
+{
+	if (bIsLocked || !InData || (uint64_t)InOffset + InBytes > Memory.size())
+	{
+		return false;
+	}
+
+	::memcpy(&Memory[InOffset], InData, InBytes);
+	return true;
+}
+
+void* FSoftwareBuffer::Lock(uint32_t InOffset, uint32_t InBytes, EBufferLockMode InMode)
+{
+	if (bIsLocked || InBytes == 0 || (uint64_t)InOffset + InBytes > Memory.size())
+	{
+		return nullptr;
+	}
+
+	bIsLocked = true;
+	return &Memory[InOffset];
+}
+
+void FSoftwareBuffer::UnLock()
+{
+	bIsLocked = false;
+}
+
+bool FRHISoftwareIndexBuffer::Initialize(uint32_t InBytes, const void *InData, uint16_t InStride)
+{
+	if ((InStride != sizeof(uint16_t) && InStride != sizeof(uint32_t)) || (InBytes % InStride))
+	{
+		return false;
+	}
+
+	Stride = InStride;
+	return FSoftwareBuffer::Initialize(InBytes, InData);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Texture
+static inline float UnsignedSmallFloatToFloat(uint32_t InBits, uint32_t InMantissaBits)
+{
+	const uint32_t kExponent = InBits >> InMantissaBits;
+	const uint32_t kMantissa = InBits & ((1u << InMantissaBits) - 1);
+	const float kScale = 1.f / (float)(1u << InMantissaBits);
+
+	if (kExponent == 0)
+	{
+		return ldexpf(kMantissa * kScale, -14);
+	}
+	return ldexpf(1.f + kMantissa * kScale, (int32_t)kExponent - 15);
+}
+
+static inline float SRGBToLinear(uint8_t InValue)
+{
+	const float kValue = InValue * (1.f / 255.f);
+	return kValue <= 0.04045f ? kValue * (1.f / 12.92f) : powf((kValue + 0.055f) * (1.f / 1.055f), 2.4f);
+}
+
+// expand a pixel to float4, the missing channels are (0, 0, 0, 1) as sampled by OpenGL.
+static void DecodePixel(EPixelFormat InFormat, const uint8_t *InSrc, FLinearColor &OutColor)
+{
+	OutColor = FLinearColor(0.f, 0.f, 0.f, 1.f);
+
+	switch (InFormat)
+	{
+	case PF_R8:
+	case PF_RG8:
+	case PF_RGBA8:
+	{
+		const uint32_t kCount = InFormat == PF_R8 ? 1 : (InFormat == PF_RG8 ? 2 : 4);
+		for (uint32_t k = 0; k < kCount; k++) { OutColor.RGBA[k] = InSrc[k] * (1.f / 255.f); }
+	}
+		break;
+	case PF_SRGB8_A8:
+		for (uint32_t k = 0; k < 3; k++) { OutColor.RGBA[k] = SRGBToLinear(InSrc[k]); }
+		OutColor.A = InSrc[3] * (1.f / 255.f);
+		break;
+	case PF_R16F:
+	case PF_RG16F:
+	case PF_RGBA16F:
+	{
+		const uint32_t kCount = InFormat == PF_R16F ? 1 : (InFormat == PF_RG16F ? 2 : 4);
+		uint16_t Values[4];
+		::memcpy(Values, InSrc, kCount * sizeof(uint16_t));
+		for (uint32_t k = 0; k < kCount; k++) { OutColor.RGBA[k] = HalfToFloat(Values[k]); }
+	}
+		break;
+	case PF_R32F:
+	case PF_RG32F:
+	case PF_RGBA32F:
+	case PF_Depth32F:
+	{
+		const uint32_t kCount = (InFormat == PF_R32F || InFormat == PF_Depth32F) ? 1 : (InFormat == PF_RG32F ? 2 : 4);
+		::memcpy(OutColor.RGBA, InSrc, kCount * sizeof(float));
+	}
+		break;
+	case PF_R11G11B10F:
+	{
+		uint32_t Packed;
+		::memcpy(&Packed, InSrc, sizeof(Packed));
+		OutColor.R = UnsignedSmallFloatToFloat(Packed & 0x7FF, 6);
+		OutColor.G = UnsignedSmallFloatToFloat((Packed >> 11) & 0x7FF, 6);
+		OutColor.B = UnsignedSmallFloatToFloat(Packed >> 22, 5);
+	}
+		break;
+	case PF_Depth24:
+	case PF_Depth24Stencil8:
+	{
+		uint32_t Packed;
+		::memcpy(&Packed, InSrc, sizeof(Packed));
+		OutColor.R = InFormat == PF_Depth24 ? (float)(Packed / 4294967295.0) : (Packed >> 8) * (1.f / 16777215.f);
+	}
+		break;
+	default:
+		break;
+	}
+}
+
+FSoftwareTexture::FSoftwareTexture(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat)
+	: PixelFormat(InFormat)
+{
+	Contents = new FSoftwareTextureData();
+	Contents->SizeX = InSizeX;
+	Contents->SizeY = InSizeY;
+	Contents->Layers = InLayers;
+	Contents->Mips = InMips;
+	Contents->Levels.resize(InLayers * InMips);
+	for (uint32_t Layer = 0; Layer < InLayers; Layer++)
+	{
+		for (uint32_t Mip = 0; Mip < InMips; Mip++)
+		{
+			Contents->Levels[Layer * InMips + Mip].resize(GetMipSize(InSizeX, Mip) * GetMipSize(InSizeY, Mip), FLinearColor(0.f, 0.f, 0.f, 1.f));
+		}
+	}
+}
+
+void FSoftwareTexture::DetachContents()
+{
+	if (Contents->RetainCount() > 1)
+	{
+		// a snapshot of a draw in flight reads the old texels
+		FSoftwareTextureData *Copy = new FSoftwareTextureData();
+		Copy->SizeX = Contents->SizeX;
+		Copy->SizeY = Contents->SizeY;
+		Copy->Layers = Contents->Layers;
+		Copy->Mips = Contents->Mips;
+		Copy->Levels = Contents->Levels;
+		Contents = Copy;
+	}
+}
+
+void FSoftwareTexture::Update(uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData)
+{
+	DetachContents();
+
+	const uint32_t kPixelBytes = GetPixelFormatBytes(PixelFormat);
+	const uint32_t kPitch = GetMipSize(Contents->SizeX, InMip);
+	std::vector<FLinearColor> &Level = Contents->Levels[InLayer * Contents->Mips + InMip];
+	const uint8_t *Src = reinterpret_cast<const uint8_t*>(InData);
+
+	for (uint32_t Row = 0; Row < InHeight; Row++)
+	{
+		FLinearColor *Dst = &Level[(InY + Row) * kPitch + InX];
+		for (uint32_t Column = 0; Column < InWidth; Column++)
+		{
+			DecodePixel(PixelFormat, Src, Dst[Column]);
+			Src += kPixelBytes;
+		}
+	} // end for Row
+}
+
+void FSoftwareTexture::GenerateMips()
+{
+	DetachContents();
+
+	const uint32_t kMips = Contents->Mips;
+	for (uint32_t Layer = 0; Layer < Contents->Layers; Layer++)
+	{
+		for (uint32_t Mip = 1; Mip < kMips; Mip++)
+		{
+			const std::vector<FLinearColor> &Upper = Contents->Levels[Layer * kMips + Mip - 1];
+			std::vector<FLinearColor> &Level = Contents->Levels[Layer * kMips + Mip];
+			const uint32_t kUpperX = GetMipSize(Contents->SizeX, Mip - 1), kUpperY = GetMipSize(Contents->SizeY, Mip - 1);
+			const uint32_t kSizeX = GetMipSize(Contents->SizeX, Mip), kSizeY = GetMipSize(Contents->SizeY, Mip);
+
+			for (uint32_t y = 0; y < kSizeY; y++)
+			{
+				const uint32_t y0 = (std::min)(y * 2, kUpperY - 1), y1 = (std::min)(y * 2 + 1, kUpperY - 1);
+				for (uint32_t x = 0; x < kSizeX; x++)
+				{
+					const uint32_t x0 = (std::min)(x * 2, kUpperX - 1), x1 = (std::min)(x * 2 + 1, kUpperX - 1);
+					FLinearColor &Dst = Level[y * kSizeX + x];
+					for (uint32_t k = 0; k < 4; k++)
+					{
+						Dst.RGBA[k] = 0.25f * (Upper[y0 * kUpperX + x0].RGBA[k] + Upper[y0 * kUpperX + x1].RGBA[k]
+							+ Upper[y1 * kUpperX + x0].RGBA[k] + Upper[y1 * kUpperX + x1].RGBA[k]);
+					}
+				}
+			}
+		} // end for Mip
+	} // end for Layer
+}
+
+std::vector<FLinearColor>& FSoftwareTexture::GetMutableLevel(uint32_t InMip, uint32_t InLayer)
+{
+	DetachContents();
+	return Contents->Levels[InLayer * Contents->Mips + InMip];
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Viewport
+FRHISoftwareViewport::FRHISoftwareViewport(void *InWindowHandle, uint32_t InSizeX, uint32_t InSizeY, bool InbIsFullscreen)
+	: WindowHandle(InWindowHandle)
+	, SizeX(0)
+	, SizeY(0)
+	, bIsFullscreen(InbIsFullscreen)
+	, Pitch(0)
+	, Rows(0)
+{
+	Resize(InSizeX, InSizeY, InbIsFullscreen);
+}
+
+void FRHISoftwareViewport::Resize(uint32_t InSizeX, uint32_t InSizeY, bool InbIsFullscreen)
+{
+	SizeX = InSizeX;
+	SizeY = InSizeY;
+	bIsFullscreen = InbIsFullscreen;
+
+	Pitch = (SizeX + SoftwareTileSize - 1) / SoftwareTileSize * SoftwareTileSize;
+	Rows = (SizeY + SoftwareTileSize - 1) / SoftwareTileSize * SoftwareTileSize;
+
+	const size_t kPixels = (size_t)Pitch * Rows;
+	ColorBuffer.assign(kPixels, 0);
+	DepthBuffer.assign(kPixels, 1.f);
+	StencilBuffer.assign(kPixels, 0);
+}
+
+void FRHISoftwareViewport::ReadPixels(std::vector<uint8_t> &OutPixels) const
+{
+	OutPixels.resize((size_t)SizeX * SizeY * 4);
+	for (uint32_t y = 0; y < SizeY; y++)
+	{
+		const uint32_t *Src = &ColorBuffer[(size_t)(SizeY - 1 - y) * Pitch];
+		uint8_t *Dst = &OutPixels[(size_t)y * SizeX * 4];
+		for (uint32_t x = 0; x < SizeX; x++)
+		{
+			const uint32_t kColor = Src[x];
+			Dst[x * 4 + 0] = (uint8_t)(kColor);
+			Dst[x * 4 + 1] = (uint8_t)(kColor >> 8);
+			Dst[x * 4 + 2] = (uint8_t)(kColor >> 16);
+			Dst[x * 4 + 3] = (uint8_t)(kColor >> 24);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Frame Buffer
+FRHISoftwareFrameBuffer::FRHISoftwareFrameBuffer(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget)
+	: FRHIFrameBuffer(InColorTargets, InColorTargetsNum, InDepthStencilTarget)
+{
+	Surface = new FRHISoftwareViewport(nullptr, GetSizeX(), GetSizeY(), false);
+}
+
+std::vector<FLinearColor>* FRHISoftwareFrameBuffer::GetTargetTexels(const FRHIRenderTargetView &InView)
+{
+	FRHISoftwareRenderBuffer *RenderBuffer = dynamic_cast<FRHISoftwareRenderBuffer*>(InView.RenderBuffer.DeRef());
+	if (RenderBuffer)
+	{
+		return &RenderBuffer->Texels;
+	}
+
+	FSoftwareTexture *Texture = dynamic_cast<FSoftwareTexture*>(InView.Texture.DeRef());
+	return Texture ? &Texture->GetMutableLevel(InView.MipIndex, InView.LayerIndex) : nullptr;
+}
+
+void FRHISoftwareFrameBuffer::LoadSurface()
+{
+	const uint32_t kSizeX = GetSizeX(), kSizeY = GetSizeY();
+	const std::vector<FLinearColor> *Color = ColorTargetsNum > 0 ? GetTargetTexels(ColorTargets[0]) : nullptr;
+	const std::vector<FLinearColor> *Depth = DepthStencilTarget.IsValid() ? GetTargetTexels(DepthStencilTarget) : nullptr;
+
+	for (uint32_t y = 0; y < kSizeY; y++)
+	{
+		for (uint32_t x = 0; x < kSizeX; x++)
+		{
+			const size_t kTexel = (size_t)y * kSizeX + x, kPixel = (size_t)y * Surface->Pitch + x;
+			if (Color)
+			{
+				Surface->ColorBuffer[kPixel] = PackColor((*Color)[kTexel]);
+			}
+			if (Depth)
+			{
+				Surface->DepthBuffer[kPixel] = (*Depth)[kTexel].RGBA[0];
+			}
+		}
+	} // end for y
+}
+
+void FRHISoftwareFrameBuffer::StoreSurface()
+{
+	const uint32_t kSizeX = GetSizeX(), kSizeY = GetSizeY();
+	std::vector<FLinearColor> *Color = ColorTargetsNum > 0 ? GetTargetTexels(ColorTargets[0]) : nullptr;
+	std::vector<FLinearColor> *Depth = DepthStencilTarget.IsValid() ? GetTargetTexels(DepthStencilTarget) : nullptr;
+
+	for (uint32_t y = 0; y < kSizeY; y++)
+	{
+		for (uint32_t x = 0; x < kSizeX; x++)
+		{
+			const size_t kTexel = (size_t)y * kSizeX + x, kPixel = (size_t)y * Surface->Pitch + x;
+			if (Color)
+			{
+				(*Color)[kTexel] = UnpackColor(Surface->ColorBuffer[kPixel]);
+			}
+			if (Depth)
+			{
+				const float kDepth = Surface->DepthBuffer[kPixel];
+				(*Depth)[kTexel] = FLinearColor(kDepth, kDepth, kDepth, 1.f);
+			}
+		}
+	} // end for y
+}
@@ -0,0 +1,324 @@
+// \brief
+//		Software RHI resources. everything lives in system memory.
+//
+
+#ifndef __JETX_SOFTWARE_RESOURCE_H__
+#define __JETX_SOFTWARE_RESOURCE_H__
+
+#include <vector>
+#include <atomic>
+#include "Foundation/JetX.h"
+#include "Renderer/RendererDefs.h"
+#include "Renderer/RendererState.h"
+#include "Renderer/RHIResource.h"
+
+
+/** The size of the rasterizer tiles in pixels */
+enum { SoftwareTileSize = 64 };
+
+static inline float HalfToFloat(uint16_t InHalf)
+{
+	const uint32_t kSign = (uint32_t)(InHalf & 0x8000) << 16;
+	const uint32_t kExponent = (InHalf >> 10) & 0x1F;
+	const uint32_t kMantissa = InHalf & 0x3FF;
+
+	if (kExponent == 0)
+	{
+		// zero or denormal
+		const float Value = kMantissa * (1.f / 16777216.f);
+		return kSign ? -Value : Value;
+	}
+
+	uint32_t Bits;
+	if (kExponent == 31)
+	{
+		Bits = kSign | 0x7F800000 | (kMantissa << 13);
+	}
+	else
+	{
+		Bits = kSign | ((kExponent + 112) << 23) | (kMantissa << 13);
+	}
+
+	float Value;
+	::memcpy(&Value, &Bits, sizeof(Value));
+	return Value;
+}
+
+// the RGBA8 color of the color buffers
+static inline uint32_t PackColor(const FLinearColor &InColor)
+{
+	uint32_t Packed = 0;
+	for (uint32_t k = 0; k < 4; k++)
+	{
+		const float Value = InColor.RGBA[k] < 0.f ? 0.f : (InColor.RGBA[k] > 1.f ? 1.f : InColor.RGBA[k]);
+		Packed |= (uint32_t)(Value * 255.f + 0.5f) << (k * 8);
+	}
+	return Packed;
+}
+
+static inline FLinearColor UnpackColor(uint32_t InColor)
+{
+	const float kScale = 1.f / 255.f;
+	return FLinearColor((InColor & 0xFF) * kScale, ((InColor >> 8) & 0xFF) * kScale, ((InColor >> 16) & 0xFF) * kScale, (InColor >> 24) * kScale);
+}
+
+// state blocks, the rasterizer reads the initializer directly.
+class FRHISoftwareSamplerState : public FRHISamplerState
+{
+public:
+	FRHISoftwareSamplerState(const FSamplerStateInitializerRHI &InInitializer)
+		: Initializer(InInitializer)
+	{}
+
+	FSamplerStateInitializerRHI	Initializer;
+};
+
+class FRHISoftwareRasterizerState : public FRHIRasterizerState
+{
+public:
+	FRHISoftwareRasterizerState(const FRasterizerStateInitializerRHI &InInitializer)
+		: Initializer(InInitializer)
+	{}
+
+	FRasterizerStateInitializerRHI	Initializer;
+};
+
+class FRHISoftwareDepthStencilState : public FRHIDepthStencilState
+{
+public:
+	FRHISoftwareDepthStencilState(const FDepthStencilStateInitializerRHI &InInitializer)
+		: Initializer(InInitializer)
+	{}
+
+	FDepthStencilStateInitializerRHI	Initializer;
+};
+
+class FRHISoftwareBlendState : public FRHIBlendState
+{
+public:
+	FRHISoftwareBlendState(const FBlendStateInitializerRHI &InInitializer)
+		: Initializer(InInitializer)
+	{}
+
+	FBlendStateInitializerRHI	Initializer;
+};
+
+// data buffer
+class FSoftwareBuffer
+{
+public:
+	FSoftwareBuffer()
+		: bIsLocked(false)
+	{}
+
+	virtual ~FSoftwareBuffer() {}
+
+	bool Initialize(uint32_t InBytes, const void *InData);
+	bool FillData(uint32_t InOffset, uint32_t InBytes, const void *InData);
+
+	void* Lock(uint32_t InOffset, uint32_t InBytes, EBufferLockMode InMode);
+	void UnLock();
+
+	uint32_t GetBytes() const { return (uint32_t)Memory.size(); }
+	const uint8_t* GetData() const { return Memory.empty() ? nullptr : &Memory[0]; }
+	uint8_t* GetMutableData() { return Memory.empty() ? nullptr : &Memory[0]; }
+
+protected:
+	std::vector<uint8_t>	Memory;
+	bool					bIsLocked;
+};
+
+class FRHISoftwareVertexBuffer : public FRHIVertexBuffer, public FSoftwareBuffer
+{
+public:
+	virtual uint32_t GetBytes() override { return FSoftwareBuffer::GetBytes(); }
+};
+
+class FRHISoftwareIndexBuffer : public FRHIIndexBuffer, public FSoftwareBuffer
+{
+public:
+	FRHISoftwareIndexBuffer()
+		: Stride(0)
+	{}
+
+	virtual uint32_t GetBytes() override { return FSoftwareBuffer::GetBytes(); }
+	virtual uint32_t GetIndexCount() override { return Stride ? GetBytes() / Stride : 0; }
+
+	bool Initialize(uint32_t InBytes, const void *InData, uint16_t InStride);
+
+	uint32_t GetIndex(uint32_t InIndex) const
+	{
+		return Stride == sizeof(uint16_t) ? reinterpret_cast<const uint16_t*>(GetData())[InIndex] : reinterpret_cast<const uint32_t*>(GetData())[InIndex];
+	}
+
+protected:
+	uint16_t	Stride;
+};
+
+class FRHISoftwareIndirectBuffer : public FRHIIndirectBuffer, public FSoftwareBuffer
+{
+public:
+	virtual uint32_t GetBytes() override { return FSoftwareBuffer::GetBytes(); }
+};
+
+// texels of a texture expanded to float4, read by the draws in flight.
+class FSoftwareTextureData : public FRefCountedObject
+{
+public:
+	const std::vector<FLinearColor>& GetLevel(uint32_t InMip, uint32_t InLayer) const { return Levels[InLayer * Mips + InMip]; }
+
+	uint32_t	SizeX;
+	uint32_t	SizeY;
+	uint32_t	Layers;
+	uint32_t	Mips;
+	// [Layer * Mips + Mip], rows are bottom-up as in OpenGL.
+	std::vector< std::vector<FLinearColor> >	Levels;
+};
+
+typedef TRefCountPtr<FSoftwareTextureData>	FSoftwareTextureDataRef;
+
+// texture
+// an update while a draw still references the contents allocates new ones (copy on write).
+class FSoftwareTexture
+{
+public:
+	FSoftwareTexture(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat);
+	virtual ~FSoftwareTexture() {}
+
+	// InData is tightly packed pixels of the format.
+	void Update(uint32_t InMip, uint32_t InLayer, uint32_t InX, uint32_t InY, uint32_t InWidth, uint32_t InHeight, const void *InData);
+	// box filter every mip from the one above.
+	void GenerateMips();
+
+	const FSoftwareTextureDataRef& GetContents() const { return Contents; }
+	// the texels of a level to write, detached from the draws in flight.
+	std::vector<FLinearColor>& GetMutableLevel(uint32_t InMip, uint32_t InLayer);
+
+protected:
+	void DetachContents();
+
+	EPixelFormat				PixelFormat;
+	FSoftwareTextureDataRef		Contents;
+};
+
+class FRHISoftwareTexture2D : public FRHITexture2D, public FSoftwareTexture
+{
+public:
+	FRHISoftwareTexture2D(uint32_t InSizeX, uint32_t InSizeY, uint32_t InMips, EPixelFormat InFormat)
+		: FRHITexture2D(InSizeX, InSizeY, InMips, InFormat)
+		, FSoftwareTexture(InSizeX, InSizeY, 1, InMips, InFormat)
+	{}
+};
+
+class FRHISoftwareTexture2DArray : public FRHITexture2DArray, public FSoftwareTexture
+{
+public:
+	FRHISoftwareTexture2DArray(uint32_t InSizeX, uint32_t InSizeY, uint32_t InLayers, uint32_t InMips, EPixelFormat InFormat)
+		: FRHITexture2DArray(InSizeX, InSizeY, InLayers, InMips, InFormat)
+		, FSoftwareTexture(InSizeX, InSizeY, InLayers, InMips, InFormat)
+	{}
+};
+
+class FRHISoftwareTextureCube : public FRHITextureCube, public FSoftwareTexture
+{
+public:
+	FRHISoftwareTextureCube(uint32_t InSize, uint32_t InMips, EPixelFormat InFormat)
+		: FRHITextureCube(InSize, InMips, InFormat)
+		, FSoftwareTexture(InSize, InSize, CubeFace_MAX, InMips, InFormat)
+	{}
+};
+
+// vertex declaration
+class FRHISoftwareVertexDeclaration : public FRHIVertexDeclaration
+{
+public:
+	FRHISoftwareVertexDeclaration(const FVertexElement *InVertexElements, uint32_t InCount)
+		: VertexElements(InVertexElements, InVertexElements + InCount)
+	{}
+
+	FVertexElementsList		VertexElements;
+};
+
+// viewport, owns the color(RGBA8), depth and stencil buffers.
+// the buffers are padded up to whole tiles, rows are bottom-up as in OpenGL.
+class FRHISoftwareViewport : public FRHIViewport
+{
+public:
+	FRHISoftwareViewport(void *InWindowHandle, uint32_t InSizeX, uint32_t InSizeY, bool InbIsFullscreen);
+
+	void Resize(uint32_t InSizeX, uint32_t InSizeY, bool InbIsFullscreen);
+
+	// copy the color buffer as RGBA8, rows are top-down.
+	void ReadPixels(std::vector<uint8_t> &OutPixels) const;
+
+	void		*WindowHandle;
+	uint32_t	SizeX;
+	uint32_t	SizeY;
+	bool		bIsFullscreen;
+
+	uint32_t	Pitch;		// pixels per row
+	uint32_t	Rows;
+	std::vector<uint32_t>	ColorBuffer;
+	std::vector<float>		DepthBuffer;
+	std::vector<uint8_t>	StencilBuffer;
+};
+
+// render buffer, the texels are kept as linear float4 as the textures.
+class FRHISoftwareRenderBuffer : public FRHIRenderBuffer
+{
+public:
+	FRHISoftwareRenderBuffer(uint32_t InSizeX, uint32_t InSizeY, EPixelFormat InFormat, uint32_t InSamples)
+		: FRHIRenderBuffer(InSizeX, InSizeY, InFormat, InSamples)
+		, Texels((size_t)InSizeX * InSizeY, FLinearColor(0.f, 0.f, 0.f, 1.f))
+	{}
+
+	std::vector<FLinearColor>	Texels;
+};
+
+// frame buffer
+// the draws go to a surface of its size, the targets are loaded into it when the frame buffer is bound
+// and stored back when the work is flushed. the color is RGBA8 and the depth is stored into red.
+class FRHISoftwareFrameBuffer : public FRHIFrameBuffer
+{
+public:
+	FRHISoftwareFrameBuffer(const FRHIRenderTargetView *InColorTargets, uint32_t InColorTargetsNum, const FRHIRenderTargetView &InDepthStencilTarget);
+
+	void LoadSurface();
+	void StoreSurface();
+
+	FRHISoftwareViewport* GetSurface() const { return Surface.DeRef(); }
+
+	// the texels of the level of a view
+	static std::vector<FLinearColor>* GetTargetTexels(const FRHIRenderTargetView &InView);
+
+protected:
+	TRefCountPtr<FRHISoftwareViewport>	Surface;
+};
+
+// occlusion query, the samples are added by the tiles of the draws. the rasterizer is flushed at
+// the end so the result is known at once.
+class FRHISoftwareOcclusionQuery : public FRHIOcclusionQuery
+{
+public:
+	FRHISoftwareOcclusionQuery()
+		: SamplesPassed(0)
+		, bEnded(false)
+	{}
+
+	std::atomic<uint64_t>	SamplesPassed;
+	bool					bEnded;
+};
+
+typedef TRefCountPtr<FRHISoftwareSamplerState>		FRHISoftwareSamplerStateRef;
+typedef TRefCountPtr<FRHISoftwareRasterizerState>	FRHISoftwareRasterizerStateRef;
+typedef TRefCountPtr<FRHISoftwareDepthStencilState>	FRHISoftwareDepthStencilStateRef;
+typedef TRefCountPtr<FRHISoftwareBlendState>		FRHISoftwareBlendStateRef;
+typedef TRefCountPtr<FRHISoftwareVertexBuffer>		FRHISoftwareVertexBufferRef;
+typedef TRefCountPtr<FRHISoftwareIndexBuffer>		FRHISoftwareIndexBufferRef;
+typedef TRefCountPtr<FRHISoftwareVertexDeclaration>	FRHISoftwareVertexDeclarationRef;
+typedef TRefCountPtr<FRHISoftwareViewport>			FRHISoftwareViewportRef;
+typedef TRefCountPtr<FRHISoftwareRenderBuffer>		FRHISoftwareRenderBufferRef;
+typedef TRefCountPtr<FRHISoftwareFrameBuffer>		FRHISoftwareFrameBufferRef;
+typedef TRefCountPtr<FRHISoftwareOcclusionQuery>	FRHISoftwareOcclusionQueryRef;
+
+#endif // __JETX_SOFTWARE_RESOURCE_H__
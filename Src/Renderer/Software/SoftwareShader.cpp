@@ -0,0 +1,359 @@
+//\brief
+//		Software Shader Implementation.
+//
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include "SoftwareShader.h"
+
+
+void SoftwarePassThroughVertexShader(const FSoftwareUniformBlock &InUniforms, const FSoftwareVertexInput &InVertex, FSoftwareVertexOutput &OutVertex)
+{
+	const float *Position = InVertex.Attributes[0];
+	OutVertex.Position[0] = Position[0];
+	OutVertex.Position[1] = Position[1];
+	OutVertex.Position[2] = Position[2];
+	OutVertex.Position[3] = Position[3];
+
+	const float *Color = InVertex.Attributes[1];
+	OutVertex.Varyings[0] = Color[0];
+	OutVertex.Varyings[1] = Color[1];
+	OutVertex.Varyings[2] = Color[2];
+	OutVertex.Varyings[3] = Color[3];
+}
+
+bool SoftwarePassThroughPixelShader(const FSoftwareUniformBlock &InUniforms, const FSoftwarePixelInput &InPixel, FLinearColor &OutColor)
+{
+	OutColor = FLinearColor(InPixel.Varyings[0], InPixel.Varyings[1], InPixel.Varyings[2], InPixel.Varyings[3]);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Texture Sampling
+// the texel of InCoord along an axis of InSize texels, -1 for the border color.
+static int32_t AddressTexel(int32_t InCoord, int32_t InSize, ESamplerAddressMode InMode)
+{
+	switch (InMode)
+	{
+	case AM_Wrap:
+		return ((InCoord % InSize) + InSize) % InSize;
+	case AM_Mirror:
+	{
+		const int32_t kPeriod = InSize * 2;
+		const int32_t kCoord = ((InCoord % kPeriod) + kPeriod) % kPeriod;
+		return kCoord < InSize ? kCoord : kPeriod - 1 - kCoord;
+	}
+	case AM_Border:
+		return (InCoord < 0 || InCoord >= InSize) ? -1 : InCoord;
+	default:
+		return (std::max)(0, (std::min)(InCoord, InSize - 1));
+	}
+}
+
+bool FSoftwareUniformBlock::SampleTexture(uint32_t InUnit, float InU, float InV, uint32_t InLayer, float InLod, FLinearColor &OutColor) const
+{
+	if (InUnit >= MaxTextureUnits || !Textures[InUnit].IsValidRef())
+	{
+		return false;
+	}
+
+	const FSoftwareTextureData &Texture = *Textures[InUnit];
+	const FSamplerStateInitializerRHI &Sampler = Samplers[InUnit];
+	const float kLod = (std::max)(Sampler.MinMipLevel, (std::min)(InLod + Sampler.MipBias, Sampler.MaxMipLevel));
+	const uint32_t kMip = (uint32_t)(std::max)(0, (std::min)((int32_t)floorf(kLod + 0.5f), (int32_t)Texture.Mips - 1));
+	const uint32_t kLayer = (std::min)(InLayer, Texture.Layers - 1);
+
+	const std::vector<FLinearColor> &Level = Texture.GetLevel(kMip, kLayer);
+	const int32_t kSizeX = (int32_t)GetMipSize(Texture.SizeX, kMip);
+	const int32_t kSizeY = (int32_t)GetMipSize(Texture.SizeY, kMip);
+	const FLinearColor kBorder(Sampler.BorderColor[0], Sampler.BorderColor[1], Sampler.BorderColor[2], Sampler.BorderColor[3]);
+
+	const float X = InU * kSizeX, Y = InV * kSizeY;
+	if (Sampler.Filter == SF_Point)
+	{
+		const int32_t tx = AddressTexel((int32_t)floorf(X), kSizeX, Sampler.AddressS);
+		const int32_t ty = AddressTexel((int32_t)floorf(Y), kSizeY, Sampler.AddressT);
+		OutColor = (tx < 0 || ty < 0) ? kBorder : Level[ty * kSizeX + tx];
+		return true;
+	}
+
+	// bilinear between the 4 texel centers around the point
+	const float fx = X - 0.5f, fy = Y - 0.5f;
+	const int32_t x0 = (int32_t)floorf(fx), y0 = (int32_t)floorf(fy);
+	const float wx = fx - x0, wy = fy - y0;
+	const int32_t tx[2] = { AddressTexel(x0, kSizeX, Sampler.AddressS), AddressTexel(x0 + 1, kSizeX, Sampler.AddressS) };
+	const int32_t ty[2] = { AddressTexel(y0, kSizeY, Sampler.AddressT), AddressTexel(y0 + 1, kSizeY, Sampler.AddressT) };
+	const float Weights[2][2] = { { (1.f - wx) * (1.f - wy), wx * (1.f - wy) }, { (1.f - wx) * wy, wx * wy } };
+
+	OutColor = FLinearColor(0.f, 0.f, 0.f, 0.f);
+	for (uint32_t j = 0; j < 2; j++)
+	{
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			const FLinearColor &Texel = (tx[i] < 0 || ty[j] < 0) ? kBorder : Level[ty[j] * kSizeX + tx[i]];
+			for (uint32_t k = 0; k < 4; k++)
+			{
+				OutColor.RGBA[k] += Texel.RGBA[k] * Weights[j][i];
+			}
+		}
+	}
+	return true;
+}
+
+static std::string MakeShaderSource(const char *InSource, int32_t InLength)
+{
+	if (!InSource)
+	{
+		return std::string();
+	}
+
+	return InLength < 0 ? std::string(InSource) : std::string(InSource, InLength);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Shaders
+FRHISoftwareVertexShader::FRHISoftwareVertexShader(const char *InSource, int32_t InLength)
+	: Source(MakeShaderSource(InSource, InLength))
+{
+}
+
+void FRHISoftwareVertexShader::Dump(class FOutputDevice &OutDevice)
+{
+	OutDevice.Log(Log_Info, "Software-Shader Dump Debug Info:");
+	OutDevice.Log(Log_Info, "    Vertex Shader, %d bytes source (not compiled)", (int32_t)Source.size());
+}
+
+FRHISoftwarePixelShader::FRHISoftwarePixelShader(const char *InSource, int32_t InLength)
+	: Source(MakeShaderSource(InSource, InLength))
+{
+}
+
+void FRHISoftwarePixelShader::Dump(class FOutputDevice &OutDevice)
+{
+	OutDevice.Log(Log_Info, "Software-Shader Dump Debug Info:");
+	OutDevice.Log(Log_Info, "    Pixel Shader, %d bytes source (not compiled)", (int32_t)Source.size());
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Uniform Buffer
+bool FRHISoftwareUniformBuffer::Initialize(uint32_t InBytes, const void *InData)
+{
+	if (InBytes == 0)
+	{
+		return false;
+	}
+
+	Bytes = InBytes;
+	Contents = new FSoftwareUniformBufferData();
+	Contents->Data.resize(Bytes, 0);
+	if (InData)
+	{
+		::memcpy(&Contents->Data[0], InData, Bytes);
+	}
+	return true;
+}
+
+void FRHISoftwareUniformBuffer::Update(const void *InData)
+{
+	if (Contents->RetainCount() > 1)
+	{
+		// a snapshot of a draw in flight reads the old contents
+		Contents = new FSoftwareUniformBufferData();
+		Contents->Data.resize(Bytes);
+	}
+
+	::memcpy(&Contents->Data[0], InData, Bytes);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Program
+FRHISoftwareGPUProgram::FRHISoftwareGPUProgram()
+	: VertexShader(SoftwarePassThroughVertexShader)
+	, PixelShader(SoftwarePassThroughPixelShader)
+	, VaryingsNum(4)
+	, bSnapshotDirty(true)
+{
+}
+
+void FRHISoftwareGPUProgram::SetShaderFunctions(FSoftwareVertexShaderFunc InVertexShader, FSoftwarePixelShaderFunc InPixelShader, uint32_t InVaryingsNum)
+{
+	assert(InVertexShader && InPixelShader);
+	VertexShader = InVertexShader;
+	PixelShader = InPixelShader;
+	VaryingsNum = (std::min)(InVaryingsNum, (uint32_t)MaxSoftwareVaryings);
+}
+
+const FSoftwareUniformBlockRef& FRHISoftwareGPUProgram::GetUniformSnapshot(const FSoftwareUniformBufferDataRef *InBuffers, const FSoftwareTextureDataRef *InTextures, const FSamplerStateInitializerRHI *InSamplers)
+{
+	bool bBuffersChanged = false;
+	for (uint32_t k = 0; k < MaxUniformBufferBindings && UniformSnapshot.IsValidRef() && !bBuffersChanged; k++)
+	{
+		bBuffersChanged = UniformSnapshot->Buffers[k].DeRef() != InBuffers[k].DeRef();
+	}
+	for (uint32_t k = 0; k < MaxTextureUnits && UniformSnapshot.IsValidRef() && !bBuffersChanged; k++)
+	{
+		bBuffersChanged = UniformSnapshot->Textures[k].DeRef() != InTextures[k].DeRef() || !(UniformSnapshot->Samplers[k] == InSamplers[k]);
+	}
+
+	if (bSnapshotDirty || bBuffersChanged || !UniformSnapshot.IsValidRef())
+	{
+		FSoftwareUniformBlock *Block = new FSoftwareUniformBlock();
+		Block->Offsets.resize(Uniforms.size());
+		Block->Sizes.resize(Uniforms.size());
+
+		uint32_t TotalBytes = 0;
+		for (size_t Index = 0; Index < Uniforms.size(); Index++)
+		{
+			Block->Offsets[Index] = TotalBytes;
+			Block->Sizes[Index] = (uint32_t)Uniforms[Index].Data.size();
+			// keep every uniform 16 bytes aligned
+			TotalBytes += (Block->Sizes[Index] + 15) & ~15u;
+		}
+
+		Block->Data.resize(TotalBytes);
+		for (size_t Index = 0; Index < Uniforms.size(); Index++)
+		{
+			if (Block->Sizes[Index])
+			{
+				::memcpy(&Block->Data[Block->Offsets[Index]], &Uniforms[Index].Data[0], Block->Sizes[Index]);
+			}
+		}
+
+		for (uint32_t k = 0; k < MaxUniformBufferBindings; k++)
+		{
+			Block->Buffers[k] = InBuffers[k];
+		}
+		for (uint32_t k = 0; k < MaxTextureUnits; k++)
+		{
+			Block->Textures[k] = InTextures[k];
+			Block->Samplers[k] = InSamplers[k];
+		}
+
+		UniformSnapshot = Block;
+		bSnapshotDirty = false;
+	}
+
+	return UniformSnapshot;
+}
+
+void FRHISoftwareGPUProgram::AddShader(const FRHIShaderRef &InShader)
+{
+	Shaders.push_back(InShader);
+}
+
+void FRHISoftwareGPUProgram::Dump(class FOutputDevice &OutDevice)
+{
+	OutDevice.Log(Log_Info, "Software-Program Dump Debug Info:");
+	OutDevice.Log(Log_Info, "    Shaders Count: %d", (int32_t)Shaders.size());
+	OutDevice.Log(Log_Info, "    Pass-Through: %s", (VertexShader == SoftwarePassThroughVertexShader && PixelShader == SoftwarePassThroughPixelShader) ? "true" : "false");
+	OutDevice.Log(Log_Info, "    Varyings Count: %u", VaryingsNum);
+	OutDevice.Log(Log_Info, "    Queried Uniforms Count: %d", (int32_t)Uniforms.size());
+	for (size_t Index = 0; Index < Uniforms.size(); Index++)
+	{
+		const FSoftwareUniform &Element = Uniforms[Index];
+		OutDevice.Log(Log_Info, "       name=%s, bytes=%d", Element.Name.c_str(), (int32_t)Element.Data.size());
+	}
+}
+
+int32_t FRHISoftwareGPUProgram::GetUniformHandle(const std::string &InName)
+{
+	for (size_t Index = 0; Index < Uniforms.size(); Index++)
+	{
+		if (Uniforms[Index].Name == InName)
+		{
+			return (int32_t)Index;
+		}
+	}
+
+	FSoftwareUniform NewUniform;
+	NewUniform.Name = InName;
+	Uniforms.push_back(NewUniform);
+	bSnapshotDirty = true;
+
+	return (int32_t)Uniforms.size() - 1;
+}
+
+bool FRHISoftwareGPUProgram::SetUniformCommon(int32_t InHandle, const void *V, uint32_t InBytes)
+{
+	if (!V || InHandle < 0 || InHandle >= (int32_t)Uniforms.size())
+	{
+		return false;
+	}
+
+	FSoftwareUniform &Element = Uniforms[InHandle];
+	if (Element.Data.size() == InBytes && ::memcmp(&Element.Data[0], V, InBytes) == 0)
+	{
+		return true;
+	}
+
+	Element.Data.resize(InBytes);
+	::memcpy(&Element.Data[0], V, InBytes);
+	bSnapshotDirty = true;
+	return true;
+}
+
+bool FRHISoftwareGPUProgram::SetUniform1iv(int32_t InHandle, const int32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(int32_t) * InCount);
+}
+
+bool FRHISoftwareGPUProgram::SetUniform2iv(int32_t InHandle, const int32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(int32_t) * 2 * InCount);
+}
+
+bool FRHISoftwareGPUProgram::SetUniform3iv(int32_t InHandle, const int32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(int32_t) * 3 * InCount);
+}
+
+bool FRHISoftwareGPUProgram::SetUniform4iv(int32_t InHandle, const int32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(int32_t) * 4 * InCount);
+}
+
+bool FRHISoftwareGPUProgram::SetUniform1uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(uint32_t) * InCount);
+}
+
+bool FRHISoftwareGPUProgram::SetUniform2uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(uint32_t) * 2 * InCount);
+}
+
+bool FRHISoftwareGPUProgram::SetUniform3uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(uint32_t) * 3 * InCount);
+}
+
+bool FRHISoftwareGPUProgram::SetUniform4uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(uint32_t) * 4 * InCount);
+}
+
+bool FRHISoftwareGPUProgram::SetUniform1fv(int32_t InHandle, const float *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(float) * InCount);
+}
+
+bool FRHISoftwareGPUProgram::SetUniform2fv(int32_t InHandle, const float *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(float) * 2 * InCount);
+}
+
+bool FRHISoftwareGPUProgram::SetUniform3fv(int32_t InHandle, const float *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(float) * 3 * InCount);
+}
+
+bool FRHISoftwareGPUProgram::SetUniform4fv(int32_t InHandle, const float *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(float) * 4 * InCount);
+}
+
+bool FRHISoftwareGPUProgram::SetUniformMatrix4fv(int32_t InHandle, const float *V, uint32_t InCount)
+{
+	return SetUniformCommon(InHandle, V, sizeof(float) * 16 * InCount);
+}
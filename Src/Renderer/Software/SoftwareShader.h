@@ -0,0 +1,234 @@
+//\brief
+//		Software Shader: C++ callbacks run in place of GLSL.
+//
+
+#ifndef __JETX_SOFTWARE_SHADER_H__
+#define __JETX_SOFTWARE_SHADER_H__
+
+#include <string>
+#include <vector>
+#include "Foundation/JetX.h"
+#include "Foundation/OutputDevice.h"
+#include "Renderer/RendererDefs.h"
+#include "Renderer/RendererState.h"
+#include "Renderer/RHIResource.h"
+#include "SoftwareResource.h"
+
+
+/** The number of floats passed from the vertex shader to the pixel shader */
+enum { MaxSoftwareVaryings = 16 };
+
+// vertex shader input, every attribute is expanded to float4 (default 0,0,0,1)
+struct FSoftwareVertexInput
+{
+	float		Attributes[MaxVertexAttributes][4];
+	uint32_t	VertexID;
+	uint32_t	InstanceID;
+};
+
+// vertex shader output
+struct FSoftwareVertexOutput
+{
+	float		Position[4];	// clip space
+	float		Varyings[MaxSoftwareVaryings];
+};
+
+// pixel shader input
+struct FSoftwarePixelInput
+{
+	float		Varyings[MaxSoftwareVaryings];	// perspective-correct interpolated
+	float		FragCoord[4];	// window x, y, depth, 1/w
+	bool		bFrontFacing;
+};
+
+// contents of a uniform buffer, not modified any more once a draw references it.
+class FSoftwareUniformBufferData : public FRefCountedObject
+{
+public:
+	std::vector<uint8_t>	Data;
+};
+
+typedef TRefCountPtr<FSoftwareUniformBufferData>	FSoftwareUniformBufferDataRef;
+
+// snapshot of the uniforms of a program, shared by the draws in flight.
+class FSoftwareUniformBlock : public FRefCountedObject
+{
+public:
+	// the contents of the uniform buffer set at InBindIndex, nullptr if none.
+	const void* GetBufferData(uint32_t InBindIndex) const
+	{
+		return (InBindIndex < MaxUniformBufferBindings && Buffers[InBindIndex].IsValidRef() && !Buffers[InBindIndex]->Data.empty()) ? &Buffers[InBindIndex]->Data[0] : nullptr;
+	}
+
+	uint32_t GetBufferBytes(uint32_t InBindIndex) const
+	{
+		return (InBindIndex < MaxUniformBufferBindings && Buffers[InBindIndex].IsValidRef()) ? (uint32_t)Buffers[InBindIndex]->Data.size() : 0;
+	}
+
+
+	// return nullptr if the uniform has never been set.
+	const void* GetData(int32_t InHandle) const
+	{
+		if (InHandle < 0 || InHandle >= (int32_t)Sizes.size() || Sizes[InHandle] == 0)
+		{
+			return nullptr;
+		}
+		return &Data[Offsets[InHandle]];
+	}
+
+	uint32_t GetBytes(int32_t InHandle) const
+	{
+		return (InHandle < 0 || InHandle >= (int32_t)Sizes.size()) ? 0 : Sizes[InHandle];
+	}
+
+	const float* GetFloats(int32_t InHandle) const { return static_cast<const float*>(GetData(InHandle)); }
+	const int32_t* GetInts(int32_t InHandle) const { return static_cast<const int32_t*>(GetData(InHandle)); }
+	const uint32_t* GetUInts(int32_t InHandle) const { return static_cast<const uint32_t*>(GetData(InHandle)); }
+
+	// sample the texture of unit InUnit with its sampler state, (InU, InV) are normalized, (0, 0) is the first texel.
+	// InLayer is the layer of an array or the face of a cube, there is no derivative in a callback so the
+	// mip is InLod (the nearest one). return false if no texture is set at the unit.
+	bool SampleTexture(uint32_t InUnit, float InU, float InV, uint32_t InLayer, float InLod, FLinearColor &OutColor) const;
+
+	std::vector<uint8_t>	Data;
+	std::vector<uint32_t>	Offsets;
+	std::vector<uint32_t>	Sizes;
+	FSoftwareUniformBufferDataRef	Buffers[MaxUniformBufferBindings];
+	FSoftwareTextureDataRef			Textures[MaxTextureUnits];
+	FSamplerStateInitializerRHI		Samplers[MaxTextureUnits];
+};
+
+typedef TRefCountPtr<FSoftwareUniformBlock>	FSoftwareUniformBlockRef;
+
+// shader callbacks. they are called from the worker threads, so they must not
+// touch any mutable shared state.
+typedef void (*FSoftwareVertexShaderFunc)(const FSoftwareUniformBlock &InUniforms, const FSoftwareVertexInput &InVertex, FSoftwareVertexOutput &OutVertex);
+// return false to discard the pixel.
+typedef bool (*FSoftwarePixelShaderFunc)(const FSoftwareUniformBlock &InUniforms, const FSoftwarePixelInput &InPixel, FLinearColor &OutColor);
+
+// default shaders:
+// vertex: attribute 0 is the position, attribute 1 is passed as a float4 varying.
+// pixel: output the float4 varying.
+void SoftwarePassThroughVertexShader(const FSoftwareUniformBlock &InUniforms, const FSoftwareVertexInput &InVertex, FSoftwareVertexOutput &OutVertex);
+bool SoftwarePassThroughPixelShader(const FSoftwareUniformBlock &InUniforms, const FSoftwarePixelInput &InPixel, FLinearColor &OutColor);
+
+
+// Shaders, the source is kept for debugging only.
+class FRHISoftwareVertexShader : public FRHIVertexShader
+{
+public:
+	FRHISoftwareVertexShader(const char *InSource, int32_t InLength = -1);
+
+	virtual void Dump(class FOutputDevice &OutDevice) override;
+
+	std::string		Source;
+};
+
+class FRHISoftwarePixelShader : public FRHIPixelShader
+{
+public:
+	FRHISoftwarePixelShader(const char *InSource, int32_t InLength = -1);
+
+	virtual void Dump(class FOutputDevice &OutDevice) override;
+
+	std::string		Source;
+};
+
+typedef TRefCountPtr<FRHISoftwareVertexShader>	FRHISoftwareVertexShaderRef;
+typedef TRefCountPtr<FRHISoftwarePixelShader>	FRHISoftwarePixelShaderRef;
+
+
+// Uniform Buffer
+// an update while a draw still references the contents allocates new ones (copy on write).
+class FRHISoftwareUniformBuffer : public FRHIUniformBuffer
+{
+public:
+	FRHISoftwareUniformBuffer()
+		: Bytes(0)
+	{}
+
+	virtual uint32_t GetBytes() override { return Bytes; }
+
+	bool Initialize(uint32_t InBytes, const void *InData);
+	void Update(const void *InData);
+
+	const FSoftwareUniformBufferDataRef& GetContents() const { return Contents; }
+
+protected:
+	uint32_t						Bytes;
+	FSoftwareUniformBufferDataRef	Contents;
+};
+
+typedef TRefCountPtr<FRHISoftwareUniformBuffer>	FRHISoftwareUniformBufferRef;
+
+
+//////////////////////////////////////////////////////////////////////////
+// Software Program
+// GLSL is not compiled, the program runs the installed callbacks (pass-through by default).
+// a uniform handle is allocated the first time a name is queried.
+class FRHISoftwareGPUProgram : public FRHIGPUProgram
+{
+public:
+	FRHISoftwareGPUProgram();
+
+	// install the shader callbacks, InVaryingsNum floats are interpolated.
+	void SetShaderFunctions(FSoftwareVertexShaderFunc InVertexShader, FSoftwarePixelShaderFunc InPixelShader, uint32_t InVaryingsNum);
+
+	FSoftwareVertexShaderFunc GetVertexShader() const { return VertexShader; }
+	FSoftwarePixelShaderFunc GetPixelShader() const { return PixelShader; }
+	uint32_t GetVaryingsNum() const { return VaryingsNum; }
+
+	// the uniform values seen by the next draw, with the contents of the uniform buffers InBuffers
+	// and the textures InTextures sampled with InSamplers.
+	const FSoftwareUniformBlockRef& GetUniformSnapshot(const FSoftwareUniformBufferDataRef *InBuffers, const FSoftwareTextureDataRef *InTextures, const FSamplerStateInitializerRHI *InSamplers);
+
+	void AddShader(const FRHIShaderRef &InShader);
+
+	virtual void Dump(class FOutputDevice &OutDevice) override;
+	// get uniform parameter handle
+	virtual int32_t GetUniformHandle(const std::string &InName) override;
+
+	virtual bool SetUniform1iv(int32_t InHandle, const int32_t *V, uint32_t InCount) override;
+	virtual bool SetUniform2iv(int32_t InHandle, const int32_t *V, uint32_t InCount) override;
+	virtual bool SetUniform3iv(int32_t InHandle, const int32_t *V, uint32_t InCount) override;
+	virtual bool SetUniform4iv(int32_t InHandle, const int32_t *V, uint32_t InCount) override;
+
+	virtual bool SetUniform1uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount) override;
+	virtual bool SetUniform2uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount) override;
+	virtual bool SetUniform3uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount) override;
+	virtual bool SetUniform4uiv(int32_t InHandle, const uint32_t *V, uint32_t InCount) override;
+
+	virtual bool SetUniform1fv(int32_t InHandle, const float *V, uint32_t InCount) override;
+	virtual bool SetUniform2fv(int32_t InHandle, const float *V, uint32_t InCount) override;
+	virtual bool SetUniform3fv(int32_t InHandle, const float *V, uint32_t InCount) override;
+	virtual bool SetUniform4fv(int32_t InHandle, const float *V, uint32_t InCount) override;
+
+	virtual bool SetUniformMatrix4fv(int32_t InHandle, const float *V, uint32_t InCount) override;
+
+	// the callbacks read the uniform buffers by slot, see FSoftwareUniformBlock::GetBufferData.
+	virtual bool SetUniformBufferBinding(const std::string &InBlockName, uint32_t InBindIndex) override { return InBindIndex < MaxUniformBufferBindings; }
+
+protected:
+	bool SetUniformCommon(int32_t InHandle, const void *V, uint32_t InBytes);
+
+	struct FSoftwareUniform
+	{
+		std::string				Name;
+		std::vector<uint8_t>	Data;
+	};
+
+	FSoftwareVertexShaderFunc	VertexShader;
+	FSoftwarePixelShaderFunc	PixelShader;
+	uint32_t					VaryingsNum;
+
+	std::vector<FRHIShaderRef>		Shaders;
+	std::vector<FSoftwareUniform>	Uniforms;
+
+	// rebuilt when a uniform changed, the draws in flight keep the old one.
+	FSoftwareUniformBlockRef	UniformSnapshot;
+	bool						bSnapshotDirty;
+};
+
+typedef TRefCountPtr<FRHISoftwareGPUProgram>	FRHISoftwareGPUProgramRef;
+
+#endif // __JETX_SOFTWARE_SHADER_H__